@@ -20,7 +20,7 @@ std::ostream &operator<<(std::ostream &os, const Event &ev) {
 
 double calculateInvariantMass(const Event &ev) {
   FourMomentum p4;
-  for (auto x : ev.ParticleList)
+  for (auto const &x : ev.ParticleList)
     p4 += x.fourMomentum();
   return p4.invMass();
 }
@@ -0,0 +1,104 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+
+#include "Core/EventCollection.hpp"
+#include "Core/Exceptions.hpp"
+
+namespace ComPWA {
+
+EventCollection createEventCollection(const std::vector<int> &Pids) {
+  return EventCollection{.Pids = Pids,
+                         .FourMomenta =
+                             std::vector<FourMomentumColumns>(Pids.size()),
+                         .Weights = {}};
+}
+
+void resize(EventCollection &Events, std::size_t Size) {
+  Events.Weights.resize(Size, 1.0);
+  for (auto &p4 : Events.FourMomenta) {
+    p4.Px.resize(Size);
+    p4.Py.resize(Size);
+    p4.Pz.resize(Size);
+    p4.E.resize(Size);
+  }
+}
+
+void reserve(EventCollection &Events, std::size_t Size) {
+  Events.Weights.reserve(Size);
+  for (auto &p4 : Events.FourMomenta) {
+    p4.Px.reserve(Size);
+    p4.Py.reserve(Size);
+    p4.Pz.reserve(Size);
+    p4.E.reserve(Size);
+  }
+}
+
+void append(EventCollection &Events, const Event &Evt) {
+  if (Events.FourMomenta.empty() && Events.Weights.empty()) {
+    for (auto const &x : Evt.ParticleList)
+      Events.Pids.push_back(x.pid());
+    Events.FourMomenta.resize(Evt.ParticleList.size());
+  }
+  if (Evt.ParticleList.size() != Events.FourMomenta.size())
+    throw BadParameter("ComPWA::append() | Event has " +
+                       std::to_string(Evt.ParticleList.size()) +
+                       " particles but the EventCollection expects " +
+                       std::to_string(Events.FourMomenta.size()) + "!");
+
+  for (std::size_t i = 0; i < Evt.ParticleList.size(); ++i) {
+    const FourMomentum &p4(Evt.ParticleList[i].fourMomentum());
+    FourMomentumColumns &Columns(Events.FourMomenta[i]);
+    Columns.Px.push_back(p4.px());
+    Columns.Py.push_back(p4.py());
+    Columns.Pz.push_back(p4.pz());
+    Columns.E.push_back(p4.e());
+  }
+  Events.Weights.push_back(Evt.Weight);
+}
+
+Event getEvent(const EventCollection &Events, std::size_t Index) {
+  Event Evt;
+  Evt.ParticleList.reserve(Events.FourMomenta.size());
+  for (std::size_t i = 0; i < Events.FourMomenta.size(); ++i) {
+    const FourMomentumColumns &p4(Events.FourMomenta[i]);
+    Evt.ParticleList.push_back(Particle(p4.Px[Index], p4.Py[Index],
+                                        p4.Pz[Index], p4.E[Index],
+                                        Events.Pids[i]));
+  }
+  Evt.Weight = Events.Weights[Index];
+  return Evt;
+}
+
+EventCollection toEventCollection(const std::vector<Event> &Events) {
+  EventCollection Collection;
+  if (Events.empty())
+    return Collection;
+
+  std::vector<int> Pids;
+  for (auto const &x : Events.front().ParticleList)
+    Pids.push_back(x.pid());
+  Collection = createEventCollection(Pids);
+  reserve(Collection, Events.size());
+  for (auto const &Evt : Events)
+    append(Collection, Evt);
+  return Collection;
+}
+
+std::vector<Event> toEvents(const EventCollection &Events) {
+  std::vector<Event> Result;
+  Result.reserve(Events.size());
+  for (std::size_t i = 0; i < Events.size(); ++i)
+    Result.push_back(getEvent(Events, i));
+  return Result;
+}
+
+double getMaximumSampleWeight(const EventCollection &Events) {
+  if (Events.Weights.empty())
+    return 0.0;
+  return *std::max_element(Events.Weights.begin(), Events.Weights.end());
+}
+
+} // namespace ComPWA
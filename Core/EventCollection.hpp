@@ -0,0 +1,74 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef COMPWA_EVENTCOLLECTION_HPP_
+#define COMPWA_EVENTCOLLECTION_HPP_
+
+#include <vector>
+
+#include "Core/Event.hpp"
+
+namespace ComPWA {
+
+///
+/// Four-momenta of one final state particle for all events of an
+/// EventCollection. Each component is stored in a separate contiguous array.
+///
+struct FourMomentumColumns {
+  std::vector<double> Px;
+  std::vector<double> Py;
+  std::vector<double> Pz;
+  std::vector<double> E;
+};
+
+///
+/// Column-wise (structure-of-arrays) storage of a sample of Events.
+///
+/// In contrast to a std::vector<Event>, which allocates a particle list for
+/// each event, the kinematic information of all events is stored in a fixed
+/// number of contiguous arrays: one FourMomentumColumns entry per final state
+/// position and one weight per event. All events share the same final state,
+/// so the particle ids are only stored once per position.
+///
+struct EventCollection {
+  std::vector<int> Pids;
+  std::vector<FourMomentumColumns> FourMomenta;
+  std::vector<double> Weights;
+
+  std::size_t size() const { return Weights.size(); }
+  std::size_t numberOfParticles() const { return FourMomenta.size(); }
+};
+
+/// Create an empty EventCollection for a final state with the given
+/// particle ids.
+EventCollection createEventCollection(const std::vector<int> &Pids);
+
+/// Resize all columns of \p Events to \p Size events.
+void resize(EventCollection &Events, std::size_t Size);
+
+/// Reserve memory for \p Size events in all columns of \p Events.
+void reserve(EventCollection &Events, std::size_t Size);
+
+/// Append \p Evt to \p Events. An empty collection takes over the particle
+/// ids of \p Evt.
+void append(EventCollection &Events, const Event &Evt);
+
+inline FourMomentum fourMomentum(const EventCollection &Events,
+                                 std::size_t Position, std::size_t Index) {
+  const FourMomentumColumns &p4(Events.FourMomenta[Position]);
+  return FourMomentum(p4.Px[Index], p4.Py[Index], p4.Pz[Index], p4.E[Index]);
+}
+
+/// Create the Event with index \p Index from the columns of \p Events.
+Event getEvent(const EventCollection &Events, std::size_t Index);
+
+EventCollection toEventCollection(const std::vector<Event> &Events);
+
+std::vector<Event> toEvents(const EventCollection &Events);
+
+double getMaximumSampleWeight(const EventCollection &Events);
+
+} // namespace ComPWA
+
+#endif
@@ -154,6 +154,18 @@ public:
   TreeBuildError(const char *error) : Exception(error) {}
   virtual ~TreeBuildError() throw() {}
 };
+//------------------------------------------------------------------------------
+//! @class   CorruptFile
+//!
+//! @brief   Input file has an invalid format
+//------------------------------------------------------------------------------
+class CorruptFile : public Exception {
+public:
+  CorruptFile(const std::string &error = "File is corrupt!")
+      : Exception(error) {}
+  CorruptFile(const char *error) : Exception(error) {}
+  virtual ~CorruptFile() throw() {}
+};
 
 } /* namespace ComPWA */
 #endif
@@ -0,0 +1,103 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef COMPWA_FUNCTIONTREE_FUNCTIONTREECACHE_HPP_
+#define COMPWA_FUNCTIONTREE_FUNCTIONTREECACHE_HPP_
+
+#include <map>
+#include <memory>
+#include <string>
+#include <tuple>
+
+#include "Core/FunctionTree/FunctionTree.hpp"
+
+namespace ComPWA {
+namespace FunctionTree {
+
+namespace Detail {
+
+template <typename T> bool keyLess(const T &a, const T &b) { return a < b; }
+
+template <typename T>
+bool keyLess(const std::weak_ptr<T> &a, const std::weak_ptr<T> &b) {
+  return a.owner_before(b);
+}
+
+/// Lexicographical comparison of the elements \p I, ..., \p N - 1.
+template <std::size_t I, std::size_t N> struct TupleKeyLess {
+  template <typename Tuple> static bool compare(const Tuple &a, const Tuple &b) {
+    if (keyLess(std::get<I>(a), std::get<I>(b)))
+      return true;
+    if (keyLess(std::get<I>(b), std::get<I>(a)))
+      return false;
+    return TupleKeyLess<I + 1, N>::compare(a, b);
+  }
+};
+
+template <std::size_t N> struct TupleKeyLess<N, N> {
+  template <typename Tuple> static bool compare(const Tuple &, const Tuple &) {
+    return false;
+  }
+};
+
+} // namespace Detail
+
+/// Ordering of tuple keys, whose std::weak_ptr elements are compared with
+/// std::owner_less. A key refers to its objects by their control block
+/// instead of their address, so that it never matches a new object that was
+/// allocated at the address of a deleted one.
+struct KeyLess {
+  template <typename... T>
+  bool operator()(const std::tuple<T...> &a, const std::tuple<T...> &b) const {
+    return Detail::TupleKeyLess<0, sizeof...(T)>::compare(a, b);
+  }
+};
+
+///
+/// \class FunctionTreeCache
+/// Stores FunctionTrees under a \p KeyType, so that a tree that is requested
+/// several times is created only once and inserted into all parent trees.
+/// The keys are tuples that are ordered by KeyLess, objects are referred to
+/// by std::weak_ptr.
+///
+/// FunctionTree::insertNode() links a node to an existing node of the same
+/// name instead of inserting it. Two different cached trees must therefore
+/// never have the same node name, even if their names are built from
+/// parameters with the same (or an empty) name. uniqueName() numbers the
+/// names by the order of creation for this purpose.
+///
+template <typename KeyType> class FunctionTreeCache {
+public:
+  /// The tree stored under \p Key, or a null pointer.
+  std::shared_ptr<ComPWA::FunctionTree::FunctionTree>
+  find(const KeyType &Key) const {
+    auto Cached = Trees.find(Key);
+    if (Cached == Trees.end())
+      return nullptr;
+    return Cached->second;
+  }
+
+  void insert(const KeyType &Key,
+              std::shared_ptr<ComPWA::FunctionTree::FunctionTree> Tree) {
+    Trees[Key] = Tree;
+  }
+
+  /// Node name \p Prefix + number + \p Suffix for the next tree.
+  std::string uniqueName(const std::string &Prefix,
+                         const std::string &Suffix) const {
+    return Prefix + std::to_string(Trees.size()) + Suffix;
+  }
+
+  std::size_t size() const { return Trees.size(); }
+
+private:
+  std::map<KeyType, std::shared_ptr<ComPWA::FunctionTree::FunctionTree>,
+           KeyLess>
+      Trees;
+};
+
+} // namespace FunctionTree
+} // namespace ComPWA
+
+#endif
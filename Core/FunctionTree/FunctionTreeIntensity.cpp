@@ -1,3 +1,5 @@
+#include <algorithm>
+
 #include "Core/FunctionTree/FunctionTreeIntensity.hpp"
 #include "Core/FunctionTree/FunctionTree.hpp"
 #include "Core/FunctionTree/Value.hpp"
@@ -8,7 +10,8 @@ namespace FunctionTree {
 FunctionTreeIntensity::FunctionTreeIntensity(
     std::shared_ptr<FunctionTree> Tree_, ParameterList Parameters_,
     ParameterList Data_)
-    : Tree(Tree_), Parameters(Parameters_), Data(Data_) {
+    : Tree(Tree_), Parameters(Parameters_), Data(Data_),
+      CheckNumericalHealth(false) {
   Tree->parameter();
 }
 
@@ -17,9 +20,19 @@ std::vector<double> FunctionTreeIntensity::evaluate(
   updateDataContainers(data);
   auto val =
       std::dynamic_pointer_cast<Value<std::vector<double>>>(Tree->parameter());
+  if (CheckNumericalHealth) {
+    auto Report = checkNumericalHealth();
+    if (!Report.isHealthy())
+      LOG(WARNING) << "FunctionTreeIntensity::evaluate() | "
+                   << Report.to_str();
+  }
   return val->value();
 }
 
+NumericalHealthReport FunctionTreeIntensity::checkNumericalHealth() const {
+  return ComPWA::FunctionTree::checkNumericalHealth(Tree->Head);
+}
+
 void FunctionTreeIntensity::updateDataContainers(
     const std::vector<std::vector<double>> &data) {
   ComPWA::FunctionTree::updateDataContainers(Data, data);
@@ -53,6 +66,24 @@ std::string FunctionTreeIntensity::print(int level) const {
   return Tree->Head->print(level);
 }
 
+std::vector<std::string>
+FunctionTreeIntensity::getUsedDataVariableNames() const {
+  return ComPWA::FunctionTree::getUsedDataVariableNames(Tree, Data);
+}
+
+std::vector<std::string>
+getUsedDataVariableNames(std::shared_ptr<FunctionTree> Tree,
+                         const ParameterList &Data) {
+  std::vector<std::shared_ptr<Parameter>> Leaves;
+  Tree->Head->fillLeafParameters(Leaves);
+  std::vector<std::string> Names;
+  for (auto x : Data.mDoubleValues()) {
+    if (std::find(Leaves.begin(), Leaves.end(), x) != Leaves.end())
+      Names.push_back(x->name());
+  }
+  return Names;
+}
+
 void updateDataContainers(ParameterList Data,
                           const std::vector<std::vector<double>> &data) {
   // just loop over the vectors and fill in the data
@@ -4,6 +4,7 @@
 #include <memory>
 
 #include "Core/Function.hpp"
+#include "Core/FunctionTree/NumericalHealth.hpp"
 #include "Core/FunctionTree/ParameterList.hpp"
 #include "FunctionTreeEstimator.hpp"
 
@@ -33,17 +34,37 @@ public:
 
   std::string print(int level) const;
 
+  /// Names of the data containers that are read by a leaf of the tree. Data
+  /// containers are named after the kinematic variables they hold, so the
+  /// result can be passed on to the data conversion in order to skip all
+  /// variables that the model does not use.
+  std::vector<std::string> getUsedDataVariableNames() const;
+
+  /// Check the values of all nodes for NaN and Inf after each evaluate() and
+  /// log a warning with the invalid nodes. Disabled by default.
+  void setNumericalHealthCheck(bool Enable) { CheckNumericalHealth = Enable; }
+
+  /// Check the values of all nodes of the last evaluation for NaN and Inf.
+  NumericalHealthReport checkNumericalHealth() const;
+
 private:
   void updateDataContainers(const std::vector<std::vector<double>> &data);
 
   std::shared_ptr<FunctionTree> Tree;
   ParameterList Parameters;
   ParameterList Data;
+  bool CheckNumericalHealth;
 };
 
 void updateDataContainers(ParameterList Data,
                           const std::vector<std::vector<double>> &data);
 
+/// Names of the data containers of \p Data that are read by a leaf of
+/// \p Tree.
+std::vector<std::string>
+getUsedDataVariableNames(std::shared_ptr<FunctionTree> Tree,
+                         const ParameterList &Data);
+
 } // namespace FunctionTree
 } // namespace ComPWA
 
@@ -7,6 +7,7 @@
 #include <numeric>
 
 #include "Functions.hpp"
+#include "Core/VectorMath.hpp"
 
 namespace ComPWA {
 namespace FunctionTree {
@@ -558,7 +559,7 @@ void LogOf::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
       std::fill(results.begin(), results.end(), 0.); // reset
       std::transform(paras.mDoubleValue(0)->operator()().begin(),
                      paras.mDoubleValue(0)->operator()().end(), results.begin(),
-                     [](double x) { return std::log(x); });
+                     [](double x) { return VectorMath::log(x); });
     }
     if (nMI) {
       size_t n = paras.mIntValue(0)->values().size();
@@ -571,7 +572,7 @@ void LogOf::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
       }
       std::transform(paras.mIntValue(0)->operator()().begin(),
                      paras.mIntValue(0)->operator()().end(), results.begin(),
-                     [](double x) { return std::log(x); });
+                     [](double x) { return VectorMath::log(x); });
     }
     break;
   } // end multi double
@@ -638,7 +639,7 @@ void Exp::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
       std::fill(results.begin(), results.end(), 0.); // reset
       std::transform(paras.mDoubleValue(0)->operator()().begin(),
                      paras.mDoubleValue(0)->operator()().end(), results.begin(),
-                     [](double x) { return std::exp(x); });
+                     [](double x) { return VectorMath::exp(x); });
     }
     if (nMI) {
       size_t n = paras.mIntValue(0)->values().size();
@@ -651,7 +652,7 @@ void Exp::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
       }
       std::transform(paras.mIntValue(0)->operator()().begin(),
                      paras.mIntValue(0)->operator()().end(), results.begin(),
-                     [](double x) { return std::exp(x); });
+                     [](double x) { return VectorMath::exp(x); });
     }
     break;
   } // end multi double
@@ -719,7 +720,9 @@ void Pow::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
       std::fill(results.begin(), results.end(), 0.); // reset
       std::transform(paras.mDoubleValue(0)->operator()().begin(),
                      paras.mDoubleValue(0)->operator()().end(), results.begin(),
-                     [powerCopy](double x) { return std::pow(x, powerCopy); });
+                     [powerCopy](double x) {
+                       return VectorMath::pow(x, powerCopy);
+                     });
     }
     if (nMI) {
       size_t n = paras.mIntValue(0)->values().size();
@@ -732,7 +735,9 @@ void Pow::execute(ParameterList &paras, std::shared_ptr<Parameter> &out) {
       }
       std::transform(paras.mIntValue(0)->operator()().begin(),
                      paras.mIntValue(0)->operator()().end(), results.begin(),
-                     [powerCopy](double x) { return std::pow(x, powerCopy); });
+                     [powerCopy](double x) {
+                       return VectorMath::pow(x, powerCopy);
+                     });
     }
     break;
   } // end multi double
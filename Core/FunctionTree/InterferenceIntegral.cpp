@@ -0,0 +1,205 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+
+#include "Core/FunctionTree/InterferenceIntegral.hpp"
+
+namespace ComPWA {
+namespace FunctionTree {
+
+InterferenceIntegralStrategy::InterferenceIntegralStrategy(
+    std::vector<bool> HasCoefficient_,
+    std::vector<std::vector<std::shared_ptr<Parameter>>> ShapeLeaves_)
+    : Strategy(ParType::DOUBLE, "InterferenceIntegral"),
+      HasCoefficient(HasCoefficient_), ShapeLeaves(ShapeLeaves_),
+      Matrix(HasCoefficient_.size() * HasCoefficient_.size()),
+      CalculatedRows(0) {
+  if (HasCoefficient.size() != ShapeLeaves.size())
+    throw BadParameter("InterferenceIntegralStrategy::"
+                       "InterferenceIntegralStrategy() | Number of shapes "
+                       "and coefficients do not match!");
+  for (auto const &Leaves : ShapeLeaves) {
+    auto Observer = std::make_shared<ShapeObserver>();
+    for (auto Leaf : Leaves)
+      Leaf->Attach(Observer);
+    Observers.push_back(Observer);
+  }
+}
+
+InterferenceIntegralStrategy::~InterferenceIntegralStrategy() {
+  for (std::size_t i = 0; i < ShapeLeaves.size(); ++i) {
+    for (auto Leaf : ShapeLeaves[i])
+      Leaf->Detach(Observers[i]);
+  }
+}
+
+void InterferenceIntegralStrategy::execute(ParameterList &paras,
+                                           std::shared_ptr<Parameter> &out) {
+  if (out && checkType != out->type())
+    throw BadParameter(
+        "InterferenceIntegralStrategy::execute() | Parameter type mismatch!");
+
+  std::size_t NumberOfAmplitudes = HasCoefficient.size();
+#ifndef NDEBUG
+  std::size_t NumberOfCoefficients =
+      std::count(HasCoefficient.begin(), HasCoefficient.end(), true);
+  if (paras.mDoubleValues().size() != 1 ||
+      paras.mComplexValues().size() != NumberOfAmplitudes ||
+      paras.doubleParameters().size() != 2 * NumberOfCoefficients)
+    throw BadParameter("InterferenceIntegralStrategy::execute() | Expected "
+                       "the weights, " +
+                       std::to_string(NumberOfAmplitudes) + " shapes and " +
+                       std::to_string(NumberOfCoefficients) +
+                       " magnitudes and phases!");
+#endif
+
+  if (!out)
+    out = std::make_shared<Value<double>>();
+  auto &Result = std::static_pointer_cast<Value<double>>(out)->operator()();
+
+  // recalculate the rows M_ij (and the columns M_ji = M_ij^*) of the shapes
+  // that have changed
+  const double *Weights = paras.mDoubleValue(0)->values().data();
+  std::size_t n = paras.mDoubleValue(0)->values().size();
+  for (std::size_t i = 0; i < NumberOfAmplitudes; ++i) {
+    if (!Observers[i]->HasChanged)
+      continue;
+    const double *A = reinterpret_cast<const double *>(
+        paras.mComplexValue(i)->values().data());
+    for (std::size_t j = 0; j < NumberOfAmplitudes; ++j) {
+      // this element was calculated with the row j
+      if (j < i && Observers[j]->HasChanged)
+        continue;
+      const double *B = reinterpret_cast<const double *>(
+          paras.mComplexValue(j)->values().data());
+      double SumRe(0.0);
+      double SumIm(0.0);
+      for (std::size_t e = 0; e < n; ++e) {
+        double ARe = A[2 * e], AIm = A[2 * e + 1];
+        double BRe = B[2 * e], BIm = B[2 * e + 1];
+        SumRe += Weights[e] * (ARe * BRe + AIm * BIm);
+        SumIm += Weights[e] * (AIm * BRe - ARe * BIm);
+      }
+      Matrix[i * NumberOfAmplitudes + j] = {SumRe, SumIm};
+      Matrix[j * NumberOfAmplitudes + i] = {SumRe, -SumIm};
+    }
+    ++CalculatedRows;
+  }
+  for (auto Observer : Observers)
+    Observer->HasChanged = false;
+
+  // coefficients in the order of the amplitudes
+  std::vector<std::complex<double>> Coefficients(NumberOfAmplitudes, 1.0);
+  std::size_t Pos(0);
+  for (std::size_t i = 0; i < NumberOfAmplitudes; ++i) {
+    if (!HasCoefficient[i])
+      continue;
+    Coefficients[i] =
+        std::polar(std::abs(paras.doubleParameter(Pos)->value()),
+                   paras.doubleParameter(Pos + 1)->value());
+    Pos += 2;
+  }
+
+  // sum_ij c_i c_j^* M_ij = sum_i |c_i|^2 M_ii + 2 Re sum_i<j c_i c_j^* M_ij
+  double Sum(0.0);
+  for (std::size_t i = 0; i < NumberOfAmplitudes; ++i) {
+    Sum += std::norm(Coefficients[i]) *
+           Matrix[i * NumberOfAmplitudes + i].real();
+    for (std::size_t j = i + 1; j < NumberOfAmplitudes; ++j)
+      Sum += 2.0 * (Coefficients[i] * std::conj(Coefficients[j]) *
+                    Matrix[i * NumberOfAmplitudes + j])
+                       .real();
+  }
+  Result = Sum;
+}
+
+std::shared_ptr<FunctionTree> createInterferenceIntegralTree(
+    std::shared_ptr<FunctionTree> Intensity,
+    std::shared_ptr<Value<std::vector<double>>> Weights) {
+  auto Head = Intensity->Head;
+  if (!std::dynamic_pointer_cast<AbsSquare>(Head->strategy()) ||
+      Head->childNodes().size() != 1)
+    return nullptr;
+  auto SumOfAmplitudes = Head->childNodes().front();
+  if (!std::dynamic_pointer_cast<AddAll>(SumOfAmplitudes->strategy()))
+    return nullptr;
+
+  // split the amplitudes into coefficients and shapes
+  std::vector<std::shared_ptr<TreeNode>> Shapes;
+  std::vector<std::pair<std::shared_ptr<FitParameter>,
+                        std::shared_ptr<FitParameter>>>
+      Coefficients;
+  for (auto Amplitude : SumOfAmplitudes->childNodes()) {
+    if (Amplitude->parameter()->type() != ParType::MCOMPLEX)
+      return nullptr;
+    auto Children = Amplitude->childNodes();
+    std::shared_ptr<FitParameter> Magnitude;
+    std::shared_ptr<FitParameter> Phase;
+    if (std::dynamic_pointer_cast<MultAll>(Amplitude->strategy()) &&
+        Children.size() == 2 &&
+        std::dynamic_pointer_cast<Complexify>(Children[0]->strategy()) &&
+        Children[0]->childNodes().size() == 2) {
+      Magnitude = std::dynamic_pointer_cast<FitParameter>(
+          Children[0]->childNodes()[0]->parameter());
+      Phase = std::dynamic_pointer_cast<FitParameter>(
+          Children[0]->childNodes()[1]->parameter());
+    }
+    if (Magnitude && Phase &&
+        Children[1]->parameter()->type() == ParType::MCOMPLEX) {
+      Shapes.push_back(Children[1]);
+      Coefficients.push_back(std::make_pair(Magnitude, Phase));
+    } else {
+      Shapes.push_back(Amplitude);
+      Coefficients.push_back(std::make_pair(nullptr, nullptr));
+    }
+  }
+  if (Shapes.empty())
+    return nullptr;
+  // the shapes are inserted by name
+  for (std::size_t i = 0; i < Shapes.size(); ++i) {
+    for (std::size_t j = 0; j < Shapes.size(); ++j) {
+      if (i != j && Shapes[j]->findNode(Shapes[i]->name()))
+        return nullptr;
+    }
+  }
+
+  std::vector<bool> HasCoefficient;
+  std::vector<std::vector<std::shared_ptr<Parameter>>> ShapeLeaves;
+  for (std::size_t i = 0; i < Shapes.size(); ++i) {
+    HasCoefficient.push_back(Coefficients[i].first != nullptr);
+    std::vector<std::shared_ptr<Parameter>> Leaves;
+    Shapes[i]->fillLeafParameters(Leaves);
+    // a change of the weights changes all rows
+    if (std::find(Leaves.begin(), Leaves.end(), Weights) == Leaves.end())
+      Leaves.push_back(Weights);
+    ShapeLeaves.push_back(Leaves);
+  }
+
+  std::string NodeName = "InterferenceIntegral(" + Head->name() + ")";
+  auto Tree = std::make_shared<FunctionTree>(
+      NodeName, std::make_shared<Value<double>>(),
+      std::make_shared<InterferenceIntegralStrategy>(HasCoefficient,
+                                                     ShapeLeaves));
+  // The leaves are created before the shapes are inserted, since nodes
+  // with the same name as an existing node are merged.
+  Tree->createLeaf(NodeName + "_EventWeight", Weights, NodeName);
+  for (std::size_t i = 0; i < Shapes.size(); ++i) {
+    if (!HasCoefficient[i])
+      continue;
+    std::string Suffix = "[" + std::to_string(i) + "]";
+    Tree->createLeaf(NodeName + "_Magnitude" + Suffix, Coefficients[i].first,
+                     NodeName);
+    Tree->createLeaf(NodeName + "_Phase" + Suffix, Coefficients[i].second,
+                     NodeName);
+  }
+  for (auto Shape : Shapes)
+    Tree->insertNode(Shape, NodeName);
+
+  Tree->parameter();
+  return Tree;
+}
+
+} // namespace FunctionTree
+} // namespace ComPWA
@@ -0,0 +1,92 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Weighted sum of a coherent intensity over a sample via the interference
+/// matrix of its amplitudes.
+///
+
+#ifndef COMPWA_FUNCTIONTREE_INTERFERENCEINTEGRAL_HPP_
+#define COMPWA_FUNCTIONTREE_INTERFERENCEINTEGRAL_HPP_
+
+#include <complex>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Core/FunctionTree/FunctionTree.hpp"
+#include "Core/FunctionTree/Functions.hpp"
+#include "Core/FunctionTree/ParObserver.hpp"
+#include "Core/FunctionTree/Value.hpp"
+
+namespace ComPWA {
+namespace FunctionTree {
+
+///
+/// \class InterferenceIntegralStrategy
+/// Calculates the weighted sum over the events e of a coherent intensity
+///
+///   sum_e w_e |sum_i c_i A_i(e)|^2 = sum_ij c_i c_j^* M_ij,
+///   M_ij = sum_e w_e A_i(e) A_j(e)^*,
+///
+/// with the amplitude shapes A_i and the coefficients
+/// c_i = |Magnitude_i| exp(i Phase_i) (or c_i = 1). The interference matrix M
+/// is stored. A row of M is recalculated only if one of the leaves of the
+/// shape A_i has changed, which is tracked by observers attached to the
+/// leaves. If only coefficients change, an evaluation costs O(n_amp^2)
+/// instead of O(N).
+///
+/// The leaves of the node are the event weights (MDOUBLE), the shapes A_i
+/// (MCOMPLEX) and the magnitude and phase of each amplitude with coefficient.
+///
+class InterferenceIntegralStrategy : public Strategy {
+public:
+  /// \p HasCoefficient_ flags the amplitudes with a coefficient,
+  /// \p ShapeLeaves_ are the leaf parameters of each shape.
+  InterferenceIntegralStrategy(
+      std::vector<bool> HasCoefficient_,
+      std::vector<std::vector<std::shared_ptr<Parameter>>> ShapeLeaves_);
+
+  virtual ~InterferenceIntegralStrategy();
+
+  virtual void execute(ParameterList &paras, std::shared_ptr<Parameter> &out);
+
+  /// Number of rows of the interference matrix that were calculated so far.
+  std::size_t numberOfCalculatedRows() const { return CalculatedRows; }
+
+private:
+  /// Flags the shape of an amplitude as modified.
+  struct ShapeObserver : public ParObserver {
+    bool HasChanged = true;
+    void update() { HasChanged = true; }
+  };
+
+  std::vector<bool> HasCoefficient;
+  std::vector<std::vector<std::shared_ptr<Parameter>>> ShapeLeaves;
+  std::vector<std::shared_ptr<ShapeObserver>> Observers;
+  /// Interference matrix, row-major
+  std::vector<std::complex<double>> Matrix;
+  std::size_t CalculatedRows;
+};
+
+/// Create a tree for the sum of \p Weights times the coherent intensity
+/// \p Intensity over the events, using the InterferenceIntegralStrategy.
+/// The head of \p Intensity has to be an AbsSquare of a single AddAll node
+/// of amplitudes. Amplitudes that are a MultAll of a Complexify node of
+/// two FitParameters (magnitude and phase) and a shape node are split into
+/// coefficient and shape, all other amplitudes are used as shapes. The shape
+/// nodes are inserted into the new tree.
+///
+/// Returns a null pointer if \p Intensity is not a coherent sum of
+/// amplitudes or if the shapes cannot be inserted, because their names are
+/// not unique.
+std::shared_ptr<FunctionTree> createInterferenceIntegralTree(
+    std::shared_ptr<FunctionTree> Intensity,
+    std::shared_ptr<Value<std::vector<double>>> Weights);
+
+} // namespace FunctionTree
+} // namespace ComPWA
+
+#endif
@@ -0,0 +1,155 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <cmath>
+#include <complex>
+#include <map>
+#include <sstream>
+
+#include "Core/FunctionTree/FitParameter.hpp"
+#include "Core/FunctionTree/NumericalHealth.hpp"
+#include "Core/FunctionTree/TreeNode.hpp"
+#include "Core/FunctionTree/Value.hpp"
+
+namespace ComPWA {
+namespace FunctionTree {
+
+namespace {
+
+/// Count the NaN and Inf values of \p n values, which consist of \p Parts
+/// doubles each (e.g. two for complex numbers).
+void checkValues(const double *Values, std::size_t n, unsigned int Parts,
+                 std::size_t MaxPositions, NodeHealth &Health) {
+  Health.NumberOfValues = n;
+  std::size_t NumberOfNaN(0);
+  std::size_t NumberOfInvalid(0);
+  for (std::size_t i = 0; i < n; ++i) {
+    bool IsNaN = false;
+    bool IsInvalid = false;
+    for (unsigned int p = 0; p < Parts; ++p) {
+      double x = Values[i * Parts + p];
+      IsNaN |= x != x;
+      IsInvalid |= !std::isfinite(x);
+    }
+    NumberOfNaN += IsNaN;
+    NumberOfInvalid += IsInvalid;
+  }
+  Health.NumberOfNaN = NumberOfNaN;
+  Health.NumberOfInf = NumberOfInvalid - NumberOfNaN;
+  if (!NumberOfInvalid)
+    return;
+
+  for (std::size_t i = 0; i < n && Health.Positions.size() < MaxPositions;
+       ++i) {
+    for (unsigned int p = 0; p < Parts; ++p) {
+      if (!std::isfinite(Values[i * Parts + p])) {
+        Health.Positions.push_back(i);
+        break;
+      }
+    }
+  }
+}
+
+NodeHealth checkParameter(std::shared_ptr<Parameter> Par,
+                          std::size_t MaxPositions) {
+  NodeHealth Health;
+  switch (Par->type()) {
+  case ParType::MDOUBLE: {
+    auto &Values =
+        std::dynamic_pointer_cast<Value<std::vector<double>>>(Par)->values();
+    checkValues(Values.data(), Values.size(), 1, MaxPositions, Health);
+    break;
+  }
+  case ParType::MCOMPLEX: {
+    auto &Values =
+        std::dynamic_pointer_cast<Value<std::vector<std::complex<double>>>>(
+            Par)
+            ->values();
+    checkValues(reinterpret_cast<const double *>(Values.data()),
+                Values.size(), 2, MaxPositions, Health);
+    break;
+  }
+  case ParType::DOUBLE: {
+    double x(0.0);
+    if (auto Fit = std::dynamic_pointer_cast<FitParameter>(Par))
+      x = Fit->value();
+    else
+      x = std::dynamic_pointer_cast<Value<double>>(Par)->value();
+    checkValues(&x, 1, 1, MaxPositions, Health);
+    break;
+  }
+  case ParType::COMPLEX: {
+    auto x = std::dynamic_pointer_cast<Value<std::complex<double>>>(Par)
+                 ->value();
+    checkValues(reinterpret_cast<const double *>(&x), 1, 2, MaxPositions,
+                Health);
+    break;
+  }
+  default:
+    // integers are always valid
+    break;
+  }
+  return Health;
+}
+
+/// Check \p Node and its child nodes. Returns true if the value of \p Node
+/// contains NaN or Inf.
+bool checkNode(std::shared_ptr<TreeNode> Node, std::size_t MaxPositions,
+               std::map<const TreeNode *, bool> &Checked,
+               NumericalHealthReport &Report) {
+  auto Found = Checked.find(Node.get());
+  if (Found != Checked.end())
+    return Found->second;
+
+  bool HasInvalidChild = false;
+  for (auto ch : Node->childNodes())
+    HasInvalidChild |= checkNode(ch, MaxPositions, Checked, Report);
+
+  NodeHealth Health = checkParameter(Node->parameter(), MaxPositions);
+  bool IsInvalid = Health.NumberOfNaN || Health.NumberOfInf;
+  if (IsInvalid) {
+    Health.NodeName = Node->name();
+    if (Node->childNodes().size() && Node->strategy())
+      Health.StrategyName = Node->strategy()->str();
+    Health.IsOrigin = !HasInvalidChild;
+    Report.InvalidNodes.push_back(Health);
+  }
+  Checked[Node.get()] = IsInvalid;
+  return IsInvalid;
+}
+
+} // namespace
+
+std::string NumericalHealthReport::to_str() const {
+  std::stringstream ss;
+  if (isHealthy()) {
+    ss << "NumericalHealthReport | All values are valid.";
+    return ss.str();
+  }
+  ss << "NumericalHealthReport | " << InvalidNodes.size()
+     << " node(s) with NaN or Inf values:";
+  for (auto const &x : InvalidNodes) {
+    ss << std::endl << "  " << x.NodeName;
+    if (x.StrategyName != "")
+      ss << " (" << x.StrategyName << ")";
+    ss << ": " << x.NumberOfNaN << " NaN and " << x.NumberOfInf
+       << " Inf of " << x.NumberOfValues << " values, first at";
+    for (auto Position : x.Positions)
+      ss << " " << Position;
+    if (x.IsOrigin)
+      ss << " [origin]";
+  }
+  return ss.str();
+}
+
+NumericalHealthReport checkNumericalHealth(std::shared_ptr<TreeNode> Head,
+                                           std::size_t MaxPositions) {
+  NumericalHealthReport Report;
+  std::map<const TreeNode *, bool> Checked;
+  checkNode(Head, MaxPositions, Checked, Report);
+  return Report;
+}
+
+} // namespace FunctionTree
+} // namespace ComPWA
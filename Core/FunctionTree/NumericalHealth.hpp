@@ -0,0 +1,66 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Validation of the values of a FunctionTree for NaN and Inf.
+///
+/// The strategies of the dynamical functions do not check their results inside
+/// of the loops over the events. Instead, the values of all nodes of a tree
+/// can be validated after an evaluation with checkNumericalHealth(). This is
+/// independent of the build type, so that numerical problems can be diagnosed
+/// in release builds as well.
+///
+
+#ifndef COMPWA_FUNCTIONTREE_NUMERICALHEALTH_HPP_
+#define COMPWA_FUNCTIONTREE_NUMERICALHEALTH_HPP_
+
+#include <cstddef>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace ComPWA {
+namespace FunctionTree {
+
+class TreeNode;
+
+/// NaN and Inf values in the (cached) value of a single node.
+struct NodeHealth {
+  std::string NodeName;
+  /// Strategy of the node, empty for leaves
+  std::string StrategyName;
+  /// Number of values (events) of the node
+  std::size_t NumberOfValues = 0;
+  /// Number of values with a NaN (real or imaginary part)
+  std::size_t NumberOfNaN = 0;
+  /// Number of values with an Inf and without a NaN
+  std::size_t NumberOfInf = 0;
+  /// Positions of the first invalid values
+  std::vector<std::size_t> Positions;
+  /// True if the invalid values are not inherited from one of the child
+  /// nodes, i.e. the node is the origin of the problem.
+  bool IsOrigin = false;
+};
+
+struct NumericalHealthReport {
+  /// Nodes with invalid values. Child nodes appear before their parents.
+  std::vector<NodeHealth> InvalidNodes;
+
+  bool isHealthy() const { return InvalidNodes.empty(); }
+
+  std::string to_str() const;
+};
+
+/// Check the values of \p Head and of all downstream nodes for NaN and Inf.
+/// Nodes that have been modified are evaluated. Nodes that are reachable via
+/// several paths are checked only once. For each invalid node the positions
+/// of at most \p MaxPositions invalid values are reported.
+NumericalHealthReport checkNumericalHealth(std::shared_ptr<TreeNode> Head,
+                                           std::size_t MaxPositions = 10);
+
+} // namespace FunctionTree
+} // namespace ComPWA
+
+#endif
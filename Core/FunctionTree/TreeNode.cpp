@@ -2,6 +2,7 @@
 // This file is part of the ComPWA framework, check
 // https://github.com/ComPWA/ComPWA/license.txt for details.
 
+#include <algorithm>
 #include <complex>
 #include <memory>
 #include <string>
@@ -48,6 +49,11 @@ void TreeNode::update() {
   HasChanged = true;
 };
 
+void TreeNode::setStrategy(std::shared_ptr<Strategy> strategy) {
+  Strat = strategy;
+  update();
+}
+
 std::shared_ptr<Parameter> TreeNode::parameter() {
   if (!OutputParameter && !ChildNodes.size())
     throw std::runtime_error("TreeNode::parameter() | Caching is disabled but "
@@ -102,6 +108,16 @@ void TreeNode::fillParameters(ParameterList &list) {
   list.addParameter(parameter());
 }
 
+void TreeNode::fillLeafParameters(
+    std::vector<std::shared_ptr<Parameter>> &Leaves) const {
+  for (auto ch : ChildNodes)
+    ch->fillLeafParameters(Leaves);
+  if (ChildNodes.size() || !OutputParameter)
+    return;
+  if (std::find(Leaves.begin(), Leaves.end(), OutputParameter) == Leaves.end())
+    Leaves.push_back(OutputParameter);
+}
+
 std::shared_ptr<TreeNode> TreeNode::findNode(std::string name) {
   if (Name == name)
     return shared_from_this();
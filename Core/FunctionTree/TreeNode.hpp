@@ -63,9 +63,21 @@ public:
   /// with fit parameters, so we add only FitParameters.
   virtual void fillParameters(ParameterList &list);
 
+  /// Fill \p Leaves with the parameters of all downstream leaf nodes. Leafs
+  /// that are reachable via several paths are added only once. In contrast to
+  /// fillParameters() the nodes are not evaluated.
+  virtual void
+  fillLeafParameters(std::vector<std::shared_ptr<Parameter>> &Leaves) const;
+
   /// Flags the node as modified. Should only be called from its child nodes.
   virtual void update();
 
+  std::shared_ptr<Strategy> strategy() const { return Strat; }
+
+  /// Replace the strategy of the node, e.g. by a strategy that wraps the
+  /// current one. The node is flagged as modified.
+  virtual void setStrategy(std::shared_ptr<Strategy> strategy);
+
   /// Get list of child nodes
   virtual std::vector<std::shared_ptr<TreeNode>> &childNodes();
 
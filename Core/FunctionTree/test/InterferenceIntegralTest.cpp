@@ -0,0 +1,133 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#define BOOST_TEST_MODULE Core
+
+#include <complex>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Core/FunctionTree/FitParameter.hpp"
+#include "Core/FunctionTree/FunctionTree.hpp"
+#include "Core/FunctionTree/Functions.hpp"
+#include "Core/FunctionTree/InterferenceIntegral.hpp"
+#include "Core/FunctionTree/Value.hpp"
+
+using namespace ComPWA::FunctionTree;
+
+BOOST_AUTO_TEST_SUITE(FunctionTreeTest);
+
+/// Shape x_i * s_i of a complex data column x_i and a parameter s_i.
+std::shared_ptr<FunctionTree>
+createShape(std::string Name, std::shared_ptr<FitParameter> Scale,
+            std::shared_ptr<Value<std::vector<std::complex<double>>>> Column) {
+  auto Tree = std::make_shared<FunctionTree>(
+      Name, MComplex("", Column->values().size()),
+      std::make_shared<MultAll>(ParType::MCOMPLEX));
+  Tree->createLeaf(Name + "_Scale", Scale, Name);
+  Tree->createLeaf(Name + "_Column", Column, Name);
+  return Tree;
+}
+
+BOOST_AUTO_TEST_CASE(InterferenceIntegral) {
+  const std::size_t NumberOfEvents = 100;
+  std::vector<std::shared_ptr<Value<std::vector<std::complex<double>>>>>
+      Columns;
+  for (unsigned int i = 0; i < 3; ++i) {
+    std::vector<std::complex<double>> Values;
+    for (std::size_t e = 0; e < NumberOfEvents; ++e)
+      Values.push_back(std::polar(1.0 + 0.01 * e * (i + 1), 0.1 * e * i));
+    Columns.push_back(
+        std::make_shared<Value<std::vector<std::complex<double>>>>(
+            "x" + std::to_string(i), Values));
+  }
+  std::vector<double> WeightValues;
+  for (std::size_t e = 0; e < NumberOfEvents; ++e)
+    WeightValues.push_back(0.5 + 0.01 * e);
+  auto Weights = MDouble("Weight", WeightValues);
+
+  std::vector<std::shared_ptr<FitParameter>> Scales;
+  std::vector<std::shared_ptr<FitParameter>> Magnitudes;
+  std::vector<std::shared_ptr<FitParameter>> Phases;
+  for (unsigned int i = 0; i < 3; ++i) {
+    Scales.push_back(std::make_shared<FitParameter>(
+        "Scale" + std::to_string(i), 1.0 + i));
+    Magnitudes.push_back(std::make_shared<FitParameter>(
+        "Magnitude" + std::to_string(i), 1.0 / (i + 1)));
+    Phases.push_back(std::make_shared<FitParameter>(
+        "Phase" + std::to_string(i), 0.5 * i));
+  }
+
+  // |c_0 A_0 + c_1 A_1 + A_2|^2, the last amplitude has no coefficient
+  auto Intensity = std::make_shared<FunctionTree>(
+      "CoherentIntensity", MDouble("", 0),
+      std::make_shared<AbsSquare>(ParType::MDOUBLE));
+  Intensity->createNode("SumOfAmplitudes", MComplex("", 0),
+                        std::make_shared<AddAll>(ParType::MCOMPLEX),
+                        "CoherentIntensity");
+  for (unsigned int i = 0; i < 2; ++i) {
+    std::string Name = "CoefficientAmplitude" + std::to_string(i);
+    auto Amplitude = std::make_shared<FunctionTree>(
+        Name, MComplex("", 0), std::make_shared<MultAll>(ParType::MCOMPLEX));
+    Amplitude->createNode("Strength",
+                          std::make_shared<Value<std::complex<double>>>(),
+                          std::make_shared<Complexify>(ParType::COMPLEX),
+                          Name);
+    Amplitude->createLeaf("Magnitude", Magnitudes[i], "Strength");
+    Amplitude->createLeaf("Phase", Phases[i], "Strength");
+    Amplitude->insertTree(
+        createShape("Shape" + std::to_string(i), Scales[i], Columns[i]),
+        Name);
+    Intensity->insertTree(Amplitude, "SumOfAmplitudes");
+  }
+  Intensity->insertTree(createShape("Shape2", Scales[2], Columns[2]),
+                        "SumOfAmplitudes");
+
+  // reference: sum_e w_e I(e)
+  auto Reference = std::make_shared<FunctionTree>(
+      "Sum", std::make_shared<Value<double>>(),
+      std::make_shared<AddAll>(ParType::DOUBLE));
+  Reference->createNode("WeightedIntensities", MDouble("", 0),
+                        std::make_shared<MultAll>(ParType::MDOUBLE), "Sum");
+  Reference->createLeaf("EventWeight", Weights, "WeightedIntensities");
+  Reference->insertTree(Intensity, "WeightedIntensities");
+
+  auto Tree = createInterferenceIntegralTree(Intensity, Weights);
+  BOOST_REQUIRE(Tree);
+  auto Strategy = std::dynamic_pointer_cast<InterferenceIntegralStrategy>(
+      Tree->Head->strategy());
+  BOOST_REQUIRE(Strategy);
+
+  auto value = [](std::shared_ptr<FunctionTree> x) {
+    return std::dynamic_pointer_cast<Value<double>>(x->parameter())->value();
+  };
+  BOOST_CHECK_CLOSE(value(Tree), value(Reference), 1e-10);
+  BOOST_CHECK_EQUAL(Strategy->numberOfCalculatedRows(), 3);
+
+  // a change of the coefficients does not recalculate the matrix
+  Magnitudes[0]->fixParameter(false);
+  Magnitudes[0]->setValue(-2.0);
+  Phases[1]->fixParameter(false);
+  Phases[1]->setValue(1.3);
+  BOOST_CHECK_CLOSE(value(Tree), value(Reference), 1e-10);
+  BOOST_CHECK_EQUAL(Strategy->numberOfCalculatedRows(), 3);
+
+  // a change of a shape recalculates its row
+  Scales[1]->fixParameter(false);
+  Scales[1]->setValue(0.7);
+  BOOST_CHECK_CLOSE(value(Tree), value(Reference), 1e-10);
+  BOOST_CHECK_EQUAL(Strategy->numberOfCalculatedRows(), 4);
+
+  // an incoherent intensity is not supported
+  auto Incoherent = std::make_shared<FunctionTree>(
+      "IncoherentIntensity", MDouble("", 0),
+      std::make_shared<AddAll>(ParType::MDOUBLE));
+  Incoherent->insertTree(Intensity, "IncoherentIntensity");
+  BOOST_CHECK(!createInterferenceIntegralTree(Incoherent, Weights));
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -32,7 +32,9 @@
 
 #include "Core/FunctionTree/FitParameter.hpp"
 #include "Core/FunctionTree/FunctionTree.hpp"
+#include "Core/FunctionTree/FunctionTreeIntensity.hpp"
 #include "Core/FunctionTree/Functions.hpp"
+#include "Core/FunctionTree/NumericalHealth.hpp"
 #include "Core/FunctionTree/TreeNode.hpp"
 #include "Core/FunctionTree/Value.hpp"
 
@@ -150,4 +152,67 @@ BOOST_AUTO_TEST_CASE(MultiParameters) {
   LOG(INFO) << std::endl << myTreeMultD;
 }
 
+BOOST_AUTO_TEST_CASE(UsedDataVariables) {
+  std::vector<double> Values{1.0, 2.0, 3.0};
+  ParameterList Data;
+  for (std::string Name : {"x", "y", "z"})
+    Data.addValue(std::make_shared<Value<std::vector<double>>>(Name, Values));
+
+  // R = Sum[x * (x + z)], the variable y is not used
+  auto Tree = std::make_shared<FunctionTree>(
+      "R", std::make_shared<Value<double>>(),
+      std::make_shared<AddAll>(ParType::DOUBLE));
+  Tree->createNode("xxz", MDouble("par_xxz", Values.size()),
+                   std::make_shared<MultAll>(ParType::MDOUBLE), "R");
+  Tree->createLeaf("x", Data.mDoubleValue(0), "xxz");
+  Tree->createNode("xz", MDouble("par_xz", Values.size()),
+                   std::make_shared<AddAll>(ParType::MDOUBLE), "xxz");
+  Tree->createLeaf("x", Data.mDoubleValue(0), "xz");
+  Tree->createLeaf("z", Data.mDoubleValue(2), "xz");
+  Tree->createLeaf("c", std::make_shared<FitParameter>("c", 1.0), "R");
+  Tree->parameter();
+
+  auto Names = getUsedDataVariableNames(Tree, Data);
+  BOOST_CHECK_EQUAL(Names.size(), 2);
+  BOOST_CHECK_EQUAL(Names.at(0), "x");
+  BOOST_CHECK_EQUAL(Names.at(1), "z");
+}
+
+BOOST_AUTO_TEST_CASE(NumericalHealth) {
+  auto x = std::make_shared<Value<std::vector<double>>>(
+      "x", std::vector<double>{1.0, 2.0, 0.0, -1.0, 3.0});
+
+  // R = Sum[a * log(x)], log(x) is -Inf and NaN for the events 2 and 3
+  auto Tree = std::make_shared<FunctionTree>(
+      "R", std::make_shared<Value<double>>(),
+      std::make_shared<AddAll>(ParType::DOUBLE));
+  Tree->createNode("alogx", MDouble("par_alogx", 5),
+                   std::make_shared<MultAll>(ParType::MDOUBLE), "R");
+  Tree->createLeaf("a", std::make_shared<FitParameter>("a", 2.0), "alogx");
+  Tree->createNode("logx", MDouble("par_logx", 5),
+                   std::make_shared<LogOf>(ParType::MDOUBLE), "alogx");
+  Tree->createLeaf("x", x, "logx");
+  Tree->parameter();
+
+  auto Report = checkNumericalHealth(Tree->Head);
+  LOG(INFO) << Report.to_str();
+  BOOST_REQUIRE_EQUAL(Report.InvalidNodes.size(), 3);
+  auto LogX = Report.InvalidNodes.at(0);
+  BOOST_CHECK_EQUAL(LogX.NodeName, "logx");
+  BOOST_CHECK_EQUAL(LogX.NumberOfValues, 5);
+  BOOST_CHECK_EQUAL(LogX.NumberOfNaN, 1);
+  BOOST_CHECK_EQUAL(LogX.NumberOfInf, 1);
+  BOOST_REQUIRE_EQUAL(LogX.Positions.size(), 2);
+  BOOST_CHECK_EQUAL(LogX.Positions.at(0), 2);
+  BOOST_CHECK_EQUAL(LogX.Positions.at(1), 3);
+  BOOST_CHECK(LogX.IsOrigin);
+  BOOST_CHECK_EQUAL(Report.InvalidNodes.at(1).NodeName, "alogx");
+  BOOST_CHECK(!Report.InvalidNodes.at(1).IsOrigin);
+  BOOST_CHECK_EQUAL(Report.InvalidNodes.at(2).NodeName, "R");
+  BOOST_CHECK_EQUAL(Report.InvalidNodes.at(2).NumberOfNaN, 1);
+
+  x->setValue(std::vector<double>{1.0, 2.0, 3.0, 4.0, 5.0});
+  BOOST_CHECK(checkNumericalHealth(Tree->Head).isHealthy());
+}
+
 BOOST_AUTO_TEST_SUITE_END();
@@ -6,6 +6,7 @@
 #define COMPWA_GENERATOR_HPP_
 
 #include "Core/Event.hpp"
+#include "Core/EventCollection.hpp"
 #include "Core/Random.hpp"
 
 namespace ComPWA {
@@ -18,6 +19,21 @@ class PhaseSpaceEventGenerator {
 public:
   virtual ~PhaseSpaceEventGenerator() = default;
   virtual ComPWA::Event generate(UniformRealNumberGenerator &gen) const = 0;
+
+  /// Generate \p NumberOfEvents (weighted) events directly into the columns
+  /// of an EventCollection. Derived classes need a using declaration to keep
+  /// this overload visible.
+  virtual ComPWA::EventCollection
+  generate(unsigned int NumberOfEvents, UniformRealNumberGenerator &gen) const {
+    ComPWA::EventCollection Events;
+    if (!NumberOfEvents)
+      return Events;
+    ComPWA::append(Events, generate(gen));
+    reserve(Events, NumberOfEvents);
+    for (unsigned int i = 1; i < NumberOfEvents; ++i)
+      ComPWA::append(Events, generate(gen));
+    return Events;
+  }
 };
 
 } // namespace ComPWA
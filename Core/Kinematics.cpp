@@ -0,0 +1,42 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include "Core/Kinematics.hpp"
+#include "Core/Event.hpp"
+#include "Core/EventCollection.hpp"
+
+namespace ComPWA {
+
+std::vector<std::vector<double>>
+Kinematics::convert(const EventCollection &Events) const {
+  std::vector<std::vector<double>> Data(getKinematicVariableNames().size());
+  for (auto &Column : Data)
+    Column.reserve(Events.size());
+
+  for (std::size_t i = 0; i < Events.size(); ++i) {
+    DataPoint Point = convert(getEvent(Events, i));
+    auto Column = Data.begin();
+    for (auto KinVar : Point.KinematicVariableList) {
+      Column->push_back(KinVar);
+      ++Column;
+    }
+  }
+  return Data;
+}
+
+void Kinematics::convert(const Event *EventsBegin, const Event *EventsEnd,
+                         const std::vector<double *> &Columns,
+                         char *PhspMask) const {
+  for (std::size_t i = 0; EventsBegin + i != EventsEnd; ++i) {
+    DataPoint Point = convert(EventsBegin[i]);
+    for (std::size_t var = 0; var < Columns.size(); ++var) {
+      if (Columns[var])
+        Columns[var][i] = Point.KinematicVariableList[var];
+    }
+    if (PhspMask)
+      PhspMask[i] = isWithinPhaseSpace(Point);
+  }
+}
+
+} // namespace ComPWA
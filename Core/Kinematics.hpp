@@ -12,6 +12,7 @@ namespace ComPWA {
 
 struct DataPoint;
 struct Event;
+struct EventCollection;
 
 /// The Kinematics interface is responsible for converting an Event into a
 /// DataPoint.
@@ -21,12 +22,39 @@ public:
 
   virtual DataPoint convert(const ComPWA::Event &event) const = 0;
 
+  /// Convert all events of \p Events. The result contains one column per
+  /// kinematic variable (in the order of getKinematicVariableNames()) with
+  /// one entry per event. The default implementation converts the events one
+  /// by one.
+  virtual std::vector<std::vector<double>>
+  convert(const ComPWA::EventCollection &Events) const;
+
+  /// Convert the events [\p EventsBegin, \p EventsEnd) into caller provided
+  /// buffers. \p Columns contains one pointer per kinematic variable (in the
+  /// order of getKinematicVariableNames()) and the variables of the i-th event
+  /// of the range are written to Columns[var][i]. A null pointer marks a
+  /// variable that is not needed; implementations may skip its calculation.
+  /// If \p PhspMask is not null, PhspMask[i] is set to the result of
+  /// isWithinPhaseSpace() for the i-th event. The default implementation
+  /// converts the events one by one; implementations should override it
+  /// without allocating per event.
+  virtual void convert(const ComPWA::Event *EventsBegin,
+                       const ComPWA::Event *EventsEnd,
+                       const std::vector<double *> &Columns,
+                       char *PhspMask) const;
+
   virtual std::vector<std::string> getKinematicVariableNames() const = 0;
 
   /// checks if DataPoint is within phase space boundaries
   virtual bool isWithinPhaseSpace(const DataPoint &point) const = 0;
 
   virtual double phspVolume() const = 0;
+
+  /// Text that identifies the configuration of the kinematics. Two instances
+  /// with the same key convert any event into the same variables, so that
+  /// converted data can be cached under this key. An empty key (the default)
+  /// means that the conversion can not be cached.
+  virtual std::string getConfigurationKey() const { return ""; }
 };
 
 } // namespace ComPWA
@@ -6,9 +6,6 @@
 
 using namespace ComPWA;
 
-Particle::Particle(double inPx, double inPy, double inPz, double inE, int inpid)
-    : P4(std::array<double, 4>{{inPx, inPy, inPz, inE}}), Pid(inpid) {}
-
 double Particle::invariantMass(const Particle &inPa, const Particle &inPb) {
   return FourMomentum::invariantMass(inPa.fourMomentum(), inPb.fourMomentum());
 }
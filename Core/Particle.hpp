@@ -16,6 +16,7 @@
 #include <iostream>
 #include <numeric>
 #include <stdexcept>
+#include <type_traits>
 #include <vector>
 
 #include <boost/property_tree/ptree.hpp>
@@ -25,36 +26,41 @@ namespace ComPWA {
 ///
 /// \class FourMomentum
 /// ComPWA four momentum class.
+/// FourMomentum is trivially copyable and its accessors are unchecked and
+/// constexpr, so that the loops over events in the kinematics, generators and
+/// readers compile to plain arithmetic on four doubles.
 ///
 class FourMomentum {
 
 public:
-  FourMomentum(double px = 0, double py = 0, double pz = 0, double E = 0)
-      : P4(std::array<double, 4>{{px, py, pz, E}}) {}
+  constexpr FourMomentum(double px = 0, double py = 0, double pz = 0,
+                         double E = 0)
+      : P4{{px, py, pz, E}} {}
 
-  FourMomentum(std::array<double, 4> p4) : P4(p4) {}
+  constexpr FourMomentum(std::array<double, 4> p4) : P4(p4) {}
 
   FourMomentum(std::vector<double> p4) {
     if (p4.size() != 4)
       throw std::runtime_error(
           "FourMomentum::Fourmomentum() | Size of vector not equal 4!");
-    P4 = std::array<double, 4>{{p4.at(0), p4.at(1), p4.at(2), p4.at(3)}};
+    P4 = std::array<double, 4>{{p4[0], p4[1], p4[2], p4[3]}};
   }
 
-  double px() const { return P4.at(0); }
-  double py() const { return P4.at(1); }
-  double pz() const { return P4.at(2); }
-  double e() const { return P4.at(3); }
+  constexpr double px() const { return P4[0]; }
+  constexpr double py() const { return P4[1]; }
+  constexpr double pz() const { return P4[2]; }
+  constexpr double e() const { return P4[3]; }
 
-  FourMomentum operator+(const FourMomentum &pB) const {
-    FourMomentum newP(*this);
-    newP += pB;
-    return newP;
+  constexpr FourMomentum operator+(const FourMomentum &pB) const {
+    return FourMomentum(P4[0] + pB.P4[0], P4[1] + pB.P4[1], P4[2] + pB.P4[2],
+                        P4[3] + pB.P4[3]);
   }
 
   void operator+=(const FourMomentum &pB) {
-    std::transform(P4.begin(), P4.end(), pB.P4.begin(), P4.begin(),
-                   std::plus<double>());
+    P4[0] += pB.P4[0];
+    P4[1] += pB.P4[1];
+    P4[2] += pB.P4[2];
+    P4[3] += pB.P4[3];
   }
 
   operator std::vector<double>() {
@@ -73,36 +79,49 @@ public:
 
   friend std::ostream &operator<<(std::ostream &stream,
                                   const FourMomentum &p4) {
-    auto vec = p4.value();
-    stream << "(" << vec.at(0) << "," << vec.at(1) << "," << vec.at(2) << ","
-           << vec.at(3) << ")";
+    stream << "(" << p4.px() << "," << p4.py() << "," << p4.pz() << ","
+           << p4.e() << ")";
     return stream;
   }
 
   const std::array<double, 4> &value() const { return P4; }
 
-  double invMassSq() const { return invariantMass(*this); }
+  constexpr double invMassSq() const { return invariantMass(*this); }
 
   double invMass() const { return std::sqrt(invMassSq()); }
 
-  static double invariantMass(const FourMomentum &p4A,
-                              const FourMomentum &p4B) {
-    return invariantMass(p4A + p4B);
+  /// Invariant mass squared of the sum of \p p4A and \p p4B. The sum is not
+  /// stored.
+  static constexpr double invariantMass(const FourMomentum &p4A,
+                                        const FourMomentum &p4B) {
+    return invariantMassSq(p4A.P4[0] + p4B.P4[0], p4A.P4[1] + p4B.P4[1],
+                           p4A.P4[2] + p4B.P4[2], p4A.P4[3] + p4B.P4[3]);
   }
 
-  static double invariantMass(const FourMomentum &p4) {
-    auto vec = p4.value();
-    return ((-1) * (vec.at(0) * vec.at(0) + vec.at(1) * vec.at(1) +
-                    vec.at(2) * vec.at(2) - vec.at(3) * vec.at(3)));
+  /// Invariant mass squared of the sum of \p p4A, \p p4B and \p p4C.
+  static constexpr double invariantMass(const FourMomentum &p4A,
+                                        const FourMomentum &p4B,
+                                        const FourMomentum &p4C) {
+    return invariantMassSq(p4A.P4[0] + p4B.P4[0] + p4C.P4[0],
+                           p4A.P4[1] + p4B.P4[1] + p4C.P4[1],
+                           p4A.P4[2] + p4B.P4[2] + p4C.P4[2],
+                           p4A.P4[3] + p4B.P4[3] + p4C.P4[3]);
   }
 
-  static double threeMomentumSq(const FourMomentum &p4) {
-    auto vec = p4.value();
-    return (vec.at(0) * vec.at(0) + vec.at(1) * vec.at(1) +
-            vec.at(2) * vec.at(2));
+  static constexpr double invariantMass(const FourMomentum &p4) {
+    return invariantMassSq(p4.P4[0], p4.P4[1], p4.P4[2], p4.P4[3]);
+  }
+
+  static constexpr double threeMomentumSq(const FourMomentum &p4) {
+    return (p4.P4[0] * p4.P4[0] + p4.P4[1] * p4.P4[1] + p4.P4[2] * p4.P4[2]);
   }
 
 private:
+  static constexpr double invariantMassSq(double px, double py, double pz,
+                                          double E) {
+    return ((-1) * (px * px + py * py + pz * pz - E * E));
+  }
+
   std::array<double, 4> P4;
 };
 
@@ -114,16 +133,16 @@ private:
 ///
 class Particle {
 public:
-  Particle(double inPx = 0, double inPy = 0, double inPz = 0, double inE = 0,
-           int inpid = 0);
-
-  Particle(std::array<double, 4> p4, int inpid = 0) : P4(p4), Pid(inpid){};
+  constexpr Particle(double inPx = 0, double inPy = 0, double inPz = 0,
+                     double inE = 0, int inpid = 0)
+      : P4(inPx, inPy, inPz, inE), Pid(inpid) {}
 
-  virtual ~Particle(){};
+  constexpr Particle(std::array<double, 4> p4, int inpid = 0)
+      : P4(p4), Pid(inpid) {}
 
-  virtual int pid() const { return Pid; }
+  constexpr int pid() const { return Pid; }
 
-  virtual const FourMomentum &fourMomentum() const { return P4; }
+  constexpr const FourMomentum &fourMomentum() const { return P4; }
 
   friend std::ostream &operator<<(std::ostream &stream, const Particle &p) {
     stream << "Particle id=" << p.pid() << " p4=" << p.fourMomentum();
@@ -136,9 +155,9 @@ public:
   }
 
   /// Get invariant mass
-  virtual double mass() const { return std::sqrt(massSq()); }
+  double mass() const { return std::sqrt(massSq()); }
 
-  virtual double massSq() const { return FourMomentum::invariantMass(P4); }
+  constexpr double massSq() const { return FourMomentum::invariantMass(P4); }
 
   /// Invariant mass of \p inPa and \p inPb.
   static double invariantMass(const Particle &inPa, const Particle &inPb);
@@ -148,5 +167,9 @@ private:
   int Pid;
 };
 
+static_assert(std::is_trivially_copyable<FourMomentum>::value &&
+                  std::is_trivially_copyable<Particle>::value,
+              "FourMomentum and Particle are copied as plain memory");
+
 } // namespace ComPWA
 #endif
@@ -0,0 +1,299 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Branch-free implementations of transcendental functions.
+///
+/// The functions in this file are drop-in replacements for the libm functions
+/// that are used inside the per-event loops of the FunctionTree strategies and
+/// dynamical functions. In contrast to libm they are inline, contain no
+/// function calls, no branches and do not set errno. Therefore the compiler is
+/// able to auto-vectorise loops over data columns which call them (e.g.
+/// std::transform with a lambda). This requires -fno-math-errno and
+/// -fno-trapping-math (VECTOR_MATH_COMPILE_OPTIONS in the top-level
+/// CMakeLists.txt), since otherwise the selects are not converted into blend
+/// instructions.
+///
+/// The polynomial and rational approximations are taken from the Cephes Math
+/// Library (S. L. Moshier). Special values are handled via selects. The
+/// maximum deviation from a correctly rounded result, measured in units in the
+/// last place (ULP) over the given input range, is:
+///
+/// | function | range                 | max. error            |
+/// |----------|-----------------------|-----------------------|
+/// | exp      | [-708, 709]           | 2 ULP                 |
+/// | log      | (0, DBL_MAX]          | 1 ULP                 |
+/// | atan     | full                  | 1 ULP                 |
+/// | atan2    | full                  | 2 ULP                 |
+/// | acos     | [-1, 1]               | 2 ULP                 |
+/// | sin, cos | [-2^20, 2^20]         | 2 ULP (*)             |
+/// | sqrt     | full                  | 0 ULP                 |
+/// | pow(x,n) | integer n             | abs(n) + 1 ULP        |
+///
+/// (*) Close to the roots of sin and cos the relative error grows, because
+/// the argument reduction has a finite absolute precision of about 1e-31.
+///
+/// The bounds are checked against libm by the unit test
+/// Core/test/VectorMathTest.cpp.
+///
+
+#ifndef COMPWA_VECTORMATH_HPP_
+#define COMPWA_VECTORMATH_HPP_
+
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+
+namespace ComPWA {
+namespace VectorMath {
+
+namespace Detail {
+
+inline std::uint64_t asBits(double x) {
+  std::uint64_t i;
+  std::memcpy(&i, &x, sizeof(double));
+  return i;
+}
+
+inline double asDouble(std::uint64_t i) {
+  double x;
+  std::memcpy(&x, &i, sizeof(double));
+  return x;
+}
+
+/// Round \p x to the nearest integer for abs(x) < 2^51. Unlike std::round
+/// or std::floor this needs no SSE4.1 instructions to be vectorised.
+inline double roundInt(double x) {
+  const double shift = 6755399441055744.0; // 2^52 + 2^51
+  return (x + shift) - shift;
+}
+
+/// Largest integer not greater than \p x for abs(x) < 2^51.
+inline double floorInt(double x) {
+  double r = roundInt(x);
+  return r > x ? r - 1.0 : r;
+}
+
+/// 2^n for integral valued \p n in [-1022, 1023]. The integer is extracted
+/// via the 2^52 + 2^51 shift trick, which avoids a (non-vectorisable)
+/// double->int64 conversion.
+inline double exp2i(double n) {
+  const double shift = 6755399441055744.0; // 2^52 + 2^51
+  std::uint64_t bits = asBits(n + shift) + 1023;
+  return asDouble(bits << 52);
+}
+
+template <unsigned int N> struct Polynomial {
+  static double eval(double x, const double *c) {
+    return Polynomial<N - 1>::eval(x, c) * x + c[N];
+  }
+};
+template <> struct Polynomial<0> {
+  static double eval(double, const double *c) { return c[0]; }
+};
+
+/// Evaluate polynomial c[0]*x^N + ... + c[N] (Horner scheme).
+template <unsigned int N> inline double polevl(double x, const double *c) {
+  return Polynomial<N>::eval(x, c);
+}
+
+} // namespace Detail
+
+/// Square root. Forwards to std::sqrt, which maps to a single hardware
+/// instruction.
+inline double sqrt(double x) { return std::sqrt(x); }
+
+/// Exponential function.
+inline double exp(double x) {
+  static const double P[] = {1.26177193074810590878E-4,
+                             3.02994407707441961300E-2,
+                             9.99999999999999999910E-1};
+  static const double Q[] = {3.00198505138664455042E-6,
+                             2.52448340349684104192E-3,
+                             2.27265548208155028766E-1,
+                             2.00000000000000000009E0};
+  const double C1 = 6.93145751953125E-1;
+  const double C2 = 1.42860682030941723212E-6;
+  const double MaxArg = 7.09782712893383996843E2;
+  const double MinArg = -7.45133219101941108420E2;
+
+  double xc = x < MinArg ? MinArg : (x > MaxArg ? MaxArg : x);
+  // x = n*ln(2) + r, |r| <= ln(2)/2
+  double n = Detail::roundInt(M_LOG2E * xc);
+  double r = xc - n * C1;
+  r -= n * C2;
+  double rr = r * r;
+  double px = r * Detail::polevl<2>(rr, P);
+  double e = 1.0 + 2.0 * px / (Detail::polevl<3>(rr, Q) - px);
+  // split the scaling in two steps to reach the subnormal range
+  double n1 = Detail::floorInt(0.5 * n);
+  double res = e * Detail::exp2i(n1) * Detail::exp2i(n - n1);
+
+  res = x > MaxArg ? std::numeric_limits<double>::infinity() : res;
+  res = x < MinArg ? 0.0 : res;
+  return x != x ? x : res;
+}
+
+/// Natural logarithm.
+inline double log(double x) {
+  static const double P[] = {
+      1.01875663804580931796E-4, 4.97494994976747001425E-1,
+      4.70579119878881725854E0,  1.44989225341610930846E1,
+      1.79368678507819816313E1,  7.70838733755885391666E0};
+  static const double Q[] = {1.0,
+                             1.12873587189167450590E1,
+                             4.52279145837532221105E1,
+                             8.29875266912776603211E1,
+                             7.11544750618563894466E1,
+                             2.31251620126765340583E1};
+  const double C1 = 0.693359375;
+  const double C2 = -2.121944400546905827679E-4;
+
+  // scale subnormal numbers into the normal range
+  bool subnormal = x < std::numeric_limits<double>::min();
+  double xs = subnormal ? x * 18014398509481984.0 : x; // 2^54
+
+  // decompose xs = m * 2^e with m in [0.5, 1)
+  std::uint64_t bits = Detail::asBits(xs);
+  double e = Detail::asDouble((bits >> 52) | 0x4330000000000000ULL) -
+             4503599627370496.0 - 1022.0;
+  e = subnormal ? e - 54.0 : e;
+  double m = Detail::asDouble((bits & 0x800fffffffffffffULL) |
+                              0x3fe0000000000000ULL);
+
+  bool small = m < M_SQRT1_2;
+  e = small ? e - 1.0 : e;
+  double f = small ? (m + m) - 1.0 : m - 1.0;
+
+  double z = f * f;
+  double y = f * (z * Detail::polevl<5>(f, P) / Detail::polevl<5>(f, Q));
+  y += e * C2;
+  y -= 0.5 * z;
+  double res = f + y + e * C1;
+
+  res = x == std::numeric_limits<double>::infinity() ? x : res;
+  res = x == 0.0 ? -std::numeric_limits<double>::infinity() : res;
+  res = (x < 0.0 || x != x) ? std::numeric_limits<double>::quiet_NaN() : res;
+  return res;
+}
+
+/// Inverse tangent.
+inline double atan(double x) {
+  static const double P[] = {
+      -8.750608600031904122785E-1, -1.615753718733365076637E1,
+      -7.500855792314704667340E1,  -1.228866684490136173410E2,
+      -6.485021904942025371773E1};
+  static const double Q[] = {1.0,
+                             2.485846490142306297962E1,
+                             1.650270098316988542046E2,
+                             4.328810604912902668951E2,
+                             4.853903996359136964868E2,
+                             1.945506571482613964425E2};
+  const double MoreBits = 6.123233995736765886130E-17;
+  const double T3P8 = 2.41421356237309504880; // tan(3 pi / 8)
+
+  double a = std::fabs(x);
+  bool large = a > T3P8;
+  bool medium = !large && a > 0.66;
+
+  double y0 = large ? M_PI_2 : (medium ? M_PI_4 : 0.0);
+  double xr = large ? -1.0 / a : (medium ? (a - 1.0) / (a + 1.0) : a);
+  double corr = large ? MoreBits : (medium ? 0.5 * MoreBits : 0.0);
+
+  double z = xr * xr;
+  z = z * Detail::polevl<4>(z, P) / Detail::polevl<5>(z, Q);
+  double res = y0 + ((xr * z + xr) + corr);
+  return std::copysign(res, x);
+}
+
+/// Inverse tangent of \p y / \p x in the quadrant of (\p x, \p y), like
+/// std::atan2 including signed zeros and infinite arguments.
+inline double atan2(double y, double x) {
+  double ax = std::fabs(x);
+  double ay = std::fabs(y);
+  // the ratio of the smaller to the larger magnitude lies in [0, 1]
+  bool swap = ay > ax;
+  double num = swap ? ax : ay;
+  double den = swap ? ay : ax;
+  double t = den == 0.0 ? 0.0 : (num == den ? 1.0 : num / den);
+  double res = VectorMath::atan(t);
+  res = swap ? M_PI_2 - res : res;
+  res = std::signbit(x) ? M_PI - res : res;
+  return std::copysign(res, y);
+}
+
+/// Inverse cosine, calculated as atan2(sqrt(1 - x^2), x). The factorization
+/// (1 - x)(1 + x) keeps the precision close to abs(\p x) = 1.
+inline double acos(double x) {
+  return VectorMath::atan2(std::sqrt((1.0 - x) * (1.0 + x)), x);
+}
+
+/// Simultaneous calculation of sine and cosine of \p x.
+inline void sincos(double x, double &s, double &c) {
+  static const double SinCoef[] = {
+      1.58962301576546568060E-10, -2.50507477628578072866E-8,
+      2.75573136213857245213E-6,  -1.98412698295895385996E-4,
+      8.33333333332211858878E-3,  -1.66666666666666307295E-1};
+  static const double CosCoef[] = {
+      -1.13585365213876817300E-11, 2.08757008419747316778E-9,
+      -2.75573141792967388112E-7,  2.48015872888517045348E-5,
+      -1.38888888888730564116E-3,  4.16666666666665929218E-2};
+  const double DP1 = 7.85398125648498535156E-1;
+  const double DP2 = 3.77489470793079817668E-8;
+  const double DP3 = 2.69515142907905952645E-15;
+
+  double a = std::fabs(x);
+  // octant j = floor(a / (pi/4)), rounded up to the next even number
+  double y = Detail::floorInt(a * (4.0 / M_PI));
+  double odd = y - 2.0 * Detail::floorInt(0.5 * y);
+  y += odd;
+  double j = y - 8.0 * Detail::floorInt(0.125 * y);
+
+  double z = ((a - y * DP1) - y * DP2) - y * DP3;
+  double zz = z * z;
+  double ps = z + z * zz * Detail::polevl<5>(zz, SinCoef);
+  double pc = 1.0 - 0.5 * zz + zz * zz * Detail::polevl<5>(zz, CosCoef);
+
+  bool swap = (j == 2.0 || j == 6.0);
+  double sinSign = (j >= 4.0) ? -1.0 : 1.0;
+  double cosSign = (j == 2.0 || j == 4.0) ? -1.0 : 1.0;
+
+  s = std::copysign(1.0, x) * sinSign * (swap ? pc : ps);
+  c = cosSign * (swap ? ps : pc);
+}
+
+inline double sin(double x) {
+  double s, c;
+  sincos(x, s, c);
+  return s;
+}
+
+inline double cos(double x) {
+  double s, c;
+  sincos(x, s, c);
+  return c;
+}
+
+/// Integer power \p x^\p n via binary exponentiation. Since \p n is usually
+/// loop-invariant the number of multiplications is the same for all elements.
+inline double pow(double x, int n) {
+  // 0u - n instead of -n, which is undefined for INT_MIN
+  unsigned int k = n < 0 ? 0u - static_cast<unsigned int>(n) : n;
+  double res = 1.0;
+  double base = x;
+  while (k) {
+    if (k & 1u)
+      res *= base;
+    base *= base;
+    k >>= 1;
+  }
+  return n < 0 ? 1.0 / res : res;
+}
+
+} // namespace VectorMath
+} // namespace ComPWA
+
+#endif
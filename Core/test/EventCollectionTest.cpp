@@ -0,0 +1,58 @@
+#define BOOST_TEST_MODULE Core
+
+#include <vector>
+
+#include <Core/EventCollection.hpp>
+#include <Core/Exceptions.hpp>
+#include <boost/test/unit_test.hpp>
+
+namespace ComPWA {
+
+BOOST_AUTO_TEST_SUITE(EventCollectionTest);
+
+BOOST_AUTO_TEST_CASE(ConversionRoundTrip) {
+  std::vector<Event> Events;
+  for (int i = 0; i < 10; ++i) {
+    Event Evt;
+    Evt.ParticleList.push_back(Particle(0.1 * i, 0.2, 0.3, 1.0 + i, 211));
+    Evt.ParticleList.push_back(Particle(-0.1 * i, -0.2, -0.3, 2.0 + i, -211));
+    Evt.ParticleList.push_back(Particle(0.0, 0.0, 0.5 * i, 3.0, 111));
+    Evt.Weight = 0.5 + i;
+    Events.push_back(Evt);
+  }
+
+  EventCollection Collection = toEventCollection(Events);
+  BOOST_CHECK_EQUAL(Collection.size(), 10);
+  BOOST_CHECK_EQUAL(Collection.numberOfParticles(), 3);
+  BOOST_CHECK_EQUAL(Collection.Pids[1], -211);
+  BOOST_CHECK_EQUAL(Collection.FourMomenta[2].Pz[4], 2.0);
+  BOOST_CHECK_EQUAL(getMaximumSampleWeight(Collection), 9.5);
+
+  auto Restored = toEvents(Collection);
+  BOOST_CHECK_EQUAL(Restored.size(), Events.size());
+  for (std::size_t i = 0; i < Events.size(); ++i) {
+    BOOST_CHECK_EQUAL(Restored[i].Weight, Events[i].Weight);
+    for (std::size_t j = 0; j < 3; ++j) {
+      BOOST_CHECK_EQUAL(Restored[i].ParticleList[j].fourMomentum(),
+                        Events[i].ParticleList[j].fourMomentum());
+      BOOST_CHECK_EQUAL(Restored[i].ParticleList[j].pid(),
+                        Events[i].ParticleList[j].pid());
+    }
+  }
+}
+
+BOOST_AUTO_TEST_CASE(AppendWrongParticleNumber) {
+  auto Collection = createEventCollection({211, -211});
+  Event Evt;
+  Evt.ParticleList.push_back(Particle(0.0, 0.0, 0.0, 1.0, 211));
+  BOOST_CHECK_THROW(append(Collection, Evt), BadParameter);
+
+  resize(Collection, 5);
+  BOOST_CHECK_EQUAL(Collection.size(), 5);
+  BOOST_CHECK_EQUAL(Collection.FourMomenta[1].E.size(), 5);
+  BOOST_CHECK_EQUAL(Collection.Weights[4], 1.0);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+} /* namespace ComPWA */
@@ -27,11 +27,26 @@ BOOST_AUTO_TEST_CASE(FourMomentum) {
   pSum += p4;
   pSum += p4B;
   BOOST_CHECK_EQUAL(pSum.invMassSq(), 8.0);
+
+  // the fused sums give the same result as the explicit sums
+  ComPWA::FourMomentum p4C(0.1, -0.2, 0.3, 1.7);
+  BOOST_CHECK_EQUAL(ComPWA::FourMomentum::invariantMass(p4, p4C),
+                    (p4 + p4C).invMassSq());
+  BOOST_CHECK_EQUAL(ComPWA::FourMomentum::invariantMass(p4, p4B, p4C),
+                    (p4 + p4B + p4C).invMassSq());
+
+  constexpr ComPWA::FourMomentum p4Const(1, 2, 3, 4);
+  static_assert(p4Const.invMassSq() == 2.0, "");
+  static_assert((p4Const + p4Const).e() == 8.0, "");
 }
 
 BOOST_AUTO_TEST_CASE(Particle) {
   ComPWA::Particle part(1, 2, 3, 4);
   BOOST_CHECK_EQUAL(part.massSq(), 2.0);
+
+  constexpr ComPWA::Particle partConst(1, 2, 3, 4, 211);
+  static_assert(partConst.pid() == 211, "");
+  static_assert(partConst.fourMomentum().px() == 1.0, "");
 }
 
 BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,188 @@
+#define BOOST_TEST_MODULE Core
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <limits>
+#include <random>
+#include <vector>
+
+#include <Core/VectorMath.hpp>
+#include <boost/test/unit_test.hpp>
+
+namespace ComPWA {
+
+BOOST_AUTO_TEST_SUITE(VectorMathTest);
+
+/// Distance of \p a and \p b in units in the last place.
+std::int64_t ulpDistance(double a, double b) {
+  if (a == b)
+    return 0;
+  std::int64_t ia, ib;
+  std::memcpy(&ia, &a, sizeof(double));
+  std::memcpy(&ib, &b, sizeof(double));
+  // map the sign-magnitude representation to a monotonic integer scale
+  if (ia < 0)
+    ia = std::numeric_limits<std::int64_t>::min() - ia;
+  if (ib < 0)
+    ib = std::numeric_limits<std::int64_t>::min() - ib;
+  return std::abs(ia - ib);
+}
+
+/// Compare \p f against the libm long double reference \p ref at a grid of
+/// equidistant points and at random points in [\p min, \p max]. Returns the
+/// maximum deviation in ULP. Points with an absolute deviation below
+/// \p absTolerance are ignored.
+std::int64_t maxUlpError(std::function<double(double)> f,
+                         std::function<long double(long double)> ref,
+                         double min, double max, double absTolerance = 0.0) {
+  std::vector<double> Points;
+  const int NGrid = 100000;
+  for (int i = 0; i <= NGrid; ++i)
+    Points.push_back(min + (max - min) * i / NGrid);
+  std::mt19937 Engine(123);
+  std::uniform_real_distribution<double> Dist(min, max);
+  for (int i = 0; i < NGrid; ++i)
+    Points.push_back(Dist(Engine));
+
+  std::int64_t MaxUlp(0);
+  for (auto x : Points) {
+    double Expected = static_cast<double>(ref(static_cast<long double>(x)));
+    if (std::abs(f(x) - Expected) < absTolerance)
+      continue;
+    auto Ulp = ulpDistance(f(x), Expected);
+    if (Ulp > MaxUlp) {
+      MaxUlp = Ulp;
+      BOOST_TEST_MESSAGE("x=" << x << " deviation=" << Ulp << " ULP");
+    }
+  }
+  return MaxUlp;
+}
+
+BOOST_AUTO_TEST_CASE(Exp) {
+  auto f = [](double x) { return VectorMath::exp(x); };
+  auto ref = [](long double x) { return std::exp(x); };
+  BOOST_CHECK_LE(maxUlpError(f, ref, -1.0, 1.0), 2);
+  BOOST_CHECK_LE(maxUlpError(f, ref, -50.0, 50.0), 2);
+  BOOST_CHECK_LE(maxUlpError(f, ref, -708.0, 709.0), 2);
+
+  BOOST_CHECK_EQUAL(VectorMath::exp(0.0), 1.0);
+  BOOST_CHECK_EQUAL(VectorMath::exp(800.0),
+                    std::numeric_limits<double>::infinity());
+  BOOST_CHECK_EQUAL(VectorMath::exp(-800.0), 0.0);
+  BOOST_CHECK(std::isnan(VectorMath::exp(std::nan(""))));
+}
+
+BOOST_AUTO_TEST_CASE(Log) {
+  auto f = [](double x) { return VectorMath::log(x); };
+  auto ref = [](long double x) { return std::log(x); };
+  BOOST_CHECK_LE(maxUlpError(f, ref, 1e-8, 2.0), 1);
+  BOOST_CHECK_LE(maxUlpError(f, ref, 0.5, 1.5), 1);
+  BOOST_CHECK_LE(maxUlpError(f, ref, 1.0, 1e6), 1);
+  BOOST_CHECK_LE(maxUlpError(f, ref, 1e-310, 1e-300), 1);
+
+  BOOST_CHECK_EQUAL(VectorMath::log(1.0), 0.0);
+  BOOST_CHECK_EQUAL(VectorMath::log(0.0),
+                    -std::numeric_limits<double>::infinity());
+  BOOST_CHECK_EQUAL(VectorMath::log(std::numeric_limits<double>::infinity()),
+                    std::numeric_limits<double>::infinity());
+  BOOST_CHECK(std::isnan(VectorMath::log(-1.0)));
+}
+
+BOOST_AUTO_TEST_CASE(Atan) {
+  auto f = [](double x) { return VectorMath::atan(x); };
+  auto ref = [](long double x) { return std::atan(x); };
+  BOOST_CHECK_LE(maxUlpError(f, ref, -3.0, 3.0), 1);
+  BOOST_CHECK_LE(maxUlpError(f, ref, -1e4, 1e4), 1);
+  BOOST_CHECK_LE(maxUlpError(f, ref, 1e-10, 1e-5), 1);
+
+  BOOST_CHECK_EQUAL(VectorMath::atan(0.0), 0.0);
+  BOOST_CHECK_CLOSE(VectorMath::atan(std::numeric_limits<double>::infinity()),
+                    M_PI_2, 1e-14);
+}
+
+BOOST_AUTO_TEST_CASE(Atan2) {
+  // directions on circles of different radii, including the axes
+  std::int64_t MaxUlp(0);
+  for (double Radius : {1e-300, 1e-5, 1.0, 1e5, 1e300}) {
+    for (int i = -100000; i <= 100000; ++i) {
+      double y = Radius * std::sin(M_PI * i / 100000);
+      double x = Radius * std::cos(M_PI * i / 100000);
+      double Expected = static_cast<double>(
+          std::atan2(static_cast<long double>(y), static_cast<long double>(x)));
+      MaxUlp = std::max(MaxUlp, ulpDistance(VectorMath::atan2(y, x), Expected));
+    }
+  }
+  BOOST_CHECK_LE(MaxUlp, 2);
+
+  const double Inf = std::numeric_limits<double>::infinity();
+  for (double y : {0.0, -0.0, 1.0, -1.0, Inf, -Inf}) {
+    for (double x : {0.0, -0.0, 1.0, -1.0, Inf, -Inf}) {
+      BOOST_CHECK_EQUAL(VectorMath::atan2(y, x), std::atan2(y, x));
+      BOOST_CHECK_EQUAL(std::signbit(VectorMath::atan2(y, x)),
+                        std::signbit(std::atan2(y, x)));
+    }
+  }
+  BOOST_CHECK(std::isnan(VectorMath::atan2(std::nan(""), 1.0)));
+  BOOST_CHECK(std::isnan(VectorMath::atan2(0.0, std::nan(""))));
+}
+
+BOOST_AUTO_TEST_CASE(Acos) {
+  auto f = [](double x) { return VectorMath::acos(x); };
+  auto ref = [](long double x) { return std::acos(x); };
+  BOOST_CHECK_LE(maxUlpError(f, ref, -1.0, 1.0), 2);
+  BOOST_CHECK_LE(maxUlpError(f, ref, 0.999999, 1.0), 2);
+  BOOST_CHECK_LE(maxUlpError(f, ref, -1.0, -0.999999), 2);
+
+  BOOST_CHECK_EQUAL(VectorMath::acos(1.0), 0.0);
+  BOOST_CHECK_EQUAL(VectorMath::acos(-1.0), M_PI);
+  BOOST_CHECK(std::isnan(VectorMath::acos(1.5)));
+}
+
+BOOST_AUTO_TEST_CASE(SinCos) {
+  auto fs = [](double x) { return VectorMath::sin(x); };
+  auto fc = [](double x) { return VectorMath::cos(x); };
+  auto refs = [](long double x) { return std::sin(x); };
+  auto refc = [](long double x) { return std::cos(x); };
+  // close to the roots the argument reduction limits the absolute precision
+  double AbsTolerance(1e-30);
+  // helicity angles
+  BOOST_CHECK_LE(maxUlpError(fs, refs, -M_PI, M_PI, AbsTolerance), 2);
+  BOOST_CHECK_LE(maxUlpError(fc, refc, -M_PI, M_PI, AbsTolerance), 2);
+  // phases of the WignerD functions
+  BOOST_CHECK_LE(maxUlpError(fs, refs, -20.0, 20.0, AbsTolerance), 2);
+  BOOST_CHECK_LE(maxUlpError(fc, refc, -20.0, 20.0, AbsTolerance), 2);
+  BOOST_CHECK_LE(maxUlpError(fs, refs, -1e6, 1e6, AbsTolerance), 2);
+
+  double s, c;
+  VectorMath::sincos(0.3, s, c);
+  BOOST_CHECK_EQUAL(s, VectorMath::sin(0.3));
+  BOOST_CHECK_EQUAL(c, VectorMath::cos(0.3));
+}
+
+BOOST_AUTO_TEST_CASE(Pow) {
+  for (int n = -16; n <= 16; ++n) {
+    auto f = [n](double x) { return VectorMath::pow(x, n); };
+    auto ref = [n](long double x) { return std::pow(x, n); };
+    BOOST_CHECK_LE(maxUlpError(f, ref, 0.1, 3.0), std::abs(n) + 1);
+  }
+  // the exponent is negated without overflow
+  BOOST_CHECK_EQUAL(VectorMath::pow(2.0, std::numeric_limits<int>::min()),
+                    0.0);
+  BOOST_CHECK_EQUAL(VectorMath::pow(1.0, std::numeric_limits<int>::min()),
+                    1.0);
+}
+
+BOOST_AUTO_TEST_CASE(Sqrt) {
+  // compare to the double precision version, because the long double result
+  // can be affected by double rounding
+  auto f = [](double x) { return VectorMath::sqrt(x); };
+  auto ref = [](long double x) { return std::sqrt(static_cast<double>(x)); };
+  BOOST_CHECK_EQUAL(maxUlpError(f, ref, 0.0, 100.0), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+} /* namespace ComPWA */
@@ -2,50 +2,282 @@
 // This file is part of the ComPWA framework, check
 // https://github.com/ComPWA/ComPWA/license.txt for details.
 
-#include <fstream>
-#include <sstream>
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <numeric>
 #include <utility>
 
 #include "AsciiReader.hpp"
 #include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+#include "Data/Binary/BinaryDataIO.hpp"
+
+#include "ThirdParty/parallelstl/include/pstl/algorithm"
+#include "ThirdParty/parallelstl/include/pstl/execution"
 
 namespace ComPWA {
 namespace Data {
 
+namespace {
+
+/// The file is split into chunks of about this size. The chunks end at line
+/// boundaries and are parsed in parallel.
+const std::size_t ChunkSize = 4 * 1024 * 1024;
+
+/// Events are converted from the columns in blocks of this size.
+const std::size_t EventBlockSize = 1024;
+
+/// Part of the file that is parsed by a single task. FirstNumber is the
+/// index of the first number of the chunk within the whole file.
+struct Chunk {
+  const char *Begin;
+  const char *End;
+  std::size_t FirstNumber;
+  std::size_t NumberOfNumbers;
+};
+
+std::vector<Chunk> splitIntoChunks(const char *Begin, const char *End) {
+  std::vector<Chunk> Chunks;
+  while (Begin != End) {
+    const char *ChunkEnd =
+        std::size_t(End - Begin) > ChunkSize ? Begin + ChunkSize : End;
+    ChunkEnd = std::find(ChunkEnd, End, '\n');
+    if (ChunkEnd != End)
+      ++ChunkEnd;
+    Chunks.push_back(Chunk{Begin, ChunkEnd, 0, 0});
+    Begin = ChunkEnd;
+  }
+  return Chunks;
+}
+
+inline bool isSpace(char c) {
+  return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' ||
+         c == '\f';
+}
+
+/// Call \p processToken(TokenBegin, TokenEnd) for each whitespace separated
+/// token in [\p Begin, \p End). Lines whose first non-whitespace character is
+/// a '#' are comments and are skipped. \p Begin has to be the beginning of a
+/// line.
+template <typename TokenFunction>
+void forEachToken(const char *Begin, const char *End,
+                  const TokenFunction &processToken) {
+  bool IsLineStart(true);
+  const char *p = Begin;
+  while (p != End) {
+    if (*p == '\n') {
+      IsLineStart = true;
+      ++p;
+    } else if (isSpace(*p)) {
+      ++p;
+    } else if (IsLineStart && *p == '#') {
+      p = std::find(p, End, '\n');
+    } else {
+      IsLineStart = false;
+      const char *TokenEnd = p;
+      while (TokenEnd != End && !isSpace(*TokenEnd))
+        ++TokenEnd;
+      processToken(p, TokenEnd);
+      p = TokenEnd;
+    }
+  }
+}
+
+/// Parse the number [\p Begin, \p End) with strtod(). The token is copied,
+/// because the mapped file is not null terminated.
+bool parseNumberWithStrtod(const char *Begin, const char *End,
+                           double &Value) {
+  char Buffer[128];
+  std::size_t Length = End - Begin;
+  if (Length >= sizeof(Buffer))
+    return false;
+  std::memcpy(Buffer, Begin, Length);
+  Buffer[Length] = '\0';
+  char *ParsedEnd;
+  Value = std::strtod(Buffer, &ParsedEnd);
+  return ParsedEnd == Buffer + Length;
+}
+
+/// Parse the decimal number [\p Begin, \p End). Numbers with at most 19
+/// significant digits whose mantissa and power of ten are exactly
+/// representable as double are converted with a single multiplication or
+/// division, which is correctly rounded. All other numbers (and special
+/// values like nan) are passed on to strtod().
+bool parseNumber(const char *Begin, const char *End, double &Value) {
+  static const double PowersOfTen[] = {
+      1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+      1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22};
+  const char *p = Begin;
+  bool IsNegative(false);
+  if (p != End && (*p == '-' || *p == '+')) {
+    IsNegative = *p == '-';
+    ++p;
+  }
+  std::uint64_t Mantissa(0);
+  int Digits(0), Exponent(0);
+  bool HasDigits(false);
+  for (; p != End && *p >= '0' && *p <= '9'; ++p) {
+    if (Digits == 19)
+      return parseNumberWithStrtod(Begin, End, Value);
+    Mantissa = 10 * Mantissa + (*p - '0');
+    Digits += Mantissa != 0;
+    HasDigits = true;
+  }
+  if (p != End && *p == '.') {
+    for (++p; p != End && *p >= '0' && *p <= '9'; ++p) {
+      if (Digits == 19)
+        return parseNumberWithStrtod(Begin, End, Value);
+      Mantissa = 10 * Mantissa + (*p - '0');
+      Digits += Mantissa != 0;
+      --Exponent;
+      HasDigits = true;
+    }
+  }
+  if (HasDigits && p != End && (*p == 'e' || *p == 'E')) {
+    ++p;
+    bool IsExponentNegative(false);
+    if (p != End && (*p == '-' || *p == '+')) {
+      IsExponentNegative = *p == '-';
+      ++p;
+    }
+    if (p == End || *p < '0' || *p > '9')
+      return false;
+    int ExplicitExponent(0);
+    for (; p != End && *p >= '0' && *p <= '9' && ExplicitExponent < 10000;
+         ++p)
+      ExplicitExponent = 10 * ExplicitExponent + (*p - '0');
+    Exponent += IsExponentNegative ? -ExplicitExponent : ExplicitExponent;
+  }
+  if (!HasDigits || p != End || Mantissa > (std::uint64_t(1) << 53) ||
+      Exponent < -22 || Exponent > 22)
+    return parseNumberWithStrtod(Begin, End, Value);
+
+  Value = double(Mantissa);
+  if (Exponent < 0)
+    Value /= PowersOfTen[-Exponent];
+  else
+    Value *= PowersOfTen[Exponent];
+  if (IsNegative)
+    Value = -Value;
+  return true;
+}
+
+} // namespace
+
 // Constructors and destructors
-AsciiReader::AsciiReader(unsigned int NumberOfParticles_)
-    : NumberOfParticles(NumberOfParticles_) {}
+AsciiReader::AsciiReader(unsigned int NumberOfParticles_, bool HasWeights_)
+    : NumberOfParticles(NumberOfParticles_), HasWeights(HasWeights_) {
+  if (!NumberOfParticles)
+    throw ComPWA::BadParameter(
+        "AsciiReader::AsciiReader() | At least one particle is required!");
+}
 
 AsciiReader::~AsciiReader() {}
 
 std::shared_ptr<std::vector<ComPWA::Event>>
 AsciiReader::readData(const std::string &InputFilePath) const {
+  auto Collection = readEventCollection(InputFilePath);
+  auto Events =
+      std::make_shared<std::vector<ComPWA::Event>>(Collection.size());
 
-  std::ifstream currentStream;
-  currentStream.open(InputFilePath);
-
-  if (!currentStream)
-    throw ComPWA::BadConfig("Can not open " + InputFilePath);
+  std::vector<std::size_t> Blocks((Collection.size() + EventBlockSize - 1) /
+                                  EventBlockSize);
+  std::iota(Blocks.begin(), Blocks.end(), 0);
+  std::for_each(pstl::execution::par, Blocks.begin(), Blocks.end(),
+                [&](std::size_t Block) {
+                  std::size_t End = std::min((Block + 1) * EventBlockSize,
+                                             Collection.size());
+                  for (std::size_t i = Block * EventBlockSize; i < End; ++i)
+                    (*Events)[i] = ComPWA::getEvent(Collection, i);
+                });
+  return Events;
+}
 
-  std::vector<ComPWA::Event> Events;
+ComPWA::EventCollection
+AsciiReader::readEventCollection(const std::string &InputFilePath) const {
+  Binary::MappedFile File(InputFilePath);
+  const char *FileEnd = File.data() + File.size();
+  auto Chunks = splitIntoChunks(File.data(), FileEnd);
 
-  while (!currentStream.eof()) {
-    double e, px, py, pz;
-    ComPWA::Event newEvent;
+  // the numbers of each chunk are counted first, so that every chunk knows
+  // the events it contributes to
+  std::for_each(pstl::execution::par, Chunks.begin(), Chunks.end(),
+                [](Chunk &Part) {
+                  forEachToken(Part.Begin, Part.End,
+                               [&Part](const char *, const char *) {
+                                 ++Part.NumberOfNumbers;
+                               });
+                });
+  std::size_t NumberOfNumbers(0);
+  for (auto &Part : Chunks) {
+    Part.FirstNumber = NumberOfNumbers;
+    NumberOfNumbers += Part.NumberOfNumbers;
+  }
+  std::size_t NumbersPerEvent = 4 * NumberOfParticles + HasWeights;
+  std::size_t NumberOfEvents = NumberOfNumbers / NumbersPerEvent;
+  if (NumberOfNumbers % NumbersPerEvent)
+    LOG(WARNING) << "AsciiReader::readEventCollection() | " << InputFilePath
+                 << " ends with an incomplete event, which is skipped.";
 
-    for (unsigned int ipart = 0; ipart < NumberOfParticles; ++ipart) {
-      currentStream >> px >> py >> pz >> e;
-      newEvent.ParticleList.push_back(ComPWA::Particle(px, py, pz, e));
-    }
+  auto Events =
+      ComPWA::createEventCollection(std::vector<int>(NumberOfParticles, 0));
+  ComPWA::resize(Events, NumberOfEvents);
+  std::fill(Events.Weights.begin(), Events.Weights.end(), 1.0);
 
-    if (!currentStream.fail()) {
-      Events.push_back(newEvent);
-      // for ( parts = 0; parts < linesToSkip; parts++ )
-      //   currentStream >> px >> py >> pz >> e;
-    }
+  // each number is written to its column, errors are collected and thrown
+  // after the parallel region
+  std::vector<std::string> Errors(Chunks.size());
+  std::vector<std::size_t> ChunkIDs(Chunks.size());
+  std::iota(ChunkIDs.begin(), ChunkIDs.end(), 0);
+  std::for_each(
+      pstl::execution::par, ChunkIDs.begin(), ChunkIDs.end(),
+      [&](std::size_t ChunkID) {
+        const Chunk &Part(Chunks[ChunkID]);
+        std::size_t EventIndex = Part.FirstNumber / NumbersPerEvent;
+        std::size_t Position = Part.FirstNumber % NumbersPerEvent;
+        forEachToken(Part.Begin, Part.End, [&](const char *Begin,
+                                               const char *End) {
+          if (EventIndex >= NumberOfEvents || !Errors[ChunkID].empty())
+            return;
+          double Value;
+          if (!parseNumber(Begin, End, Value)) {
+            Errors[ChunkID] = "AsciiReader::readEventCollection() | " +
+                              InputFilePath + " contains the invalid number " +
+                              std::string(Begin, End) + "!";
+            return;
+          }
+          if (HasWeights && Position == 0) {
+            Events.Weights[EventIndex] = Value;
+          } else {
+            std::size_t Number = Position - HasWeights;
+            auto &Columns = Events.FourMomenta[Number / 4];
+            switch (Number % 4) {
+            case 0:
+              Columns.Px[EventIndex] = Value;
+              break;
+            case 1:
+              Columns.Py[EventIndex] = Value;
+              break;
+            case 2:
+              Columns.Pz[EventIndex] = Value;
+              break;
+            default:
+              Columns.E[EventIndex] = Value;
+            }
+          }
+          if (++Position == NumbersPerEvent) {
+            Position = 0;
+            ++EventIndex;
+          }
+        });
+      });
+  for (const auto &Error : Errors) {
+    if (!Error.empty())
+      throw ComPWA::CorruptFile(Error);
   }
-  currentStream.close();
-  return std::make_shared<std::vector<ComPWA::Event>>(Events);
+  return Events;
 }
 
 } // namespace Data
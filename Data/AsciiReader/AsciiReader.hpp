@@ -6,9 +6,11 @@
 #define COMPWA_DATA_ASCIIREADER_HPP_
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "Core/Event.hpp"
+#include "Core/EventCollection.hpp"
 
 namespace ComPWA {
 namespace Data {
@@ -18,16 +20,34 @@ namespace Data {
 /// Reader for data in ASCII-Format. This class reads event-based data from
 /// ascii-files in the same syntax.
 ///
+/// The file is a sequence of whitespace separated numbers. Each event
+/// consists of an optional weight followed by (px, py, pz, E) of each
+/// particle; the line breaks are arbitrary. Lines starting with '#' are
+/// comments. An incomplete event at the end of the file is skipped.
+///
+/// The file is memory mapped and split at line boundaries into chunks,
+/// which are parsed in parallel directly into the columns of an
+/// EventCollection.
+///
 class AsciiReader {
   unsigned int NumberOfParticles;
+  bool HasWeights;
 
 public:
   virtual ~AsciiReader();
 
-  AsciiReader(unsigned int NumberOfParticles_);
+  /// \param NumberOfParticles_ Number of particles per event, at least one.
+  /// \param HasWeights_ Each event starts with its weight. Otherwise all
+  /// events have the weight 1.
+  AsciiReader(unsigned int NumberOfParticles_, bool HasWeights_ = false);
 
   std::shared_ptr<std::vector<ComPWA::Event>>
   readData(const std::string &InputFilePath) const;
+
+  /// Read the events of \p InputFilePath directly into the columns of an
+  /// EventCollection.
+  ComPWA::EventCollection
+  readEventCollection(const std::string &InputFilePath) const;
 };
 
 } // namespace Data
@@ -0,0 +1,119 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#define BOOST_TEST_MODULE Data_AsciiReaderTest
+
+#include "Data/AsciiReader/AsciiReader.hpp"
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <random>
+#include <string>
+
+namespace ComPWA {
+namespace Data {
+
+BOOST_AUTO_TEST_SUITE(AsciiData);
+
+BOOST_AUTO_TEST_CASE(FormatCheck) {
+  ComPWA::Logging log("warning");
+
+  // two events with weights, comments and arbitrary line breaks
+  std::ofstream("AsciiReaderTest-format.txt")
+      << "# generated events\n"
+      << "0.5\n"
+      << "1 2 3 4\n"
+      << "  # indented comment\n"
+      << "-1.5e-3 +2.25E2 .5 7.\n"
+      << "2 0.1 -0.0 12345678901234567890 1e300\n"
+      << "-4.9406564584124654e-324 3.14159265358979323846 1e-30 4\n"
+      << "1 2\n";
+
+  AsciiReader Reader(2, true);
+  auto Events = Reader.readEventCollection("AsciiReaderTest-format.txt");
+  BOOST_REQUIRE_EQUAL(Events.size(), 2);
+  BOOST_CHECK_EQUAL(Events.Weights[0], 0.5);
+  BOOST_CHECK_EQUAL(Events.Weights[1], 2.0);
+  BOOST_CHECK_EQUAL(Events.FourMomenta[0].E[0], 4.0);
+  BOOST_CHECK_EQUAL(Events.FourMomenta[1].Px[0], -1.5e-3);
+  BOOST_CHECK_EQUAL(Events.FourMomenta[1].Py[0], 225.0);
+  BOOST_CHECK_EQUAL(Events.FourMomenta[1].Pz[0], 0.5);
+  BOOST_CHECK_EQUAL(Events.FourMomenta[1].E[0], 7.0);
+  BOOST_CHECK_EQUAL(Events.FourMomenta[0].Px[1], 0.1);
+  BOOST_CHECK_EQUAL(Events.FourMomenta[0].Pz[1], 12345678901234567890.0);
+  BOOST_CHECK_EQUAL(Events.FourMomenta[0].E[1], 1e300);
+  BOOST_CHECK_EQUAL(Events.FourMomenta[1].Px[1], -4.9406564584124654e-324);
+  BOOST_CHECK_EQUAL(Events.FourMomenta[1].Py[1], 3.14159265358979323846);
+  BOOST_CHECK_EQUAL(Events.FourMomenta[1].Pz[1], 1e-30);
+
+  auto EventList = Reader.readData("AsciiReaderTest-format.txt");
+  BOOST_REQUIRE_EQUAL(EventList->size(), 2);
+  BOOST_CHECK_EQUAL(EventList->at(1).Weight, 2.0);
+  BOOST_CHECK_EQUAL(EventList->at(1).ParticleList[1].fourMomentum().py(),
+                    3.14159265358979323846);
+
+  // without weights the 20 numbers of the same file are five events of a
+  // single particle
+  AsciiReader ReaderWithoutWeights(1);
+  auto Unweighted =
+      ReaderWithoutWeights.readEventCollection("AsciiReaderTest-format.txt");
+  BOOST_CHECK_EQUAL(Unweighted.size(), 5);
+  BOOST_CHECK_EQUAL(Unweighted.Weights[4], 1.0);
+
+  std::ofstream("AsciiReaderTest-format.txt") << "1 2 3 four\n";
+  BOOST_CHECK_THROW(
+      ReaderWithoutWeights.readEventCollection("AsciiReaderTest-format.txt"),
+      ComPWA::CorruptFile);
+
+  std::remove("AsciiReaderTest-format.txt");
+
+  BOOST_CHECK_THROW(AsciiReader(0), ComPWA::BadParameter);
+  BOOST_CHECK_THROW(AsciiReader(0, true), ComPWA::BadParameter);
+}
+
+BOOST_AUTO_TEST_CASE(LargeFileCheck) {
+  ComPWA::Logging log("warning");
+
+  // the file is large enough to be split into several chunks
+  std::mt19937 Generator(42);
+  std::uniform_real_distribution<double> Momentum(-2.0, 2.0);
+  std::vector<double> Numbers;
+  {
+    std::ofstream Stream("AsciiReaderTest-large.txt");
+    char Buffer[32];
+    for (int i = 0; i < 25000 * 12; ++i) {
+      std::snprintf(Buffer, sizeof(Buffer), "%.17g", Momentum(Generator));
+      Stream << Buffer << ((i % 4 == 3) ? "\n" : " ");
+      Numbers.push_back(std::strtod(Buffer, nullptr));
+    }
+  }
+
+  AsciiReader Reader(3);
+  auto Events = Reader.readEventCollection("AsciiReaderTest-large.txt");
+  BOOST_REQUIRE_EQUAL(Events.size(), 25000);
+  std::size_t Mismatches(0);
+  for (std::size_t i = 0; i < Events.size(); ++i) {
+    for (std::size_t part = 0; part < 3; ++part) {
+      const double *Expected = &Numbers[12 * i + 4 * part];
+      const auto &Columns = Events.FourMomenta[part];
+      Mismatches += Columns.Px[i] != Expected[0];
+      Mismatches += Columns.Py[i] != Expected[1];
+      Mismatches += Columns.Pz[i] != Expected[2];
+      Mismatches += Columns.E[i] != Expected[3];
+    }
+  }
+  BOOST_CHECK_EQUAL(Mismatches, 0);
+
+  std::remove("AsciiReaderTest-large.txt");
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+} // namespace Data
+} // namespace ComPWA
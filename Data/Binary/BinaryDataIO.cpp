@@ -0,0 +1,336 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "BinaryDataIO.hpp"
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+
+namespace ComPWA {
+namespace Data {
+namespace Binary {
+
+namespace {
+
+const char Magic[8] = {'C', 'o', 'm', 'P', 'W', 'A', '\0', '\0'};
+const std::uint32_t ByteOrderMark = 0x01020304;
+const std::uint32_t FormatVersion = 1;
+const std::size_t ColumnAlignment = 64;
+
+enum class ContentType : std::uint32_t { Events = 1, DataSet = 2 };
+
+struct FileHeader {
+  char Magic[8];
+  std::uint32_t ByteOrderMark;
+  std::uint32_t Version;
+  ContentType Content;
+  std::uint32_t NumberOfColumns;
+  std::uint64_t NumberOfEvents;
+  std::uint64_t ColumnOffset;
+};
+static_assert(sizeof(FileHeader) == 40, "FileHeader: unexpected padding!");
+
+std::uint64_t alignedOffset(std::uint64_t Offset) {
+  return (Offset + ColumnAlignment - 1) / ColumnAlignment * ColumnAlignment;
+}
+
+/// Write \p Header, the meta data and the padding up to the column block.
+void writeHead(std::ofstream &Stream, FileHeader Header,
+               const std::string &MetaData) {
+  std::memcpy(Header.Magic, Magic, sizeof(Magic));
+  Header.ByteOrderMark = ByteOrderMark;
+  Header.Version = FormatVersion;
+  Header.ColumnOffset = alignedOffset(sizeof(FileHeader) + MetaData.size());
+  Stream.write(reinterpret_cast<const char *>(&Header), sizeof(FileHeader));
+  Stream.write(MetaData.data(), MetaData.size());
+  std::string Padding(Header.ColumnOffset - sizeof(FileHeader) -
+                          MetaData.size(),
+                      '\0');
+  Stream.write(Padding.data(), Padding.size());
+}
+
+void writeColumn(std::ofstream &Stream, const std::vector<double> &Column) {
+  Stream.write(reinterpret_cast<const char *>(Column.data()),
+               Column.size() * sizeof(double));
+}
+
+std::ofstream openOutput(const std::string &OutputFilePath) {
+  std::ofstream Stream(OutputFilePath, std::ios::binary | std::ios::trunc);
+  if (!Stream)
+    throw ComPWA::BadConfig("Binary::openOutput() | Can not open " +
+                            OutputFilePath);
+  return Stream;
+}
+
+/// Check the header of \p File and return it. The meta data offset is
+/// checked against the file size.
+FileHeader readHeader(const MappedFile &File, ContentType Content,
+                      const std::string &FilePath) {
+  FileHeader Header;
+  if (File.size() < sizeof(FileHeader))
+    throw ComPWA::CorruptFile("Binary::readHeader() | " + FilePath +
+                              " is too small!");
+  std::memcpy(&Header, File.data(), sizeof(FileHeader));
+  if (std::memcmp(Header.Magic, Magic, sizeof(Magic)))
+    throw ComPWA::CorruptFile("Binary::readHeader() | " + FilePath +
+                              " is not a ComPWA binary file!");
+  if (Header.ByteOrderMark != ByteOrderMark)
+    throw ComPWA::CorruptFile("Binary::readHeader() | " + FilePath +
+                              " was written with a different byte order!");
+  if (Header.Version != FormatVersion)
+    throw ComPWA::CorruptFile(
+        "Binary::readHeader() | " + FilePath + " has format version " +
+        std::to_string(Header.Version) + ", but version " +
+        std::to_string(FormatVersion) + " is expected!");
+  if (Header.Content != Content)
+    throw ComPWA::CorruptFile("Binary::readHeader() | " + FilePath +
+                              " contains the wrong content type!");
+  if (Header.ColumnOffset % ColumnAlignment ||
+      Header.ColumnOffset > File.size())
+    throw ComPWA::CorruptFile("Binary::readHeader() | " + FilePath +
+                              " is truncated!");
+  return Header;
+}
+
+/// Check that \p File contains \p NumberOfStoredColumns columns.
+void checkColumnBlock(const MappedFile &File, const FileHeader &Header,
+                      std::uint64_t NumberOfStoredColumns,
+                      const std::string &FilePath) {
+  if ((File.size() - Header.ColumnOffset) / sizeof(double) /
+          NumberOfStoredColumns <
+      Header.NumberOfEvents)
+    throw ComPWA::CorruptFile("Binary::checkColumnBlock() | " + FilePath +
+                              " is truncated!");
+}
+
+const double *column(const MappedFile &File, const FileHeader &Header,
+                     std::size_t Index) {
+  return reinterpret_cast<const double *>(File.data() + Header.ColumnOffset) +
+         Index * Header.NumberOfEvents;
+}
+
+} // namespace
+
+MappedFile::MappedFile(const std::string &FilePath)
+    : Address(nullptr), Size(0) {
+  int FileDescriptor = open(FilePath.c_str(), O_RDONLY);
+  if (FileDescriptor < 0)
+    throw ComPWA::BadConfig("MappedFile::MappedFile() | Can not open " +
+                            FilePath);
+  struct stat FileStatus;
+  if (fstat(FileDescriptor, &FileStatus) < 0) {
+    close(FileDescriptor);
+    throw ComPWA::BadConfig("MappedFile::MappedFile() | Can not stat " +
+                            FilePath);
+  }
+  Size = FileStatus.st_size;
+  if (Size) {
+    void *Mapping =
+        mmap(nullptr, Size, PROT_READ, MAP_PRIVATE, FileDescriptor, 0);
+    if (Mapping == MAP_FAILED) {
+      close(FileDescriptor);
+      throw ComPWA::BadConfig("MappedFile::MappedFile() | Can not map " +
+                              FilePath);
+    }
+    Address = static_cast<const char *>(Mapping);
+  }
+  // the mapping stays valid after the file is closed
+  close(FileDescriptor);
+}
+
+MappedFile::~MappedFile() {
+  if (Address)
+    munmap(const_cast<char *>(Address), Size);
+}
+
+void MappedFile::releasePages(const void *Begin, std::size_t Length) const {
+  // only whole pages inside the range can be released
+  std::uintptr_t PageSize = sysconf(_SC_PAGESIZE);
+  std::uintptr_t First = reinterpret_cast<std::uintptr_t>(Begin);
+  std::uintptr_t Last = First + Length;
+  First = (First + PageSize - 1) / PageSize * PageSize;
+  Last = Last / PageSize * PageSize;
+  if (First < Last)
+    madvise(reinterpret_cast<void *>(First), Last - First, MADV_DONTNEED);
+}
+
+void writeEvents(const ComPWA::EventCollection &Events,
+                 const std::string &OutputFilePath) {
+  LOG(INFO) << "Binary::writeEvents() | writing " << Events.size()
+            << " events to " << OutputFilePath;
+
+  if (Events.Pids.size() != Events.numberOfParticles())
+    throw ComPWA::BadParameter(
+        "Binary::writeEvents() | Number of pids does not match the number "
+        "of particles!");
+  for (const auto &p4 : Events.FourMomenta) {
+    if (p4.Px.size() != Events.size() || p4.Py.size() != Events.size() ||
+        p4.Pz.size() != Events.size() || p4.E.size() != Events.size())
+      throw ComPWA::BadParameter("Binary::writeEvents() | Four momentum "
+                                 "columns differ in size from the weights!");
+  }
+
+  std::string MetaData;
+  for (std::int32_t pid : Events.Pids)
+    MetaData.append(reinterpret_cast<const char *>(&pid), sizeof(pid));
+
+  auto Stream = openOutput(OutputFilePath);
+  FileHeader Header;
+  Header.Content = ContentType::Events;
+  Header.NumberOfColumns = Events.numberOfParticles();
+  Header.NumberOfEvents = Events.size();
+  writeHead(Stream, Header, MetaData);
+  for (const auto &p4 : Events.FourMomenta) {
+    writeColumn(Stream, p4.Px);
+    writeColumn(Stream, p4.Py);
+    writeColumn(Stream, p4.Pz);
+    writeColumn(Stream, p4.E);
+  }
+  writeColumn(Stream, Events.Weights);
+  // errors of the final flush are only reported by close()
+  Stream.close();
+  if (!Stream)
+    throw ComPWA::BadConfig("Binary::writeEvents() | Error writing " +
+                            OutputFilePath);
+}
+
+ComPWA::EventCollection readEvents(const std::string &InputFilePath) {
+  MappedFile File(InputFilePath);
+  auto Header = readHeader(File, ContentType::Events, InputFilePath);
+  checkColumnBlock(File, Header, 4 * Header.NumberOfColumns + 1,
+                   InputFilePath);
+
+  if (sizeof(FileHeader) + Header.NumberOfColumns * sizeof(std::int32_t) >
+      Header.ColumnOffset)
+    throw ComPWA::CorruptFile("Binary::readEvents() | " + InputFilePath +
+                              " has corrupt meta data!");
+  std::vector<int> Pids(Header.NumberOfColumns);
+  for (std::size_t i = 0; i < Pids.size(); ++i) {
+    std::int32_t pid;
+    std::memcpy(&pid, File.data() + sizeof(FileHeader) + i * sizeof(pid),
+                sizeof(pid));
+    Pids[i] = pid;
+  }
+
+  auto Events = ComPWA::createEventCollection(Pids);
+  std::size_t n = Header.NumberOfEvents;
+  auto copyColumn = [&](std::size_t Index) {
+    const double *Begin = column(File, Header, Index);
+    return std::vector<double>(Begin, Begin + n);
+  };
+  for (std::size_t i = 0; i < Pids.size(); ++i) {
+    Events.FourMomenta[i].Px = copyColumn(4 * i);
+    Events.FourMomenta[i].Py = copyColumn(4 * i + 1);
+    Events.FourMomenta[i].Pz = copyColumn(4 * i + 2);
+    Events.FourMomenta[i].E = copyColumn(4 * i + 3);
+  }
+  Events.Weights = copyColumn(4 * Pids.size());
+  return Events;
+}
+
+void writeDataSet(const DataSet &Set, const std::string &OutputFilePath) {
+  LOG(INFO) << "Binary::writeDataSet() | writing " << Set.Weights.size()
+            << " events to " << OutputFilePath;
+
+  // data sets without variable names are stored with empty names
+  std::vector<std::string> VariableNames(Set.VariableNames);
+  if (VariableNames.empty())
+    VariableNames.resize(Set.Data.size());
+  if (Set.Data.size() != VariableNames.size())
+    throw ComPWA::BadParameter(
+        "Binary::writeDataSet() | Number of variable names does not match "
+        "the number of data columns!");
+  // columns of unused variables are empty and are not stored
+  for (const auto &Column : Set.Data) {
+    if (Column.size() != Set.Weights.size() && !Column.empty())
+      throw ComPWA::BadParameter("Binary::writeDataSet() | Data columns "
+                                 "differ in size!");
+  }
+
+  std::string MetaData;
+  for (std::size_t i = 0; i < VariableNames.size(); ++i) {
+    std::uint32_t Length = VariableNames[i].size();
+    MetaData.append(reinterpret_cast<const char *>(&Length), sizeof(Length));
+    MetaData.append(VariableNames[i]);
+    MetaData.push_back(Set.Data[i].size() == Set.Weights.size());
+  }
+
+  auto Stream = openOutput(OutputFilePath);
+  FileHeader Header;
+  Header.Content = ContentType::DataSet;
+  Header.NumberOfColumns = Set.Data.size();
+  Header.NumberOfEvents = Set.Weights.size();
+  writeHead(Stream, Header, MetaData);
+  for (const auto &Column : Set.Data) {
+    if (Column.size() == Set.Weights.size())
+      writeColumn(Stream, Column);
+  }
+  writeColumn(Stream, Set.Weights);
+  // errors of the final flush are only reported by close()
+  Stream.close();
+  if (!Stream)
+    throw ComPWA::BadConfig("Binary::writeDataSet() | Error writing " +
+                            OutputFilePath);
+}
+
+MappedDataSet mapDataSet(const std::string &InputFilePath) {
+  auto File = std::make_shared<const MappedFile>(InputFilePath);
+  auto Header = readHeader(*File, ContentType::DataSet, InputFilePath);
+
+  MappedDataSet Set;
+  Set.File = File;
+  Set.Size = Header.NumberOfEvents;
+
+  std::size_t Position = sizeof(FileHeader);
+  std::size_t NumberOfStoredColumns(0);
+  for (std::size_t i = 0; i < Header.NumberOfColumns; ++i) {
+    std::uint32_t Length;
+    if (Position + sizeof(Length) > Header.ColumnOffset)
+      throw ComPWA::CorruptFile("Binary::mapDataSet() | " + InputFilePath +
+                                " has corrupt meta data!");
+    std::memcpy(&Length, File->data() + Position, sizeof(Length));
+    Position += sizeof(Length);
+    if (Position + Length + 1 > Header.ColumnOffset)
+      throw ComPWA::CorruptFile("Binary::mapDataSet() | " + InputFilePath +
+                                " has corrupt meta data!");
+    Set.VariableNames.push_back(std::string(File->data() + Position, Length));
+    Position += Length;
+
+    bool Stored = File->data()[Position++];
+    Set.Data.push_back(Stored ? column(*File, Header, NumberOfStoredColumns++)
+                              : nullptr);
+  }
+  checkColumnBlock(*File, Header, NumberOfStoredColumns + 1, InputFilePath);
+  Set.Weights = column(*File, Header, NumberOfStoredColumns);
+  return Set;
+}
+
+DataSet toDataSet(const MappedDataSet &Set) {
+  DataSet Result;
+  Result.VariableNames = Set.VariableNames;
+  for (const double *Column : Set.Data) {
+    if (Column)
+      Result.Data.push_back(std::vector<double>(Column, Column + Set.Size));
+    else
+      Result.Data.push_back(std::vector<double>());
+  }
+  Result.Weights = std::vector<double>(Set.Weights, Set.Weights + Set.Size);
+  return Result;
+}
+
+DataSet readDataSet(const std::string &InputFilePath) {
+  return toDataSet(mapDataSet(InputFilePath));
+}
+
+} // namespace Binary
+} // namespace Data
+} // namespace ComPWA
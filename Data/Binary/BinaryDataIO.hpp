@@ -0,0 +1,112 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Native columnar binary format for EventCollections and DataSets.
+///
+/// A file consists of a fixed size header, a meta data block and the column
+/// block:
+///
+/// | offset      | content                                                  |
+/// |-------------|----------------------------------------------------------|
+/// | 0           | magic bytes "ComPWA\0\0"                                 |
+/// | 8           | uint32 byte order mark (0x01020304 in native order)      |
+/// | 12          | uint32 format version                                    |
+/// | 16          | uint32 content type (1: events, 2: data set)             |
+/// | 20          | uint32 number of columns (particles or variables)        |
+/// | 24          | uint64 number of events                                  |
+/// | 32          | uint64 offset of the column block                        |
+/// | 40          | meta data                                                |
+/// | ColumnBlock | double columns, each with one entry per event            |
+///
+/// The meta data of an event file is the list of particle ids (int32 per
+/// particle), the columns are (px, py, pz, E) for each particle followed by
+/// the weights. The meta data of a data set file is the list of variables
+/// (uint32 length and characters of the name, and a uint8 that is 0 if the
+/// column is empty), the columns are the non-empty variables in the same order
+/// followed by the weights. Empty columns, e.g. those of variables that a model
+/// does not read, take no space. The column block starts at a 64 byte
+/// boundary.
+///
+/// Files are read via mmap(). The columns of a MappedDataSet point directly
+/// into the mapped memory, so no data is copied or parsed while loading.
+///
+
+#ifndef DATA_BINARY_BINARYDATAIO_HPP_
+#define DATA_BINARY_BINARYDATAIO_HPP_
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Core/EventCollection.hpp"
+#include "Data/DataSet.hpp"
+
+namespace ComPWA {
+namespace Data {
+namespace Binary {
+
+///
+/// \class MappedFile
+/// Read-only memory mapping of a file. The mapping is released in the
+/// destructor.
+///
+class MappedFile {
+public:
+  MappedFile(const std::string &FilePath);
+  ~MappedFile();
+
+  MappedFile(const MappedFile &that) = delete;
+  MappedFile &operator=(const MappedFile &that) = delete;
+
+  const char *data() const { return Address; }
+  std::size_t size() const { return Size; }
+
+  /// Hint that the pages in [\p Begin, \p Begin + \p Length) are not needed
+  /// anymore. They are dropped from the resident memory and read again from
+  /// the file on the next access.
+  void releasePages(const void *Begin, std::size_t Length) const;
+
+private:
+  const char *Address;
+  std::size_t Size;
+};
+
+///
+/// DataSet whose columns reside in a memory mapped file. The column pointers
+/// stay valid as long as the MappedDataSet (or a copy of it) exists. Columns
+/// that were empty in the written DataSet are null pointers.
+///
+struct MappedDataSet {
+  std::shared_ptr<const MappedFile> File;
+  std::vector<const double *> Data;
+  const double *Weights;
+  std::size_t Size;
+  std::vector<std::string> VariableNames;
+};
+
+void writeEvents(const ComPWA::EventCollection &Events,
+                 const std::string &OutputFilePath);
+
+ComPWA::EventCollection readEvents(const std::string &InputFilePath);
+
+/// Write \p Set to \p OutputFilePath. Each data column has to be empty or
+/// has one entry per weight.
+void writeDataSet(const DataSet &Set, const std::string &OutputFilePath);
+
+/// Map the data set file \p InputFilePath into memory.
+MappedDataSet mapDataSet(const std::string &InputFilePath);
+
+/// Copy the columns of \p Set into a DataSet.
+DataSet toDataSet(const MappedDataSet &Set);
+
+/// Read the data set file \p InputFilePath into a DataSet.
+DataSet readDataSet(const std::string &InputFilePath);
+
+} // namespace Binary
+} // namespace Data
+} // namespace ComPWA
+
+#endif
@@ -0,0 +1,291 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <sstream>
+#include <thread>
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "BinaryDataIO.hpp"
+#include "DataSetCache.hpp"
+#include "Core/Exceptions.hpp"
+#include "Core/Kinematics.hpp"
+#include "Core/Logging.hpp"
+
+namespace ComPWA {
+namespace Data {
+namespace Binary {
+
+namespace {
+
+const std::uint64_t FNVPrime = 0x100000001b3;
+
+std::uint64_t hashWord(std::uint64_t Word, std::uint64_t Hash) {
+  return (Hash ^ Word) * FNVPrime;
+}
+
+std::uint64_t hashDouble(double Value, std::uint64_t Hash) {
+  std::uint64_t Word;
+  std::memcpy(&Word, &Value, sizeof(Word));
+  return hashWord(Word, Hash);
+}
+
+std::uint64_t hashString(const std::string &Text, std::uint64_t Hash) {
+  std::uint64_t Length = Text.size();
+  Hash = hashBytes(reinterpret_cast<const char *>(&Length), sizeof(Length),
+                   Hash);
+  return hashBytes(Text.data(), Text.size(), Hash);
+}
+
+/// Hash of the content of all files \p FilePaths.
+std::uint64_t hashFiles(const std::vector<std::string> &FilePaths) {
+  std::uint64_t Hash = hashBytes(nullptr, 0);
+  for (const auto &FilePath : FilePaths)
+    Hash = hashWord(hashFile(FilePath), Hash);
+  return Hash;
+}
+
+bool fileExists(const std::string &FilePath) {
+  struct stat FileStatus;
+  return stat(FilePath.c_str(), &FileStatus) == 0;
+}
+
+/// Copy the cached columns of \p Cached into a DataSet with one column per
+/// variable of \p VariableNames. Returns false if \p Cached does not
+/// contain exactly the variables \p UsedVariableNames.
+bool expandCachedDataSet(const MappedDataSet &Cached,
+                         const std::vector<std::string> &VariableNames,
+                         const std::vector<std::string> &UsedVariableNames,
+                         DataSet &Set) {
+  if (Cached.VariableNames != UsedVariableNames)
+    return false;
+  Set.VariableNames = VariableNames;
+  Set.Data = DataList(VariableNames.size());
+  for (std::size_t i = 0; i < Cached.VariableNames.size(); ++i) {
+    auto Found = std::find(VariableNames.begin(), VariableNames.end(),
+                           Cached.VariableNames[i]);
+    if (Found == VariableNames.end())
+      return false;
+    Set.Data[Found - VariableNames.begin()] =
+        std::vector<double>(Cached.Data[i], Cached.Data[i] + Cached.Size);
+  }
+  Set.Weights = std::vector<double>(Cached.Weights,
+                                    Cached.Weights + Cached.Size);
+  return true;
+}
+
+/// Write the columns \p UsedVariableNames of \p Set to \p FilePath. The
+/// file is written under a temporary name first, so that concurrent jobs
+/// never see a partially written file. The temporary name contains the
+/// process and the thread id, since several threads of a job may store the
+/// same entry.
+void storeDataSet(const DataSet &Set,
+                  const std::vector<std::string> &UsedVariableNames,
+                  const std::string &FilePath) {
+  DataSet Used;
+  Used.VariableNames = UsedVariableNames;
+  Used.Weights = Set.Weights;
+  for (const auto &Name : UsedVariableNames) {
+    auto Found =
+        std::find(Set.VariableNames.begin(), Set.VariableNames.end(), Name);
+    Used.Data.push_back(Set.Data[Found - Set.VariableNames.begin()]);
+  }
+  std::stringstream TemporaryPath;
+  TemporaryPath << FilePath << ".tmp" << getpid() << "-"
+                << std::this_thread::get_id();
+  try {
+    writeDataSet(Used, TemporaryPath.str());
+  } catch (...) {
+    std::remove(TemporaryPath.str().c_str());
+    throw;
+  }
+  if (std::rename(TemporaryPath.str().c_str(), FilePath.c_str())) {
+    std::remove(TemporaryPath.str().c_str());
+    throw ComPWA::BadConfig("DataSetCache::storeDataSet() | Can not rename " +
+                            TemporaryPath.str() + " to " + FilePath);
+  }
+}
+
+} // namespace
+
+std::uint64_t hashBytes(const char *Data, std::size_t Size,
+                        std::uint64_t Hash) {
+  std::size_t Words = Size / sizeof(std::uint64_t);
+  for (std::size_t i = 0; i < Words; ++i) {
+    std::uint64_t Word;
+    std::memcpy(&Word, Data + i * sizeof(Word), sizeof(Word));
+    Hash = (Hash ^ Word) * FNVPrime;
+  }
+  for (std::size_t i = Words * sizeof(std::uint64_t); i < Size; ++i)
+    Hash = (Hash ^ static_cast<unsigned char>(Data[i])) * FNVPrime;
+  return Hash;
+}
+
+std::uint64_t hashEvents(const std::vector<Event> &Events) {
+  std::uint64_t Hash = hashWord(Events.size(), hashBytes(nullptr, 0));
+  for (const auto &Evt : Events) {
+    Hash = hashDouble(Evt.Weight, hashWord(Evt.ParticleList.size(), Hash));
+    for (const auto &Particle : Evt.ParticleList) {
+      for (double x : Particle.fourMomentum().value())
+        Hash = hashDouble(x, Hash);
+      Hash = hashWord(static_cast<std::uint64_t>(Particle.pid()), Hash);
+    }
+  }
+  return Hash;
+}
+
+std::uint64_t hashFile(const std::string &FilePath) {
+  MappedFile File(FilePath);
+  // release the pages that were hashed, so that hashing a large input file
+  // does not increase the resident memory
+  const std::size_t ChunkSize = 64 * 1024 * 1024;
+  std::uint64_t Hash = hashBytes(nullptr, 0);
+  for (std::size_t Begin = 0; Begin < File.size(); Begin += ChunkSize) {
+    std::size_t Size = std::min(ChunkSize, File.size() - Begin);
+    Hash = hashBytes(File.data() + Begin, Size, Hash);
+    File.releasePages(File.data() + Begin, Size);
+  }
+  return Hash;
+}
+
+DataSetCache::DataSetCache(const std::string &CacheDirectory_)
+    : CacheDirectory(CacheDirectory_) {
+  if (mkdir(CacheDirectory.c_str(), 0755) && errno != EEXIST)
+    throw ComPWA::BadConfig(
+        "DataSetCache::DataSetCache() | Can not create cache directory " +
+        CacheDirectory + ": " + std::strerror(errno));
+}
+
+std::string DataSetCache::getCacheFilePath(
+    const std::vector<std::string> &InputFilePaths,
+    const ComPWA::Kinematics &Kinematics,
+    const std::vector<std::string> &UsedVariableNames) const {
+  return getCacheFilePath(hashFiles(InputFilePaths), Kinematics,
+                          UsedVariableNames);
+}
+
+std::string DataSetCache::getCacheFilePath(
+    const std::vector<Event> &Events, const ComPWA::Kinematics &Kinematics,
+    const std::vector<std::string> &UsedVariableNames) const {
+  return getCacheFilePath(hashEvents(Events), Kinematics, UsedVariableNames);
+}
+
+std::string DataSetCache::getCacheFilePath(
+    std::uint64_t InputHash, const ComPWA::Kinematics &Kinematics,
+    const std::vector<std::string> &UsedVariableNames) const {
+  std::uint64_t Hash = hashString(Kinematics.getConfigurationKey(),
+                                  hashBytes(nullptr, 0));
+  for (const auto &Name : UsedVariableNames)
+    Hash = hashString(Name, Hash);
+  Hash = hashWord(InputHash, Hash);
+  std::stringstream FilePath;
+  FilePath << CacheDirectory << "/DataSet-" << std::hex << Hash << ".bin";
+  return FilePath.str();
+}
+
+DataSet DataSetCache::convertEventsToDataSet(
+    const std::vector<std::string> &InputFilePaths,
+    const std::function<std::vector<Event>()> &readEvents,
+    const ComPWA::Kinematics &Kinematics) const {
+  return convertEventsToDataSet(InputFilePaths, readEvents, Kinematics,
+                                Kinematics.getKinematicVariableNames());
+}
+
+DataSet DataSetCache::convertEventsToDataSet(
+    const std::vector<std::string> &InputFilePaths,
+    const std::function<std::vector<Event>()> &readEvents,
+    const ComPWA::Kinematics &Kinematics,
+    const std::vector<std::string> &UsedVariableNames) const {
+  return lookUpOrConvert(
+      [&InputFilePaths]() { return hashFiles(InputFilePaths); },
+      [&]() {
+        return Data::convertEventsToDataSet(readEvents(), Kinematics,
+                                            UsedVariableNames);
+      },
+      Kinematics, UsedVariableNames);
+}
+
+DataSet DataSetCache::convertEventsToDataSet(
+    const std::vector<Event> &Events,
+    const ComPWA::Kinematics &Kinematics) const {
+  return convertEventsToDataSet(Events, Kinematics,
+                                Kinematics.getKinematicVariableNames());
+}
+
+DataSet DataSetCache::convertEventsToDataSet(
+    const std::vector<Event> &Events, const ComPWA::Kinematics &Kinematics,
+    const std::vector<std::string> &UsedVariableNames) const {
+  return lookUpOrConvert(
+      [&Events]() { return hashEvents(Events); },
+      [&]() {
+        return Data::convertEventsToDataSet(Events, Kinematics,
+                                            UsedVariableNames);
+      },
+      Kinematics, UsedVariableNames);
+}
+
+DataSet DataSetCache::lookUpOrConvert(
+    const std::function<std::uint64_t()> &hashInput,
+    const std::function<DataSet()> &convert,
+    const ComPWA::Kinematics &Kinematics,
+    const std::vector<std::string> &UsedVariableNames) const {
+  if (Kinematics.getConfigurationKey().empty()) {
+    LOG(INFO) << "DataSetCache::convertEventsToDataSet() | Kinematics "
+                 "provides no configuration key, the data is not cached.";
+    return convert();
+  }
+
+  // the cached columns are stored in the order of the kinematic variables
+  auto VariableNames = Kinematics.getKinematicVariableNames();
+  for (const auto &Name : UsedVariableNames) {
+    if (std::find(VariableNames.begin(), VariableNames.end(), Name) ==
+        VariableNames.end())
+      throw ComPWA::BadParameter(
+          "DataSetCache::convertEventsToDataSet() | Kinematics does not "
+          "provide the variable " +
+          Name + "!");
+  }
+  std::vector<std::string> SortedNames;
+  for (const auto &Name : VariableNames) {
+    if (std::find(UsedVariableNames.begin(), UsedVariableNames.end(), Name) !=
+        UsedVariableNames.end())
+      SortedNames.push_back(Name);
+  }
+
+  std::string FilePath = getCacheFilePath(hashInput(), Kinematics, SortedNames);
+  if (fileExists(FilePath)) {
+    try {
+      DataSet Set;
+      if (expandCachedDataSet(mapDataSet(FilePath), VariableNames,
+                              SortedNames, Set)) {
+        LOG(INFO) << "DataSetCache::convertEventsToDataSet() | Read "
+                  << Set.Weights.size() << " events from " << FilePath;
+        return Set;
+      }
+      LOG(WARNING) << "DataSetCache::convertEventsToDataSet() | " << FilePath
+                   << " contains the wrong variables and is replaced.";
+    } catch (ComPWA::Exception &ex) {
+      LOG(WARNING) << "DataSetCache::convertEventsToDataSet() | " << ex.what()
+                   << " The file is replaced.";
+    }
+  }
+
+  auto Set = convert();
+  try {
+    storeDataSet(Set, SortedNames, FilePath);
+  } catch (ComPWA::BadConfig &ex) {
+    // a failing cache must not stop the job
+    LOG(WARNING) << "DataSetCache::convertEventsToDataSet() | " << ex.what();
+  }
+  return Set;
+}
+
+} // namespace Binary
+} // namespace Data
+} // namespace ComPWA
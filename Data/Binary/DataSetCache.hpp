@@ -0,0 +1,116 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Persistent cache of converted DataSets.
+///
+
+#ifndef DATA_BINARY_DATASETCACHE_HPP_
+#define DATA_BINARY_DATASETCACHE_HPP_
+
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Data/DataSet.hpp"
+
+namespace ComPWA {
+class Kinematics;
+namespace Data {
+namespace Binary {
+
+///
+/// \class DataSetCache
+/// Content addressed on-disk cache of DataSets. The key of a DataSet is a
+/// hash of the input (the content of the input files or of the events), of
+/// Kinematics::getConfigurationKey() and of the requested variables. The
+/// DataSets are stored in the binary format of writeDataSet() in the cache
+/// directory, one file per key. A job that converts the same input with the
+/// same kinematics again copies the stored columns from the mapped file
+/// instead of converting the events.
+///
+/// The hash is not cryptographic; it protects against stale entries, not
+/// against deliberately forged cache files.
+///
+class DataSetCache {
+public:
+  /// The directory \p CacheDirectory_ is created if it does not exist.
+  DataSetCache(const std::string &CacheDirectory_);
+
+  /// Return the DataSet of the events read from \p InputFilePaths.
+  /// \p readEvents() has to read the events from these files and must not
+  /// depend on anything else. It is only called if the DataSet is not in the
+  /// cache yet. Kinematics that return an empty configuration key are not
+  /// cached.
+  DataSet
+  convertEventsToDataSet(const std::vector<std::string> &InputFilePaths,
+                         const std::function<std::vector<Event>()> &readEvents,
+                         const ComPWA::Kinematics &Kinematics) const;
+
+  /// Same as above, but only the variables \p UsedVariableNames are
+  /// calculated and stored (see Data::convertEventsToDataSet()).
+  DataSet convertEventsToDataSet(
+      const std::vector<std::string> &InputFilePaths,
+      const std::function<std::vector<Event>()> &readEvents,
+      const ComPWA::Kinematics &Kinematics,
+      const std::vector<std::string> &UsedVariableNames) const;
+
+  /// Return the DataSet of \p Events. The key is a hash of the events, so
+  /// the events have to be read (and e.g. reduced to the phase space) before,
+  /// but their conversion is cached.
+  DataSet convertEventsToDataSet(const std::vector<Event> &Events,
+                                 const ComPWA::Kinematics &Kinematics) const;
+
+  /// Same as above, but only the variables \p UsedVariableNames are
+  /// calculated and stored.
+  DataSet convertEventsToDataSet(
+      const std::vector<Event> &Events, const ComPWA::Kinematics &Kinematics,
+      const std::vector<std::string> &UsedVariableNames) const;
+
+  /// Path of the cache file for the given input.
+  std::string
+  getCacheFilePath(const std::vector<std::string> &InputFilePaths,
+                   const ComPWA::Kinematics &Kinematics,
+                   const std::vector<std::string> &UsedVariableNames) const;
+
+  std::string
+  getCacheFilePath(const std::vector<Event> &Events,
+                   const ComPWA::Kinematics &Kinematics,
+                   const std::vector<std::string> &UsedVariableNames) const;
+
+private:
+  /// Look up the DataSet of the input with the hash hashInput() and call
+  /// \p convert() if it is not in the cache yet.
+  DataSet lookUpOrConvert(
+      const std::function<std::uint64_t()> &hashInput,
+      const std::function<DataSet()> &convert,
+      const ComPWA::Kinematics &Kinematics,
+      const std::vector<std::string> &UsedVariableNames) const;
+
+  std::string
+  getCacheFilePath(std::uint64_t InputHash,
+                   const ComPWA::Kinematics &Kinematics,
+                   const std::vector<std::string> &UsedVariableNames) const;
+
+  std::string CacheDirectory;
+};
+
+/// Hash of \p Size bytes at \p Data, continuing from \p Hash. This is the
+/// 64 bit FNV-1a hash applied to 64 bit words instead of single bytes.
+std::uint64_t hashBytes(const char *Data, std::size_t Size,
+                        std::uint64_t Hash = 0xcbf29ce484222325);
+
+/// Hash of the content of the file \p FilePath.
+std::uint64_t hashFile(const std::string &FilePath);
+
+/// Hash of the particle ids, four-momenta and weights of \p Events.
+std::uint64_t hashEvents(const std::vector<Event> &Events);
+
+} // namespace Binary
+} // namespace Data
+} // namespace ComPWA
+
+#endif
@@ -0,0 +1,80 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <future>
+
+#include "StreamingDataSet.hpp"
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+
+namespace ComPWA {
+namespace Data {
+namespace Binary {
+
+StreamingDataSet::StreamingDataSet(const std::vector<std::string> &FilePaths,
+                                   std::size_t ChunkSize_)
+    : NumberOfEvents(0) {
+  if (!ChunkSize_)
+    throw ComPWA::BadParameter(
+        "StreamingDataSet::StreamingDataSet() | Chunk size has to be "
+        "positive!");
+  for (const auto &Path : FilePaths) {
+    Files.push_back(mapDataSet(Path));
+    if (Files.size() == 1)
+      VariableNames = Files.front().VariableNames;
+    else if (Files.back().VariableNames != VariableNames)
+      throw ComPWA::BadConfig("StreamingDataSet::StreamingDataSet() | "
+                              "Variables of " +
+                              Path + " differ from " + FilePaths.front());
+
+    std::size_t FileSize = Files.back().Size;
+    for (std::size_t Begin = 0; Begin < FileSize; Begin += ChunkSize_) {
+      Chunks.push_back(Chunk{Files.size() - 1, Begin,
+                             std::min(ChunkSize_, FileSize - Begin)});
+    }
+    NumberOfEvents += FileSize;
+  }
+  LOG(INFO) << "StreamingDataSet::StreamingDataSet() | " << NumberOfEvents
+            << " events in " << Files.size() << " files and "
+            << Chunks.size() << " chunks";
+}
+
+DataSet StreamingDataSet::loadChunk(const Chunk &ChunkInfo) const {
+  const MappedDataSet &Mapped(Files[ChunkInfo.File]);
+  auto copyAndRelease = [&](const double *Column) {
+    if (!Column)
+      return std::vector<double>();
+    const double *Begin = Column + ChunkInfo.Begin;
+    std::vector<double> Result(Begin, Begin + ChunkInfo.Size);
+    Mapped.File->releasePages(Begin, ChunkInfo.Size * sizeof(double));
+    return Result;
+  };
+
+  DataSet Set;
+  Set.VariableNames = VariableNames;
+  for (const double *Column : Mapped.Data)
+    Set.Data.push_back(copyAndRelease(Column));
+  Set.Weights = copyAndRelease(Mapped.Weights);
+  return Set;
+}
+
+void StreamingDataSet::forEachChunk(
+    const std::function<void(const DataSet &)> &Function) const {
+  if (Chunks.empty())
+    return;
+  auto Next = std::async(std::launch::async, &StreamingDataSet::loadChunk,
+                         this, Chunks.front());
+  for (std::size_t i = 0; i < Chunks.size(); ++i) {
+    DataSet Current = Next.get();
+    if (i + 1 < Chunks.size())
+      Next = std::async(std::launch::async, &StreamingDataSet::loadChunk, this,
+                        Chunks[i + 1]);
+    Function(Current);
+  }
+}
+
+} // namespace Binary
+} // namespace Data
+} // namespace ComPWA
@@ -0,0 +1,61 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef DATA_BINARY_STREAMINGDATASET_HPP_
+#define DATA_BINARY_STREAMINGDATASET_HPP_
+
+#include <string>
+#include <vector>
+
+#include "Data/Binary/BinaryDataIO.hpp"
+#include "Data/ChunkedDataSet.hpp"
+
+namespace ComPWA {
+namespace Data {
+namespace Binary {
+
+///
+/// \class StreamingDataSet
+/// Out-of-core data sample, that is backed by one or more data set files (see
+/// BinaryDataIO.hpp). The files are memory mapped and split into chunks of
+/// at most \p ChunkSize events. While a chunk is processed the next chunk is
+/// loaded in a background thread. Pages of processed chunks are released, so
+/// that at most two chunks are resident in memory.
+///
+class StreamingDataSet : public ChunkedDataSet {
+public:
+  StreamingDataSet(const std::vector<std::string> &FilePaths,
+                   std::size_t ChunkSize_ = 1000000);
+
+  std::size_t size() const final { return NumberOfEvents; }
+
+  std::vector<std::string> getVariableNames() const final {
+    return VariableNames;
+  }
+
+  std::size_t numberOfChunks() const { return Chunks.size(); }
+
+  void forEachChunk(
+      const std::function<void(const DataSet &)> &Function) const final;
+
+private:
+  struct Chunk {
+    std::size_t File;
+    std::size_t Begin;
+    std::size_t Size;
+  };
+
+  DataSet loadChunk(const Chunk &ChunkInfo) const;
+
+  std::vector<MappedDataSet> Files;
+  std::vector<Chunk> Chunks;
+  std::vector<std::string> VariableNames;
+  std::size_t NumberOfEvents;
+};
+
+} // namespace Binary
+} // namespace Data
+} // namespace ComPWA
+
+#endif
@@ -0,0 +1,344 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#define BOOST_TEST_MODULE Data_BinaryDataIOTest
+
+#include "Data/Binary/BinaryDataIO.hpp"
+#include "Data/Binary/DataSetCache.hpp"
+#include "Data/Binary/StreamingDataSet.hpp"
+#include "Core/Exceptions.hpp"
+#include "Core/Kinematics.hpp"
+#include "Core/Logging.hpp"
+
+#include <boost/test/unit_test.hpp>
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <string>
+
+#include <unistd.h>
+
+namespace ComPWA {
+namespace Data {
+
+/// Kinematics with the energies of the particles as variables.
+class EnergyKinematics : public ComPWA::Kinematics {
+public:
+  DataPoint convert(const Event &Evt) const {
+    DataPoint Point;
+    for (const auto &Particle : Evt.ParticleList)
+      Point.KinematicVariableList.push_back(Particle.fourMomentum().e());
+    return Point;
+  }
+  using Kinematics::convert;
+
+  std::vector<std::string> getKinematicVariableNames() const {
+    return {"E_0", "E_1", "E_2"};
+  }
+  bool isWithinPhaseSpace(const DataPoint &) const { return true; }
+  double phspVolume() const { return 1.0; }
+  std::string getConfigurationKey() const { return Key; }
+
+  std::string Key = "energies";
+};
+
+BOOST_AUTO_TEST_SUITE(BinaryData);
+
+BOOST_AUTO_TEST_CASE(EventsWriteReadCheck) {
+  ComPWA::Logging log("warning");
+
+  auto Events = ComPWA::createEventCollection({22, 111, 111});
+  for (int i = 0; i < 100; ++i) {
+    Event Evt;
+    Evt.ParticleList.push_back(Particle(0.1 * i, 0.2, -0.3, 1.5, 22));
+    Evt.ParticleList.push_back(Particle(-0.1 * i, 0.4, 0.3, 1.0, 111));
+    Evt.ParticleList.push_back(Particle(0.0, -0.6, 0.001 * i, 0.6, 111));
+    Evt.Weight = 1.0 / (i + 1);
+    ComPWA::append(Events, Evt);
+  }
+
+  Binary::writeEvents(Events, "BinaryDataIOTest-events.bin");
+  auto EventsIn = Binary::readEvents("BinaryDataIOTest-events.bin");
+
+  BOOST_CHECK(EventsIn.Pids == Events.Pids);
+  BOOST_CHECK(EventsIn.Weights == Events.Weights);
+  BOOST_REQUIRE_EQUAL(EventsIn.numberOfParticles(), 3);
+  for (std::size_t i = 0; i < 3; ++i) {
+    BOOST_CHECK(EventsIn.FourMomenta[i].Px == Events.FourMomenta[i].Px);
+    BOOST_CHECK(EventsIn.FourMomenta[i].Py == Events.FourMomenta[i].Py);
+    BOOST_CHECK(EventsIn.FourMomenta[i].Pz == Events.FourMomenta[i].Pz);
+    BOOST_CHECK(EventsIn.FourMomenta[i].E == Events.FourMomenta[i].E);
+  }
+
+  // an event file is not a data set
+  BOOST_CHECK_THROW(Binary::mapDataSet("BinaryDataIOTest-events.bin"),
+                    ComPWA::CorruptFile);
+
+  std::remove("BinaryDataIOTest-events.bin");
+
+  // all columns need one entry per event
+  Events.FourMomenta[1].Pz.pop_back();
+  BOOST_CHECK_THROW(
+      Binary::writeEvents(Events, "BinaryDataIOTest-events.bin"),
+      ComPWA::BadParameter);
+  Events.FourMomenta[1].Pz.push_back(0.3);
+  Events.Weights.push_back(1.0);
+  BOOST_CHECK_THROW(
+      Binary::writeEvents(Events, "BinaryDataIOTest-events.bin"),
+      ComPWA::BadParameter);
+}
+
+BOOST_AUTO_TEST_CASE(DataSetWriteReadCheck) {
+  ComPWA::Logging log("warning");
+
+  DataSet Set;
+  Set.VariableNames = {"mSq_(1,2)", "theta_(1,2)", "phi_(1,2)"};
+  Set.Data.resize(3);
+  for (int i = 0; i < 1000; ++i) {
+    Set.Data[0].push_back(0.5 + 0.001 * i);
+    Set.Data[1].push_back(0.003 * i);
+    Set.Data[2].push_back(-0.002 * i);
+    Set.Weights.push_back(1.0 + 0.01 * i);
+  }
+
+  Binary::writeDataSet(Set, "BinaryDataIOTest-dataset.bin");
+  {
+    auto Mapped = Binary::mapDataSet("BinaryDataIOTest-dataset.bin");
+    BOOST_CHECK_EQUAL(Mapped.Size, 1000);
+    BOOST_CHECK(Mapped.VariableNames == Set.VariableNames);
+    // columns are aligned and point into the mapping
+    for (auto Column : Mapped.Data)
+      BOOST_CHECK_EQUAL(reinterpret_cast<std::uintptr_t>(Column) % 8, 0);
+    BOOST_CHECK_EQUAL(Mapped.Data[1][500], Set.Data[1][500]);
+    BOOST_CHECK_EQUAL(Mapped.Weights[999], Set.Weights[999]);
+  }
+
+  auto SetIn = Binary::readDataSet("BinaryDataIOTest-dataset.bin");
+  BOOST_CHECK(SetIn.Data == Set.Data);
+  BOOST_CHECK(SetIn.Weights == Set.Weights);
+  BOOST_CHECK(SetIn.VariableNames == Set.VariableNames);
+
+  // columns of unused variables are empty and are not stored
+  DataSet Sparse(Set);
+  Sparse.Data[1].clear();
+  Binary::writeDataSet(Sparse, "BinaryDataIOTest-sparse.bin");
+  {
+    auto Mapped = Binary::mapDataSet("BinaryDataIOTest-sparse.bin");
+    BOOST_CHECK(Mapped.VariableNames == Sparse.VariableNames);
+    BOOST_REQUIRE_EQUAL(Mapped.Data.size(), 3);
+    BOOST_CHECK(Mapped.Data[1] == nullptr);
+    BOOST_CHECK_EQUAL(Mapped.Data[2][500], Sparse.Data[2][500]);
+  }
+  auto SparseIn = Binary::readDataSet("BinaryDataIOTest-sparse.bin");
+  BOOST_CHECK(SparseIn.Data == Sparse.Data);
+  BOOST_CHECK(SparseIn.Weights == Sparse.Weights);
+  BOOST_CHECK(SparseIn.VariableNames == Sparse.VariableNames);
+
+  // truncated files are rejected
+  {
+    std::ifstream In("BinaryDataIOTest-dataset.bin", std::ios::binary);
+    std::string Content((std::istreambuf_iterator<char>(In)),
+                        std::istreambuf_iterator<char>());
+    std::ofstream Out("BinaryDataIOTest-truncated.bin", std::ios::binary);
+    Out.write(Content.data(), Content.size() - 8);
+  }
+  BOOST_CHECK_THROW(Binary::mapDataSet("BinaryDataIOTest-truncated.bin"),
+                    ComPWA::CorruptFile);
+
+  std::remove("BinaryDataIOTest-dataset.bin");
+  std::remove("BinaryDataIOTest-sparse.bin");
+  std::remove("BinaryDataIOTest-truncated.bin");
+}
+
+BOOST_AUTO_TEST_CASE(StreamingDataSetCheck) {
+  ComPWA::Logging log("warning");
+
+  // two files with 250 and 100 events
+  DataSet Set;
+  Set.VariableNames = {"x", "y"};
+  Set.Data.resize(2);
+  for (int i = 0; i < 350; ++i) {
+    Set.Data[0].push_back(i);
+    Set.Data[1].push_back(-i);
+    Set.Weights.push_back(0.5 * i);
+  }
+  DataSet First(Set), Second(Set);
+  resize(First, 250);
+  for (auto &Column : Second.Data)
+    Column.erase(Column.begin(), Column.begin() + 250);
+  Second.Weights.erase(Second.Weights.begin(), Second.Weights.begin() + 250);
+  Binary::writeDataSet(First, "BinaryDataIOTest-first.bin");
+  Binary::writeDataSet(Second, "BinaryDataIOTest-second.bin");
+
+  {
+    Binary::StreamingDataSet Stream(
+        {"BinaryDataIOTest-first.bin", "BinaryDataIOTest-second.bin"}, 100);
+    BOOST_CHECK_EQUAL(Stream.size(), 350);
+    BOOST_CHECK_EQUAL(Stream.numberOfChunks(), 4);
+    BOOST_CHECK(Stream.getVariableNames() == Set.VariableNames);
+
+    // the chunks reproduce the complete sample in order
+    DataSet Streamed;
+    Streamed.Data.resize(2);
+    std::vector<std::size_t> ChunkSizes;
+    Stream.forEachChunk([&](const DataSet &Chunk) {
+      ChunkSizes.push_back(Chunk.Weights.size());
+      for (std::size_t i = 0; i < 2; ++i)
+        Streamed.Data[i].insert(Streamed.Data[i].end(), Chunk.Data[i].begin(),
+                                Chunk.Data[i].end());
+      Streamed.Weights.insert(Streamed.Weights.end(), Chunk.Weights.begin(),
+                              Chunk.Weights.end());
+    });
+    BOOST_CHECK(ChunkSizes == std::vector<std::size_t>({100, 100, 50, 100}));
+    BOOST_CHECK(Streamed.Data == Set.Data);
+    BOOST_CHECK(Streamed.Weights == Set.Weights);
+  }
+
+  std::remove("BinaryDataIOTest-first.bin");
+  std::remove("BinaryDataIOTest-second.bin");
+}
+
+BOOST_AUTO_TEST_CASE(DataSetCacheCheck) {
+  ComPWA::Logging log("warning");
+
+  auto Events = ComPWA::createEventCollection({22, 111, 111});
+  for (int i = 0; i < 100; ++i) {
+    Event Evt;
+    Evt.ParticleList.push_back(Particle(0.1 * i, 0.2, -0.3, 1.5 + i, 22));
+    Evt.ParticleList.push_back(Particle(-0.1 * i, 0.4, 0.3, 1.0, 111));
+    Evt.ParticleList.push_back(Particle(0.0, -0.6, 0.001 * i, 0.6 * i, 111));
+    Evt.Weight = 1.0 / (i + 1);
+    ComPWA::append(Events, Evt);
+  }
+  Binary::writeEvents(Events, "BinaryDataIOTest-input.bin");
+
+  std::size_t NumberOfReads(0);
+  auto readEvents = [&NumberOfReads]() {
+    ++NumberOfReads;
+    auto Collection = Binary::readEvents("BinaryDataIOTest-input.bin");
+    std::vector<Event> Result;
+    for (std::size_t i = 0; i < Collection.size(); ++i)
+      Result.push_back(ComPWA::getEvent(Collection, i));
+    return Result;
+  };
+
+  EnergyKinematics Kinematics;
+  Binary::DataSetCache Cache("BinaryDataIOTest-cache");
+  std::vector<std::string> Inputs{"BinaryDataIOTest-input.bin"};
+  std::vector<std::string> CacheFiles{
+      Cache.getCacheFilePath(Inputs, Kinematics,
+                             Kinematics.getKinematicVariableNames()),
+      Cache.getCacheFilePath(Inputs, Kinematics, {"E_1"})};
+
+  auto Converted = Cache.convertEventsToDataSet(Inputs, readEvents, Kinematics);
+  BOOST_CHECK_EQUAL(NumberOfReads, 1);
+  BOOST_REQUIRE_EQUAL(Converted.Weights.size(), 100);
+  BOOST_CHECK_EQUAL(Converted.Data[0][10], 11.5);
+  BOOST_CHECK(Converted.Weights == Events.Weights);
+
+  // the second conversion is read from the cache
+  auto Cached = Cache.convertEventsToDataSet(Inputs, readEvents, Kinematics);
+  BOOST_CHECK_EQUAL(NumberOfReads, 1);
+  BOOST_CHECK(Cached.VariableNames == Converted.VariableNames);
+  BOOST_CHECK(Cached.Data == Converted.Data);
+  BOOST_CHECK(Cached.Weights == Converted.Weights);
+
+  // a different selection of variables is a different entry
+  for (int i = 0; i < 2; ++i) {
+    auto Selected =
+        Cache.convertEventsToDataSet(Inputs, readEvents, Kinematics, {"E_1"});
+    BOOST_CHECK_EQUAL(NumberOfReads, 2);
+    BOOST_CHECK(Selected.Data[0].empty());
+    BOOST_CHECK(Selected.Data[1] == Converted.Data[1]);
+    BOOST_CHECK(Selected.Data[2].empty());
+  }
+  BOOST_CHECK_THROW(
+      Cache.convertEventsToDataSet(Inputs, readEvents, Kinematics, {"x"}),
+      ComPWA::BadParameter);
+
+  // changes of the kinematics or of the input files are detected
+  Kinematics.Key = "other energies";
+  CacheFiles.push_back(Cache.getCacheFilePath(
+      Inputs, Kinematics, Kinematics.getKinematicVariableNames()));
+  Cache.convertEventsToDataSet(Inputs, readEvents, Kinematics);
+  BOOST_CHECK_EQUAL(NumberOfReads, 3);
+  Events.Weights[50] = 2.0;
+  Binary::writeEvents(Events, "BinaryDataIOTest-input.bin");
+  CacheFiles.push_back(Cache.getCacheFilePath(
+      Inputs, Kinematics, Kinematics.getKinematicVariableNames()));
+  auto Changed = Cache.convertEventsToDataSet(Inputs, readEvents, Kinematics);
+  BOOST_CHECK_EQUAL(NumberOfReads, 4);
+  BOOST_CHECK_EQUAL(Changed.Weights[50], 2.0);
+
+  // a corrupt cache file is replaced
+  std::ofstream(CacheFiles.back(), std::ios::trunc) << "corrupt";
+  Changed = Cache.convertEventsToDataSet(Inputs, readEvents, Kinematics);
+  BOOST_CHECK_EQUAL(NumberOfReads, 5);
+  BOOST_CHECK_EQUAL(Changed.Weights[50], 2.0);
+
+  for (const auto &FilePath : CacheFiles)
+    BOOST_CHECK_EQUAL(std::remove(FilePath.c_str()), 0);
+  BOOST_CHECK_EQUAL(rmdir("BinaryDataIOTest-cache"), 0);
+  std::remove("BinaryDataIOTest-input.bin");
+}
+
+BOOST_AUTO_TEST_CASE(DataSetCacheEventsCheck) {
+  ComPWA::Logging log("warning");
+
+  std::vector<Event> Events;
+  for (int i = 0; i < 100; ++i) {
+    Event Evt;
+    Evt.ParticleList.push_back(Particle(0.1 * i, 0.2, -0.3, 1.5 + i, 22));
+    Evt.ParticleList.push_back(Particle(-0.1 * i, 0.4, 0.3, 1.0, 111));
+    Evt.ParticleList.push_back(Particle(0.0, -0.6, 0.001 * i, 0.6 * i, 111));
+    Evt.Weight = 1.0 / (i + 1);
+    Events.push_back(Evt);
+  }
+
+  EnergyKinematics Kinematics;
+  Binary::DataSetCache Cache("BinaryDataIOTest-cache");
+  std::string CacheFile = Cache.getCacheFilePath(
+      Events, Kinematics, Kinematics.getKinematicVariableNames());
+  auto Converted = Cache.convertEventsToDataSet(Events, Kinematics);
+  BOOST_REQUIRE_EQUAL(std::ifstream(CacheFile).good(), true);
+
+  auto Expected = convertEventsToDataSet(Events, Kinematics);
+  BOOST_CHECK(Converted.Data == Expected.Data);
+  BOOST_CHECK(Converted.Weights == Expected.Weights);
+
+  // the second conversion is read from the cache, which is shown by a
+  // modified cache entry
+  auto Modified = Converted;
+  Modified.Weights[10] = 5.0;
+  Binary::writeDataSet(Modified, CacheFile);
+  auto Cached = Cache.convertEventsToDataSet(Events, Kinematics);
+  BOOST_CHECK(Cached.Data == Converted.Data);
+  BOOST_CHECK_EQUAL(Cached.Weights[10], 5.0);
+
+  // any change of the events is a different entry
+  std::vector<std::string> CacheFiles{CacheFile};
+  Events[50].Weight = 2.0;
+  CacheFiles.push_back(Cache.getCacheFilePath(
+      Events, Kinematics, Kinematics.getKinematicVariableNames()));
+  Events[50].Weight = 1.0 / 51;
+  Events[20].ParticleList[1] = Particle(-3.0, 0.4, 0.3, 1.0, 111);
+  CacheFiles.push_back(Cache.getCacheFilePath(
+      Events, Kinematics, Kinematics.getKinematicVariableNames()));
+  Events[20].ParticleList[1] = Particle(-3.0, 0.4, 0.3, 1.0, 211);
+  CacheFiles.push_back(Cache.getCacheFilePath(
+      Events, Kinematics, Kinematics.getKinematicVariableNames()));
+  std::sort(CacheFiles.begin(), CacheFiles.end());
+  BOOST_CHECK(std::unique(CacheFiles.begin(), CacheFiles.end()) ==
+              CacheFiles.end());
+
+  BOOST_CHECK_EQUAL(std::remove(CacheFile.c_str()), 0);
+  BOOST_CHECK_EQUAL(rmdir("BinaryDataIOTest-cache"), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+} // namespace Data
+} // namespace ComPWA
@@ -0,0 +1,157 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#define BOOST_TEST_MODULE Data_DataSetCacheTest
+
+#include "Data/Binary/DataSetCache.hpp"
+#include "Core/Logging.hpp"
+#include "Core/Properties.hpp"
+#include "Data/DataSet.hpp"
+#include "Data/Generate.hpp"
+#include "Data/Root/RootGenerator.hpp"
+#include "Physics/BuilderXML.hpp"
+#include "Physics/HelicityFormalism/HelicityKinematics.hpp"
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include <cstdio>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <dirent.h>
+#include <unistd.h>
+
+namespace ComPWA {
+namespace Data {
+
+const std::string ModelXML = R"####(
+<Intensity Class="NormalizedIntensity" Name="jpsiGammaPiPi_norm">
+  <IntegrationStrategy Class="MCIntegrationStrategy"/>
+  <Intensity Class="CoherentIntensity" Name="jpsiGammaPiPi">
+    <Amplitude Class="CoefficientAmplitude" Name="f2(1270)">
+      <Parameter Class='Double' Type="Magnitude"  Name="Magnitude_f2">
+        <Value>1.0</Value>
+      </Parameter>
+      <Parameter Class='Double' Type="Phase" Name="Phase_f2">
+        <Value>0.0</Value>
+      </Parameter>
+      <Amplitude Class="NormalizedAmplitude" Name="f2(1270)_normed">
+        <IntegrationStrategy Class="MCIntegrationStrategy"/>
+        <Amplitude Class="HelicityDecay" Name="f2ToPiPi">
+          <DecayParticle Name="f2(1270)" Helicity="0"/>
+          <RecoilSystem FinalState="0" />
+          <DecayProducts>
+            <Particle Name="pi0" FinalState="1"  Helicity="0"/>
+            <Particle Name="pi0" FinalState="2"  Helicity="0"/>
+          </DecayProducts>
+        </Amplitude>
+      </Amplitude>
+    </Amplitude>
+  </Intensity>
+</Intensity>
+)####";
+
+const std::string ModelParticles = R"####(
+<ParticleList>
+  <Particle Name="J/psi">
+    <Pid>443</Pid>
+    <Parameter Type="Mass" Name="Mass_jpsi">
+      <Value>3.096900</Value>
+    </Parameter>
+    <QuantumNumber Class="Spin" Type="Spin" Value="1" />
+  </Particle>
+  <Particle Name="pi0">
+    <Pid>111</Pid>
+    <Parameter Type="Mass" Name="Mass_neutralPion">
+      <Value>0.1349766</Value>
+    </Parameter>
+    <QuantumNumber Class="Spin" Type="Spin" Value="0" />
+  </Particle>
+  <Particle Name="gamma">
+    <Pid>22</Pid>
+    <Parameter Type="Mass" Name="Mass_gamma">
+      <Value>0.0</Value>
+    </Parameter>
+    <QuantumNumber Class="Spin" Type="Spin" Value="1" />
+  </Particle>
+  <Particle Name="f2(1270)">
+    <Pid>225</Pid>
+    <Parameter Class='Double' Type="Mass" Name="Mass_f2(1270)">
+      <Value>1.2755</Value>
+    </Parameter>
+    <QuantumNumber Class="Spin" Type="Spin" Value="2"/>
+    <DecayInfo Type="relativisticBreitWigner">
+      <FormFactor Type="0" />
+      <Parameter Class='Double' Type="Width" Name="Width_f2(1270)">
+        <Value>0.1867</Value>
+      </Parameter>
+      <Parameter Class='Double' Type="MesonRadius" Name="Radius_rho">
+        <Value>2.5</Value>
+      </Parameter>
+    </DecayInfo>
+  </Particle>
+</ParticleList>
+)####";
+
+BOOST_AUTO_TEST_SUITE(BinaryData);
+
+BOOST_AUTO_TEST_CASE(CachedPhspSample) {
+  ComPWA::Logging Log("warning");
+
+  std::stringstream ParticlesStream(ModelParticles);
+  ParticleList PartL = readParticles(ParticlesStream);
+  Physics::HelicityFormalism::HelicityKinematics Kin(PartL, {443},
+                                                     {22, 111, 111});
+  Root::RootGenerator Gen(Kin.getParticleStateTransitionKinematicsInfo());
+  Root::RootUniformRealGenerator RandomGenerator(173);
+  auto PhspSample(generatePhsp(5000, Gen, RandomGenerator));
+  auto Sample = generatePhsp(100, Gen, RandomGenerator);
+
+  std::stringstream ModelStream(ModelXML);
+  boost::property_tree::ptree ModelTree;
+  boost::property_tree::xml_parser::read_xml(ModelStream, ModelTree);
+  auto evaluate =
+      [&](Physics::IntensityBuilderXML::PhspConverter ConvertPhspSample) {
+        Physics::IntensityBuilderXML Builder(
+            PartL, Kin, ModelTree.get_child("Intensity"), PhspSample,
+            ConvertPhspSample);
+        auto Intensity = Builder.createIntensity();
+        return Intensity.evaluate(convertEventsToDataSet(Sample, Kin).Data);
+      };
+
+  // the normalization is the same if the phsp sample is converted or read
+  // from the cache
+  Binary::DataSetCache Cache("DataSetCacheTest-cache");
+  auto ConvertCached = [&Cache](const std::vector<Event> &Events,
+                                const Kinematics &Kinematics,
+                                const std::vector<std::string> &UsedNames) {
+    return Cache.convertEventsToDataSet(Events, Kinematics, UsedNames);
+  };
+  auto Expected = evaluate(nullptr);
+  BOOST_CHECK(evaluate(ConvertCached) == Expected);
+  BOOST_CHECK(evaluate(ConvertCached) == Expected);
+
+  // one entry for each normalization tree
+  std::size_t NumberOfEntries(0);
+  DIR *CacheDirectory = opendir("DataSetCacheTest-cache");
+  BOOST_REQUIRE(CacheDirectory);
+  while (dirent *Entry = readdir(CacheDirectory)) {
+    std::string Name(Entry->d_name);
+    if (Name == "." || Name == "..")
+      continue;
+    ++NumberOfEntries;
+    std::remove(("DataSetCacheTest-cache/" + Name).c_str());
+  }
+  closedir(CacheDirectory);
+  BOOST_CHECK(NumberOfEntries > 0);
+  BOOST_CHECK_EQUAL(rmdir("DataSetCacheTest-cache"), 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
+
+} // namespace Data
+} // namespace ComPWA
@@ -0,0 +1,65 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef DATA_CHUNKEDDATASET_HPP_
+#define DATA_CHUNKEDDATASET_HPP_
+
+#include <functional>
+#include <string>
+#include <vector>
+
+#include "Data/DataSet.hpp"
+
+namespace ComPWA {
+namespace Data {
+
+///
+/// \class ChunkedDataSet
+/// Interface for a data sample that is processed in consecutive chunks, e.g.
+/// because it does not fit into memory. Each chunk is a complete DataSet.
+/// Algorithms that accept a ChunkedDataSet accumulate their result over all
+/// chunks and never hold more than one chunk of intensities.
+///
+class ChunkedDataSet {
+public:
+  virtual ~ChunkedDataSet() = default;
+
+  /// Total number of events in all chunks.
+  virtual std::size_t size() const = 0;
+
+  virtual std::vector<std::string> getVariableNames() const = 0;
+
+  /// Call \p Function for each chunk in order.
+  virtual void
+  forEachChunk(const std::function<void(const DataSet &)> &Function) const = 0;
+};
+
+///
+/// \class SingleChunkDataSet
+/// Adapter for a resident DataSet, which is passed as a single chunk. The
+/// DataSet is not copied and has to outlive the adapter.
+///
+class SingleChunkDataSet : public ChunkedDataSet {
+public:
+  SingleChunkDataSet(const DataSet &Set_) : Set(Set_) {}
+
+  std::size_t size() const final { return Set.Weights.size(); }
+
+  std::vector<std::string> getVariableNames() const final {
+    return Set.VariableNames;
+  }
+
+  void forEachChunk(
+      const std::function<void(const DataSet &)> &Function) const final {
+    Function(Set);
+  }
+
+private:
+  const DataSet &Set;
+};
+
+} // namespace Data
+} // namespace ComPWA
+
+#endif
@@ -2,27 +2,133 @@
 // This file is part of the ComPWA framework, check
 // https://github.com/ComPWA/ComPWA/license.txt for details.
 
+#include <algorithm>
+#include <numeric>
+
 #include "DataSet.hpp"
+#include "Core/Exceptions.hpp"
 #include "Core/Kinematics.hpp"
 #include "Core/Logging.hpp"
 
+#include "ThirdParty/parallelstl/include/pstl/algorithm"
+#include "ThirdParty/parallelstl/include/pstl/execution"
+
 namespace ComPWA {
 namespace Data {
 
+namespace {
+
+/// Events are converted in blocks of this size. The blocks are distributed
+/// over the worker threads.
+const std::size_t BlockSize = 1024;
+
+std::vector<std::size_t> createBlocks(std::size_t NumberOfEvents) {
+  std::vector<std::size_t> Blocks((NumberOfEvents + BlockSize - 1) /
+                                  BlockSize);
+  std::iota(Blocks.begin(), Blocks.end(), 0);
+  return Blocks;
+}
+
+/// Flag the variables of \p Kinematics that are listed in
+/// \p UsedVariableNames.
+std::vector<char>
+findUsedVariables(const ComPWA::Kinematics &Kinematics,
+                  const std::vector<std::string> &UsedVariableNames) {
+  auto VariableNames = Kinematics.getKinematicVariableNames();
+  std::vector<char> IsUsed(VariableNames.size(), 0);
+  for (const auto &Name : UsedVariableNames) {
+    auto Found = std::find(VariableNames.begin(), VariableNames.end(), Name);
+    if (Found == VariableNames.end())
+      throw ComPWA::BadParameter(
+          "DataSet::convertEventsToDataSet() | Kinematics does not provide "
+          "the variable " +
+          Name + "!");
+    IsUsed[Found - VariableNames.begin()] = 1;
+  }
+  return IsUsed;
+}
+
+/// Convert the events [\p EventsBegin, \p EventsEnd) in parallel. The
+/// variables of event i are written to index i of the preallocated columns
+/// of \p Set, so that the worker threads fill disjoint ranges. Only the
+/// variables flagged in \p IsUsed are calculated, the columns of all other
+/// variables stay empty. If \p PhspMask is given, it is filled with the
+/// result of Kinematics::isWithinPhaseSpace() for each event.
+void convertInParallel(std::vector<Event>::const_iterator EventsBegin,
+                       std::vector<Event>::const_iterator EventsEnd,
+                       const ComPWA::Kinematics &Kinematics,
+                       const std::vector<char> &IsUsed, DataSet &Set,
+                       std::vector<char> *PhspMask) {
+  std::size_t NumberOfEvents = EventsEnd - EventsBegin;
+  Set.VariableNames = Kinematics.getKinematicVariableNames();
+  Set.Data = DataList(Set.VariableNames.size());
+  Set.Weights.resize(NumberOfEvents);
+  for (std::size_t var = 0; var < Set.Data.size(); ++var) {
+    if (IsUsed[var])
+      Set.Data[var].resize(NumberOfEvents);
+  }
+  if (PhspMask)
+    PhspMask->resize(NumberOfEvents);
+  if (!NumberOfEvents)
+    return;
+
+  // exceptions must not leave the parallel region, therefore the number of
+  // variables is checked once in advance
+  std::size_t NumberOfVariables =
+      Kinematics.convert(*EventsBegin).KinematicVariableList.size();
+  if (NumberOfVariables != Set.Data.size())
+    throw ComPWA::BadConfig(
+        "DataSet::convertEventsToDataSet() | Kinematics returns " +
+        std::to_string(NumberOfVariables) + " variables, but " +
+        std::to_string(Set.Data.size()) + " variable names!");
+
+  auto Blocks = createBlocks(NumberOfEvents);
+  std::for_each(pstl::execution::par, Blocks.begin(), Blocks.end(),
+                [&](std::size_t Block) {
+                  std::size_t Begin = Block * BlockSize;
+                  std::size_t End = std::min(Begin + BlockSize, NumberOfEvents);
+                  std::vector<double *> Columns;
+                  for (auto &Column : Set.Data)
+                    Columns.push_back(Column.size() ? Column.data() + Begin
+                                                    : nullptr);
+                  const Event *Evt = &*(EventsBegin + Begin);
+                  Kinematics.convert(Evt, Evt + (End - Begin), Columns,
+                                     PhspMask ? PhspMask->data() + Begin
+                                              : nullptr);
+                  for (std::size_t i = Begin; i < End; ++i)
+                    Set.Weights[i] = (EventsBegin + i)->Weight;
+                });
+}
+
+} // namespace
+
 std::vector<Event> reduceToPhaseSpace(const std::vector<Event> &Events,
                                       const ComPWA::Kinematics &Kinematics) {
-  std::vector<Event> tmp;
   LOG(INFO) << "DataSet::reduceToPhaseSpace(): "
                "Remove all events outside PHSP boundary from data sample.";
 
-  std::copy_if(Events.begin(), Events.end(), std::back_inserter(tmp),
-               [&](const Event &evt) {
-                 DataPoint point = Kinematics.convert(evt);
-                 return Kinematics.isWithinPhaseSpace(point);
-               });
+  // only the phase space check is needed, so no variable is requested
+  std::vector<double *> Columns(Kinematics.getKinematicVariableNames().size(),
+                                nullptr);
+  std::vector<char> PhspMask(Events.size());
+  auto Blocks = createBlocks(Events.size());
+  std::for_each(pstl::execution::par, Blocks.begin(), Blocks.end(),
+                [&](std::size_t Block) {
+                  std::size_t Begin = Block * BlockSize;
+                  std::size_t End = std::min(Begin + BlockSize, Events.size());
+                  Kinematics.convert(Events.data() + Begin,
+                                     Events.data() + End, Columns,
+                                     PhspMask.data() + Begin);
+                });
+  std::vector<Event> tmp;
+  tmp.reserve(std::count(PhspMask.begin(), PhspMask.end(), 1));
+  for (std::size_t i = 0; i < Events.size(); ++i) {
+    if (PhspMask[i])
+      tmp.push_back(Events[i]);
+  }
   LOG(INFO) << "reduceToPhaseSpace(): Removed " << Events.size() - tmp.size()
             << " from " << Events.size() << " Events ("
-            << (1.0 - tmp.size() / Events.size()) * 100 << "%).";
+            << (1.0 - 1.0 * tmp.size() / Events.size()) * 100 << "%).";
   return tmp;
 }
 
@@ -44,22 +150,10 @@ addIntensityWeights(std::shared_ptr<ComPWA::Intensity> Intensity,
 DataSet convertEventsToDataSet(std::vector<Event>::const_iterator EventsBegin,
                                std::vector<Event>::const_iterator EventsEnd,
                                const ComPWA::Kinematics &Kinematics) {
-  auto VariableNames = Kinematics.getKinematicVariableNames();
-  std::vector<std::vector<double>> Data(VariableNames.size());
-
-  std::vector<double> Weights;
-  for (auto evt = EventsBegin; evt != EventsEnd; ++evt) {
-    DataPoint p = Kinematics.convert(*evt);
-    auto data_it = Data.begin();
-    for (auto kinvar : p.KinematicVariableList) {
-      data_it->push_back(kinvar); // warning: past the end access possible
-      ++data_it;
-    }
-    Weights.push_back(evt->Weight);
-  }
-
-  return DataSet{
-      .Data = Data, .Weights = Weights, .VariableNames = VariableNames};
+  DataSet Set;
+  std::vector<char> IsUsed(Kinematics.getKinematicVariableNames().size(), 1);
+  convertInParallel(EventsBegin, EventsEnd, Kinematics, IsUsed, Set, nullptr);
+  return Set;
 }
 
 DataSet convertEventsToDataSet(const std::vector<Event> &Events,
@@ -67,5 +161,80 @@ DataSet convertEventsToDataSet(const std::vector<Event> &Events,
   return convertEventsToDataSet(Events.begin(), Events.end(), Kinematics);
 }
 
+DataSet
+convertEventsToDataSet(const std::vector<Event> &Events,
+                       const ComPWA::Kinematics &Kinematics,
+                       const std::vector<std::string> &UsedVariableNames) {
+  DataSet Set;
+  convertInParallel(Events.begin(), Events.end(), Kinematics,
+                    findUsedVariables(Kinematics, UsedVariableNames), Set,
+                    nullptr);
+  return Set;
+}
+
+DataSet
+convertEventsToDataSetWithinPhaseSpace(const std::vector<Event> &Events,
+                                       const ComPWA::Kinematics &Kinematics) {
+  return convertEventsToDataSetWithinPhaseSpace(
+      Events, Kinematics, Kinematics.getKinematicVariableNames());
+}
+
+DataSet convertEventsToDataSetWithinPhaseSpace(
+    const std::vector<Event> &Events, const ComPWA::Kinematics &Kinematics,
+    const std::vector<std::string> &UsedVariableNames) {
+  DataSet Converted;
+  std::vector<char> PhspMask;
+  convertInParallel(Events.begin(), Events.end(), Kinematics,
+                    findUsedVariables(Kinematics, UsedVariableNames),
+                    Converted, &PhspMask);
+
+  // determine the position of each block in the reduced data set
+  auto Blocks = createBlocks(Events.size());
+  std::vector<std::size_t> Offsets(Blocks.size() + 1, 0);
+  for (std::size_t Block = 0; Block < Blocks.size(); ++Block) {
+    auto MaskBegin = PhspMask.begin() + Block * BlockSize;
+    auto MaskEnd =
+        PhspMask.begin() + std::min((Block + 1) * BlockSize, Events.size());
+    Offsets[Block + 1] = Offsets[Block] + std::count(MaskBegin, MaskEnd, 1);
+  }
+
+  DataSet Set;
+  Set.VariableNames = Converted.VariableNames;
+  Set.Data = DataList(Set.VariableNames.size());
+  Set.Weights.resize(Offsets.back());
+  for (std::size_t var = 0; var < Set.Data.size(); ++var) {
+    if (Converted.Data[var].size())
+      Set.Data[var].resize(Offsets.back());
+  }
+  std::for_each(pstl::execution::par, Blocks.begin(), Blocks.end(),
+                [&](std::size_t Block) {
+                  std::size_t Position = Offsets[Block];
+                  std::size_t End =
+                      std::min((Block + 1) * BlockSize, Events.size());
+                  for (std::size_t i = Block * BlockSize; i < End; ++i) {
+                    if (!PhspMask[i])
+                      continue;
+                    for (std::size_t var = 0; var < Set.Data.size(); ++var) {
+                      if (Set.Data[var].size())
+                        Set.Data[var][Position] = Converted.Data[var][i];
+                    }
+                    Set.Weights[Position] = Converted.Weights[i];
+                    ++Position;
+                  }
+                });
+
+  LOG(INFO) << "convertEventsToDataSetWithinPhaseSpace(): Removed "
+            << Events.size() - Set.Weights.size() << " from " << Events.size()
+            << " Events.";
+  return Set;
+}
+
+DataSet convertEventsToDataSet(const EventCollection &Events,
+                               const ComPWA::Kinematics &Kinematics) {
+  return DataSet{.Data = Kinematics.convert(Events),
+                 .Weights = Events.Weights,
+                 .VariableNames = Kinematics.getKinematicVariableNames()};
+}
+
 } // namespace Data
 } // namespace ComPWA
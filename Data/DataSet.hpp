@@ -6,9 +6,11 @@
 #define DATA_DATASET_HPP_
 
 #include <memory>
+#include <string>
 #include <vector>
 
 #include "Core/Event.hpp"
+#include "Core/EventCollection.hpp"
 #include "Core/Function.hpp"
 
 namespace ComPWA {
@@ -38,6 +40,8 @@ addIntensityWeights(std::shared_ptr<ComPWA::Intensity> Intensity,
                     const std::vector<Event> &Events,
                     const ComPWA::Kinematics &Kinematics);
 
+/// Convert \p Events into a DataSet. The events are converted in parallel
+/// and written directly into the preallocated columns.
 DataSet convertEventsToDataSet(std::vector<Event>::const_iterator EventsBegin,
                                std::vector<Event>::const_iterator EventsEnd,
                                const ComPWA::Kinematics &Kinematics);
@@ -45,6 +49,33 @@ DataSet convertEventsToDataSet(std::vector<Event>::const_iterator EventsBegin,
 DataSet convertEventsToDataSet(const std::vector<Event> &Events,
                                const ComPWA::Kinematics &Kinematics);
 
+/// Convert \p Events into a DataSet, but calculate only the kinematic
+/// variables listed in \p UsedVariableNames, e.g. the variables returned by
+/// FunctionTreeIntensity::getUsedDataVariableNames(). The DataSet contains a
+/// column for each kinematic variable, so that the positions still match the
+/// data containers of the model, but the columns of the unused variables are
+/// empty.
+DataSet
+convertEventsToDataSet(const std::vector<Event> &Events,
+                       const ComPWA::Kinematics &Kinematics,
+                       const std::vector<std::string> &UsedVariableNames);
+
+/// Convert \p Events into a DataSet and drop events outside of the phase
+/// space in the same pass. Equivalent to (but faster than)
+/// convertEventsToDataSet(reduceToPhaseSpace(Events, Kinematics), Kinematics).
+DataSet
+convertEventsToDataSetWithinPhaseSpace(const std::vector<Event> &Events,
+                                       const ComPWA::Kinematics &Kinematics);
+
+/// Same as above, but only the variables listed in \p UsedVariableNames are
+/// calculated and stored (see convertEventsToDataSet()).
+DataSet convertEventsToDataSetWithinPhaseSpace(
+    const std::vector<Event> &Events, const ComPWA::Kinematics &Kinematics,
+    const std::vector<std::string> &UsedVariableNames);
+
+DataSet convertEventsToDataSet(const EventCollection &Events,
+                               const ComPWA::Kinematics &Kinematics);
+
 } // namespace Data
 } // namespace ComPWA
 
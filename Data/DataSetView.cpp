@@ -0,0 +1,132 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+
+#include "DataSetView.hpp"
+#include "Core/Exceptions.hpp"
+
+namespace ComPWA {
+namespace Data {
+
+DataSetView::DataSetView(const DataSet &Set_,
+                         std::vector<std::size_t> Indices_,
+                         std::vector<double> ReplicaWeights_)
+    : Set(Set_), Indices(std::move(Indices_)),
+      ReplicaWeights(std::move(ReplicaWeights_)) {
+  for (auto Index : Indices) {
+    if (Index >= Set.Weights.size())
+      throw ComPWA::BadParameter(
+          "DataSetView::DataSetView() | Index " + std::to_string(Index) +
+          " is out of range of the DataSet with " +
+          std::to_string(Set.Weights.size()) + " events!");
+  }
+  if (!ReplicaWeights.empty() && ReplicaWeights.size() != size())
+    throw ComPWA::BadParameter(
+        "DataSetView::DataSetView() | Number of replica weights (" +
+        std::to_string(ReplicaWeights.size()) +
+        ") does not match the number of entries (" + std::to_string(size()) +
+        ")!");
+}
+
+double DataSetView::getNumberOfEvents() const {
+  if (ReplicaWeights.empty())
+    return size();
+  return std::accumulate(ReplicaWeights.begin(), ReplicaWeights.end(), 0.0);
+}
+
+std::vector<double>
+DataSetView::select(const std::vector<double> &EventValues) const {
+  if (Indices.empty())
+    return EventValues;
+  std::vector<double> Values(Indices.size());
+  for (std::size_t i = 0; i < Indices.size(); ++i)
+    Values[i] = EventValues[Indices[i]];
+  return Values;
+}
+
+std::vector<double> DataSetView::getFoldedWeights() const {
+  if (Indices.empty() && ReplicaWeights.empty())
+    return Set.Weights;
+  std::vector<double> Weights(Set.Weights.size(), 0.0);
+  for (std::size_t i = 0; i < size(); ++i) {
+    std::size_t Index = Indices.empty() ? i : Indices[i];
+    double ReplicaWeight = ReplicaWeights.empty() ? 1.0 : ReplicaWeights[i];
+    Weights[Index] += Set.Weights[Index] * ReplicaWeight;
+  }
+  return Weights;
+}
+
+DataSet DataSetView::getFoldedDataSet() const {
+  auto FoldedWeights = getFoldedWeights();
+  std::vector<std::size_t> Events;
+  for (std::size_t i = 0; i < FoldedWeights.size(); ++i) {
+    if (FoldedWeights[i] != 0.0)
+      Events.push_back(i);
+  }
+
+  DataSet Folded;
+  Folded.VariableNames = Set.VariableNames;
+  Folded.Data.resize(Set.Data.size());
+  for (std::size_t Column = 0; Column < Set.Data.size(); ++Column) {
+    if (Set.Data[Column].empty())
+      continue;
+    Folded.Data[Column].reserve(Events.size());
+    for (auto i : Events)
+      Folded.Data[Column].push_back(Set.Data[Column][i]);
+  }
+  Folded.Weights.reserve(Events.size());
+  for (auto i : Events)
+    Folded.Weights.push_back(FoldedWeights[i]);
+  return Folded;
+}
+
+DataSetView createPoissonBootstrapView(const DataSet &Set, unsigned int Seed) {
+  std::mt19937 Generator(Seed);
+  std::poisson_distribution<int> Distribution(1.0);
+  std::vector<double> ReplicaWeights(Set.Weights.size());
+  for (auto &Weight : ReplicaWeights)
+    Weight = Distribution(Generator);
+  return DataSetView(Set, {}, std::move(ReplicaWeights));
+}
+
+DataSetView createMultinomialBootstrapView(const DataSet &Set,
+                                           unsigned int Seed) {
+  std::vector<double> ReplicaWeights(Set.Weights.size(), 0.0);
+  if (!Set.Weights.empty()) {
+    std::mt19937 Generator(Seed);
+    std::uniform_int_distribution<std::size_t> Distribution(
+        0, Set.Weights.size() - 1);
+    for (std::size_t i = 0; i < Set.Weights.size(); ++i)
+      ReplicaWeights[Distribution(Generator)] += 1.0;
+  }
+  return DataSetView(Set, {}, std::move(ReplicaWeights));
+}
+
+DataSetView createJackknifeView(const DataSet &Set, std::size_t NumberOfBlocks,
+                                std::size_t Block) {
+  if (Block >= NumberOfBlocks)
+    throw ComPWA::BadParameter("createJackknifeView() | Block " +
+                               std::to_string(Block) +
+                               " does not exist, there are only " +
+                               std::to_string(NumberOfBlocks) + " blocks!");
+  std::size_t NumberOfEvents = Set.Weights.size();
+  std::vector<double> ReplicaWeights(NumberOfEvents, 1.0);
+  std::size_t Begin = NumberOfEvents * Block / NumberOfBlocks;
+  std::size_t End = NumberOfEvents * (Block + 1) / NumberOfBlocks;
+  std::fill(ReplicaWeights.begin() + Begin, ReplicaWeights.begin() + End, 0.0);
+  return DataSetView(Set, {}, std::move(ReplicaWeights));
+}
+
+std::vector<double> evaluate(ComPWA::Intensity &Intensity,
+                             const DataSetView &View) {
+  return View.select(Intensity.evaluate(View.getDataSet().Data));
+}
+
+} // namespace Data
+} // namespace ComPWA
@@ -0,0 +1,95 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef DATA_DATASETVIEW_HPP_
+#define DATA_DATASETVIEW_HPP_
+
+#include <cstddef>
+#include <vector>
+
+#include "Data/DataSet.hpp"
+
+namespace ComPWA {
+namespace Data {
+
+///
+/// \class DataSetView
+/// Resampled version of a DataSet that does not copy its columns. The entries
+/// of the view refer to events of the DataSet through an index array (empty
+/// for the events in their original order) and carry an additional replica
+/// weight (empty if all replica weights are one). A bootstrap replica is
+/// therefore either an index array drawn with replacement or just a vector
+/// of replica weights on the unchanged sample.
+///
+/// Algorithms that accept a DataSetView evaluate the intensity once on the
+/// columns of the DataSet and map the result to the entries. An entry with
+/// replica weight r counts like r copies of its event. The DataSet is not
+/// copied and has to outlive the view.
+///
+class DataSetView {
+public:
+  DataSetView(const DataSet &Set_, std::vector<std::size_t> Indices_ = {},
+              std::vector<double> ReplicaWeights_ = {});
+
+  /// Number of entries of the view.
+  std::size_t size() const {
+    return Indices.empty() ? Set.Weights.size() : Indices.size();
+  }
+
+  /// Number of events of the replica, i.e. the sum of the replica weights.
+  double getNumberOfEvents() const;
+
+  const DataSet &getDataSet() const { return Set; }
+  const std::vector<std::size_t> &getIndices() const { return Indices; }
+  const std::vector<double> &getReplicaWeights() const {
+    return ReplicaWeights;
+  }
+
+  /// Map \p EventValues, one value for each event of the DataSet, to the
+  /// entries of the view.
+  std::vector<double> select(const std::vector<double> &EventValues) const;
+
+  /// Weights of the entries without the replica weights.
+  std::vector<double> getWeights() const { return select(Set.Weights); }
+
+  /// Weight of each event of the DataSet, summed over all entries that refer
+  /// to the event and multiplied by the replica weights. Sums over the view
+  /// that are linear in the weights can be calculated on the DataSet with
+  /// these weights.
+  std::vector<double> getFoldedWeights() const;
+
+  /// Copy of the events of the DataSet with a non-zero folded weight, which
+  /// is their weight in the copy. Empty columns stay empty.
+  DataSet getFoldedDataSet() const;
+
+private:
+  const DataSet &Set;
+  std::vector<std::size_t> Indices;
+  std::vector<double> ReplicaWeights;
+};
+
+/// Bootstrap replica of \p Set with replica weights drawn from a Poisson
+/// distribution with mean one.
+DataSetView createPoissonBootstrapView(const DataSet &Set, unsigned int Seed);
+
+/// Bootstrap replica of \p Set that draws as many events with replacement as
+/// \p Set contains. The number of draws of each event is its replica weight.
+DataSetView createMultinomialBootstrapView(const DataSet &Set,
+                                           unsigned int Seed);
+
+/// Jackknife replica of \p Set, which is split into \p NumberOfBlocks blocks
+/// of consecutive events. The events of block \p Block get the replica
+/// weight zero.
+DataSetView createJackknifeView(const DataSet &Set, std::size_t NumberOfBlocks,
+                                std::size_t Block);
+
+/// Intensities of the entries of \p View. The intensity is evaluated on the
+/// columns of the DataSet.
+std::vector<double> evaluate(ComPWA::Intensity &Intensity,
+                             const DataSetView &View);
+
+} // namespace Data
+} // namespace ComPWA
+
+#endif
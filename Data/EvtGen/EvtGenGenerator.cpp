@@ -49,6 +49,29 @@ ComPWA::Event EvtGenGenerator::generate(UniformRealNumberGenerator &gen) const {
   return evt;
 }
 
+ComPWA::EventCollection
+EvtGenGenerator::generate(unsigned int NumberOfEvents,
+                          UniformRealNumberGenerator &gen) const {
+  RandomEngine->setRandomNumberGenerator(gen);
+  auto Events = ComPWA::createEventCollection(
+      std::vector<int>(FinalStateMasses.size(), 0));
+  ComPWA::resize(Events, NumberOfEvents);
+
+  std::vector<EvtVector4R> FourVectors(FinalStateMasses.size());
+  for (unsigned int i = 0; i < NumberOfEvents; ++i) {
+    Events.Weights[i] = EvtGenKine::PhaseSpace(
+        FinalStateMasses.size(), (double *)(&FinalStateMasses[0]), // const cast
+        &FourVectors[0], CMSP4.invMass());
+    for (std::size_t j = 0; j < FourVectors.size(); ++j) {
+      Events.FourMomenta[j].Px[i] = FourVectors[j].get(1);
+      Events.FourMomenta[j].Py[i] = FourVectors[j].get(2);
+      Events.FourMomenta[j].Pz[i] = FourVectors[j].get(3);
+      Events.FourMomenta[j].E[i] = FourVectors[j].get(0);
+    }
+  }
+  return Events;
+}
+
 EvtGenStdRandomEngine::EvtGenStdRandomEngine() : NumberGenerator(nullptr) {}
 
 void EvtGenStdRandomEngine::setRandomNumberGenerator(
@@ -45,6 +45,11 @@ public:
       const Physics::ParticleStateTransitionKinematicsInfo &KinematicsInfo);
 
   ComPWA::Event generate(UniformRealNumberGenerator &gen) const final;
+
+  /// Generate \p NumberOfEvents events directly into the columns of the
+  /// EventCollection, without creating intermediate Events.
+  ComPWA::EventCollection generate(unsigned int NumberOfEvents,
+                                   UniformRealNumberGenerator &gen) const final;
 };
 
 } // namespace EvtGen
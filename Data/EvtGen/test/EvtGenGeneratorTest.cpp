@@ -102,4 +102,29 @@ BOOST_AUTO_TEST_CASE(EvtGenGeneratorPrecisionTest) {
                 {0.1, 0.5, 0.2, 0.3, 0.1, 0.2}, std::make_pair(100, 20),
                 std::make_pair(90, 95));
 };
+
+BOOST_AUTO_TEST_CASE(EvtGenGeneratorEventCollectionTest) {
+  ComPWA::FourMomentum CMSP4(0.0, 0.0, 0.0, 3.0);
+  std::vector<double> masses{0.2, 0.3, 0.4};
+  auto EventGenerator = ComPWA::Data::EvtGen::EvtGenGenerator(CMSP4, masses);
+  unsigned int NumberOfEvents(1000);
+
+  ComPWA::StdUniformRealGenerator RandomGenerator(1234);
+  std::vector<ComPWA::Event> Events;
+  for (unsigned int i = 0; i < NumberOfEvents; ++i)
+    Events.push_back(EventGenerator.generate(RandomGenerator));
+
+  RandomGenerator.setSeed(1234);
+  auto Collection = EventGenerator.generate(NumberOfEvents, RandomGenerator);
+
+  BOOST_CHECK_EQUAL(Collection.size(), NumberOfEvents);
+  BOOST_CHECK_EQUAL(Collection.numberOfParticles(), masses.size());
+  for (unsigned int i = 0; i < NumberOfEvents; ++i) {
+    BOOST_CHECK_EQUAL(Collection.Weights[i], Events[i].Weight);
+    for (unsigned int j = 0; j < masses.size(); ++j)
+      BOOST_CHECK_EQUAL(ComPWA::fourMomentum(Collection, j, i),
+                        Events[i].ParticleList[j].fourMomentum());
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
@@ -5,87 +5,348 @@
 // Root-Headers
 #include "RootDataIO.hpp"
 
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
 #include "TChain.h"
 #include "TClonesArray.h"
 #include "TFile.h"
 #include "TLorentzVector.h"
 #include "TParticle.h"
 #include "TParticlePDG.h"
+#include "TROOT.h"
+#include "TTreeReader.h"
+#include "TTreeReaderArray.h"
+#include "TTreeReaderValue.h"
 
 #include "Core/Generator.hpp"
 #include "Core/Kinematics.hpp"
 #include "Core/Logging.hpp"
 #include "Core/Properties.hpp"
 
+#include "ThirdParty/parallelstl/include/pstl/algorithm"
+#include "ThirdParty/parallelstl/include/pstl/execution"
+
 namespace ComPWA {
 namespace Data {
 namespace Root {
 
-RootDataIO::RootDataIO(const std::string TreeName_, std::size_t NumberEventsToProcess_)
-    : TreeName(TreeName_), NumberEventsToProcess(NumberEventsToProcess_) {}
+namespace {
 
-std::vector<ComPWA::Event>
-RootDataIO::readData(const std::string &InputFilePath) const {
-  /// @todo Use of `TChain` in this way may result in run-time errors for larger
-  /// data samples.
-  TChain chain(TreeName.c_str());
-  chain.Add(InputFilePath.c_str());
-  if (!chain.GetListOfFiles()->GetEntriesFast())
-    throw std::runtime_error("RootDataIO::RootDataIO() | "
-                             "Unable to load files: " +
-                             InputFilePath);
+/// Entries are read in tasks of at most this size. The tasks are distributed
+/// over the worker threads.
+const Long64_t EntriesPerTask = 100000;
+
+/// The entries [Begin, End) of the tree in FileName, which are stored
+/// starting at index Offset of the output.
+struct ReadTask {
+  std::string FileName;
+  Long64_t Begin;
+  Long64_t End;
+  std::size_t Offset;
+};
+
+/// Particles and weight of a single entry in structure of arrays layout.
+struct EntryBuffer {
+  std::vector<double> Px;
+  std::vector<double> Py;
+  std::vector<double> Pz;
+  std::vector<double> E;
+  std::vector<int> Pids;
+  double Weight;
+
+  void resize(std::size_t Size) {
+    Px.resize(Size);
+    Py.resize(Size);
+    Pz.resize(Size);
+    E.resize(Size);
+    Pids.resize(Size);
+  }
+};
 
-  if (!chain.GetEntriesFast())
-    throw std::runtime_error("RootDataIO::RootDataIO() | Tree \"" + TreeName +
-                             "\" can not be opened from file " + InputFilePath +
+/// Open the tree \p TreeName of the file \p FileName, which is kept open by
+/// \p File.
+TTree *openTree(const std::string &FileName, const std::string &TreeName,
+                std::unique_ptr<TFile> &File, const std::string &Caller) {
+  File.reset(TFile::Open(FileName.c_str()));
+  TTree *Tree(nullptr);
+  if (File && !File->IsZombie())
+    File->GetObject(TreeName.c_str(), Tree);
+  if (!Tree)
+    throw std::runtime_error(Caller + " | Tree \"" + TreeName +
+                             "\" can not be opened from file " + FileName +
                              "!");
+  return Tree;
+}
+
+/// Run \p task(i) for i in [0, NumberOfTasks) in parallel. Errors are
+/// collected and rethrown after all tasks are done, because exceptions must
+/// not leave the parallel region.
+template <typename TaskFunction>
+void runInParallel(std::size_t NumberOfTasks, const TaskFunction &task) {
+  ROOT::EnableThreadSafety();
+  std::vector<std::string> Errors(NumberOfTasks);
+  std::vector<std::size_t> TaskIDs(NumberOfTasks);
+  std::iota(TaskIDs.begin(), TaskIDs.end(), 0);
+  std::for_each(pstl::execution::par, TaskIDs.begin(), TaskIDs.end(),
+                [&](std::size_t TaskID) {
+                  try {
+                    task(TaskID);
+                  } catch (std::exception &ex) {
+                    Errors[TaskID] = ex.what();
+                  }
+                });
+  for (const auto &Error : Errors) {
+    if (!Error.empty())
+      throw std::runtime_error(Error);
+  }
+}
+
+/// Split the first \p NumberEventsToProcess entries (all if 0 or larger than
+/// the number of entries) of the trees in the files matching \p InputFilePath
+/// into read tasks. The files are opened in parallel to count their entries.
+std::vector<ReadTask> createReadTasks(const std::string &TreeName,
+                                      const std::string &InputFilePath,
+                                      std::size_t NumberEventsToProcess,
+                                      const std::string &Caller) {
+  // the wildcards are expanded by TChain
+  TChain Chain(TreeName.c_str());
+  Chain.Add(InputFilePath.c_str());
+  TObjArray *Files = Chain.GetListOfFiles();
+  if (!Files->GetEntriesFast())
+    throw std::runtime_error(Caller + " | Unable to load files: " +
+                             InputFilePath);
+  std::vector<std::string> FileNames;
+  for (int i = 0; i < Files->GetEntriesFast(); ++i)
+    FileNames.push_back(Files->At(i)->GetTitle());
+
+  std::vector<Long64_t> FileEntries(FileNames.size());
+  runInParallel(FileNames.size(), [&](std::size_t i) {
+    std::unique_ptr<TFile> File;
+    FileEntries[i] =
+        openTree(FileNames[i], TreeName, File, Caller)->GetEntries();
+  });
+
+  Long64_t NumberEventsToRead = std::numeric_limits<Long64_t>::max();
+  if (NumberEventsToProcess > 0 &&
+      NumberEventsToProcess < static_cast<std::size_t>(NumberEventsToRead))
+    NumberEventsToRead = NumberEventsToProcess;
 
-  // TTree branch variables
+  std::vector<ReadTask> Tasks;
+  std::size_t Offset(0);
+  for (std::size_t i = 0; i < FileNames.size() && NumberEventsToRead; ++i) {
+    Long64_t Entries = std::min(FileEntries[i], NumberEventsToRead);
+    NumberEventsToRead -= Entries;
+    for (Long64_t Begin = 0; Begin < Entries; Begin += EntriesPerTask) {
+      Long64_t End = std::min(Begin + EntriesPerTask, Entries);
+      Tasks.push_back(ReadTask{FileNames[i], Begin, End, Offset});
+      Offset += End - Begin;
+    }
+  }
+  if (Tasks.empty())
+    throw std::runtime_error(Caller + " | Tree \"" + TreeName +
+                             "\" can not be opened from file " +
+                             InputFilePath + "!");
+  return Tasks;
+}
+
+/// Read the entries of \p Task and call \p store(Index, Buffer) for each of
+/// them. If the particles are stored in split mode (the default of
+/// writeData()), only the momenta and ids are read from their branches, so
+/// that no TParticle objects have to be created. Otherwise the TClonesArray
+/// is read.
+template <typename StoreFunction>
+void readEntries(const ReadTask &Task, const std::string &TreeName,
+                 const StoreFunction &store) {
+  std::unique_ptr<TFile> File;
+  TTree *Tree =
+      openTree(Task.FileName, TreeName, File, "RootDataIO::readEntries()");
+
+  EntryBuffer Buffer;
+  std::size_t Index(Task.Offset);
+  if (Tree->GetBranch("Particles.fPx")) {
+    TTreeReader Reader(Tree);
+    TTreeReaderArray<Double_t> Px(Reader, "Particles.fPx");
+    TTreeReaderArray<Double_t> Py(Reader, "Particles.fPy");
+    TTreeReaderArray<Double_t> Pz(Reader, "Particles.fPz");
+    TTreeReaderArray<Double_t> E(Reader, "Particles.fE");
+    TTreeReaderArray<Int_t> Pids(Reader, "Particles.fPdgCode");
+    TTreeReaderValue<Double_t> Weight(Reader, "weight");
+    if (Reader.SetEntriesRange(Task.Begin, Task.End) !=
+        TTreeReader::kEntryValid)
+      throw std::runtime_error("RootDataIO::readEntries() | Can not read "
+                               "entries of file " +
+                               Task.FileName + "!");
+    while (Reader.Next()) {
+      std::size_t Size = Px.GetSize();
+      Buffer.resize(Size);
+      for (std::size_t part = 0; part < Size; ++part) {
+        Buffer.Px[part] = Px[part];
+        Buffer.Py[part] = Py[part];
+        Buffer.Pz[part] = Pz[part];
+        Buffer.E[part] = E[part];
+        Buffer.Pids[part] = Pids[part];
+      }
+      Buffer.Weight = *Weight;
+      store(Index++, Buffer);
+    }
+  } else {
+    TClonesArray Particles("TParticle");
+    TClonesArray *pParticles(&Particles);
+    double feventWeight;
+    Tree->GetBranch("Particles")->SetAutoDelete(false);
+    Tree->SetBranchAddress("Particles", &pParticles);
+    Tree->SetBranchAddress("weight", &feventWeight);
+    TLorentzVector inN;
+    for (Long64_t i = Task.Begin; i < Task.End; ++i) {
+      Particles.Clear();
+      Tree->GetEntry(i);
+      Buffer.resize(0);
+      for (auto part = 0; part < Particles.GetEntriesFast(); part++) {
+        auto partN = (TParticle *)Particles.At(part);
+        if (!partN)
+          continue;
+        partN->Momentum(inN);
+        Buffer.Px.push_back(inN.X());
+        Buffer.Py.push_back(inN.Y());
+        Buffer.Pz.push_back(inN.Z());
+        Buffer.E.push_back(inN.E());
+        Buffer.Pids.push_back(partN->GetPdgCode());
+      }
+      Buffer.Weight = feventWeight;
+      store(Index++, Buffer);
+    }
+    Tree->ResetBranchAddresses();
+  }
+  if (Index != Task.Offset + (Task.End - Task.Begin))
+    throw std::runtime_error("RootDataIO::readEntries() | Error reading "
+                             "entries of file " +
+                             Task.FileName + "!");
+}
+
+/// Run readEntries() for all \p Tasks in parallel.
+template <typename StoreFunction>
+void readInParallel(const std::vector<ReadTask> &Tasks,
+                    const std::string &TreeName, const StoreFunction &store) {
+  runInParallel(Tasks.size(), [&](std::size_t TaskID) {
+    readEntries(Tasks[TaskID], TreeName, store);
+  });
+}
+
+/// Write \p NumberOfEvents entries to the tree \p TreeName of the new file
+/// \p OutputFilePath. The particles and the weight of entry i are filled
+/// into the buffer by \p fill(i, Buffer). The particles are stored as
+/// TParticles, whose mother momentum is the invariant mass of the event at
+/// rest.
+template <typename FillFunction>
+void writeEntries(const std::string &TreeName,
+                  const std::string &OutputFilePath, std::size_t NumberOfEvents,
+                  const FillFunction &fill) {
+  TFile File(OutputFilePath.c_str(), "RECREATE");
+  if (File.IsZombie())
+    throw std::runtime_error("RootDataIO::writeData(): can't open data file: " +
+                             OutputFilePath);
+
+  // TTree branch variables, the particles outlive the tree
   TClonesArray Particles("TParticle");
   TClonesArray *pParticles(&Particles);
   double feventWeight;
+  int fFlavour(0);
 
-  chain.GetBranch("Particles")->SetAutoDelete(false);
-  chain.SetBranchAddress("Particles", &pParticles);
-  chain.SetBranchAddress("weight", &feventWeight);
+  TTree Tree(TreeName.c_str(), TreeName.c_str());
+  Tree.Branch("Particles", &pParticles);
+  Tree.Branch("weight", &feventWeight, "weight/D");
+  Tree.Branch("flavour", &fFlavour, "flavour/I");
 
-  unsigned int NumberEventsToRead(NumberEventsToProcess);
-  if (NumberEventsToProcess <= 0 || NumberEventsToProcess > chain.GetEntries())
-    NumberEventsToRead = chain.GetEntries();
+  EntryBuffer Buffer;
+  for (std::size_t evt = 0; evt < NumberOfEvents; ++evt) {
+    fill(evt, Buffer);
+    Particles.Clear();
+    feventWeight = Buffer.Weight;
 
-  std::vector<ComPWA::Event> Events;
-  Events.reserve(NumberEventsToRead);
+    FourMomentum MotherP4;
+    for (std::size_t i = 0; i < Buffer.Pids.size(); ++i)
+      MotherP4 +=
+          FourMomentum(Buffer.Px[i], Buffer.Py[i], Buffer.Pz[i], Buffer.E[i]);
+    TLorentzVector motherMomentum(0, 0, 0, MotherP4.invMass());
+    for (std::size_t i = 0; i < Buffer.Pids.size(); ++i) {
+      TLorentzVector oldMomentum(Buffer.Px[i], Buffer.Py[i], Buffer.Pz[i],
+                                 Buffer.E[i]);
+      new (Particles[i]) TParticle(Buffer.Pids[i], 1, 0, 0, 0, 0, oldMomentum,
+                                   motherMomentum);
+    }
+    Tree.Fill();
+  }
+  Tree.Write("", TObject::kOverwrite, 0);
+  File.Close();
+}
 
-  for (unsigned int i = 0; i < NumberEventsToRead; ++i) {
-    Event evt;
-    Particles.Clear();
-    chain.GetEntry(i);
+} // namespace
 
-    // Get number of particle in TClonesrray
-    auto nParts = Particles.GetEntriesFast();
+RootDataIO::RootDataIO(const std::string TreeName_,
+                       std::size_t NumberEventsToProcess_)
+    : TreeName(TreeName_), NumberEventsToProcess(NumberEventsToProcess_) {}
 
-    TParticle *partN;
-    TLorentzVector inN;
-    for (auto part = 0; part < nParts; part++) {
-      partN = 0;
-      partN = (TParticle *)Particles.At(part);
-      if (!partN)
-        continue;
-      partN->Momentum(inN);
-      evt.ParticleList.push_back(
-          Particle(inN.X(), inN.Y(), inN.Z(), inN.E(), partN->GetPdgCode()));
-    } // particle loop
-    evt.Weight = feventWeight;
-
-    Events.push_back(evt);
-  } // end event loop
+std::vector<ComPWA::Event>
+RootDataIO::readData(const std::string &InputFilePath) const {
+  auto Tasks = createReadTasks(TreeName, InputFilePath, NumberEventsToProcess,
+                               "RootDataIO::readData()");
+  std::vector<ComPWA::Event> Events(Tasks.back().Offset + Tasks.back().End -
+                                    Tasks.back().Begin);
+  readInParallel(Tasks, TreeName,
+                 [&Events](std::size_t i, const EntryBuffer &Buffer) {
+                   Event &evt = Events[i];
+                   evt.ParticleList.reserve(Buffer.Pids.size());
+                   for (std::size_t part = 0; part < Buffer.Pids.size();
+                        ++part)
+                     evt.ParticleList.push_back(
+                         Particle(Buffer.Px[part], Buffer.Py[part],
+                                  Buffer.Pz[part], Buffer.E[part],
+                                  Buffer.Pids[part]));
+                   evt.Weight = Buffer.Weight;
+                 });
+  return Events;
+}
+
+ComPWA::EventCollection
+RootDataIO::readEventCollection(const std::string &InputFilePath) const {
+  auto Tasks = createReadTasks(TreeName, InputFilePath, NumberEventsToProcess,
+                               "RootDataIO::readEventCollection()");
 
+  // the final state (and therefore the particle ids) is taken from the first
+  // event
+  std::vector<int> Pids;
+  ReadTask FirstEntry(Tasks.front());
+  FirstEntry.End = FirstEntry.Begin + 1;
+  readEntries(FirstEntry, TreeName,
+              [&Pids](std::size_t, const EntryBuffer &Buffer) {
+                Pids = Buffer.Pids;
+              });
+
+  auto Events = ComPWA::createEventCollection(Pids);
+  ComPWA::resize(Events, Tasks.back().Offset + Tasks.back().End -
+                             Tasks.back().Begin);
+  auto storeEntry = [&Events, &Pids](std::size_t i, const EntryBuffer &Buffer) {
+    if (Buffer.Pids.size() != Pids.size())
+      throw std::runtime_error(
+          "RootDataIO::readEventCollection() | Event " + std::to_string(i) +
+          " has a different number of particles than the first event!");
+    for (unsigned int part = 0; part < Pids.size(); part++) {
+      auto &Columns = Events.FourMomenta[part];
+      Columns.Px[i] = Buffer.Px[part];
+      Columns.Py[i] = Buffer.Py[part];
+      Columns.Pz[i] = Buffer.Pz[part];
+      Columns.E[i] = Buffer.E[part];
+    }
+    Events.Weights[i] = Buffer.Weight;
+  };
+  readInParallel(Tasks, TreeName, storeEntry);
   return Events;
 }
 
 void RootDataIO::writeData(const std::vector<ComPWA::Event> &Events,
                            const std::string &OutputFilePath) const {
-
   LOG(INFO) << "RootDataIO::writeData(): writing current "
                "vector of events to file "
             << OutputFilePath;
@@ -95,41 +356,49 @@ void RootDataIO::writeData(const std::vector<ComPWA::Event> &Events,
     return;
   }
 
-  TFile File(OutputFilePath.c_str(), "RECREATE");
-  if (File.IsZombie())
-    throw std::runtime_error("RootDataIO::writeData(): can't open data file: " +
-                             OutputFilePath);
+  writeEntries(TreeName, OutputFilePath, Events.size(),
+               [&Events](std::size_t i, EntryBuffer &Buffer) {
+                 const Event &evt = Events[i];
+                 Buffer.resize(evt.ParticleList.size());
+                 for (std::size_t part = 0; part < evt.ParticleList.size();
+                      ++part) {
+                   const Particle &x(evt.ParticleList[part]);
+                   auto FourMom(x.fourMomentum());
+                   Buffer.Px[part] = FourMom.px();
+                   Buffer.Py[part] = FourMom.py();
+                   Buffer.Pz[part] = FourMom.pz();
+                   Buffer.E[part] = FourMom.e();
+                   Buffer.Pids[part] = x.pid();
+                 }
+                 Buffer.Weight = evt.Weight;
+               });
+}
 
-  // TTree branch variables
-  TClonesArray *fParticles;
-  double feventWeight;
-  int fFlavour;
+void RootDataIO::writeData(const ComPWA::EventCollection &Events,
+                           const std::string &OutputFilePath) const {
+  LOG(INFO) << "RootDataIO::writeData(): writing current "
+               "collection of events to file "
+            << OutputFilePath;
 
-  TTree Tree(TreeName.c_str(), TreeName.c_str());
-  unsigned int numPart = Events[0].ParticleList.size();
-  fParticles = new TClonesArray("TParticle", numPart);
-  Tree.Branch("Particles", &fParticles);
-  Tree.Branch("weight", &feventWeight, "weight/D");
-  Tree.Branch("flavour", &fFlavour, "flavour/I");
-  TClonesArray &partArray = *fParticles;
-
-  for (auto const &evt : Events) {
-    fParticles->Clear();
-    feventWeight = evt.Weight;
-
-    TLorentzVector motherMomentum(0, 0, 0, ComPWA::calculateInvariantMass(evt));
-    for (unsigned int i = 0; i < evt.ParticleList.size(); ++i) {
-      const Particle &x(evt.ParticleList[i]);
-      auto FourMom(x.fourMomentum());
-      TLorentzVector oldMomentum(FourMom.px(), FourMom.py(), FourMom.pz(),
-                                 FourMom.e());
-      new (partArray[i])
-          TParticle(x.pid(), 1, 0, 0, 0, 0, oldMomentum, motherMomentum);
-    }
-    Tree.Fill();
+  if (0 == Events.size()) {
+    LOG(ERROR) << "RootDataIO::writeData(): no events given!";
+    return;
   }
-  Tree.Write("", TObject::kOverwrite, 0);
-  File.Close();
+
+  unsigned int numPart = Events.numberOfParticles();
+  writeEntries(TreeName, OutputFilePath, Events.size(),
+               [&Events, numPart](std::size_t i, EntryBuffer &Buffer) {
+                 Buffer.resize(numPart);
+                 for (unsigned int part = 0; part < numPart; ++part) {
+                   const auto &Columns = Events.FourMomenta[part];
+                   Buffer.Px[part] = Columns.Px[i];
+                   Buffer.Py[part] = Columns.Py[i];
+                   Buffer.Pz[part] = Columns.Pz[i];
+                   Buffer.E[part] = Columns.E[i];
+                   Buffer.Pids[part] = Events.Pids[part];
+                 }
+                 Buffer.Weight = Events.Weights[i];
+               });
 }
 
 } // namespace Root
@@ -9,6 +9,7 @@
 #include <string>
 
 #include "Core/Event.hpp"
+#include "Core/EventCollection.hpp"
 
 class TTree;
 
@@ -23,19 +24,34 @@ namespace Root {
 ///
 class RootDataIO {
   std::string TreeName;
-  int NumberEventsToProcess;
+  std::size_t NumberEventsToProcess;
 
 public:
   /// \param TreeName_	Name of tree in input or output file
-  /// \param NumberEventsToProcess_	-1 processes all events
+  /// \param NumberEventsToProcess_	std::size_t(-1) (the default) or 0
+  /// processes all events
   RootDataIO(const std::string TreeName_ = "data",
              std::size_t NumberEventsToProcess_ = -1);
 
+  /// The entries of all files are split into ranges, which are read in
+  /// parallel. Each range is read with its own TFile and written directly to
+  /// its position in the output, so the order of the events is kept. If the
+  /// particles are stored in split mode, only the momenta, ids and weights
+  /// are read from their branches.
   /// @param InputFilePath Input file(s); can take wildcards, because it uses [`TChain::Add`](https://root.cern.ch/doc/master/classTChain.html).
   std::vector<ComPWA::Event> readData(const std::string &InputFilePath) const;
 
+  /// Read the events of \p InputFilePath directly into the columns of an
+  /// EventCollection. The particle ids are taken from the first event. The
+  /// events are read in parallel like in readData().
+  ComPWA::EventCollection
+  readEventCollection(const std::string &InputFilePath) const;
+
   void writeData(const std::vector<ComPWA::Event> &Events,
                  const std::string &OutputFilePath) const;
+
+  void writeData(const ComPWA::EventCollection &Events,
+                 const std::string &OutputFilePath) const;
 };
 
 } // namespace Root
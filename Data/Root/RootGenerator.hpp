@@ -54,6 +54,7 @@ public:
 
   virtual ~RootGenerator(){};
 
+  using PhaseSpaceEventGenerator::generate;
   ComPWA::Event generate(UniformRealNumberGenerator &gen) const final;
 
 private:
@@ -38,6 +38,46 @@ BOOST_AUTO_TEST_CASE(SimpleWriteReadCheck) {
   std::remove("RootReaderTest-output.root"); // delete file
 }
 
+BOOST_AUTO_TEST_CASE(ParallelReadCheck) {
+  ComPWA::Logging log("", "warning");
+
+  std::vector<double> FSMasses = {0.5, 0.5, 0.5};
+  ComPWA::Data::Root::RootGenerator gen(1.864, FSMasses);
+  ComPWA::Data::Root::RootUniformRealGenerator RandomGenerator(305896);
+  auto sample(ComPWA::Data::generatePhsp(400, gen, RandomGenerator));
+
+  // two files, which are read via a wildcard
+  ComPWA::Data::Root::RootDataIO RootIO("trtr");
+  RootIO.writeData(std::vector<Event>(sample.begin(), sample.begin() + 250),
+                   "RootReaderTest-part1.root");
+  RootIO.writeData(std::vector<Event>(sample.begin() + 250, sample.end()),
+                   "RootReaderTest-part2.root");
+
+  // the number of events to process spans both files
+  ComPWA::Data::Root::RootDataIO LimitedRootIO("trtr", 300);
+  auto sampleIn(LimitedRootIO.readData("RootReaderTest-part*.root"));
+  auto collectionIn(
+      LimitedRootIO.readEventCollection("RootReaderTest-part*.root"));
+  BOOST_REQUIRE_EQUAL(sampleIn.size(), 300);
+  BOOST_REQUIRE_EQUAL(collectionIn.size(), 300);
+  for (std::size_t i = 0; i < sampleIn.size(); ++i) {
+    BOOST_CHECK_EQUAL(sampleIn[i].Weight, sample[i].Weight);
+    BOOST_CHECK_EQUAL(collectionIn.Weights[i], sample[i].Weight);
+    BOOST_REQUIRE_EQUAL(sampleIn[i].ParticleList.size(), 3);
+    for (std::size_t part = 0; part < 3; ++part) {
+      auto P4 = sample[i].ParticleList[part].fourMomentum();
+      BOOST_CHECK_EQUAL(sampleIn[i].ParticleList[part].fourMomentum().px(),
+                        P4.px());
+      BOOST_CHECK_EQUAL(sampleIn[i].ParticleList[part].fourMomentum().e(),
+                        P4.e());
+      BOOST_CHECK_EQUAL(collectionIn.FourMomenta[part].Pz[i], P4.pz());
+    }
+  }
+
+  std::remove("RootReaderTest-part1.root");
+  std::remove("RootReaderTest-part2.root");
+}
+
 BOOST_AUTO_TEST_SUITE_END();
 
 } // namespace Data
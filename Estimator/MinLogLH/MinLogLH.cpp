@@ -7,7 +7,9 @@
 #include "Core/FunctionTree/ParameterList.hpp"
 #include "Core/Kinematics.hpp"
 #include "Core/Particle.hpp"
+#include "Data/ChunkedDataSet.hpp"
 #include "Data/DataSet.hpp"
+#include "Data/DataSetView.hpp"
 
 namespace ComPWA {
 namespace Estimator {
@@ -17,36 +19,74 @@ using namespace ComPWA::FunctionTree;
 MinLogLH::MinLogLH(ComPWA::Intensity &intensity,
                    const Data::DataSet &datasample,
                    const Data::DataSet &phspdatasample)
+    : Intensity(intensity),
+      ResidentDataSample(new Data::SingleChunkDataSet(datasample)),
+      ResidentPhspDataSample(new Data::SingleChunkDataSet(phspdatasample)),
+      DataSample(*ResidentDataSample), PhspDataSample(*ResidentPhspDataSample),
+      NumberOfDataEvents(DataSample.size()) {
+
+  LOG(INFO) << "MinLogLH::MinLogLH() |  Size of data sample = "
+            << DataSample.size();
+}
+
+MinLogLH::MinLogLH(ComPWA::Intensity &intensity,
+                   const Data::ChunkedDataSet &datasample,
+                   const Data::ChunkedDataSet &phspdatasample)
     : Intensity(intensity), DataSample(datasample),
-      PhspDataSample(phspdatasample) {
+      PhspDataSample(phspdatasample), NumberOfDataEvents(DataSample.size()) {
 
   LOG(INFO) << "MinLogLH::MinLogLH() |  Size of data sample = "
-            << DataSample.Weights.size();
+            << DataSample.size();
+}
+
+MinLogLH::MinLogLH(ComPWA::Intensity &intensity,
+                   const Data::DataSetView &datasample,
+                   const Data::DataSetView &phspdatasample)
+    : Intensity(intensity), ResidentDataSample(new Data::SingleChunkDataSet(
+                                datasample.getDataSet())),
+      ResidentPhspDataSample(
+          new Data::SingleChunkDataSet(phspdatasample.getDataSet())),
+      DataSample(*ResidentDataSample), PhspDataSample(*ResidentPhspDataSample),
+      DataWeights(datasample.getFoldedWeights()),
+      PhspWeights(phspdatasample.getFoldedWeights()),
+      NumberOfDataEvents(datasample.getNumberOfEvents()) {
+
+  LOG(INFO) << "MinLogLH::MinLogLH() |  Size of data sample = "
+            << NumberOfDataEvents;
 }
 
 double MinLogLH::evaluate() noexcept {
   double lh(0.0);
 
   double Norm(0.0);
-  if (0 < PhspDataSample.Weights.size()) {
+  if (0 < PhspDataSample.size()) {
     double PhspIntegral(0.0);
     double WeightSum(0.0);
-    auto Intensities = Intensity.evaluate(PhspDataSample.Data);
-    auto IntensIter = Intensities.begin();
-    for (auto x = PhspDataSample.Weights.begin();
-         x != PhspDataSample.Weights.end(); ++x) {
-      PhspIntegral += *x * *IntensIter;
-      WeightSum += *x;
-      ++IntensIter;
-    }
-    Norm = (std::log(PhspIntegral / WeightSum) * DataSample.Weights.size());
+    PhspDataSample.forEachChunk([&](const Data::DataSet &Chunk) {
+      auto Intensities = Intensity.evaluate(Chunk.Data);
+      const auto &Weights = PhspWeights.empty() ? Chunk.Weights : PhspWeights;
+      auto IntensIter = Intensities.begin();
+      for (auto x = Weights.begin(); x != Weights.end(); ++x) {
+        PhspIntegral += *x * *IntensIter;
+        WeightSum += *x;
+        ++IntensIter;
+      }
+    });
+    Norm = (std::log(PhspIntegral / WeightSum) * NumberOfDataEvents);
   }
   // calculate data log sum
   double LogSum(0.0);
-  auto Intensities = Intensity.evaluate(DataSample.Data);
-  for (size_t i = 0; i < DataSample.Weights.size(); ++i) {
-    LogSum += std::log(Intensities[i]) * DataSample.Weights[i];
-  }
+  DataSample.forEachChunk([&](const Data::DataSet &Chunk) {
+    auto Intensities = Intensity.evaluate(Chunk.Data);
+    const auto &Weights = DataWeights.empty() ? Chunk.Weights : DataWeights;
+    for (size_t i = 0; i < Weights.size(); ++i) {
+      // events that are not part of a resampled sample are skipped, their
+      // intensity may even be zero. All events of a DataSet are used.
+      if (!DataWeights.empty() && DataWeights[i] == 0.0)
+        continue;
+      LogSum += std::log(Intensities[i]) * Weights[i];
+    }
+  });
   lh = Norm - LogSum;
 
   return lh;
@@ -60,15 +100,59 @@ std::vector<ComPWA::Parameter> MinLogLH::getParameters() const {
   return Intensity.getParameters();
 }
 
+namespace {
+
+///
+/// \class LogOfSelected
+/// Logarithm of the values of the events with a non-zero weight. The result
+/// of all other events is zero, so that their weighted logarithm is zero even
+/// if their value is zero.
+///
+class LogOfSelected : public Strategy {
+public:
+  LogOfSelected(std::shared_ptr<const Value<std::vector<double>>> Weights_)
+      : Strategy(ParType::MDOUBLE, "LogOfSelected"), Weights(Weights_) {}
+
+  void execute(ParameterList &paras,
+               std::shared_ptr<ComPWA::FunctionTree::Parameter> &out) {
+    if (out && checkType != out->type())
+      throw BadParameter("LogOfSelected::execute() | Parameter type mismatch!");
+    if (paras.numParameters() + paras.numValues() != 1 ||
+        paras.mDoubleValues().size() != 1)
+      throw BadParameter(
+          "LogOfSelected::execute() | Expecting only one multi double");
+
+    const auto &Values = paras.mDoubleValue(0)->operator()();
+    const auto &EventWeights = (*Weights)();
+    if (Values.size() != EventWeights.size())
+      throw BadParameter("LogOfSelected::execute() | Number of values does "
+                         "not match the number of weights");
+    if (!out)
+      out = MDouble("", Values.size());
+    auto &Results =
+        std::static_pointer_cast<Value<std::vector<double>>>(out)->values();
+    Results.resize(Values.size());
+    for (std::size_t i = 0; i < Values.size(); ++i)
+      Results[i] = EventWeights[i] == 0.0 ? 0.0 : std::log(Values[i]);
+  }
+
+private:
+  std::shared_ptr<const Value<std::vector<double>>> Weights;
+};
+
+/// If \p SkipZeroWeights is set, the events with a zero weight do not
+/// contribute to the log sum. Their intensity may be zero, which would give
+/// 0 * log(0).
 std::pair<ComPWA::FunctionTree::FunctionTreeEstimator, FitParameterList>
 createMinLogLHFunctionTreeEstimator(
     ComPWA::FunctionTree::FunctionTreeIntensity &Intensity,
-    const ComPWA::Data::DataSet &DataSample) {
+    const ComPWA::Data::DataList &Data, const std::vector<double> &Weights,
+    bool SkipZeroWeights) {
   using namespace ComPWA::FunctionTree;
   LOG(DEBUG)
       << "createMinLogLHEstimatorFunctionTree(): constructing FunctionTree!";
 
-  if (0 == DataSample.Weights.size()) {
+  if (0 == Weights.size()) {
     LOG(ERROR) << "createMinLogLHEstimatorFunctionTree(): Data sample is "
                   "empty! Please supply some data.";
     return std::make_pair(
@@ -79,13 +163,13 @@ createMinLogLHFunctionTreeEstimator(
   std::shared_ptr<ComPWA::FunctionTree::FunctionTree> DataIntensityFunctionTree;
   ComPWA::FunctionTree::ParameterList Parameters;
   std::tie(DataIntensityFunctionTree, Parameters) =
-      Intensity.bind(DataSample.Data);
+      Intensity.bind(Data);
 
   FitParameterList FitParList =
       ComPWA::FunctionTree::createFitParameterList(Parameters);
 
   auto weights = std::make_shared<Value<std::vector<double>>>(
-      "Weights", DataSample.Weights);
+      "Weights", Weights);
 
   std::shared_ptr<ComPWA::FunctionTree::FunctionTree> EvaluationTree =
       std::make_shared<ComPWA::FunctionTree::FunctionTree>(
@@ -104,9 +188,12 @@ createMinLogLHFunctionTreeEstimator(
                        "Sum");
   if (weights)
     dataTree->createLeaf("EventWeight", weights, "WeightedLogIntensities");
-  dataTree->createNode("Log",
-                       std::shared_ptr<Strategy>(new LogOf(ParType::MDOUBLE)),
-                       "WeightedLogIntensities");
+  std::shared_ptr<Strategy> Log;
+  if (SkipZeroWeights)
+    Log = std::make_shared<LogOfSelected>(weights);
+  else
+    Log = std::make_shared<LogOf>(ParType::MDOUBLE);
+  dataTree->createNode("Log", Log, "WeightedLogIntensities");
   dataTree->insertTree(DataIntensityFunctionTree, "Log");
 
   EvaluationTree->insertTree(dataTree, "LH");
@@ -121,5 +208,26 @@ createMinLogLHFunctionTreeEstimator(
       FunctionTreeEstimator(EvaluationTree, Parameters), FitParList);
 }
 
+} // namespace
+
+std::pair<ComPWA::FunctionTree::FunctionTreeEstimator, FitParameterList>
+createMinLogLHFunctionTreeEstimator(
+    ComPWA::FunctionTree::FunctionTreeIntensity &Intensity,
+    const ComPWA::Data::DataSet &DataSample) {
+  return createMinLogLHFunctionTreeEstimator(Intensity, DataSample.Data,
+                                             DataSample.Weights, false);
+}
+
+std::pair<ComPWA::FunctionTree::FunctionTreeEstimator, FitParameterList>
+createMinLogLHFunctionTreeEstimator(
+    ComPWA::FunctionTree::FunctionTreeIntensity &Intensity,
+    const ComPWA::Data::DataSetView &DataSample) {
+  // Like in MinLogLH, the events that are not part of the resampled sample
+  // are skipped
+  return createMinLogLHFunctionTreeEstimator(
+      Intensity, DataSample.getDataSet().Data, DataSample.getFoldedWeights(),
+      true);
+}
+
 } // namespace Estimator
 } // namespace ComPWA
@@ -11,11 +11,12 @@
 #include "Core/FitParameter.hpp"
 #include "Core/FunctionTree/FunctionTreeEstimator.hpp"
 #include "Core/FunctionTree/FunctionTreeIntensity.hpp"
+#include "Data/ChunkedDataSet.hpp"
 #include "Estimator/Estimator.hpp"
 
 namespace ComPWA {
 namespace Data {
-struct DataSet;
+class DataSetView;
 }
 
 namespace Estimator {
@@ -47,12 +48,30 @@ namespace Estimator {
 /// \par Efficiency correction
 /// It is assumed that the data already includes the efficiency.
 ///
+/// \par Large samples
+/// Both samples can be given as Data::ChunkedDataSet (e.g. a
+/// Data::Binary::StreamingDataSet). The sums are then accumulated over the
+/// chunks and only the intensities of a single chunk are kept in memory.
+///
+/// \par Resampled samples
+/// Both samples can be given as Data::DataSetView, e.g. a bootstrap replica.
+/// The intensity is evaluated on the columns of the underlying DataSets and
+/// the views only enter through their weights, so that fitting many replicas
+/// of a sample never copies its columns.
+///
 class MinLogLH : public ComPWA::Estimator::Estimator<double> {
 
 public:
   MinLogLH(ComPWA::Intensity &intensity, const Data::DataSet &datasample,
            const Data::DataSet &phspdatasample);
 
+  MinLogLH(ComPWA::Intensity &intensity,
+           const Data::ChunkedDataSet &datasample,
+           const Data::ChunkedDataSet &phspdatasample);
+
+  MinLogLH(ComPWA::Intensity &intensity, const Data::DataSetView &datasample,
+           const Data::DataSetView &phspdatasample);
+
   /// Value of log likelihood function.
   double evaluate() noexcept final;
 
@@ -63,8 +82,19 @@ public:
 private:
   ComPWA::Intensity &Intensity;
 
-  const Data::DataSet &DataSample;
-  const Data::DataSet &PhspDataSample;
+  /// Adapters in case that resident DataSets are given
+  std::unique_ptr<const Data::ChunkedDataSet> ResidentDataSample;
+  std::unique_ptr<const Data::ChunkedDataSet> ResidentPhspDataSample;
+
+  const Data::ChunkedDataSet &DataSample;
+  const Data::ChunkedDataSet &PhspDataSample;
+
+  /// Weights of the events in case that DataSetViews are given. The weights
+  /// of the chunks are used if these are empty. Events with a zero weight
+  /// are not part of the view and are skipped.
+  std::vector<double> DataWeights;
+  std::vector<double> PhspWeights;
+  double NumberOfDataEvents;
 };
 
 std::pair<ComPWA::FunctionTree::FunctionTreeEstimator, FitParameterList>
@@ -72,6 +102,15 @@ createMinLogLHFunctionTreeEstimator(
     ComPWA::FunctionTree::FunctionTreeIntensity &Intensity,
     const ComPWA::Data::DataSet &DataSample);
 
+/// Same as above for a resampled data sample. The tree is bound to the
+/// columns of the underlying DataSet, the entries of the view enter only
+/// through the event weights (see Data::DataSetView::getFoldedWeights()).
+/// Events with a zero weight are not part of the view and are skipped.
+std::pair<ComPWA::FunctionTree::FunctionTreeEstimator, FitParameterList>
+createMinLogLHFunctionTreeEstimator(
+    ComPWA::FunctionTree::FunctionTreeIntensity &Intensity,
+    const ComPWA::Data::DataSetView &DataSample);
+
 } // namespace Estimator
 } // namespace ComPWA
 
@@ -13,6 +13,7 @@
 #include "Core/FunctionTree/FunctionTree.hpp"
 #include "Core/FunctionTree/FunctionTreeIntensity.hpp"
 #include "Data/DataSet.hpp"
+#include "Data/DataSetView.hpp"
 #include "Estimator/MinLogLH/MinLogLH.hpp"
 #include "Optimizer/Minuit2/MinuitIF.hpp"
 #include "Optimizer/Minuit2/MinuitResult.hpp"
@@ -153,6 +154,26 @@ PullInfo calculatePull(const std::vector<std::pair<double, double>> &FitValues,
   return PInfo;
 }
 
+/// Copy of the entries of \p View, each repeated as often as its replica
+/// weight.
+ComPWA::Data::DataSet materialize(const ComPWA::Data::DataSetView &View) {
+  const auto &Set = View.getDataSet();
+  ComPWA::Data::DataSet Copy;
+  Copy.Data.resize(Set.Data.size());
+  for (std::size_t i = 0; i < View.size(); ++i) {
+    std::size_t Index = View.getIndices().empty() ? i : View.getIndices()[i];
+    int Copies = View.getReplicaWeights().empty()
+                     ? 1
+                     : int(View.getReplicaWeights()[i]);
+    for (int j = 0; j < Copies; ++j) {
+      for (std::size_t Column = 0; Column < Set.Data.size(); ++Column)
+        Copy.Data[Column].push_back(Set.Data[Column][Index]);
+      Copy.Weights.push_back(Set.Weights[Index]);
+    }
+  }
+  return Copy;
+}
+
 BOOST_AUTO_TEST_SUITE(Estimator_MinLogLHEstimatorTest)
 
 BOOST_AUTO_TEST_CASE(MinLogLHEstimator_GaussianModelFitTest) {
@@ -516,4 +537,109 @@ BOOST_AUTO_TEST_CASE(MinLogLHEstimator_GaussianModelEventWeightTest) {
   BOOST_CHECK(std::abs(pwft.Width - 1.0) < 3.0 * pwft.WidthError);
 };
 
+BOOST_AUTO_TEST_CASE(MinLogLHEstimator_DataSetViewTest) {
+  ComPWA::Logging log("INFO", "output.log");
+  double mean(3.0);
+  double sigma(0.1);
+
+  std::mt19937 mt_gen(123456);
+  std::uniform_real_distribution<double> distribution(mean - 10.0 * sigma,
+                                                      mean + 10.0 * sigma);
+  std::normal_distribution<double> normal_distribution(mean, sigma);
+  std::uniform_real_distribution<double> weight_distribution(0.5, 1.5);
+
+  ComPWA::Data::DataSet PhspSample;
+  PhspSample.Data.push_back({});
+  for (unsigned int i = 0; i < 2000; ++i) {
+    PhspSample.Data[0].push_back(distribution(mt_gen));
+    PhspSample.Weights.push_back(1.0);
+  }
+  ComPWA::Data::DataSet DataSample;
+  DataSample.Data.push_back({});
+  for (unsigned int i = 0; i < 500; ++i) {
+    DataSample.Data[0].push_back(normal_distribution(mt_gen));
+    DataSample.Weights.push_back(weight_distribution(mt_gen));
+  }
+
+  auto Gauss = Gaussian(1.1 * mean, 0.9 * sigma);
+
+  // the likelihood of a replica has to be the same as the one of a copy of
+  // the resampled events
+  std::vector<ComPWA::Data::DataSetView> Replicas{
+      ComPWA::Data::DataSetView(DataSample),
+      ComPWA::Data::DataSetView(DataSample, {4, 4, 17, 499, 0}),
+      ComPWA::Data::DataSetView(DataSample, {4, 17, 4}, {2.0, 0.0, 3.0}),
+      ComPWA::Data::createPoissonBootstrapView(DataSample, 1),
+      ComPWA::Data::createMultinomialBootstrapView(DataSample, 2),
+      ComPWA::Data::createJackknifeView(DataSample, 10, 3)};
+  for (const auto &Replica : Replicas) {
+    auto ReplicaSample = materialize(Replica);
+    ComPWA::Estimator::MinLogLH CopyLH(Gauss, ReplicaSample, PhspSample);
+    ComPWA::Estimator::MinLogLH ViewLH(Gauss, Replica,
+                                       ComPWA::Data::DataSetView(PhspSample));
+    BOOST_CHECK_CLOSE(ViewLH.evaluate(), CopyLH.evaluate(), 1e-9);
+  }
+
+  // the phase space sample can be resampled as well
+  auto PhspReplica = ComPWA::Data::createPoissonBootstrapView(PhspSample, 3);
+  auto PhspReplicaSample = materialize(PhspReplica);
+  ComPWA::Estimator::MinLogLH CopyLH(Gauss, DataSample, PhspReplicaSample);
+  ComPWA::Estimator::MinLogLH ViewLH(
+      Gauss, ComPWA::Data::DataSetView(DataSample), PhspReplica);
+  BOOST_CHECK_CLOSE(ViewLH.evaluate(), CopyLH.evaluate(), 1e-9);
+
+  // the function tree estimator is bound to the unchanged columns
+  auto Mean = std::make_shared<ComPWA::FunctionTree::FitParameter>("Mean", 3.3);
+  auto Width =
+      std::make_shared<ComPWA::FunctionTree::FitParameter>("Width", 0.09);
+  auto Strength =
+      std::make_shared<ComPWA::FunctionTree::FitParameter>("Strength", 1.0);
+  ComPWA::FunctionTree::ParameterList Parameters;
+  Parameters.addParameter(Mean);
+  Parameters.addParameter(Width);
+  Parameters.addParameter(Strength);
+  ComPWA::FunctionTree::ParameterList DataList;
+  DataList.addValue(
+      std::make_shared<ComPWA::FunctionTree::Value<std::vector<double>>>(
+          "x", std::vector<double>()));
+  auto intens = ComPWA::FunctionTree::FunctionTreeIntensity(
+      createFunctionTree(Mean, Width, Strength, DataList), Parameters,
+      DataList);
+
+  auto Replica = ComPWA::Data::createPoissonBootstrapView(DataSample, 4);
+  auto ReplicaSample = materialize(Replica);
+  // both estimators share the tree of the intensity, so the first one has to
+  // be evaluated before the second one binds the data
+  double CopyValue = ComPWA::Estimator::createMinLogLHFunctionTreeEstimator(
+                         intens, ReplicaSample)
+                         .first.evaluate();
+  auto ViewEstimator =
+      ComPWA::Estimator::createMinLogLHFunctionTreeEstimator(intens, Replica);
+  BOOST_CHECK_CLOSE(ViewEstimator.first.evaluate(), CopyValue, 1e-9);
+
+  // an event far off the peak has a zero intensity. It does not matter as
+  // long as it is not part of the replica.
+  DataSample.Data[0].push_back(mean + 100.0 * sigma);
+  DataSample.Weights.push_back(1.0);
+  std::vector<double> ReplicaWeights(DataSample.Weights.size(), 1.0);
+  ReplicaWeights.back() = 0.0;
+  ComPWA::Data::DataSetView Jackknife(DataSample, {}, ReplicaWeights);
+  auto Folded = Jackknife.getFoldedDataSet();
+  BOOST_CHECK_EQUAL(Folded.Weights.size(), DataSample.Weights.size() - 1);
+  BOOST_CHECK_EQUAL(Folded.Data[0].size(), DataSample.Weights.size() - 1);
+  CopyValue =
+      ComPWA::Estimator::createMinLogLHFunctionTreeEstimator(intens, Folded)
+          .first.evaluate();
+  double ViewValue =
+      ComPWA::Estimator::createMinLogLHFunctionTreeEstimator(intens, Jackknife)
+          .first.evaluate();
+  BOOST_CHECK(std::isfinite(ViewValue));
+  BOOST_CHECK_CLOSE(ViewValue, CopyValue, 1e-9);
+  ComPWA::Estimator::MinLogLH CopyJackknifeLH(Gauss, Folded, PhspSample);
+  ComPWA::Estimator::MinLogLH JackknifeLH(
+      Gauss, Jackknife, ComPWA::Data::DataSetView(PhspSample));
+  BOOST_CHECK(std::isfinite(JackknifeLH.evaluate()));
+  BOOST_CHECK_CLOSE(JackknifeLH.evaluate(), CopyJackknifeLH.evaluate(), 1e-9);
+}
+
 BOOST_AUTO_TEST_SUITE_END()
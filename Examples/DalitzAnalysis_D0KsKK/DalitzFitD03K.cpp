@@ -15,6 +15,7 @@
 // ComPWA header files
 #include "Core/Event.hpp"
 #include "Core/FunctionTree/FunctionTreeIntensity.hpp"
+#include "Data/Binary/DataSetCache.hpp"
 #include "Data/CorrectionTable.hpp"
 #include "Data/DataCorrection.hpp"
 #include "Data/Generate.hpp"
@@ -50,6 +51,7 @@ int main(int argc, char **argv) {
   std::string logLevel;
   std::string pathPrefix;
   std::string logFileName;
+  std::string dataSetCacheDirectory;
 
   po::options_description config("Settings");
   config.add_options()("help,h", "produce help message");
@@ -69,6 +71,11 @@ int main(int argc, char **argv) {
   config.add_options()("pathPrefix",
                        po::value<std::string>(&pathPrefix)->default_value("./"),
                        "Set prefix of output files");
+  config.add_options()(
+      "dataSetCacheDirectory",
+      po::value<std::string>(&dataSetCacheDirectory)->default_value(""),
+      "Directory of the cache of converted data and phsp samples (empty to "
+      "disable the cache)");
 
   std::string dataFile, dataFileTreeName;
   unsigned int numEvents; // data size to be generated
@@ -272,11 +279,23 @@ int main(int argc, char **argv) {
     phspSample = phspSampleTrue = phspSampleToy;
   }
 
+  // The conversions of the phsp sample are read from the DataSet cache, if
+  // a cache directory is given
+  Physics::IntensityBuilderXML::PhspConverter convertPhspSample;
+  if (!dataSetCacheDirectory.empty()) {
+    Data::Binary::DataSetCache cache(dataSetCacheDirectory);
+    convertPhspSample = [cache](const std::vector<Event> &events,
+                                const Kinematics &kin,
+                                const std::vector<std::string> &usedNames) {
+      return cache.convertEventsToDataSet(events, kin, usedNames);
+    };
+  }
+
   // TODO: Builder needs two samples here (see Issue #213)
   //  Builder = Physics::IntensityBuilderXML(phspSample, phspSampleToy);
-  Physics::IntensityBuilderXML TrueBuilder(trueParticleList, trueKinematics,
-                                           trueModelTree.get_child("Intensity"),
-                                           phspSample);
+  Physics::IntensityBuilderXML TrueBuilder(
+      trueParticleList, trueKinematics, trueModelTree.get_child("Intensity"),
+      phspSample, convertPhspSample);
 
   auto trueIntens = TrueBuilder.createIntensity();
   LOG(INFO) << "Subsystems used by true model:";
@@ -318,7 +337,6 @@ int main(int argc, char **argv) {
       sample = ComPWA::Data::generate(numEvents, trueKinematics, gen,
                                       trueIntens, randGen);
   }
-  sample = Data::reduceToPhaseSpace(sample, trueKinematics);
 
   std::stringstream s;
   s << "Printing the first 10 events of data sample:\n";
@@ -331,6 +349,7 @@ int main(int argc, char **argv) {
   LOG(INFO) << "Initial seed: " << seed;
   LOG(INFO) << "Path prefix: " << pathPrefix;
   LOG(INFO) << "Log file (level): " << logFileName << " (" << logLevel << ")";
+  LOG(INFO) << "DataSet cache directory: " << dataSetCacheDirectory;
   LOG(INFO) << "==== Input samples and true model";
   LOG(INFO) << "Number of events: " << numEvents;
   if (!dataFile.empty()) // read in data
@@ -361,7 +380,7 @@ int main(int argc, char **argv) {
 
   Physics::IntensityBuilderXML Builder(fitParticleList, fitKinematics,
                                        fitModelTree.get_child("Intensity"),
-                                       phspSample);
+                                       phspSample, convertPhspSample);
 
   auto fitIntens = Builder.createIntensity();
   ComPWA::Optimizer::Minuit2::MinuitResult result;
@@ -369,9 +388,17 @@ int main(int argc, char **argv) {
   if (enableFit) {
     //========================FITTING =====================
 
-    // Construct likelihood
+    // Construct likelihood from the events within the phase space
+    DataSet sampleDataSet =
+        dataSetCacheDirectory.empty()
+            ? Data::convertEventsToDataSetWithinPhaseSpace(sample,
+                                                          fitKinematics)
+            : Data::Binary::DataSetCache(dataSetCacheDirectory)
+                  .convertEventsToDataSet(
+                      Data::reduceToPhaseSpace(sample, fitKinematics),
+                      fitKinematics);
     auto esti = ComPWA::Estimator::createMinLogLHFunctionTreeEstimator(
-        fitIntens, Data::convertEventsToDataSet(sample, fitKinematics));
+        fitIntens, sampleDataSet);
 
     for (auto x : esti.second)
       LOG(DEBUG) << x;
@@ -404,10 +431,12 @@ int main(int argc, char **argv) {
     // Print fit result
     LOG(INFO) << result;
     LOG(INFO) << "AIC: "
-              << calculateAIC(result.FinalEstimatorValue, sample.size(),
+              << calculateAIC(result.FinalEstimatorValue,
+                              sampleDataSet.Weights.size(),
                               result.NumFreeParameters);
     LOG(INFO) << "BIC: "
-              << calculateBIC(result.FinalEstimatorValue, sample.size(),
+              << calculateBIC(result.FinalEstimatorValue,
+                              sampleDataSet.Weights.size(),
                               result.NumFreeParameters);
 
     // Save fit result
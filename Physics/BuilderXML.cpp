@@ -5,6 +5,7 @@
 #include "BuilderXML.hpp"
 
 #include "Core/Exceptions.hpp"
+#include "Core/FunctionTree/InterferenceIntegral.hpp"
 #include "Core/Logging.hpp"
 #include "Core/Properties.hpp"
 #include "Data/DataSet.hpp"
@@ -13,8 +14,10 @@
 
 #include "Physics/Dynamics/Flatte.hpp"
 #include "Physics/Dynamics/FormFactor.hpp"
+#include "Physics/Dynamics/KMatrix.hpp"
 #include "Physics/Dynamics/NonResonant.hpp"
 #include "Physics/Dynamics/RelativisticBreitWigner.hpp"
+#include "Physics/Dynamics/TabulatedDynamics.hpp"
 #include "Physics/Dynamics/Voigtian.hpp"
 #include "Physics/HelicityFormalism/WignerD.hpp"
 
@@ -33,9 +36,9 @@ using ComPWA::FunctionTree::FunctionTreeIntensity;
 IntensityBuilderXML::IntensityBuilderXML(
     ParticleList PartList_, Kinematics &Kin,
     const boost::property_tree::ptree &ModelTree_,
-    std::vector<Event> PhspSample_)
+    std::vector<Event> PhspSample_, PhspConverter ConvertPhspSample_)
     : PartList(PartList_), Kinematic(Kin), ModelTree(ModelTree_),
-      PhspSample(PhspSample_) {}
+      PhspSample(PhspSample_), ConvertPhspSample(ConvertPhspSample_) {}
 
 ComPWA::FunctionTree::FunctionTreeIntensity
 IntensityBuilderXML::createIntensity() {
@@ -253,12 +256,23 @@ IntensityBuilderXML::createIntegrationStrategyFT(
       LOG(FATAL) << "IntensityBuilderXML::createIntegrationStrategyFT(): phsp "
                     "sample is not set!";
 
-    // update the PhspData
+    // update the PhspData. Only the variables that are read by the
+    // unnormalized intensity are calculated. The containers of the other
+    // variables may be in use by other normalization trees and are left as
+    // they are.
     updateDataContainerState();
+    auto UsedVariableNames = ComPWA::FunctionTree::getUsedDataVariableNames(
+        UnnormalizedIntensity, CurrentIntensityState.ActiveData);
     auto PhspDataSet =
-        ComPWA::Data::convertEventsToDataSet(PhspSample, Kinematic);
-    ComPWA::FunctionTree::updateDataContainers(CurrentIntensityState.ActiveData,
-                                               PhspDataSet.Data);
+        ConvertPhspSample
+            ? ConvertPhspSample(PhspSample, Kinematic, UsedVariableNames)
+            : ComPWA::Data::convertEventsToDataSet(PhspSample, Kinematic,
+                                                   UsedVariableNames);
+    for (std::size_t i = 0; i < PhspDataSet.Data.size(); ++i) {
+      if (PhspDataSet.Data[i].size())
+        CurrentIntensityState.ActiveData.mDoubleValue(i)->setValue(
+            PhspDataSet.Data[i]);
+    }
 
     if (!PhspWeights) {
       PhspWeights = MDouble("Weight", PhspDataSet.Weights);
@@ -276,16 +290,31 @@ IntensityBuilderXML::createIntegrationStrategyFT(
                    NodeName);
     // normTree->createLeaf("PhspVolume", PhspVolume, "Integral");
     tr->createLeaf("InverseSampleWeights", 1.0 / PhspWeightSum, "Integral");
-    tr->createNode("Sum",
-                   std::shared_ptr<Strategy>(new AddAll(ParType::DOUBLE)),
-                   "Integral");
-    tr->createNode("WeightedIntensities",
-                   std::shared_ptr<Strategy>(new MultAll(ParType::MDOUBLE)),
-                   "Sum");
 
-    if (PhspWeights)
-      tr->createLeaf("EventWeight", PhspWeights, "WeightedIntensities");
-    tr->insertTree(UnnormalizedIntensity, "WeightedIntensities");
+    // The integral of a coherent sum of amplitudes is calculated from the
+    // interference matrix of the amplitudes. Then a change of the
+    // coefficients does not require a loop over the phsp sample.
+    auto InterferenceTree =
+        createInterferenceIntegralTree(UnnormalizedIntensity, PhspWeights);
+    if (InterferenceTree) {
+      tr->insertTree(InterferenceTree, "Integral");
+    } else {
+      // e.g. the integrals of the NormalizedAmplitudes
+      LOG(DEBUG) << "IntensityBuilderXML::createIntegrationStrategyFT(): "
+                    "no interference matrix for "
+                 << UnnormalizedIntensity->Head->name()
+                 << ", the integral is a sum over the phsp sample!";
+      tr->createNode("Sum",
+                     std::shared_ptr<Strategy>(new AddAll(ParType::DOUBLE)),
+                     "Integral");
+      tr->createNode("WeightedIntensities",
+                     std::shared_ptr<Strategy>(new MultAll(ParType::MDOUBLE)),
+                     "Sum");
+
+      if (PhspWeights)
+        tr->createLeaf("EventWeight", PhspWeights, "WeightedIntensities");
+      tr->insertTree(UnnormalizedIntensity, "WeightedIntensities");
+    }
 
     tr->parameter();
   } else {
@@ -612,6 +641,9 @@ IntensityBuilderXML::createHelicityDecayFT(
   }
 
   std::string decayType = partProp.getDecayType();
+  // smooth dynamical functions can be interpolated from a table, which
+  // requires that they depend on the mSq column only
+  auto Tabulation = decayInfo.get_child_optional("Tabulation");
 
   std::shared_ptr<ComPWA::FunctionTree::FunctionTree> DynamicFunctionFT(
       nullptr);
@@ -629,8 +661,13 @@ IntensityBuilderXML::createHelicityDecayFT(
     RBW.DaughterMasses = std::make_pair(parMass1, parMass2);
     RBW.FFType = ffType;
     RBW.L = (unsigned int)orbitL;
-    DynamicFunctionFT = createFunctionTree(
-        RBW, CurrentIntensityState.ActiveData, DataPosition, suffix);
+    if (Tabulation)
+      DynamicFunctionFT = createFunctionTree(
+          RBW, CurrentIntensityState.ActiveData, DataPosition, suffix);
+    else
+      DynamicFunctionFT = createFunctionTree(
+          RBW, CurrentIntensityState.ActiveData, DataPosition, suffix,
+          CurrentIntensityState.FactorTrees);
   } else if (decayType == "flatte") {
     ComPWA::Physics::Dynamics::Flatte::InputInfo FlatteInfo;
     FlatteInfo.Mass = Mass;
@@ -663,8 +700,13 @@ IntensityBuilderXML::createHelicityDecayFT(
       }
     }
     FlatteInfo.HiddenCouplings = couplings;
-    DynamicFunctionFT = createFunctionTree(
-        FlatteInfo, CurrentIntensityState.ActiveData, DataPosition, suffix);
+    if (Tabulation)
+      DynamicFunctionFT = Dynamics::Flatte::createFunctionTree(
+          FlatteInfo, CurrentIntensityState.ActiveData, DataPosition, suffix);
+    else
+      DynamicFunctionFT = Dynamics::Flatte::createFunctionTree(
+          FlatteInfo, CurrentIntensityState.ActiveData, DataPosition, suffix,
+          CurrentIntensityState.FactorTrees);
   } else if (decayType == "voigt") {
     using namespace ComPWA::Physics::Dynamics::Voigtian;
     InputInfo VoigtInfo;
@@ -675,8 +717,73 @@ IntensityBuilderXML::createHelicityDecayFT(
     VoigtInfo.FFType = ffType;
     VoigtInfo.L = (unsigned int)orbitL;
     VoigtInfo.Sigma = decayInfo.get<double>("Resolution.<xmlattr>.Sigma");
+    VoigtInfo.Accuracy = decayInfo.get<double>(
+        "Resolution.<xmlattr>.Accuracy", VoigtInfo.Accuracy);
     DynamicFunctionFT = createFunctionTree(
         VoigtInfo, CurrentIntensityState.ActiveData, DataPosition, suffix);
+  } else if (decayType == "kMatrix") {
+    Dynamics::KMatrix::InputInfo KMatrixInfo;
+    bool HasDecayChannel(false);
+    for (const auto &v : decayInfo.get_child("")) {
+      if (v.first == "Channel") {
+        std::string NameA = v.second.get<std::string>("ParticleA");
+        std::string NameB = v.second.get<std::string>("ParticleB");
+        if ((NameA == DecayProducts.first && NameB == DecayProducts.second) ||
+            (NameA == DecayProducts.second && NameB == DecayProducts.first)) {
+          KMatrixInfo.Channel = KMatrixInfo.Channels.size();
+          HasDecayChannel = true;
+        }
+        auto MassA = std::make_shared<FitParameter>(
+            ComPWA::findParticle(PartList, NameA).getMass());
+        auto MassB = std::make_shared<FitParameter>(
+            ComPWA::findParticle(PartList, NameB).getMass());
+        KMatrixInfo.Channels.push_back(std::make_pair(
+            CurrentIntensityState.Parameters.addUniqueParameter(MassA),
+            CurrentIntensityState.Parameters.addUniqueParameter(MassB)));
+      } else if (v.first == "Pole") {
+        Dynamics::KMatrix::Pole Pole;
+        for (const auto &p : v.second.get_child("")) {
+          if (p.first != "Parameter")
+            continue;
+          auto Par = CurrentIntensityState.Parameters.addUniqueParameter(
+              std::make_shared<FitParameter>(p.second));
+          std::string type = p.second.get<std::string>("<xmlattr>.Type");
+          if (type == "Mass")
+            Pole.Mass = Par;
+          else if (type == "Coupling")
+            Pole.Couplings.push_back(Par);
+          else if (type == "Magnitude")
+            Pole.Magnitude = Par;
+          else if (type == "Phase")
+            Pole.Phase = Par;
+          else
+            throw BadConfig("IntensityBuilderXML::createHelicityDecayFT() | "
+                            "Unknown parameter type " +
+                            type + " of a K-matrix pole!");
+        }
+        if (!Pole.Mass || !Pole.Magnitude || !Pole.Phase)
+          throw BadConfig("IntensityBuilderXML::createHelicityDecayFT() | "
+                          "K-matrix pole requires a Mass, Magnitude and "
+                          "Phase parameter!");
+        KMatrixInfo.Poles.push_back(Pole);
+      } else if (v.first == "Parameter" &&
+                 v.second.get<std::string>("<xmlattr>.Type") ==
+                     "Background") {
+        Dynamics::KMatrix::BackgroundTerm Term;
+        Term.ChannelA = v.second.get<unsigned int>("ChannelA");
+        Term.ChannelB = v.second.get<unsigned int>("ChannelB");
+        Term.Value = CurrentIntensityState.Parameters.addUniqueParameter(
+            std::make_shared<FitParameter>(v.second));
+        KMatrixInfo.Background.push_back(Term);
+      }
+    }
+    if (!HasDecayChannel)
+      throw BadConfig("IntensityBuilderXML::createHelicityDecayFT() | Decay "
+                      "products " +
+                      DecayProducts.first + " and " + DecayProducts.second +
+                      " are not a channel of the K-matrix of " + name + "!");
+    DynamicFunctionFT = Dynamics::KMatrix::createFunctionTree(
+        KMatrixInfo, CurrentIntensityState.ActiveData, DataPosition, suffix);
   } else if (decayType == "virtual" || decayType == "nonResonant") {
     DynamicFunctionFT = Dynamics::NonResonant::createFunctionTree(
         CurrentIntensityState.ActiveData, DataPosition, suffix);
@@ -685,10 +792,14 @@ IntensityBuilderXML::createHelicityDecayFT(
                              decayType + "!");
   }
 
-  auto AngularFunction =
-      ComPWA::Physics::HelicityFormalism::WignerD::createFunctionTree(
-          J, mu, DecayHelicities.first - DecayHelicities.second,
-          CurrentIntensityState.ActiveData, DataPosition + 1, DataPosition + 2);
+  if (Tabulation)
+    Dynamics::TabulatedDynamics::tabulate(
+        *DynamicFunctionFT, kin.invMassBounds(SubSystemIndex),
+        Tabulation->get<double>("<xmlattr>.RelativeError", 1e-6));
+
+  auto AngularFunction = CurrentIntensityState.WignerDTrees.wignerDTree(
+      J, mu, DecayHelicities.first - DecayHelicities.second,
+      CurrentIntensityState.ActiveData, DataPosition + 1, DataPosition + 2);
 
   std::string nodeName = "PartialAmplitude(" + ampname + ")" + suffix;
 
@@ -710,8 +821,8 @@ IntensityBuilderXML::createHelicityDecayFT(
     }
 
     std::shared_ptr<ComPWA::FunctionTree::FunctionTree> ProductionFormFactorFT =
-        Dynamics::createFunctionTree(
-            name, parMass1, parMass2, parRadius, orbitL, ffType,
+        CurrentIntensityState.FactorTrees.productionFormFactorTree(
+            parMass1, parMass2, parRadius, orbitL, ffType,
             CurrentIntensityState.ActiveData, DataPosition, suffix);
 
     tr->insertTree(ProductionFormFactorFT, nodeName);
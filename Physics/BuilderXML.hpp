@@ -5,7 +5,9 @@
 #ifndef COMPWA_PHYSICS_BUILDERXML_HPP_
 #define COMPWA_PHYSICS_BUILDERXML_HPP_
 
+#include <functional>
 #include <memory>
+#include <string>
 #include <tuple>
 #include <vector>
 
@@ -13,6 +15,8 @@
 #include "Core/FunctionTree/FunctionTreeIntensity.hpp"
 #include "Core/FunctionTree/Value.hpp"
 #include "Data/DataSet.hpp"
+#include "Physics/Dynamics/FormFactor.hpp"
+#include "Physics/HelicityFormalism/WignerD.hpp"
 #include "Physics/ParticleStateTransitionKinematicsInfo.hpp"
 
 #include <boost/property_tree/ptree_fwd.hpp>
@@ -31,9 +35,19 @@ class HelicityKinematics;
 
 class IntensityBuilderXML {
 public:
+  /// Conversion of the phase space sample into a DataSet that contains only
+  /// the listed variables (see Data::convertEventsToDataSet()).
+  using PhspConverter = std::function<Data::DataSet(
+      const std::vector<Event> &, const Kinematics &,
+      const std::vector<std::string> &)>;
+
+  /// \param ConvertPhspSample_ Replaces Data::convertEventsToDataSet() for
+  /// the conversion of \p PhspSample_, e.g. to read the DataSets from a
+  /// cache.
   IntensityBuilderXML(ParticleList PartList_, Kinematics &Kin,
                       const boost::property_tree::ptree &ModelTree_,
-                      std::vector<Event> PhspSample_ = {});
+                      std::vector<Event> PhspSample_ = {},
+                      PhspConverter ConvertPhspSample_ = nullptr);
 
   ComPWA::FunctionTree::FunctionTreeIntensity createIntensity();
 
@@ -44,6 +58,12 @@ private:
     ComPWA::FunctionTree::ParameterList PhspData;
     ComPWA::FunctionTree::ParameterList ActiveData;
     bool IsDataActive = true;
+    /// Per event factors that are shared by the resonances of the same
+    /// subsystem and decay channel
+    Dynamics::FactorTreeCache FactorTrees;
+    /// Angular distributions that are shared by all amplitudes with the same
+    /// helicities in the same subsystem
+    HelicityFormalism::WignerDTreeCache WignerDTrees;
   };
 
   std::shared_ptr<ComPWA::FunctionTree::FunctionTree>
@@ -99,6 +119,7 @@ private:
   boost::property_tree::ptree ModelTree;
   std::vector<ComPWA::Event> PhspSample;
   std::shared_ptr<ComPWA::FunctionTree::Value<std::vector<double>>> PhspWeights;
+  PhspConverter ConvertPhspSample;
 
   IntensityBuilderState CurrentIntensityState;
 };
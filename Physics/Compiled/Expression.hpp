@@ -0,0 +1,417 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Expression templates for intensities with a structure that is fixed at
+/// compile time.
+///
+/// The FunctionTree builds an intensity at runtime from a graph of Strategy
+/// nodes. Each node evaluates a complete data column and stores it, which
+/// costs a virtual call, a temporary vector and a memory pass per node. For
+/// models that do not change between fits the same intensity can be written
+/// as a C++ expression:
+/// \code
+///   Compiled::ParameterSet Pars;
+///   auto Amp = coefficient(Pars.add("Magnitude", 1.0), Pars.add("Phase", 0.0))
+///              * wignerD<2, 0, 0>(Sys) * relativisticBreitWigner<1>(...);
+///   auto Intens = makeIntensity(normalized(absSquare(Amp), PhspSample), Pars);
+/// \endcode
+/// Every node is a small value type and the whole expression is a single
+/// type. The compiler therefore inlines the complete per-event expression into
+/// one loop, with spins and orbital angular momenta as compile-time constants.
+///
+/// Nodes are either amplitudes (complex valued, derived from
+/// AmplitudeExpression) or intensities (real valued, derived from
+/// IntensityExpression). Each node implements
+///   - `void update(const double *Parameters)`: per evaluation
+///      precalculations (e.g. normalization integrals)
+///   - `operator()(const EvaluationContext &, std::size_t Event) const`:
+///      value for a single event
+///
+/// The HelicityFormalism building blocks are in HelicityExpression.hpp.
+///
+
+#ifndef COMPWA_PHYSICS_COMPILED_EXPRESSION_HPP_
+#define COMPWA_PHYSICS_COMPILED_EXPRESSION_HPP_
+
+#include <cmath>
+#include <complex>
+#include <memory>
+#include <numeric>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "Core/Exceptions.hpp"
+#include "Core/Function.hpp"
+#include "Data/DataSet.hpp"
+
+namespace ComPWA {
+namespace Physics {
+namespace Compiled {
+
+/// Reference to a parameter in a ParameterSet.
+struct ParameterRef {
+  std::size_t Index;
+};
+
+/// Bookkeeping of the parameters of a compiled intensity. Parameters are
+/// identified by their name, adding a parameter twice returns the same
+/// reference (like ParameterList::addUniqueParameter()).
+class ParameterSet {
+public:
+  ParameterRef add(const std::string &Name, double Value) {
+    for (std::size_t i = 0; i < Parameters.size(); ++i) {
+      if (Parameters[i].Name == Name)
+        return ParameterRef{i};
+    }
+    Parameters.push_back(ComPWA::Parameter{Name, Value});
+    return ParameterRef{Parameters.size() - 1};
+  }
+
+  const std::vector<ComPWA::Parameter> &parameters() const {
+    return Parameters;
+  }
+
+private:
+  std::vector<ComPWA::Parameter> Parameters;
+};
+
+/// Parameter values and data columns that are passed to the expressions.
+struct EvaluationContext {
+  const double *Parameters;
+  std::vector<const double *> Columns;
+
+  double parameter(ParameterRef Par) const { return Parameters[Par.Index]; }
+  double column(std::size_t Column, std::size_t Event) const {
+    return Columns[Column][Event];
+  }
+};
+
+inline EvaluationContext
+createEvaluationContext(const double *Parameters,
+                        const std::vector<std::vector<double>> &Data) {
+  EvaluationContext Context{Parameters, {}};
+  Context.Columns.reserve(Data.size());
+  for (const auto &Column : Data)
+    Context.Columns.push_back(Column.data());
+  return Context;
+}
+
+/// Context for data columns that are owned elsewhere, e.g. by a
+/// Data::Binary::MappedDataSet.
+inline EvaluationContext
+createEvaluationContext(const double *Parameters,
+                        const std::vector<const double *> &Columns) {
+  return EvaluationContext{Parameters, Columns};
+}
+
+template <typename Derived> struct AmplitudeExpression {};
+template <typename Derived> struct IntensityExpression {};
+
+template <typename T>
+using IsAmplitude = std::is_base_of<AmplitudeExpression<T>, T>;
+template <typename T>
+using IsIntensity = std::is_base_of<IntensityExpression<T>, T>;
+
+// ------------------------------ Amplitudes --------------------------------
+
+/// Constant complex factor, e.g. a Clebsch-Gordan prefactor.
+struct Constant : AmplitudeExpression<Constant> {
+  std::complex<double> Value;
+
+  explicit Constant(std::complex<double> Value_) : Value(Value_) {}
+  void update(const double *) {}
+  std::complex<double> operator()(const EvaluationContext &,
+                                  std::size_t) const {
+    return Value;
+  }
+};
+
+/// Complex coefficient from magnitude and phase (see Complexify).
+struct Coefficient : AmplitudeExpression<Coefficient> {
+  ParameterRef Magnitude;
+  ParameterRef Phase;
+  std::complex<double> Value;
+
+  Coefficient(ParameterRef Magnitude_, ParameterRef Phase_)
+      : Magnitude(Magnitude_), Phase(Phase_) {}
+  void update(const double *Parameters) {
+    Value = std::polar(std::abs(Parameters[Magnitude.Index]),
+                       Parameters[Phase.Index]);
+  }
+  std::complex<double> operator()(const EvaluationContext &,
+                                  std::size_t) const {
+    return Value;
+  }
+};
+
+template <typename A, typename B>
+struct AmplitudeProduct : AmplitudeExpression<AmplitudeProduct<A, B>> {
+  A Left;
+  B Right;
+
+  AmplitudeProduct(A Left_, B Right_) : Left(Left_), Right(Right_) {}
+  void update(const double *Parameters) {
+    Left.update(Parameters);
+    Right.update(Parameters);
+  }
+  std::complex<double> operator()(const EvaluationContext &Context,
+                                  std::size_t Event) const {
+    return Left(Context, Event) * Right(Context, Event);
+  }
+};
+
+/// Coherent sum of two amplitudes.
+template <typename A, typename B>
+struct AmplitudeSum : AmplitudeExpression<AmplitudeSum<A, B>> {
+  A Left;
+  B Right;
+
+  AmplitudeSum(A Left_, B Right_) : Left(Left_), Right(Right_) {}
+  void update(const double *Parameters) {
+    Left.update(Parameters);
+    Right.update(Parameters);
+  }
+  std::complex<double> operator()(const EvaluationContext &Context,
+                                  std::size_t Event) const {
+    return Left(Context, Event) + Right(Context, Event);
+  }
+};
+
+/// Monte Carlo integral of \p Expr over the weighted sample \p Phsp, the same
+/// as created by IntensityBuilderXML for the MCIntegrationStrategy.
+template <typename Expr, typename Transformation>
+double integrate(const Expr &Expression, const double *Parameters,
+                 const Data::DataSet &Phsp, Transformation Transform) {
+  auto Context = createEvaluationContext(Parameters, Phsp.Data);
+  double Sum(0.0);
+  for (std::size_t i = 0; i < Phsp.Weights.size(); ++i)
+    Sum += Phsp.Weights[i] * Transform(Expression(Context, i));
+  double WeightSum =
+      std::accumulate(Phsp.Weights.begin(), Phsp.Weights.end(), 0.0);
+  return 1.0 / WeightSum * Sum;
+}
+
+/// Amplitude normalized to an integral of one over the phase space sample.
+template <typename A>
+struct NormalizedAmplitude : AmplitudeExpression<NormalizedAmplitude<A>> {
+  A Amplitude;
+  std::shared_ptr<const Data::DataSet> Phsp;
+  double Normalization = 1.0;
+
+  NormalizedAmplitude(A Amplitude_, std::shared_ptr<const Data::DataSet> Phsp_)
+      : Amplitude(Amplitude_), Phsp(Phsp_) {}
+  void update(const double *Parameters) {
+    Amplitude.update(Parameters);
+    Normalization = std::sqrt(
+        1.0 / integrate(Amplitude, Parameters, *Phsp,
+                        [](std::complex<double> x) { return std::norm(x); }));
+  }
+  std::complex<double> operator()(const EvaluationContext &Context,
+                                  std::size_t Event) const {
+    return Amplitude(Context, Event) * Normalization;
+  }
+};
+
+// ------------------------------ Intensities -------------------------------
+
+/// Coherent intensity: absolute square of an amplitude.
+template <typename A> struct AbsSquare : IntensityExpression<AbsSquare<A>> {
+  A Amplitude;
+
+  explicit AbsSquare(A Amplitude_) : Amplitude(Amplitude_) {}
+  void update(const double *Parameters) { Amplitude.update(Parameters); }
+  double operator()(const EvaluationContext &Context, std::size_t Event) const {
+    return std::norm(Amplitude(Context, Event));
+  }
+};
+
+/// Incoherent sum of two intensities.
+template <typename A, typename B>
+struct IntensitySum : IntensityExpression<IntensitySum<A, B>> {
+  A Left;
+  B Right;
+
+  IntensitySum(A Left_, B Right_) : Left(Left_), Right(Right_) {}
+  void update(const double *Parameters) {
+    Left.update(Parameters);
+    Right.update(Parameters);
+  }
+  double operator()(const EvaluationContext &Context, std::size_t Event) const {
+    return Left(Context, Event) + Right(Context, Event);
+  }
+};
+
+/// Intensity scaled by a strength parameter.
+template <typename I> struct Strength : IntensityExpression<Strength<I>> {
+  ParameterRef Factor;
+  I Intensity;
+  double Value;
+
+  Strength(ParameterRef Factor_, I Intensity_)
+      : Factor(Factor_), Intensity(Intensity_) {}
+  void update(const double *Parameters) {
+    Intensity.update(Parameters);
+    Value = Parameters[Factor.Index];
+  }
+  double operator()(const EvaluationContext &Context, std::size_t Event) const {
+    return Value * Intensity(Context, Event);
+  }
+};
+
+/// Intensity normalized to an integral of one over the phase space sample.
+template <typename I>
+struct NormalizedIntensity : IntensityExpression<NormalizedIntensity<I>> {
+  I Intensity;
+  std::shared_ptr<const Data::DataSet> Phsp;
+  double Normalization = 1.0;
+
+  NormalizedIntensity(I Intensity_, std::shared_ptr<const Data::DataSet> Phsp_)
+      : Intensity(Intensity_), Phsp(Phsp_) {}
+  void update(const double *Parameters) {
+    Intensity.update(Parameters);
+    Normalization =
+        1.0 / integrate(Intensity, Parameters, *Phsp, [](double x) { return x; });
+  }
+  double operator()(const EvaluationContext &Context, std::size_t Event) const {
+    return Intensity(Context, Event) * Normalization;
+  }
+};
+
+// ------------------------------- Builders ---------------------------------
+
+inline Coefficient coefficient(ParameterRef Magnitude, ParameterRef Phase) {
+  return Coefficient(Magnitude, Phase);
+}
+
+template <typename A, typename B,
+          typename = typename std::enable_if<IsAmplitude<A>::value &&
+                                             IsAmplitude<B>::value>::type>
+AmplitudeProduct<A, B> operator*(A Left, B Right) {
+  return AmplitudeProduct<A, B>(Left, Right);
+}
+
+template <typename A, typename B,
+          typename = typename std::enable_if<IsAmplitude<A>::value &&
+                                             IsAmplitude<B>::value>::type>
+AmplitudeSum<A, B> operator+(A Left, B Right) {
+  return AmplitudeSum<A, B>(Left, Right);
+}
+
+template <typename A,
+          typename = typename std::enable_if<IsAmplitude<A>::value>::type>
+AbsSquare<A> absSquare(A Amplitude) {
+  return AbsSquare<A>(Amplitude);
+}
+
+template <typename A, typename B>
+typename std::enable_if<IsIntensity<A>::value && IsIntensity<B>::value,
+                        IntensitySum<A, B>>::type
+operator+(A Left, B Right) {
+  return IntensitySum<A, B>(Left, Right);
+}
+
+template <typename I,
+          typename = typename std::enable_if<IsIntensity<I>::value>::type>
+Strength<I> strength(ParameterRef Factor, I Intensity) {
+  return Strength<I>(Factor, Intensity);
+}
+
+template <typename A>
+typename std::enable_if<IsAmplitude<A>::value, NormalizedAmplitude<A>>::type
+normalized(A Amplitude, std::shared_ptr<const Data::DataSet> Phsp) {
+  return NormalizedAmplitude<A>(Amplitude, Phsp);
+}
+
+template <typename I>
+typename std::enable_if<IsIntensity<I>::value, NormalizedIntensity<I>>::type
+normalized(I Intensity, std::shared_ptr<const Data::DataSet> Phsp) {
+  return NormalizedIntensity<I>(Intensity, Phsp);
+}
+
+// ----------------------------- Intensity ----------------------------------
+
+///
+/// \class CompiledIntensity
+/// Implementation of the ComPWA::Intensity interface for an intensity
+/// expression \p Expr.
+///
+template <typename Expr> class CompiledIntensity : public ComPWA::Intensity {
+  static_assert(IsIntensity<Expr>::value,
+                "CompiledIntensity: expression is not an intensity!");
+
+public:
+  CompiledIntensity(Expr Expression_,
+                    const std::vector<ComPWA::Parameter> &Parameters_)
+      : Expression(Expression_), Parameters(Parameters_) {
+    for (const auto &p : Parameters)
+      Values.push_back(p.Value);
+    Expression.update(Values.data());
+  }
+
+  std::vector<double>
+  evaluate(const std::vector<std::vector<double>> &data) noexcept final {
+    // the columns of variables that are not used can be empty
+    std::size_t n(0);
+    for (const auto &Column : data) {
+      n = Column.size();
+      if (n)
+        break;
+    }
+    return evaluate(createEvaluationContext(Values.data(), data), n);
+  }
+
+  /// Evaluate \p NumberOfEvents events of the data \p Columns in place. The
+  /// columns are not copied, so they can point into a memory mapped file.
+  std::vector<double> evaluate(const std::vector<const double *> &Columns,
+                               std::size_t NumberOfEvents) const {
+    return evaluate(createEvaluationContext(Values.data(), Columns),
+                    NumberOfEvents);
+  }
+
+  void updateParametersFrom(const std::vector<double> &params) final {
+    if (params.size() != Values.size())
+      throw BadParameter("CompiledIntensity::updateParametersFrom() | Number "
+                         "of parameters does not match: " +
+                         std::to_string(params.size()) + " given but " +
+                         std::to_string(Values.size()) + " expected.");
+    if (params == Values)
+      return;
+    Values = params;
+    for (std::size_t i = 0; i < Values.size(); ++i)
+      Parameters[i].Value = Values[i];
+    Expression.update(Values.data());
+  }
+
+  std::vector<ComPWA::Parameter> getParameters() const final {
+    return Parameters;
+  }
+
+private:
+  std::vector<double> evaluate(const EvaluationContext &Context,
+                               std::size_t NumberOfEvents) const {
+    std::vector<double> Result(NumberOfEvents);
+    for (std::size_t i = 0; i < NumberOfEvents; ++i)
+      Result[i] = Expression(Context, i);
+    return Result;
+  }
+
+  Expr Expression;
+  std::vector<ComPWA::Parameter> Parameters;
+  std::vector<double> Values;
+};
+
+template <typename Expr>
+CompiledIntensity<Expr> makeIntensity(Expr Expression,
+                                      const ParameterSet &Parameters) {
+  return CompiledIntensity<Expr>(Expression, Parameters.parameters());
+}
+
+} // namespace Compiled
+} // namespace Physics
+} // namespace ComPWA
+
+#endif
@@ -0,0 +1,339 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+///
+/// \file
+/// Building blocks of helicity decay amplitudes for the compiled intensity
+/// expressions (see Expression.hpp).
+///
+/// The nodes evaluate the same dynamical functions as the corresponding
+/// FunctionTree strategies. Spins, helicities, orbital angular momenta and
+/// form factor types are template parameters. Since half-integer spins can
+/// not be template arguments, spins and helicities are given as twice their
+/// value (e.g. wignerD<3, 1, -1> for J=3/2, mu'=1/2, mu=-1/2).
+///
+
+#ifndef COMPWA_PHYSICS_COMPILED_HELICITYEXPRESSION_HPP_
+#define COMPWA_PHYSICS_COMPILED_HELICITYEXPRESSION_HPP_
+
+#include "Core/VectorMath.hpp"
+#include "Physics/Compiled/Expression.hpp"
+#include "Physics/Dynamics/Flatte.hpp"
+#include "Physics/Dynamics/FormFactor.hpp"
+#include "Physics/Dynamics/RelativisticBreitWigner.hpp"
+#include "Physics/HelicityFormalism/WignerD.hpp"
+
+namespace ComPWA {
+namespace Physics {
+namespace Compiled {
+
+/// Data columns of a SubSystem of the HelicityKinematics.
+struct HelicityColumns {
+  std::size_t MassSq;
+  std::size_t Theta;
+  std::size_t Phi;
+};
+
+/// Columns of the SubSystem with ID \p SubSystemID, as returned by
+/// HelicityKinematics::addSubSystem().
+inline HelicityColumns helicityColumns(unsigned int SubSystemID) {
+  return HelicityColumns{3 * SubSystemID, 3 * SubSystemID + 1,
+                         3 * SubSystemID + 2};
+}
+
+namespace Detail {
+
+constexpr long double factorial(int n) {
+  long double Result = 1.0L;
+  for (int i = 2; i <= n; ++i)
+    Result *= i;
+  return Result;
+}
+
+/// Square root via Newton's method, since std::sqrt is not constexpr. The
+/// iteration starts above the root and stops once it no longer decreases.
+constexpr long double sqrt(long double x) {
+  if (x <= 0.0L)
+    return 0.0L;
+  long double Root = x > 1.0L ? x : 1.0L;
+  for (int i = 0; i < 1000; ++i) {
+    long double Next = 0.5L * (Root + x / Root);
+    if (Next >= Root)
+      break;
+    Root = Next;
+  }
+  return Root;
+}
+
+/// Coefficient of the term \p k of the WignerD polynomial, see
+/// HelicityFormalism::WignerDCoefficients.
+constexpr double wignerDCoefficient(int TwiceJ, int TwiceMuPrime, int TwiceMu,
+                                    int k) {
+  int MPlusN = (TwiceMuPrime + TwiceMu) / 2;
+  int JPlusM = (TwiceJ + TwiceMuPrime) / 2;
+  int JMinusM = (TwiceJ - TwiceMuPrime) / 2;
+  int JPlusN = (TwiceJ + TwiceMu) / 2;
+  int JMinusN = (TwiceJ - TwiceMu) / 2;
+  long double Norm = Detail::sqrt((TwiceJ + 1) / (4.0L * M_PI));
+  long double Term =
+      Norm *
+      Detail::sqrt(factorial(JPlusM) * factorial(JMinusM) *
+                   factorial(JPlusN) * factorial(JMinusN)) /
+      (factorial(k) * factorial(JPlusM - k) * factorial(JPlusN - k) *
+       factorial(k - MPlusN));
+  return ((JPlusM + k) % 2) ? -Term : Term;
+}
+
+template <int Size> struct CoefficientArray {
+  double Values[Size];
+};
+
+template <int TwiceJ, int TwiceMuPrime, int TwiceMu, int KLow, int Size>
+constexpr CoefficientArray<Size> wignerDCoefficients() {
+  CoefficientArray<Size> Coefficients{};
+  for (int i = 0; i < Size; ++i)
+    Coefficients.Values[i] =
+        wignerDCoefficient(TwiceJ, TwiceMuPrime, TwiceMu, KLow + i);
+  return Coefficients;
+}
+
+/// Polynomial of HelicityFormalism::WignerDCoefficients with the powers and
+/// coefficients calculated at compile time.
+template <int TwiceJ, int TwiceMuPrime, int TwiceMu> struct WignerDPolynomial {
+  static constexpr int MPlusN = (TwiceMuPrime + TwiceMu) / 2;
+  static constexpr int JPlusM = (TwiceJ + TwiceMuPrime) / 2;
+  static constexpr int JPlusN = (TwiceJ + TwiceMu) / 2;
+  static constexpr int KLow = MPlusN > 0 ? MPlusN : 0;
+  static constexpr int KHigh = JPlusM < JPlusN ? JPlusM : JPlusN;
+  static constexpr int CosPower = 2 * KLow - MPlusN;
+  static constexpr int SinPower = TwiceJ + MPlusN - 2 * KHigh;
+  static constexpr int Size = KHigh - KLow + 1;
+  static constexpr CoefficientArray<Size> Coefficients =
+      wignerDCoefficients<TwiceJ, TwiceMuPrime, TwiceMu, KLow, Size>();
+};
+
+template <int TwiceJ, int TwiceMuPrime, int TwiceMu>
+constexpr CoefficientArray<
+    WignerDPolynomial<TwiceJ, TwiceMuPrime, TwiceMu>::Size>
+    WignerDPolynomial<TwiceJ, TwiceMuPrime, TwiceMu>::Coefficients;
+
+} // namespace Detail
+
+/// Angular distribution, see WignerDStrategy. The polynomial in cos(beta/2)
+/// and sin(beta/2) of HelicityFormalism::WignerDCoefficients is generated
+/// from the template parameters at compile time.
+template <int TwiceJ, int TwiceMuPrime, int TwiceMu>
+struct WignerD : AmplitudeExpression<WignerD<TwiceJ, TwiceMuPrime, TwiceMu>> {
+  static_assert(TwiceJ >= 0, "WignerD: negative spin!");
+  static_assert(TwiceMuPrime <= TwiceJ && -TwiceMuPrime <= TwiceJ &&
+                    TwiceMu <= TwiceJ && -TwiceMu <= TwiceJ,
+                "WignerD: helicity larger than the spin!");
+  static_assert((TwiceJ + TwiceMuPrime) % 2 == 0 &&
+                    (TwiceJ + TwiceMu) % 2 == 0,
+                "WignerD: spin and helicities are not all integer or all "
+                "half-integer!");
+
+  using Polynomial = Detail::WignerDPolynomial<TwiceJ, TwiceMuPrime, TwiceMu>;
+
+  HelicityColumns Columns;
+
+  explicit WignerD(HelicityColumns Columns_) : Columns(Columns_) {}
+  void update(const double *) {}
+  std::complex<double> operator()(const EvaluationContext &Context,
+                                  std::size_t Event) const {
+    if (TwiceJ == 0)
+      return std::complex<double>(1.0, 0.0);
+    double s, c;
+    VectorMath::sincos(0.5 * Context.column(Columns.Theta, Event), s, c);
+    double CosSq = c * c;
+    double SinSq = s * s;
+    // homogeneous Horner scheme in cos^2 and sin^2
+    double Sum = Polynomial::Coefficients.Values[Polynomial::Size - 1];
+    double SinPowers = 1.0;
+    for (int m = Polynomial::Size - 1; m-- > 0;) {
+      SinPowers *= SinSq;
+      Sum = Sum * CosSq + Polynomial::Coefficients.Values[m] * SinPowers;
+    }
+    double d = VectorMath::pow(c, Polynomial::CosPower) *
+               VectorMath::pow(s, Polynomial::SinPower) * Sum;
+    // phase exp(-i mu' alpha)
+    VectorMath::sincos(0.5 * TwiceMuPrime * Context.column(Columns.Phi, Event),
+                       s, c);
+    return std::complex<double>(d * c, -d * s);
+  }
+};
+
+/// Relativistic Breit-Wigner, see BreitWignerStrategy.
+template <unsigned int L, Dynamics::FormFactorType FFType>
+struct RelativisticBreitWigner
+    : AmplitudeExpression<RelativisticBreitWigner<L, FFType>> {
+  std::size_t MassSq;
+  ParameterRef Mass;
+  ParameterRef Width;
+  ParameterRef MesonRadius;
+  ParameterRef MassA;
+  ParameterRef MassB;
+  Dynamics::RelativisticBreitWigner::ParameterBlock Block;
+
+  RelativisticBreitWigner(std::size_t MassSq_, ParameterRef Mass_,
+                          ParameterRef Width_, ParameterRef MesonRadius_,
+                          ParameterRef MassA_, ParameterRef MassB_)
+      : MassSq(MassSq_), Mass(Mass_), Width(Width_), MesonRadius(MesonRadius_),
+        MassA(MassA_), MassB(MassB_) {}
+  void update(const double *Parameters) {
+    Block = Dynamics::RelativisticBreitWigner::createParameterBlock(
+        Parameters[Mass.Index], Parameters[MassA.Index],
+        Parameters[MassB.Index], Parameters[Width.Index], L,
+        Parameters[MesonRadius.Index], FFType);
+  }
+  std::complex<double> operator()(const EvaluationContext &Context,
+                                  std::size_t Event) const {
+    return Dynamics::RelativisticBreitWigner::dynamicalFunction(
+        Context.column(MassSq, Event), Block);
+  }
+};
+
+/// Masses and coupling of a Flatte decay channel.
+struct FlatteChannel {
+  ParameterRef MassA;
+  ParameterRef MassB;
+  ParameterRef G;
+};
+
+/// Flatte with two or three coupled channels, see FlatteStrategy. The
+/// channel constants are calculated once per evaluation in update().
+template <unsigned int L, Dynamics::FormFactorType FFType>
+struct Flatte : AmplitudeExpression<Flatte<L, FFType>> {
+  std::size_t MassSq;
+  ParameterRef Mass;
+  ParameterRef MesonRadius;
+  FlatteChannel Signal;
+  FlatteChannel HiddenB;
+  FlatteChannel HiddenC;
+  bool HasHiddenC;
+  double MassR;
+  double SignalCoupling;
+  double Radius;
+  Dynamics::Flatte::ChannelBlock Channels[3];
+  unsigned int NumberOfChannels;
+
+  Flatte(std::size_t MassSq_, ParameterRef Mass_, ParameterRef MesonRadius_,
+         FlatteChannel Signal_, FlatteChannel HiddenB_)
+      : MassSq(MassSq_), Mass(Mass_), MesonRadius(MesonRadius_),
+        Signal(Signal_), HiddenB(HiddenB_), HiddenC(HiddenB_),
+        HasHiddenC(false), NumberOfChannels(0) {}
+  Flatte(std::size_t MassSq_, ParameterRef Mass_, ParameterRef MesonRadius_,
+         FlatteChannel Signal_, FlatteChannel HiddenB_, FlatteChannel HiddenC_)
+      : MassSq(MassSq_), Mass(Mass_), MesonRadius(MesonRadius_),
+        Signal(Signal_), HiddenB(HiddenB_), HiddenC(HiddenC_),
+        HasHiddenC(true), NumberOfChannels(0) {}
+  void update(const double *Parameters) {
+    MassR = Parameters[Mass.Index];
+    SignalCoupling = Parameters[Signal.G.Index];
+    Radius = Parameters[MesonRadius.Index];
+    NumberOfChannels = 0;
+    const FlatteChannel *All[] = {&Signal, &HiddenB, &HiddenC};
+    for (unsigned int i = 0; i < 3; ++i) {
+      double Coupling = Parameters[All[i]->G.Index];
+      // the third channel is skipped if its coupling is zero, like in
+      // Flatte::dynamicalFunction()
+      if (i == 2 && (!HasHiddenC || Coupling == 0.0))
+        continue;
+      Channels[NumberOfChannels++] = Dynamics::Flatte::createChannelBlock(
+          MassR, Coupling, Parameters[All[i]->MassA.Index],
+          Parameters[All[i]->MassB.Index], L, Radius, FFType);
+    }
+  }
+  std::complex<double> operator()(const EvaluationContext &Context,
+                                  std::size_t Event) const {
+    double mSq = Context.column(MassSq, Event);
+    double sqrtS = std::sqrt(mSq);
+    // sum of the coupling terms, see Flatte::flatteCouplingTerm()
+    std::complex<double> Term(0.0, 0.0);
+    for (unsigned int i = 0; i < NumberOfChannels; ++i) {
+      const auto &Channel = Channels[i];
+      double b = Dynamics::FormFactor(sqrtS, Channel.MassA, Channel.MassB, L,
+                                      Radius, FFType) /
+                 Channel.FormFactorR;
+      Term += Channel.CouplingSq / MassR * b * b *
+              Dynamics::phspFactor(sqrtS, Channel.MassA, Channel.MassB);
+    }
+    return Dynamics::Flatte::dynamicalFunction(mSq, MassR, SignalCoupling,
+                                               Term, 0.0);
+  }
+};
+
+/// Production form factor of a decay, see FormFactorStrategy.
+template <unsigned int L, Dynamics::FormFactorType FFType>
+struct ProductionFormFactor
+    : AmplitudeExpression<ProductionFormFactor<L, FFType>> {
+  std::size_t MassSq;
+  ParameterRef MesonRadius;
+  ParameterRef MassA;
+  ParameterRef MassB;
+
+  ProductionFormFactor(std::size_t MassSq_, ParameterRef MesonRadius_,
+                       ParameterRef MassA_, ParameterRef MassB_)
+      : MassSq(MassSq_), MesonRadius(MesonRadius_), MassA(MassA_),
+        MassB(MassB_) {}
+  void update(const double *) {}
+  std::complex<double> operator()(const EvaluationContext &Context,
+                                  std::size_t Event) const {
+    // Dynamics::FormFactor() expects sqrt(s), but FormFactorStrategy passes
+    // the invariant mass squared. The same argument is passed here, so that
+    // both give identical results. The agreement with the FunctionTree is
+    // therefore no check of the physics of the production form factor.
+    return Dynamics::FormFactor(
+        Context.column(MassSq, Event), Context.parameter(MassA),
+        Context.parameter(MassB), L, Context.parameter(MesonRadius), FFType);
+  }
+};
+
+// ------------------------------- Builders ---------------------------------
+
+template <int TwiceJ, int TwiceMuPrime, int TwiceMu>
+WignerD<TwiceJ, TwiceMuPrime, TwiceMu> wignerD(HelicityColumns Columns) {
+  return WignerD<TwiceJ, TwiceMuPrime, TwiceMu>(Columns);
+}
+
+template <unsigned int L, Dynamics::FormFactorType FFType =
+                              Dynamics::FormFactorType::noFormFactor>
+RelativisticBreitWigner<L, FFType>
+relativisticBreitWigner(HelicityColumns Columns, ParameterRef Mass,
+                        ParameterRef Width, ParameterRef MesonRadius,
+                        ParameterRef MassA, ParameterRef MassB) {
+  return RelativisticBreitWigner<L, FFType>(Columns.MassSq, Mass, Width,
+                                            MesonRadius, MassA, MassB);
+}
+
+template <unsigned int L, Dynamics::FormFactorType FFType =
+                              Dynamics::FormFactorType::noFormFactor>
+Flatte<L, FFType> flatte(HelicityColumns Columns, ParameterRef Mass,
+                         ParameterRef MesonRadius, FlatteChannel Signal,
+                         FlatteChannel HiddenB) {
+  return Flatte<L, FFType>(Columns.MassSq, Mass, MesonRadius, Signal, HiddenB);
+}
+
+template <unsigned int L, Dynamics::FormFactorType FFType =
+                              Dynamics::FormFactorType::noFormFactor>
+Flatte<L, FFType> flatte(HelicityColumns Columns, ParameterRef Mass,
+                         ParameterRef MesonRadius, FlatteChannel Signal,
+                         FlatteChannel HiddenB, FlatteChannel HiddenC) {
+  return Flatte<L, FFType>(Columns.MassSq, Mass, MesonRadius, Signal, HiddenB,
+                           HiddenC);
+}
+
+template <unsigned int L, Dynamics::FormFactorType FFType>
+ProductionFormFactor<L, FFType>
+productionFormFactor(HelicityColumns Columns, ParameterRef MesonRadius,
+                     ParameterRef MassA, ParameterRef MassB) {
+  return ProductionFormFactor<L, FFType>(Columns.MassSq, MesonRadius, MassA,
+                                         MassB);
+}
+
+} // namespace Compiled
+} // namespace Physics
+} // namespace ComPWA
+
+#endif
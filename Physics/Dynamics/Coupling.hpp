@@ -20,18 +20,6 @@ inline std::complex<double> couplingToWidth(double mR, double g,
                                             std::complex<double> phspFactor) {
   // calculate phsp factor
   std::complex<double> res = std::norm(gamma) * g * g * phspFactor / mR;
-
-#ifndef NDEBUG
-  // check for NaN
-  if (std::isnan(res.real()) || std::isnan(res.imag()))
-    throw std::runtime_error("AmpAbsDynamicalFunction::couplingToWidth() | "
-                             "Result is NaN!");
-  // check for inf
-  if (std::isinf(res.real()) || std::isinf(res.imag()))
-    throw std::runtime_error("AmpAbsDynamicalFunction::couplingToWidth() | "
-                             "Result is inf!");
-#endif
-
   return res;
 }
 
@@ -67,17 +55,6 @@ inline std::complex<double> widthToCoupling(double mR, double width,
 
   auto denom = gamma * std::sqrt(phspFactor);
   auto res = std::complex<double>(sqrt(mR * width), 0) / denom;
-
-#ifndef NDEBUG
-  // check for NaN
-  if (std::isnan(res.real()) || std::isnan(res.imag()))
-    throw std::runtime_error("AmpAbsDynamicalFunction::widthToCoupling() | "
-                             "Result is NaN!");
-  // check for inf
-  if (std::isinf(res.real()) || std::isinf(res.imag()))
-    throw std::runtime_error("AbstractDynamicalFunction::widthToCoupling() | "
-                             "Result is inf!");
-#endif
   return res;
 }
 
@@ -2,6 +2,8 @@
 // This file is part of the ComPWA framework, check
 // https://github.com/ComPWA/ComPWA/license.txt for details.
 
+#include <algorithm>
+
 #include "Flatte.hpp"
 
 namespace ComPWA {
@@ -14,6 +16,15 @@ using ComPWA::FunctionTree::Parameter;
 using ComPWA::FunctionTree::ParameterList;
 using ComPWA::FunctionTree::Value;
 
+namespace {
+
+/// Number of events whose denominators are calculated together. The loops
+/// over the events of a block operate on plain arrays and are vectorised by
+/// the compiler.
+const std::size_t EventBlockSize = 64;
+
+} // namespace
+
 std::shared_ptr<FunctionTree> Flatte::createFunctionTree(
     InputInfo Params, const ComPWA::FunctionTree::ParameterList &DataSample,
     unsigned int pos, std::string suffix) {
@@ -29,7 +40,9 @@ std::shared_ptr<FunctionTree> Flatte::createFunctionTree(
   if (!Params.G)
     throw std::runtime_error(
         "Flatte::createFunctionTree() | Coupling to signal channel not set");
-        
+
+  checkFormFactorType(Params.L, Params.FFType);
+
   size_t sampleSize = DataSample.mDoubleValue(pos)->values().size();
 
   std::string NodeName = "Flatte" + suffix;
@@ -39,7 +52,7 @@ std::shared_ptr<FunctionTree> Flatte::createFunctionTree(
 
   tr->createLeaf("Mass", Params.Mass, NodeName);
   tr->createLeaf("massA", Params.DaughterMasses.first, NodeName);
-  tr->createLeaf("massB", Params.DaughterMasses.first, NodeName);
+  tr->createLeaf("massB", Params.DaughterMasses.second, NodeName);
   tr->createLeaf("G", Params.G, NodeName);
   for (unsigned int i = 0; i < Params.HiddenCouplings.size(); ++i) {
     tr->createLeaf("g_" + std::to_string(i) + "_massA",
@@ -58,6 +71,31 @@ std::shared_ptr<FunctionTree> Flatte::createFunctionTree(
   return tr;
 }
 
+std::shared_ptr<FunctionTree> Flatte::createFunctionTree(
+    InputInfo Params, const ComPWA::FunctionTree::ParameterList &DataSample,
+    unsigned int pos, std::string suffix, FactorTreeCache &Cache) {
+  auto tr = createFunctionTree(Params, DataSample, pos, suffix);
+  std::string NodeName = tr->Head->name();
+
+  // signal channel and the given hidden channels, in the order of the leaves
+  std::vector<std::pair<std::shared_ptr<FitParameter>,
+                        std::shared_ptr<FitParameter>>>
+      ChannelMasses{Params.DaughterMasses};
+  for (const auto &Channel : Params.HiddenCouplings)
+    ChannelMasses.push_back(std::make_pair(Channel.MassA, Channel.MassB));
+  for (const auto &Masses : ChannelMasses) {
+    tr->insertTree(Cache.phspFactorTree(Masses.first, Masses.second,
+                                        DataSample, pos, suffix),
+                   NodeName);
+    tr->insertTree(Cache.barrierFactorTree(Masses.first, Masses.second,
+                                           Params.MesonRadius, Params.L,
+                                           Params.FFType, DataSample, pos,
+                                           suffix),
+                   NodeName);
+  }
+  return tr;
+}
+
 void FlatteStrategy::execute(ParameterList &paras,
                              std::shared_ptr<Parameter> &out) {
   if (out && checkType != out->type())
@@ -83,10 +121,12 @@ void FlatteStrategy::execute(ParameterList &paras,
   size_t nComplex = paras.complexValues().size();
   size_t check_nMInteger = 0;
   size_t nMInteger = paras.mIntValues().size();
-  size_t check_nMDouble = 1;
   size_t nMDouble = paras.mDoubleValues().size();
-  size_t check_nMComplex = 0;
   size_t nMComplex = paras.mComplexValues().size();
+  // mSq, and optionally the shared barrier and phase space factors of two
+  // or three channels
+  size_t check_nMDouble = 1 + nMComplex;
+  size_t check_nMComplex = (nMComplex == 2 || nMComplex == 3) ? nMComplex : 0;
 
   // Check size of parameter list
   if (nInt != check_nInt)
@@ -131,31 +171,82 @@ void FlatteStrategy::execute(ParameterList &paras,
   if (results.size() != n) {
     results.resize(n);
   }
-  // calc function for each point
-  for (size_t ele = 0; ele < n; ele++) {
-    try {
-      // Generally we need to add a factor q^{2J+1} to each channel term.
-      // But since Flatte resonances are usually J=0 we neglect it here.
-      results.at(ele) = Flatte::dynamicalFunction(
-          paras.mDoubleValue(0)->values().at(ele),
-          paras.doubleParameter(0)->value(), // mass
-          paras.doubleParameter(1)->value(), // g1_massA
-          paras.doubleParameter(2)->value(), // g1_massB
-          paras.doubleParameter(3)->value(), // g1
-          paras.doubleParameter(4)->value(), // g2_massA
-          paras.doubleParameter(5)->value(), // g2_massB
-          paras.doubleParameter(6)->value(), // g2
-          paras.doubleParameter(7)->value(), // g3_massA
-          paras.doubleParameter(8)->value(), // g3_massB
-          paras.doubleParameter(9)->value(), // g3
-          paras.doubleValue(0)->value(),     // OrbitalAngularMomentum
-          paras.doubleParameter(10)->value(),// mesonRadius
-          FormFactorType(paras.doubleValue(1)->value()) // ffType
-      );
-    } catch (std::exception &ex) {
-      LOG(ERROR) << "FlatteStrategy::execute() | " << ex.what();
-      throw(std::runtime_error("FlatteStrategy::execute() | "
-                               "Evaluation of dynamic function failed!"));
+  double mR = paras.doubleParameter(0)->value();
+  double gA = paras.doubleParameter(3)->value();
+  unsigned int orbitL = paras.doubleValue(0)->value();
+  double MesonRadius = paras.doubleParameter(10)->value();
+  FormFactorType ffType = FormFactorType(paras.doubleValue(1)->value());
+  bool HasSharedFactors = paras.mComplexValues().size() > 0;
+
+  const double *mSq = paras.mDoubleValue(0)->values().data();
+  std::complex<double> *Result = results.data();
+  // The parameters of channel i are massA, massB and the coupling at the
+  // positions 3 * i + 1 to 3 * i + 3. The third channel is optional and is
+  // skipped if its coupling is zero, like in Flatte::dynamicalFunction().
+  // Generally we need to add a factor q^{2J+1} to each channel term.
+  // But since Flatte resonances are usually J=0 we neglect it here.
+  std::vector<Flatte::ChannelBlock> Channels;
+  std::vector<const std::complex<double> *> SharedPhsp;
+  std::vector<const double *> SharedBarrier;
+  for (unsigned int i = 0; i < 3; ++i) {
+    double Coupling = paras.doubleParameter(3 * i + 3)->value();
+    if (i == 2 && Coupling == 0.0)
+      continue;
+    Channels.push_back(Flatte::createChannelBlock(
+        mR, Coupling, paras.doubleParameter(3 * i + 1)->value(),
+        paras.doubleParameter(3 * i + 2)->value(), orbitL, MesonRadius,
+        ffType));
+    if (HasSharedFactors) {
+      SharedPhsp.push_back(paras.mComplexValue(i)->values().data());
+      SharedBarrier.push_back(paras.mDoubleValue(i + 1)->values().data());
+    }
+  }
+
+  double mRSq = mR * mR;
+  for (size_t Begin = 0; Begin < n; Begin += EventBlockSize) {
+    size_t Size = std::min(EventBlockSize, n - Begin);
+    double SqrtS[EventBlockSize];
+    double TermRe[EventBlockSize];
+    double TermIm[EventBlockSize];
+    for (size_t i = 0; i < Size; ++i) {
+      SqrtS[i] = std::sqrt(mSq[Begin + i]);
+      TermRe[i] = 0.0;
+      TermIm[i] = 0.0;
+    }
+
+    // sum of the coupling terms, see Flatte::flatteCouplingTerm()
+    for (size_t k = 0; k < Channels.size(); ++k) {
+      const auto &Channel = Channels[k];
+      std::complex<double> PhspBuffer[EventBlockSize];
+      double BarrierBuffer[EventBlockSize];
+      const std::complex<double> *Phsp = PhspBuffer;
+      const double *Barrier = BarrierBuffer;
+      if (HasSharedFactors) {
+        Phsp = SharedPhsp[k] + Begin;
+        Barrier = SharedBarrier[k] + Begin;
+      } else {
+        std::complex<double> Q[EventBlockSize];
+        phspFactor(Size, SqrtS, Channel.MassA, Channel.MassB, PhspBuffer);
+        for (size_t i = 0; i < Size; ++i)
+          Q[i] = PhspBuffer[i] * (8.0 * M_PI * SqrtS[i]);
+        FormFactor(Size, Q, orbitL, MesonRadius, ffType, BarrierBuffer);
+      }
+      const double *PhspParts = reinterpret_cast<const double *>(Phsp);
+      for (size_t i = 0; i < Size; ++i) {
+        double b = Barrier[i] / Channel.FormFactorR;
+        TermRe[i] += Channel.CouplingSq * PhspParts[2 * i] / mR * b * b;
+        TermIm[i] += Channel.CouplingSq * PhspParts[2 * i + 1] / mR * b * b;
+      }
+    }
+
+    // gA / (mR^2 - s - i sqrt(s) * Term)
+    double *ResultParts = reinterpret_cast<double *>(Result + Begin);
+    for (size_t i = 0; i < Size; ++i) {
+      double DenomRe = mRSq - mSq[Begin + i] + SqrtS[i] * TermIm[i];
+      double DenomIm = -SqrtS[i] * TermRe[i];
+      double Scale = gA / (DenomRe * DenomRe + DenomIm * DenomIm);
+      ResultParts[2 * i] = DenomRe * Scale;
+      ResultParts[2 * i + 1] = -DenomIm * Scale;
     }
   }
 }
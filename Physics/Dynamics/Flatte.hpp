@@ -47,6 +47,37 @@ inline std::complex<double> flatteCouplingTerm(double sqrtS, double mR,
   return (width * barrierA * barrierA);
 }
 
+/// Quantities of flatteCouplingTerm() that depend only on the parameters of
+/// a channel. They are calculated once per evaluation by
+/// createChannelBlock().
+struct ChannelBlock {
+  double MassA;
+  double MassB;
+  double Coupling;
+  /// Form factor at the resonance position
+  double FormFactorR;
+  /// std::norm(vtxA) * coupling * coupling, the factor of couplingToWidth()
+  double CouplingSq;
+};
+
+inline ChannelBlock createChannelBlock(double mR, double coupling,
+                                       double massA, double massB,
+                                       unsigned int J, double mesonRadius,
+                                       FormFactorType ffType) {
+  ChannelBlock Block;
+  Block.MassA = massA;
+  Block.MassB = massB;
+  Block.Coupling = coupling;
+  auto qR = qValue(mR, massA, massB);
+  Block.FormFactorR = FormFactor(qR, J, mesonRadius, ffType);
+  std::complex<double> vtxA(1, 0); // spin==0
+  if (J > 0 || ffType == FormFactorType::CrystalBarrel) {
+    vtxA = Block.FormFactorR * std::pow(qR, J);
+  }
+  Block.CouplingSq = std::norm(vtxA) * coupling * coupling;
+  return Block;
+}
+
 /** Dynamical function for two coupled channel approach
  *
  * @param mSq center-of-mass energy^2 (=s)
@@ -69,14 +100,6 @@ dynamicalFunction(double mSq, double mR, double gA, std::complex<double> termA,
 
   std::complex<double> result = std::complex<double>(gA, 0) / denom;
 
-#ifndef NDEBUG
-  if (std::isnan(result.real()) || std::isnan(result.imag())) {
-    std::cout << "AmpFlatteRes::dynamicalFunction() | " << mR << " " << mSq
-              << " " << termA << " " << termB << " " << termC << std::endl;
-    return 0;
-  }
-#endif
-
   return result;
 }
 
@@ -127,8 +150,26 @@ createFunctionTree(InputInfo Params,
                    const ComPWA::FunctionTree::ParameterList &DataSample,
                    unsigned int pos, std::string suffix);
 
+/// Same as above, but the phase space factors and barrier factors of the
+/// channels at sqrt(s) are taken from the shared trees of \p Cache.
+std::shared_ptr<ComPWA::FunctionTree::FunctionTree>
+createFunctionTree(InputInfo Params,
+                   const ComPWA::FunctionTree::ParameterList &DataSample,
+                   unsigned int pos, std::string suffix,
+                   FactorTreeCache &Cache);
+
 } // namespace Flatte
 
+///
+/// \class FlatteStrategy
+/// Batched evaluation of Flatte::dynamicalFunction(). The channel constants
+/// are calculated once per evaluation with createChannelBlock(). The phase
+/// space and barrier factors of the channels are read from shared nodes if
+/// they are attached (see FactorTreeCache), otherwise they are calculated
+/// per event. The denominator is evaluated in blocks of events with real
+/// arithmetic, so that the compiler vectorises the loop. The result agrees
+/// with Flatte::dynamicalFunction() up to rounding.
+///
 class FlatteStrategy : public ComPWA::FunctionTree::Strategy {
 public:
   FlatteStrategy(const std::string resonanceName)
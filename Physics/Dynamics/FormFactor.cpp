@@ -2,6 +2,11 @@
 // This file is part of the ComPWA framework, check
 // https://github.com/ComPWA/ComPWA/license.txt for details.
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+#include "Core/VectorMath.hpp"
 #include "FormFactor.hpp"
 
 namespace ComPWA {
@@ -14,6 +19,137 @@ using ComPWA::FunctionTree::Parameter;
 using ComPWA::FunctionTree::ParameterList;
 using ComPWA::FunctionTree::Value;
 
+namespace {
+
+/// Number of events whose phase space factors are calculated together.
+const std::size_t EventBlockSize = 64;
+
+/// Squared Blatt-Weisskopf form factor of FormFactor() for z = q^2 R^2.
+template <unsigned int L> double blattWeisskopfSq(double z);
+template <> double blattWeisskopfSq<1>(double z) { return 2 * z / (z + 1); }
+template <> double blattWeisskopfSq<2>(double z) {
+  return 13 * z * z / ((z - 3) * (z - 3) + 9 * z);
+}
+template <> double blattWeisskopfSq<3>(double z) {
+  return 277 * z * z * z /
+         (z * (z - 15) * (z - 15) + 9 * (2 * z - 5) * (2 * z - 5));
+}
+template <> double blattWeisskopfSq<4>(double z) {
+  return 12746 * z * z * z * z /
+         ((z * z - 45 * z + 105) * (z * z - 45 * z + 105) +
+          25 * z * (2 * z - 21) * (2 * z - 21));
+}
+
+/// Blatt-Weisskopf form factors of \p n break-up momenta \p q (real and
+/// imaginary parts).
+template <unsigned int L>
+void blattWeisskopf(std::size_t n, const double *q, double mesonRadius,
+                    double *Result) {
+  double RadiusSq = mesonRadius * mesonRadius;
+  for (std::size_t i = 0; i < n; ++i) {
+    double qSq = q[2 * i] * q[2 * i] + q[2 * i + 1] * q[2 * i + 1];
+    double z = std::fabs(qSq * RadiusSq);
+    Result[i] = VectorMath::sqrt(blattWeisskopfSq<L>(z));
+  }
+}
+
+} // namespace
+
+void phspFactor(std::size_t n, const double *sqrtS, double ma, double mb,
+                std::complex<double> *Result) {
+  double ThresholdSq = (ma + mb) * (ma + mb);
+  double *ResultParts = reinterpret_cast<double *>(Result);
+  for (std::size_t i = 0; i < n; ++i) {
+    double s = sqrtS[i] * sqrtS[i];
+    double q = std::sqrt(std::fabs(qSqValue(sqrtS[i], ma, mb) * 4 / s));
+    double Log = VectorMath::log(std::fabs((1 + q) / (1 - q)));
+    double Atan = VectorMath::atan(1 / q);
+    double Norm = 1.0 / (16.0 * M_PI * sqrtS[i]);
+
+    // above threshold: (-q/pi log|(1+q)/(1-q)| + i q) / (i 16 pi sqrtS)
+    double AboveRe = q * Norm;
+    double AboveIm = q / M_PI * Log * Norm;
+    // below threshold: (-2q/pi atan(1/q)) / (i 16 pi sqrtS)
+    double BelowIm = 2.0 * q / M_PI * Atan * Norm;
+    // below 0: -q/pi log|(1+q)/(1-q)|, NaN for invalid sqrtS
+    double NegativeRe = -q / M_PI * Log;
+
+    bool Above = ThresholdSq < s;
+    bool Below = 0 < s && !Above;
+    ResultParts[2 * i] = Above ? AboveRe : (Below ? 0.0 : NegativeRe);
+    ResultParts[2 * i + 1] = Above ? AboveIm : (Below ? BelowIm : 0.0);
+  }
+}
+
+void qValue(std::size_t n, const double *sqrtS, double ma, double mb,
+            std::complex<double> *Result) {
+  phspFactor(n, sqrtS, ma, mb, Result);
+  double *ResultParts = reinterpret_cast<double *>(Result);
+  for (std::size_t i = 0; i < n; ++i) {
+    double Scale = 8.0 * M_PI * sqrtS[i];
+    ResultParts[2 * i] *= Scale;
+    ResultParts[2 * i + 1] *= Scale;
+  }
+}
+
+void checkFormFactorType(unsigned int orbitL, FormFactorType type) {
+  if (type == FormFactorType::noFormFactor)
+    return;
+  if (type == FormFactorType::CrystalBarrel) {
+    if (orbitL != 0)
+      throw BadParameter("checkFormFactorType() | Form factors of type " +
+                         std::string(formFactorTypeString[type]) +
+                         " are implemented for spin 0 only!");
+  } else if (type == FormFactorType::BlattWeisskopf) {
+    if (orbitL > 4)
+      throw BadParameter("checkFormFactorType() | Form factors of type " +
+                         std::string(formFactorTypeString[type]) +
+                         " are implemented for spins up to 4!");
+  } else {
+    throw BadParameter("checkFormFactorType() | Form factor type " +
+                       std::to_string((long long int)type) +
+                       " not specified!");
+  }
+}
+
+void FormFactor(std::size_t n, const std::complex<double> *qValue,
+                unsigned int orbitL, double mesonRadius, FormFactorType type,
+                double *Result) {
+  const double *q = reinterpret_cast<const double *>(qValue);
+  bool Disabled = mesonRadius == 0 || type == FormFactorType::noFormFactor ||
+                  (type == FormFactorType::BlattWeisskopf && orbitL == 0);
+  if (Disabled) {
+    std::fill(Result, Result + n, 1.0);
+  } else if (type == FormFactorType::CrystalBarrel && orbitL == 0) {
+    double alpha = mesonRadius * mesonRadius / 6;
+    for (std::size_t i = 0; i < n; ++i) {
+      double qSq = q[2 * i] * q[2 * i] + q[2 * i + 1] * q[2 * i + 1];
+      Result[i] = VectorMath::exp(-alpha * qSq);
+    }
+  } else if (type == FormFactorType::BlattWeisskopf && orbitL == 1) {
+    blattWeisskopf<1>(n, q, mesonRadius, Result);
+  } else if (type == FormFactorType::BlattWeisskopf && orbitL == 2) {
+    blattWeisskopf<2>(n, q, mesonRadius, Result);
+  } else if (type == FormFactorType::BlattWeisskopf && orbitL == 3) {
+    blattWeisskopf<3>(n, q, mesonRadius, Result);
+  } else if (type == FormFactorType::BlattWeisskopf && orbitL == 4) {
+    blattWeisskopf<4>(n, q, mesonRadius, Result);
+  } else {
+    std::fill(Result, Result + n, std::numeric_limits<double>::quiet_NaN());
+  }
+}
+
+void FormFactor(std::size_t n, const double *sqrtS, double ma, double mb,
+                unsigned int orbitL, double mesonRadius, FormFactorType type,
+                double *Result) {
+  for (std::size_t Begin = 0; Begin < n; Begin += EventBlockSize) {
+    std::size_t Size = std::min(EventBlockSize, n - Begin);
+    std::complex<double> Q[EventBlockSize];
+    qValue(Size, sqrtS + Begin, ma, mb, Q);
+    FormFactor(Size, Q, orbitL, mesonRadius, type, Result + Begin);
+  }
+}
+
 std::shared_ptr<ComPWA::FunctionTree::FunctionTree> createFunctionTree(
     std::string Name,
     std::shared_ptr<ComPWA::FunctionTree::FitParameter> Daughter1Mass,
@@ -21,7 +157,8 @@ std::shared_ptr<ComPWA::FunctionTree::FunctionTree> createFunctionTree(
     std::shared_ptr<ComPWA::FunctionTree::FitParameter> MesonRadius,
     unsigned int L, FormFactorType FFType, const ParameterList &DataSample,
     unsigned int pos, std::string suffix) {
-  size_t sampleSize = DataSample.mDoubleValue(0)->values().size();
+  checkFormFactorType(L, FFType);
+  size_t sampleSize = DataSample.mDoubleValue(pos)->values().size();
 
   std::string ffNodeName = "ProductionFormFactor(" + Name + ")" + suffix;
   auto ffTree = std::make_shared<FunctionTree>(
@@ -123,19 +260,182 @@ void FormFactorStrategy::execute(ParameterList &paras,
   double ma = paras.doubleParameter(1)->value();
   double mb = paras.doubleParameter(2)->value();
 
-  // calc function for each point
-  for (unsigned int ele = 0; ele < n; ele++) {
-    try {
-      results.at(ele) = FormFactor(paras.mDoubleValue(0)->values().at(ele), ma,
-                                   mb, orbitL, MesonRadius, ffType);
-    } catch (std::exception &ex) {
-      LOG(ERROR) << "FormFactorStrategy::execute() | " << ex.what();
-      throw(std::runtime_error("FormFactorStrategy::execute() | "
-                               "Evaluation of dynamic function failed!"));
+  // calc function for each point. Note that the invariant mass squared is
+  // passed as the first argument of FormFactor(), which expects sqrt(s). The
+  // reference integrals of the existing models depend on this.
+  const double *mSq = paras.mDoubleValue(0)->values().data();
+  double *Result = results.data();
+  try {
+    FormFactor(n, mSq, ma, mb, orbitL, MesonRadius, ffType, Result);
+  } catch (std::exception &ex) {
+    LOG(ERROR) << "FormFactorStrategy::execute() | " << ex.what();
+    throw(std::runtime_error("FormFactorStrategy::execute() | "
+                             "Evaluation of dynamic function failed!"));
+  }
+}
+
+void PhspFactorStrategy::execute(ParameterList &paras,
+                                 std::shared_ptr<Parameter> &out) {
+  if (out && checkType != out->type())
+    throw BadParameter(
+        "PhspFactorStrategy::execute() | Parameter type mismatch!");
+
+#ifndef NDEBUG
+  // MassA, MassB and the data column mSq
+  if (paras.doubleParameters().size() != 2 ||
+      paras.mDoubleValues().size() != 1)
+    throw BadParameter("PhspFactorStrategy::execute() | Expected two masses "
+                       "and one data column!");
+#endif
+
+  size_t n = paras.mDoubleValue(0)->values().size();
+  if (!out)
+    out = ComPWA::FunctionTree::MComplex("", n);
+  auto par =
+      std::static_pointer_cast<Value<std::vector<std::complex<double>>>>(out);
+  auto &results = par->values(); // reference
+  if (results.size() != n)
+    results.resize(n);
+
+  double ma = paras.doubleParameter(0)->value();
+  double mb = paras.doubleParameter(1)->value();
+  const double *mSq = paras.mDoubleValue(0)->values().data();
+  std::complex<double> *Result = results.data();
+  try {
+    for (size_t Begin = 0; Begin < n; Begin += EventBlockSize) {
+      size_t Size = std::min(EventBlockSize, n - Begin);
+      double SqrtS[EventBlockSize];
+      for (size_t i = 0; i < Size; ++i)
+        SqrtS[i] = std::sqrt(mSq[Begin + i]);
+      phspFactor(Size, SqrtS, ma, mb, Result + Begin);
     }
+  } catch (std::exception &ex) {
+    LOG(ERROR) << "PhspFactorStrategy::execute() | " << ex.what();
+    throw(std::runtime_error("PhspFactorStrategy::execute() | "
+                             "Evaluation of phase space factor failed!"));
   }
 }
 
+void BarrierFactorStrategy::execute(ParameterList &paras,
+                                    std::shared_ptr<Parameter> &out) {
+  if (out && checkType != out->type())
+    throw BadParameter(
+        "BarrierFactorStrategy::execute() | Parameter type mismatch!");
+
+#ifndef NDEBUG
+  // L, FFType, MesonRadius, the data column mSq and the phase space factor
+  if (paras.doubleValues().size() != 2 ||
+      paras.doubleParameters().size() != 1 ||
+      paras.mDoubleValues().size() != 1 || paras.mComplexValues().size() != 1)
+    throw BadParameter("BarrierFactorStrategy::execute() | Unexpected "
+                       "number of parameters!");
+#endif
+
+  size_t n = paras.mDoubleValue(0)->values().size();
+  if (!out)
+    out = ComPWA::FunctionTree::MDouble("", n);
+  auto par = std::static_pointer_cast<Value<std::vector<double>>>(out);
+  auto &results = par->values(); // reference
+  if (results.size() != n)
+    results.resize(n);
+
+  unsigned int orbitL = paras.doubleValue(0)->value();
+  double MesonRadius = paras.doubleParameter(0)->value();
+  FormFactorType ffType = FormFactorType(paras.doubleValue(1)->value());
+  const double *mSq = paras.mDoubleValue(0)->values().data();
+  const std::complex<double> *Phsp = paras.mComplexValue(0)->values().data();
+  double *Result = results.data();
+  try {
+    for (size_t Begin = 0; Begin < n; Begin += EventBlockSize) {
+      size_t Size = std::min(EventBlockSize, n - Begin);
+      // break-up momentum like in qValue()
+      std::complex<double> Q[EventBlockSize];
+      for (size_t i = 0; i < Size; ++i)
+        Q[i] = Phsp[Begin + i] * (8.0 * M_PI * std::sqrt(mSq[Begin + i]));
+      FormFactor(Size, Q, orbitL, MesonRadius, ffType, Result + Begin);
+    }
+  } catch (std::exception &ex) {
+    LOG(ERROR) << "BarrierFactorStrategy::execute() | " << ex.what();
+    throw(std::runtime_error("BarrierFactorStrategy::execute() | "
+                             "Evaluation of barrier factor failed!"));
+  }
+}
+
+std::shared_ptr<FunctionTree>
+FactorTreeCache::phspFactorTree(std::shared_ptr<FitParameter> MassA,
+                                std::shared_ptr<FitParameter> MassB,
+                                const ParameterList &DataSample,
+                                unsigned int pos, std::string suffix) {
+  auto Column = DataSample.mDoubleValue(pos);
+  Key PhspKey(Column, MassA, MassB, ParameterKey(), 0, 0);
+  if (auto Cached = PhspFactorTrees.find(PhspKey))
+    return Cached;
+
+  std::string NodeName = PhspFactorTrees.uniqueName(
+      "PhspFactor", "(" + MassA->name() + "," + MassB->name() + ")[" +
+                        Column->name() + "]" + suffix);
+  auto Tree = std::make_shared<FunctionTree>(
+      NodeName, ComPWA::FunctionTree::MComplex("", Column->values().size()),
+      std::make_shared<PhspFactorStrategy>());
+  Tree->createLeaf("MassA", MassA, NodeName);
+  Tree->createLeaf("MassB", MassB, NodeName);
+  Tree->createLeaf(Column->name(), Column, NodeName);
+
+  PhspFactorTrees.insert(PhspKey, Tree);
+  return Tree;
+}
+
+std::shared_ptr<FunctionTree> FactorTreeCache::barrierFactorTree(
+    std::shared_ptr<FitParameter> MassA, std::shared_ptr<FitParameter> MassB,
+    std::shared_ptr<FitParameter> MesonRadius, unsigned int L,
+    FormFactorType FFType, const ParameterList &DataSample, unsigned int pos,
+    std::string suffix) {
+  checkFormFactorType(L, FFType);
+  auto Column = DataSample.mDoubleValue(pos);
+  Key BarrierKey(Column, MassA, MassB, MesonRadius, L, FFType);
+  if (auto Cached = BarrierFactorTrees.find(BarrierKey))
+    return Cached;
+
+  std::string NodeName = BarrierFactorTrees.uniqueName(
+      "BarrierFactor", "(" + MassA->name() + "," + MassB->name() + ",L=" +
+                           std::to_string(L) + "," + MesonRadius->name() +
+                           "," + formFactorTypeString[FFType] + ")[" +
+                           Column->name() + "]" + suffix);
+  auto Tree = std::make_shared<FunctionTree>(
+      NodeName, ComPWA::FunctionTree::MDouble("", Column->values().size()),
+      std::make_shared<BarrierFactorStrategy>());
+  Tree->createLeaf("OrbitalAngularMomentum", L, NodeName);
+  Tree->createLeaf("MesonRadius", MesonRadius, NodeName);
+  Tree->createLeaf("FormFactorType", (double)FFType, NodeName);
+  Tree->createLeaf(Column->name(), Column, NodeName);
+  Tree->insertTree(phspFactorTree(MassA, MassB, DataSample, pos, suffix),
+                   NodeName);
+
+  BarrierFactorTrees.insert(BarrierKey, Tree);
+  return Tree;
+}
+
+std::shared_ptr<FunctionTree> FactorTreeCache::productionFormFactorTree(
+    std::shared_ptr<FitParameter> MassA, std::shared_ptr<FitParameter> MassB,
+    std::shared_ptr<FitParameter> MesonRadius, unsigned int L,
+    FormFactorType FFType, const ParameterList &DataSample, unsigned int pos,
+    std::string suffix) {
+  auto Column = DataSample.mDoubleValue(pos);
+  Key FormFactorKey(Column, MassA, MassB, MesonRadius, L, FFType);
+  if (auto Cached = ProductionFormFactorTrees.find(FormFactorKey))
+    return Cached;
+
+  std::string Name = ProductionFormFactorTrees.uniqueName(
+      "", "," + MassA->name() + "," + MassB->name() + ",L=" +
+              std::to_string(L) + "," + MesonRadius->name() + "," +
+              formFactorTypeString[FFType]);
+  auto Tree = createFunctionTree(Name, MassA, MassB, MesonRadius, L, FFType,
+                                 DataSample, pos, suffix);
+
+  ProductionFormFactorTrees.insert(FormFactorKey, Tree);
+  return Tree;
+}
+
 } // namespace Dynamics
 } // namespace Physics
 } // namespace ComPWA
@@ -7,8 +7,11 @@
 
 #include <complex>
 #include <exception>
+#include <map>
+#include <tuple>
 
 #include "Core/FunctionTree/FunctionTree.hpp"
+#include "Core/FunctionTree/FunctionTreeCache.hpp"
 #include "Core/FunctionTree/Functions.hpp"
 
 namespace ComPWA {
@@ -68,15 +71,6 @@ inline std::complex<double> phspFactor(double sqrtS, double ma, double mb) {
                              "defined at sqrtS = " +
                              std::to_string((long double)sqrtS));
 
-#ifndef NDEBUG
-  if (rho.real() != rho.real() || rho.imag() != rho.imag()) {
-    std::stringstream ss;
-    ss << "phspFactor() | Result invalid (NaN)! sqrtS=" << sqrtS
-       << ", ma=" << ma << ", mb=" << mb;
-    throw std::runtime_error(ss.str());
-  }
-#endif
-
   return rho; // correct analytical continuation
 }
 
@@ -90,11 +84,31 @@ inline std::complex<double> qValue(double sqrtS, double ma, double mb) {
   return phspFactor(sqrtS, ma, mb) * 8.0 * M_PI * sqrtS;
 }
 
+/// Two body phsp factor of \p n events at the invariant masses \p sqrtS.
+/// Same as phspFactor() above, but all three regions of the analytic
+/// continuation are calculated for each event and the result is selected
+/// afterwards. The loop contains no branches and no calls to libm (see
+/// VectorMath.hpp), so that it is vectorised by the compiler. The input is
+/// not checked, invalid values of \p sqrtS give NaN or Inf. The values of a
+/// FunctionTree can be validated with FunctionTree::checkNumericalHealth().
+void phspFactor(std::size_t n, const double *sqrtS, double ma, double mb,
+                std::complex<double> *Result);
+
+/// Break-up momentum of \p n events, see phspFactor() above.
+void qValue(std::size_t n, const double *sqrtS, double ma, double mb,
+            std::complex<double> *Result);
+
 static const char *formFactorTypeString[] = {"noFormFactor", "BlattWeisskopf",
                                              "CrystalBarrel"};
 
 enum FormFactorType { noFormFactor = 0, BlattWeisskopf = 1, CrystalBarrel = 2 };
 
+/// Check that FormFactor() is implemented for the form factor \p type and the
+/// orbital angular momentum \p orbitL. Throws a BadParameter exception
+/// otherwise. The FunctionTrees of the dynamical functions call this at
+/// construction, so that the loops over the events do not throw.
+void checkFormFactorType(unsigned int orbitL, FormFactorType type);
+
 /// Calculate form factor from the (complex) break-up momentum \p qValue.
 inline double FormFactor(std::complex<double> qValue, unsigned int orbitL,
                          double mesonRadius, FormFactorType type) {
@@ -174,6 +188,21 @@ inline double FormFactor(double sqrtS, double ma, double mb,
   return FormFactor(qV, orbitL, mesonRadius, type);
 }
 
+/// Form factors of \p n events from the (complex) break-up momenta
+/// \p qValue, see FormFactor() above. The type and orbital angular momentum
+/// are selected once outside of the loop over the events. The loop uses the
+/// functions of VectorMath.hpp and is vectorised by the compiler. The result
+/// agrees with FormFactor() within a few ULP. Unsupported combinations of
+/// \p type and \p orbitL (see checkFormFactorType()) give NaN.
+void FormFactor(std::size_t n, const std::complex<double> *qValue,
+                unsigned int orbitL, double mesonRadius, FormFactorType type,
+                double *Result);
+
+/// Form factors of \p n events at \p sqrtS, see FormFactor() above.
+void FormFactor(std::size_t n, const double *sqrtS, double ma, double mb,
+                unsigned int orbitL, double mesonRadius, FormFactorType type,
+                double *Result);
+
 std::shared_ptr<ComPWA::FunctionTree::FunctionTree> createFunctionTree(
     std::string Name,
     std::shared_ptr<ComPWA::FunctionTree::FitParameter> Daughter1Mass,
@@ -200,6 +229,87 @@ private:
   std::string name;
 };
 
+/// Strategy that calculates phspFactor(sqrt(mSq), ma, mb) for each event.
+/// Leaves: MassA, MassB and the data column mSq.
+class PhspFactorStrategy : public ComPWA::FunctionTree::Strategy {
+public:
+  PhspFactorStrategy()
+      : ComPWA::FunctionTree::Strategy(
+            ComPWA::FunctionTree::ParType::MCOMPLEX) {}
+
+  virtual const std::string to_str() const { return "PhspFactorStrategy"; }
+
+  virtual void execute(ComPWA::FunctionTree::ParameterList &paras,
+                       std::shared_ptr<ComPWA::FunctionTree::Parameter> &out);
+};
+
+/// Strategy that calculates the barrier factor
+/// FormFactor(sqrt(mSq), ma, mb, L, MesonRadius, FFType) for each event. The
+/// break-up momentum is taken from a phase space factor node, so that the
+/// result is identical to the one of
+/// RelativisticBreitWigner::dynamicalFunction(). Leaves: L, MesonRadius,
+/// FFType, the data column mSq and the phase space factor column.
+class BarrierFactorStrategy : public ComPWA::FunctionTree::Strategy {
+public:
+  BarrierFactorStrategy()
+      : ComPWA::FunctionTree::Strategy(ComPWA::FunctionTree::ParType::MDOUBLE) {
+  }
+
+  virtual const std::string to_str() const { return "BarrierFactorStrategy"; }
+
+  virtual void execute(ComPWA::FunctionTree::ParameterList &paras,
+                       std::shared_ptr<ComPWA::FunctionTree::Parameter> &out);
+};
+
+///
+/// \class FactorTreeCache
+/// Per event factors that depend only on a data column and on the daughter
+/// masses are identical for all resonances of the same subsystem and decay
+/// channel. The cache creates a FunctionTree for each of these factors once
+/// and returns the same tree for all further requests, so that the factor is
+/// calculated once per data column. The trees are keyed by the data column
+/// (data and phase space sample are different columns), the mass, radius
+/// parameters and the quantum numbers. The parameters are compared by
+/// identity, therefore the trees are only shared if the parameters are
+/// (e.g. via ParameterList::addUniqueParameter()).
+///
+class FactorTreeCache {
+public:
+  /// Phase space factor phspFactor(sqrt(mSq), ma, mb) of data column \p pos.
+  std::shared_ptr<ComPWA::FunctionTree::FunctionTree> phspFactorTree(
+      std::shared_ptr<ComPWA::FunctionTree::FitParameter> MassA,
+      std::shared_ptr<ComPWA::FunctionTree::FitParameter> MassB,
+      const ComPWA::FunctionTree::ParameterList &DataSample, unsigned int pos,
+      std::string suffix = "");
+
+  /// Barrier factor FormFactor(sqrt(mSq), ma, mb, L, MesonRadius, FFType) of
+  /// data column \p pos. It uses the shared phspFactorTree() as input.
+  std::shared_ptr<ComPWA::FunctionTree::FunctionTree> barrierFactorTree(
+      std::shared_ptr<ComPWA::FunctionTree::FitParameter> MassA,
+      std::shared_ptr<ComPWA::FunctionTree::FitParameter> MassB,
+      std::shared_ptr<ComPWA::FunctionTree::FitParameter> MesonRadius,
+      unsigned int L, FormFactorType FFType,
+      const ComPWA::FunctionTree::ParameterList &DataSample, unsigned int pos,
+      std::string suffix = "");
+
+  /// Production form factor of createFunctionTree() above.
+  std::shared_ptr<ComPWA::FunctionTree::FunctionTree> productionFormFactorTree(
+      std::shared_ptr<ComPWA::FunctionTree::FitParameter> MassA,
+      std::shared_ptr<ComPWA::FunctionTree::FitParameter> MassB,
+      std::shared_ptr<ComPWA::FunctionTree::FitParameter> MesonRadius,
+      unsigned int L, FormFactorType FFType,
+      const ComPWA::FunctionTree::ParameterList &DataSample, unsigned int pos,
+      std::string suffix = "");
+
+private:
+  using ParameterKey = std::weak_ptr<const ComPWA::FunctionTree::Parameter>;
+  using Key = std::tuple<ParameterKey, ParameterKey, ParameterKey,
+                         ParameterKey, unsigned int, int>;
+  ComPWA::FunctionTree::FunctionTreeCache<Key> PhspFactorTrees;
+  ComPWA::FunctionTree::FunctionTreeCache<Key> BarrierFactorTrees;
+  ComPWA::FunctionTree::FunctionTreeCache<Key> ProductionFormFactorTrees;
+};
+
 } // namespace Dynamics
 } // namespace Physics
 } // namespace ComPWA
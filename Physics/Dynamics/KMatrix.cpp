@@ -0,0 +1,376 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <cmath>
+
+#include "Core/Exceptions.hpp"
+#include "KMatrix.hpp"
+
+namespace ComPWA {
+namespace Physics {
+namespace Dynamics {
+
+using ComPWA::FunctionTree::FunctionTree;
+using ComPWA::FunctionTree::Parameter;
+using ComPWA::FunctionTree::ParameterList;
+using ComPWA::FunctionTree::Value;
+
+namespace {
+
+/// Number of events whose linear systems are solved together.
+const std::size_t EventBlockSize = 64;
+
+/// Square of the phase space factor rho = 2q/sqrt(s) of a channel with the
+/// particle masses \p ma and \p mb.
+inline double phspFactorSq(double mSq, double ma, double mb) {
+  double mapb = ma + mb;
+  double mamb = ma - mb;
+  return (1.0 - mapb * mapb / mSq) * (1.0 - mamb * mamb / mSq);
+}
+
+} // namespace
+
+std::complex<double> KMatrix::dynamicalFunction(double mSq,
+                                                const InputInfo &Params) {
+  std::size_t N = Params.Channels.size();
+  std::vector<double> K(N * N, 0.0);
+  std::vector<std::complex<double>> F(N, 0.0);
+  for (const auto &Pole : Params.Poles) {
+    double Denominator = Pole.Mass->value() * Pole.Mass->value() - mSq;
+    auto Beta = std::polar(std::abs(Pole.Magnitude->value()),
+                           Pole.Phase->value());
+    for (std::size_t a = 0; a < N; ++a) {
+      double ga = Pole.Couplings[a]->value();
+      F[a] += Beta * ga / Denominator;
+      for (std::size_t b = 0; b < N; ++b)
+        K[a * N + b] += ga * Pole.Couplings[b]->value() / Denominator;
+    }
+  }
+  for (const auto &Term : Params.Background) {
+    K[Term.ChannelA * N + Term.ChannelB] += Term.Value->value();
+    if (Term.ChannelA != Term.ChannelB)
+      K[Term.ChannelB * N + Term.ChannelA] += Term.Value->value();
+  }
+
+  // M = 1 - i K rho
+  std::complex<double> i(0, 1);
+  std::vector<std::complex<double>> M(N * N);
+  for (std::size_t b = 0; b < N; ++b) {
+    auto rho = std::sqrt(std::complex<double>(
+        phspFactorSq(mSq, Params.Channels[b].first->value(),
+                     Params.Channels[b].second->value()),
+        0.0));
+    for (std::size_t a = 0; a < N; ++a)
+      M[a * N + b] = double(a == b) - i * K[a * N + b] * rho;
+  }
+
+  // solve M F = P, F contains P on input
+  for (std::size_t k = 0; k < N; ++k) {
+    std::size_t Pivot = k;
+    for (std::size_t r = k + 1; r < N; ++r)
+      if (std::norm(M[r * N + k]) > std::norm(M[Pivot * N + k]))
+        Pivot = r;
+    for (std::size_t c = k; c < N; ++c)
+      std::swap(M[k * N + c], M[Pivot * N + c]);
+    std::swap(F[k], F[Pivot]);
+    for (std::size_t r = k + 1; r < N; ++r) {
+      auto Factor = M[r * N + k] / M[k * N + k];
+      for (std::size_t c = k + 1; c < N; ++c)
+        M[r * N + c] -= Factor * M[k * N + c];
+      F[r] -= Factor * F[k];
+    }
+  }
+  for (std::size_t k = N; k-- > 0;) {
+    for (std::size_t c = k + 1; c < N; ++c)
+      F[k] -= M[k * N + c] * F[c];
+    F[k] /= M[k * N + k];
+  }
+  return F[Params.Channel];
+}
+
+std::shared_ptr<FunctionTree>
+KMatrix::createFunctionTree(const InputInfo &Params,
+                            const ParameterList &DataSample, unsigned int pos,
+                            std::string suffix) {
+  std::size_t N = Params.Channels.size();
+  for (const auto &Pole : Params.Poles) {
+    if (Pole.Couplings.size() != N)
+      throw BadParameter("KMatrix::createFunctionTree() | Pole " +
+                         Pole.Mass->name() + " has " +
+                         std::to_string(Pole.Couplings.size()) +
+                         " couplings but there are " + std::to_string(N) +
+                         " channels!");
+  }
+  std::vector<std::pair<unsigned int, unsigned int>> BackgroundChannels;
+  for (const auto &Term : Params.Background)
+    BackgroundChannels.push_back(
+        std::make_pair(Term.ChannelA, Term.ChannelB));
+
+  size_t sampleSize = DataSample.mDoubleValue(pos)->values().size();
+  std::string NodeName = "KMatrix" + suffix;
+  auto tr = std::make_shared<FunctionTree>(
+      NodeName, ComPWA::FunctionTree::MComplex("", sampleSize),
+      std::make_shared<KMatrixStrategy>(N, Params.Poles.size(),
+                                        BackgroundChannels, Params.Channel));
+
+  for (std::size_t a = 0; a < N; ++a) {
+    std::string Prefix = "Channel" + std::to_string(a) + "_";
+    tr->createLeaf(Prefix + "MassA", Params.Channels[a].first, NodeName);
+    tr->createLeaf(Prefix + "MassB", Params.Channels[a].second, NodeName);
+  }
+  for (std::size_t p = 0; p < Params.Poles.size(); ++p) {
+    const auto &Pole = Params.Poles[p];
+    std::string Prefix = "Pole" + std::to_string(p) + "_";
+    tr->createLeaf(Prefix + "Mass", Pole.Mass, NodeName);
+    for (std::size_t a = 0; a < N; ++a)
+      tr->createLeaf(Prefix + "Coupling" + std::to_string(a),
+                     Pole.Couplings[a], NodeName);
+    tr->createLeaf(Prefix + "Magnitude", Pole.Magnitude, NodeName);
+    tr->createLeaf(Prefix + "Phase", Pole.Phase, NodeName);
+  }
+  for (const auto &Term : Params.Background)
+    tr->createLeaf("Background" + std::to_string(Term.ChannelA) + "_" +
+                       std::to_string(Term.ChannelB),
+                   Term.Value, NodeName);
+  tr->createLeaf(DataSample.mDoubleValue(pos)->name(),
+                 DataSample.mDoubleValue(pos), NodeName);
+
+  return tr;
+}
+
+KMatrixStrategy::KMatrixStrategy(
+    unsigned int NumberOfChannels_, unsigned int NumberOfPoles_,
+    std::vector<std::pair<unsigned int, unsigned int>> BackgroundChannels_,
+    unsigned int Channel_, std::string name_)
+    : ComPWA::FunctionTree::Strategy(ComPWA::FunctionTree::ParType::MCOMPLEX),
+      NumberOfChannels(NumberOfChannels_), NumberOfPoles(NumberOfPoles_),
+      BackgroundChannels(BackgroundChannels_), Channel(Channel_), name(name_) {
+  if (NumberOfChannels == 0 || NumberOfChannels > KMatrix::MaxChannels)
+    throw BadParameter("KMatrixStrategy::KMatrixStrategy() | " +
+                       std::to_string(NumberOfChannels) +
+                       " channels given, but 1 to " +
+                       std::to_string(KMatrix::MaxChannels) + " supported!");
+  if (Channel >= NumberOfChannels)
+    throw BadParameter("KMatrixStrategy::KMatrixStrategy() | Channel " +
+                       std::to_string(Channel) + " does not exist!");
+  for (const auto &Channels : BackgroundChannels) {
+    if (Channels.first >= NumberOfChannels ||
+        Channels.second >= NumberOfChannels)
+      throw BadParameter("KMatrixStrategy::KMatrixStrategy() | Background "
+                         "term of a channel that does not exist!");
+  }
+}
+
+void KMatrixStrategy::execute(ParameterList &paras,
+                              std::shared_ptr<Parameter> &out) {
+  if (out && checkType != out->type())
+    throw BadParameter("KMatrixStrategy::execute() | Parameter type mismatch!");
+
+  const unsigned int N = NumberOfChannels;
+#ifndef NDEBUG
+  size_t check_nDouble = 2 * N + NumberOfPoles * (N + 3) +
+                         BackgroundChannels.size();
+  if (paras.doubleParameters().size() != check_nDouble)
+    throw(BadParameter("KMatrixStrategy::execute() | "
+                       "Number of FitParameters does not match: " +
+                       std::to_string(paras.doubleParameters().size()) +
+                       " given but " + std::to_string(check_nDouble) +
+                       " expected."));
+  if (paras.mDoubleValues().size() != 1)
+    throw(BadParameter("KMatrixStrategy::execute() | "
+                       "Number of MultiDoubles does not match: " +
+                       std::to_string(paras.mDoubleValues().size()) +
+                       " given but 1 expected."));
+#endif
+
+  size_t n = paras.mDoubleValue(0)->values().size();
+  if (!out)
+    out = ComPWA::FunctionTree::MComplex("", n);
+  auto par =
+      std::static_pointer_cast<Value<std::vector<std::complex<double>>>>(out);
+  auto &results = par->values(); // reference
+  if (results.size() != n)
+    results.resize(n);
+
+  // quantities that do not depend on s: the squared pole masses, the
+  // residues g_i g_j and the P-vector couplings beta g_j of each pole
+  std::vector<double> ThresholdSq(N), PseudoThresholdSq(N);
+  for (unsigned int a = 0; a < N; ++a) {
+    double ma = paras.doubleParameter(2 * a)->value();
+    double mb = paras.doubleParameter(2 * a + 1)->value();
+    ThresholdSq[a] = (ma + mb) * (ma + mb);
+    PseudoThresholdSq[a] = (ma - mb) * (ma - mb);
+  }
+  std::vector<double> PoleMassSq(NumberOfPoles);
+  std::vector<double> Residues(NumberOfPoles * N * N);
+  std::vector<double> ProductionRe(NumberOfPoles * N);
+  std::vector<double> ProductionIm(NumberOfPoles * N);
+  for (unsigned int p = 0; p < NumberOfPoles; ++p) {
+    std::size_t First = 2 * N + p * (N + 3);
+    double Mass = paras.doubleParameter(First)->value();
+    PoleMassSq[p] = Mass * Mass;
+    double Magnitude = paras.doubleParameter(First + N + 1)->value();
+    double Phase = paras.doubleParameter(First + N + 2)->value();
+    auto Beta = std::polar(std::abs(Magnitude), Phase);
+    for (unsigned int a = 0; a < N; ++a) {
+      double ga = paras.doubleParameter(First + 1 + a)->value();
+      ProductionRe[p * N + a] = Beta.real() * ga;
+      ProductionIm[p * N + a] = Beta.imag() * ga;
+      for (unsigned int b = 0; b < N; ++b)
+        Residues[(p * N + a) * N + b] =
+            ga * paras.doubleParameter(First + 1 + b)->value();
+    }
+  }
+  std::vector<double> Background(N * N, 0.0);
+  std::size_t FirstBackground = 2 * N + NumberOfPoles * (N + 3);
+  for (std::size_t t = 0; t < BackgroundChannels.size(); ++t) {
+    unsigned int a = BackgroundChannels[t].first;
+    unsigned int b = BackgroundChannels[t].second;
+    double f = paras.doubleParameter(FirstBackground + t)->value();
+    Background[a * N + b] += f;
+    if (a != b)
+      Background[b * N + a] += f;
+  }
+
+  const double *mSq = paras.mDoubleValue(0)->values().data();
+  double *ResultParts = reinterpret_cast<double *>(results.data());
+  for (size_t Begin = 0; Begin < n; Begin += EventBlockSize) {
+    size_t Size = std::min(EventBlockSize, n - Begin);
+    const double *s = mSq + Begin;
+
+    // M = 1 - i K rho and the right hand side P of each event
+    double Mr[KMatrix::MaxChannels][KMatrix::MaxChannels][EventBlockSize];
+    double Mi[KMatrix::MaxChannels][KMatrix::MaxChannels][EventBlockSize];
+    double Fr[KMatrix::MaxChannels][EventBlockSize];
+    double Fi[KMatrix::MaxChannels][EventBlockSize];
+    double RhoRe[KMatrix::MaxChannels][EventBlockSize];
+    double RhoIm[KMatrix::MaxChannels][EventBlockSize];
+    for (unsigned int a = 0; a < N; ++a) {
+      for (size_t i = 0; i < Size; ++i) {
+        double RhoSq = (1.0 - ThresholdSq[a] / s[i]) *
+                       (1.0 - PseudoThresholdSq[a] / s[i]);
+        double Rho = std::sqrt(std::fabs(RhoSq));
+        RhoRe[a][i] = RhoSq >= 0.0 ? Rho : 0.0;
+        RhoIm[a][i] = RhoSq >= 0.0 ? 0.0 : Rho;
+        Fr[a][i] = 0.0;
+        Fi[a][i] = 0.0;
+      }
+      for (unsigned int b = 0; b < N; ++b)
+        for (size_t i = 0; i < Size; ++i)
+          Mr[a][b][i] = Background[a * N + b];
+    }
+    for (unsigned int p = 0; p < NumberOfPoles; ++p) {
+      double Denominator[EventBlockSize];
+      for (size_t i = 0; i < Size; ++i)
+        Denominator[i] = 1.0 / (PoleMassSq[p] - s[i]);
+      for (unsigned int a = 0; a < N; ++a) {
+        double Pr = ProductionRe[p * N + a];
+        double Pi = ProductionIm[p * N + a];
+        for (size_t i = 0; i < Size; ++i) {
+          Fr[a][i] += Pr * Denominator[i];
+          Fi[a][i] += Pi * Denominator[i];
+        }
+        for (unsigned int b = 0; b < N; ++b) {
+          double R = Residues[(p * N + a) * N + b];
+          for (size_t i = 0; i < Size; ++i)
+            Mr[a][b][i] += R * Denominator[i];
+        }
+      }
+    }
+    // Mr contains K, M_ab = delta_ab + K_ab Im(rho_b) - i K_ab Re(rho_b)
+    for (unsigned int a = 0; a < N; ++a) {
+      for (unsigned int b = 0; b < N; ++b) {
+        double Delta = a == b ? 1.0 : 0.0;
+        for (size_t i = 0; i < Size; ++i) {
+          double K = Mr[a][b][i];
+          Mr[a][b][i] = Delta + K * RhoIm[b][i];
+          Mi[a][b][i] = -K * RhoRe[b][i];
+        }
+      }
+    }
+
+    // Gaussian elimination, the row with the largest pivot is swapped
+    // into row k with selects
+    for (unsigned int k = 0; k < N; ++k) {
+      for (unsigned int r = k + 1; r < N; ++r) {
+        bool Swap[EventBlockSize];
+        for (size_t i = 0; i < Size; ++i)
+          Swap[i] = Mr[r][k][i] * Mr[r][k][i] + Mi[r][k][i] * Mi[r][k][i] >
+                    Mr[k][k][i] * Mr[k][k][i] + Mi[k][k][i] * Mi[k][k][i];
+        for (unsigned int c = k; c < N; ++c) {
+          for (size_t i = 0; i < Size; ++i) {
+            double Re = Mr[k][c][i], Im = Mi[k][c][i];
+            Mr[k][c][i] = Swap[i] ? Mr[r][c][i] : Re;
+            Mi[k][c][i] = Swap[i] ? Mi[r][c][i] : Im;
+            Mr[r][c][i] = Swap[i] ? Re : Mr[r][c][i];
+            Mi[r][c][i] = Swap[i] ? Im : Mi[r][c][i];
+          }
+        }
+        for (size_t i = 0; i < Size; ++i) {
+          double Re = Fr[k][i], Im = Fi[k][i];
+          Fr[k][i] = Swap[i] ? Fr[r][i] : Re;
+          Fi[k][i] = Swap[i] ? Fi[r][i] : Im;
+          Fr[r][i] = Swap[i] ? Re : Fr[r][i];
+          Fi[r][i] = Swap[i] ? Im : Fi[r][i];
+        }
+      }
+      // 1 / M_kk
+      double InvRe[EventBlockSize], InvIm[EventBlockSize];
+      for (size_t i = 0; i < Size; ++i) {
+        double Scale = 1.0 / (Mr[k][k][i] * Mr[k][k][i] +
+                              Mi[k][k][i] * Mi[k][k][i]);
+        InvRe[i] = Mr[k][k][i] * Scale;
+        InvIm[i] = -Mi[k][k][i] * Scale;
+      }
+      for (unsigned int r = k + 1; r < N; ++r) {
+        double FactorRe[EventBlockSize], FactorIm[EventBlockSize];
+        for (size_t i = 0; i < Size; ++i) {
+          FactorRe[i] = Mr[r][k][i] * InvRe[i] - Mi[r][k][i] * InvIm[i];
+          FactorIm[i] = Mr[r][k][i] * InvIm[i] + Mi[r][k][i] * InvRe[i];
+        }
+        for (unsigned int c = k + 1; c < N; ++c) {
+          for (size_t i = 0; i < Size; ++i) {
+            Mr[r][c][i] -= FactorRe[i] * Mr[k][c][i] -
+                           FactorIm[i] * Mi[k][c][i];
+            Mi[r][c][i] -= FactorRe[i] * Mi[k][c][i] +
+                           FactorIm[i] * Mr[k][c][i];
+          }
+        }
+        for (size_t i = 0; i < Size; ++i) {
+          Fr[r][i] -= FactorRe[i] * Fr[k][i] - FactorIm[i] * Fi[k][i];
+          Fi[r][i] -= FactorRe[i] * Fi[k][i] + FactorIm[i] * Fr[k][i];
+        }
+      }
+    }
+
+    // back substitution, stops at the channel of the amplitude
+    for (unsigned int k = N; k-- > Channel;) {
+      for (unsigned int c = k + 1; c < N; ++c) {
+        for (size_t i = 0; i < Size; ++i) {
+          Fr[k][i] -= Mr[k][c][i] * Fr[c][i] - Mi[k][c][i] * Fi[c][i];
+          Fi[k][i] -= Mr[k][c][i] * Fi[c][i] + Mi[k][c][i] * Fr[c][i];
+        }
+      }
+      for (size_t i = 0; i < Size; ++i) {
+        double Scale = 1.0 / (Mr[k][k][i] * Mr[k][k][i] +
+                              Mi[k][k][i] * Mi[k][k][i]);
+        double Re = (Fr[k][i] * Mr[k][k][i] + Fi[k][i] * Mi[k][k][i]);
+        double Im = (Fi[k][i] * Mr[k][k][i] - Fr[k][i] * Mi[k][k][i]);
+        Fr[k][i] = Re * Scale;
+        Fi[k][i] = Im * Scale;
+      }
+    }
+
+    double *Out = ResultParts + 2 * Begin;
+    for (size_t i = 0; i < Size; ++i) {
+      Out[2 * i] = Fr[Channel][i];
+      Out[2 * i + 1] = Fi[Channel][i];
+    }
+  }
+}
+
+} // namespace Dynamics
+} // namespace Physics
+} // namespace ComPWA
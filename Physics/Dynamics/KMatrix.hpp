@@ -0,0 +1,113 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef COMPWA_PHYSICS_DYNAMICS_KMATRIX_HPP_
+#define COMPWA_PHYSICS_DYNAMICS_KMATRIX_HPP_
+
+#include <complex>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "Core/FunctionTree/FitParameter.hpp"
+#include "Core/FunctionTree/FunctionTree.hpp"
+#include "Core/FunctionTree/Functions.hpp"
+
+namespace ComPWA {
+namespace Physics {
+namespace Dynamics {
+
+///
+/// \namespace KMatrix
+/// S-wave production amplitude of the K-matrix/P-vector approach (see PDG
+/// 2018, Resonances, Eq. 48.34 and I.J.R. Aitchison, Nucl. Phys. A189
+/// (1972) 417). For N channels and a set of poles alpha with masses m_alpha,
+/// real couplings g_alpha,i and complex production couplings beta_alpha
+///
+///   K_ij(s) = sum_alpha g_alpha,i g_alpha,j / (m_alpha^2 - s) + f_ij
+///   P_j(s) = sum_alpha beta_alpha g_alpha,j / (m_alpha^2 - s)
+///   F(s) = (1 - i K(s) rho(s))^-1 P(s)
+///
+/// with the background terms f_ij = f_ji and the phase space factors
+/// rho_j(s) = 2q_j/sqrt(s), which are continued to i|rho_j| below threshold.
+/// The amplitude is the component F_c of the channel c of the decay.
+///
+namespace KMatrix {
+
+/// Largest number of channels of the batched evaluation.
+const unsigned int MaxChannels = 5;
+
+struct Pole {
+  std::shared_ptr<ComPWA::FunctionTree::FitParameter> Mass;
+  /// Couplings g_alpha,i in the order of the channels
+  std::vector<std::shared_ptr<ComPWA::FunctionTree::FitParameter>> Couplings;
+  /// Production coupling beta_alpha = Magnitude * exp(i Phase)
+  std::shared_ptr<ComPWA::FunctionTree::FitParameter> Magnitude;
+  std::shared_ptr<ComPWA::FunctionTree::FitParameter> Phase;
+};
+
+/// Constant term f_ij = f_ji of the K-matrix.
+struct BackgroundTerm {
+  unsigned int ChannelA;
+  unsigned int ChannelB;
+  std::shared_ptr<ComPWA::FunctionTree::FitParameter> Value;
+};
+
+struct InputInfo {
+  /// Masses of the two particles of each channel
+  std::vector<std::pair<std::shared_ptr<ComPWA::FunctionTree::FitParameter>,
+                        std::shared_ptr<ComPWA::FunctionTree::FitParameter>>>
+      Channels;
+  std::vector<Pole> Poles;
+  std::vector<BackgroundTerm> Background;
+  /// Channel c of the amplitude F_c
+  unsigned int Channel = 0;
+};
+
+/// Amplitude F_c(s) at \p mSq. The linear system is solved with
+/// std::complex arithmetic, this is the reference for the
+/// KMatrixStrategy.
+std::complex<double> dynamicalFunction(double mSq, const InputInfo &Params);
+
+std::shared_ptr<ComPWA::FunctionTree::FunctionTree>
+createFunctionTree(const InputInfo &Params,
+                   const ComPWA::FunctionTree::ParameterList &DataSample,
+                   unsigned int pos, std::string suffix);
+
+} // namespace KMatrix
+
+/// Strategy that calculates the K-matrix amplitude for each event. The leaves
+/// are the masses of the channels, the mass, couplings, magnitude and phase
+/// of each pole, the background terms and the data column mSq. The residues
+/// g_alpha,i g_alpha,j and the P-vector couplings beta_alpha g_alpha,j are
+/// calculated once per evaluation. The events are processed in blocks, for
+/// which the linear system (1 - i K rho) F = P is solved by a Gaussian
+/// elimination with partial pivoting. The pivoting is done with selects, so
+/// that the loops over the events of a block are vectorised.
+class KMatrixStrategy : public ComPWA::FunctionTree::Strategy {
+public:
+  KMatrixStrategy(unsigned int NumberOfChannels_, unsigned int NumberOfPoles_,
+                  std::vector<std::pair<unsigned int, unsigned int>>
+                      BackgroundChannels_,
+                  unsigned int Channel_, std::string name_ = "");
+
+  virtual const std::string to_str() const { return ("K-matrix " + name); }
+
+  virtual void execute(ComPWA::FunctionTree::ParameterList &paras,
+                       std::shared_ptr<ComPWA::FunctionTree::Parameter> &out);
+
+protected:
+  unsigned int NumberOfChannels;
+  unsigned int NumberOfPoles;
+  std::vector<std::pair<unsigned int, unsigned int>> BackgroundChannels;
+  unsigned int Channel;
+  std::string name;
+};
+
+} // namespace Dynamics
+} // namespace Physics
+} // namespace ComPWA
+
+#endif
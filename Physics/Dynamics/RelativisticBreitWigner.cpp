@@ -2,6 +2,8 @@
 // This file is part of the ComPWA framework, check
 // https://github.com/ComPWA/ComPWA/license.txt for details.
 
+#include <algorithm>
+
 #include "RelativisticBreitWigner.hpp"
 
 namespace ComPWA {
@@ -14,9 +16,70 @@ using ComPWA::FunctionTree::Parameter;
 using ComPWA::FunctionTree::ParameterList;
 using ComPWA::FunctionTree::Value;
 
+namespace {
+
+/// Number of events whose phase space factors are calculated together.
+const std::size_t EventBlockSize = 64;
+
+} // namespace
+
+void RelativisticBreitWigner::dynamicalFunction(
+    std::size_t n, const double *mSq,
+    const std::complex<double> *phspFactorSqrtS, const double *ff,
+    const ParameterBlock &Block, std::complex<double> *Result) {
+  const double *Phsp = reinterpret_cast<const double *>(phspFactorSqrtS);
+  double *ResultParts = reinterpret_cast<double *>(Result);
+  // 1 / PhspFactorR
+  double PhspRNorm = std::norm(Block.PhspFactorR);
+  double InvPhspRRe = Block.PhspFactorR.real() / PhspRNorm;
+  double InvPhspRIm = -Block.PhspFactorR.imag() / PhspRNorm;
+  double GammaARe = Block.GammaA.real();
+  double GammaAIm = Block.GammaA.imag();
+  double mRSq = Block.mR * Block.mR;
+  for (std::size_t i = 0; i < n; ++i) {
+    double PhspRe = Phsp[2 * i];
+    double PhspIm = Phsp[2 * i + 1];
+    double sqrtS = std::sqrt(mSq[i]);
+
+    // barrierTermSq = phspFactorSqrtS / PhspFactorR * ff^2 / FormFactorRSq
+    double Scale = ff[i] * ff[i] / Block.FormFactorRSq;
+    double BarrierRe = (PhspRe * InvPhspRRe - PhspIm * InvPhspRIm) * Scale;
+    double BarrierIm = (PhspRe * InvPhspRIm + PhspIm * InvPhspRRe) * Scale;
+
+    // sqrt(phspFactorSqrtS) on the principal branch, like std::sqrt()
+    double Abs = std::sqrt(PhspRe * PhspRe + PhspIm * PhspIm);
+    double t = std::sqrt(0.5 * (std::fabs(PhspRe) + Abs));
+    double u = 0.5 * std::fabs(PhspIm) / t;
+    double SqrtRe = PhspRe >= 0 ? t : u;
+    double SqrtIm = std::copysign(PhspRe >= 0 ? u : t, PhspIm);
+
+    // g_final = SqrtMRWidth / (GammaA * sqrt(phspFactorSqrtS))
+    double VertexRe = GammaARe * SqrtRe - GammaAIm * SqrtIm;
+    double VertexIm = GammaARe * SqrtIm + GammaAIm * SqrtRe;
+    double VertexScale =
+        Block.SqrtMRWidth / (VertexRe * VertexRe + VertexIm * VertexIm);
+    double gRe = VertexRe * VertexScale;
+    double gIm = -VertexIm * VertexScale;
+
+    // g_final / (mR^2 - s - i sqrt(s) Width barrierTermSq)
+    double DenomRe = mRSq - mSq[i] + sqrtS * Block.Width * BarrierIm;
+    double DenomIm = -sqrtS * Block.Width * BarrierRe;
+    double DenomScale = 1.0 / (DenomRe * DenomRe + DenomIm * DenomIm);
+    double Re = (gRe * DenomRe + gIm * DenomIm) * DenomScale;
+    double Im = (gIm * DenomRe - gRe * DenomIm) * DenomScale;
+
+    // zero at the phase space boundary. The two selects use different
+    // comparisons, since GCC turns two selects with the same condition into
+    // a branch, which prevents the vectorisation of the loop.
+    ResultParts[2 * i] = Abs == 0.0 ? 0.0 : Re;
+    ResultParts[2 * i + 1] = Abs > 0.0 ? Im : 0.0;
+  }
+}
+
 std::shared_ptr<FunctionTree> RelativisticBreitWigner::createFunctionTree(
     RelativisticBreitWigner::InputInfo Params, const ParameterList &DataSample,
     unsigned int pos, std::string suffix) {
+  checkFormFactorType(Params.L, Params.FFType);
   size_t sampleSize = DataSample.mDoubleValue(pos)->values().size();
 
   std::string NodeName = "RelBreitWigner" + suffix;
@@ -38,6 +101,23 @@ std::shared_ptr<FunctionTree> RelativisticBreitWigner::createFunctionTree(
   return tr;
 };
 
+std::shared_ptr<FunctionTree> RelativisticBreitWigner::createFunctionTree(
+    RelativisticBreitWigner::InputInfo Params, const ParameterList &DataSample,
+    unsigned int pos, std::string suffix, FactorTreeCache &Cache) {
+  auto tr = createFunctionTree(Params, DataSample, pos, suffix);
+  std::string NodeName = tr->Head->name();
+  tr->insertTree(Cache.phspFactorTree(Params.DaughterMasses.first,
+                                      Params.DaughterMasses.second,
+                                      DataSample, pos, suffix),
+                 NodeName);
+  tr->insertTree(Cache.barrierFactorTree(
+                     Params.DaughterMasses.first, Params.DaughterMasses.second,
+                     Params.MesonRadius, Params.L, Params.FFType, DataSample,
+                     pos, suffix),
+                 NodeName);
+  return tr;
+}
+
 void BreitWignerStrategy::execute(ParameterList &paras,
                                   std::shared_ptr<Parameter> &out) {
   if (out && checkType != out->type())
@@ -64,10 +144,11 @@ void BreitWignerStrategy::execute(ParameterList &paras,
   size_t nComplex = paras.complexValues().size();
   size_t check_nMInteger = 0;
   size_t nMInteger = paras.mIntValues().size();
-  size_t check_nMDouble = 1;
   size_t nMDouble = paras.mDoubleValues().size();
-  size_t check_nMComplex = 0;
   size_t nMComplex = paras.mComplexValues().size();
+  // mSq, and optionally the shared barrier and phase space factors
+  size_t check_nMDouble = nMComplex ? 2 : 1;
+  size_t check_nMComplex = nMDouble > 1 ? 1 : 0;
 
   // Check size of parameter list
   if (nInt != check_nInt)
@@ -122,17 +203,35 @@ void BreitWignerStrategy::execute(ParameterList &paras,
   double ma = paras.doubleParameter(3)->value();
   double mb = paras.doubleParameter(4)->value();
 
-  // calc function for each point
-  for (unsigned int ele = 0; ele < n; ele++) {
-    try {
-      results.at(ele) =
-          ComPWA::Physics::Dynamics::RelativisticBreitWigner::dynamicalFunction(
-              paras.mDoubleValue(0)->values().at(ele), m0, ma, mb, Gamma0,
-              orbitL, MesonRadius, ffType);
-    } catch (std::exception &ex) {
-      LOG(ERROR) << "BreitWignerStrategy::execute() | " << ex.what();
-      throw(std::runtime_error("BreitWignerStrategy::execute() | "
-                               "Evaluation of dynamic function failed!"));
+  // calc function for each point, the parameter dependent terms are
+  // calculated only once. The phase space and barrier factors at sqrt(s) are
+  // taken from the shared nodes if they are attached. Otherwise the phase
+  // space factors are calculated in blocks of events.
+  const double *mSq = paras.mDoubleValue(0)->values().data();
+  std::complex<double> *Result = results.data();
+  auto Block = RelativisticBreitWigner::createParameterBlock(
+      m0, ma, mb, Gamma0, orbitL, MesonRadius, ffType);
+  if (paras.mComplexValues().size()) {
+    const double *ff = paras.mDoubleValue(1)->values().data();
+    const std::complex<double> *Phsp =
+        paras.mComplexValue(0)->values().data();
+    RelativisticBreitWigner::dynamicalFunction(n, mSq, Phsp, ff, Block,
+                                               Result);
+  } else {
+    for (size_t Begin = 0; Begin < n; Begin += EventBlockSize) {
+      size_t Size = std::min(EventBlockSize, n - Begin);
+      double SqrtS[EventBlockSize];
+      std::complex<double> Phsp[EventBlockSize];
+      for (size_t i = 0; i < Size; ++i)
+        SqrtS[i] = std::sqrt(mSq[Begin + i]);
+      std::complex<double> Q[EventBlockSize];
+      double ff[EventBlockSize];
+      phspFactor(Size, SqrtS, ma, mb, Phsp);
+      for (size_t i = 0; i < Size; ++i)
+        Q[i] = Phsp[i] * (8.0 * M_PI * SqrtS[i]);
+      FormFactor(Size, Q, orbitL, MesonRadius, ffType, ff);
+      RelativisticBreitWigner::dynamicalFunction(Size, mSq + Begin, Phsp, ff,
+                                                 Block, Result + Begin);
     }
   }
 }
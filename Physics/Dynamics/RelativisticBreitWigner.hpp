@@ -108,22 +108,120 @@ dynamicalFunction(double mSq, double mR, double ma, double mb, double width,
   denom += (-1.0) * i * sqrtS * (width * barrierTermSq);
 
   std::complex<double> result = g_final / denom;
+  return result;
+}
 
-  assert(
-      (!std::isnan(result.real()) || !std::isinf(result.real())) &&
-      "RelativisticBreitWigner::dynamicalFunction() | Result is NaN or Inf!");
-  assert(
-      (!std::isnan(result.imag()) || !std::isinf(result.imag())) &&
-      "RelativisticBreitWigner::dynamicalFunction() | Result is NaN or Inf!");
+/// Quantities of dynamicalFunction() that depend only on the parameters.
+/// They are calculated once per evaluation by createParameterBlock() instead
+/// of once per event.
+struct ParameterBlock {
+  double mR;
+  double ma;
+  double mb;
+  double Width;
+  unsigned int L;
+  double MesonRadius;
+  FormFactorType FFType;
+  /// Phase space factor at the resonance position
+  std::complex<double> PhspFactorR;
+  /// Squared form factor at the resonance position
+  double FormFactorRSq;
+  /// Normalized vertex function gammaA(s_R)
+  std::complex<double> GammaA;
+  /// Numerator of widthToCoupling()
+  double SqrtMRWidth;
+};
 
-  return result;
+inline ParameterBlock createParameterBlock(double mR, double ma, double mb,
+                                           double width, unsigned int L,
+                                           double mesonRadius,
+                                           FormFactorType ffType) {
+  ParameterBlock Block;
+  Block.mR = mR;
+  Block.ma = ma;
+  Block.mb = mb;
+  Block.Width = width;
+  Block.L = L;
+  Block.MesonRadius = mesonRadius;
+  Block.FFType = ffType;
+  Block.PhspFactorR = phspFactor(mR, ma, mb);
+  Block.SqrtMRWidth = std::sqrt(mR * width);
+
+  double ffR = FormFactor(mR, ma, mb, L, mesonRadius, ffType);
+  Block.FormFactorRSq = ffR * ffR;
+  Block.GammaA = std::complex<double>(1, 0); // spin==0
+  if (L > 0) {
+    std::complex<double> qR = std::pow(qValue(mR, ma, mb), L);
+    Block.GammaA = ffR * qR;
+  }
+  return Block;
+}
+
+/// Same as dynamicalFunction() above, with the parameter dependent terms
+/// taken from \p Block and the phase space factor \p phspFactorSqrtS and the
+/// barrier factor \p ff at sqrt(s) calculated by the caller. The arithmetic
+/// is the same, so that both functions give bit-identical results.
+inline std::complex<double>
+dynamicalFunction(double mSq, std::complex<double> phspFactorSqrtS, double ff,
+                  const ParameterBlock &Block) {
+  std::complex<double> i(0, 1);
+  double sqrtS = std::sqrt(mSq);
+
+  if (phspFactorSqrtS == std::complex<double>(0, 0))
+    return std::complex<double>(0, 0);
+
+  std::complex<double> qRatio = (phspFactorSqrtS / Block.PhspFactorR);
+  std::complex<double> barrierTermSq =
+      qRatio * (ff * ff) / Block.FormFactorRSq;
+
+  std::complex<double> g_final =
+      std::complex<double>(Block.SqrtMRWidth, 0) /
+      (Block.GammaA * std::sqrt(phspFactorSqrtS));
+
+  std::complex<double> denom(Block.mR * Block.mR - mSq, 0);
+  denom += (-1.0) * i * sqrtS * (Block.Width * barrierTermSq);
+
+  return g_final / denom;
 }
 
+/// Same as dynamicalFunction() above, with the parameter dependent terms
+/// taken from \p Block. The break-up momentum of the form factor is
+/// calculated from the phase space factor at sqrt(s), like in qValue().
+inline std::complex<double> dynamicalFunction(double mSq,
+                                              const ParameterBlock &Block) {
+  double sqrtS = std::sqrt(mSq);
+  auto phspFactorSqrtS = phspFactor(sqrtS, Block.ma, Block.mb);
+  if (phspFactorSqrtS == std::complex<double>(0, 0))
+    return std::complex<double>(0, 0);
+  double ff = FormFactor(phspFactorSqrtS * 8.0 * M_PI * sqrtS, Block.L,
+                         Block.MesonRadius, Block.FFType);
+  return dynamicalFunction(mSq, phspFactorSqrtS, ff, Block);
+}
+
+/// Same as dynamicalFunction(mSq, phspFactorSqrtS, ff, Block) above for \p n
+/// events. The complex arithmetic is written out in real and imaginary parts
+/// and the phase space boundary is handled by a select, so that the loop is
+/// vectorised by the compiler. The result agrees with the scalar function to
+/// a relative deviation of 1e-12.
+void dynamicalFunction(std::size_t n, const double *mSq,
+                       const std::complex<double> *phspFactorSqrtS,
+                       const double *ff, const ParameterBlock &Block,
+                       std::complex<double> *Result);
+
 std::shared_ptr<ComPWA::FunctionTree::FunctionTree>
 createFunctionTree(InputInfo Params,
                    const ComPWA::FunctionTree::ParameterList &DataSample,
                    unsigned int pos, std::string suffix);
 
+/// Same as above, but the phase space factor and the barrier factor at
+/// sqrt(s) are taken from the shared trees of \p Cache. Resonances of the
+/// same subsystem and decay channel calculate them only once.
+std::shared_ptr<ComPWA::FunctionTree::FunctionTree>
+createFunctionTree(InputInfo Params,
+                   const ComPWA::FunctionTree::ParameterList &DataSample,
+                   unsigned int pos, std::string suffix,
+                   FactorTreeCache &Cache);
+
 } // namespace RelativisticBreitWigner
 
 class BreitWignerStrategy : public ComPWA::FunctionTree::Strategy {
@@ -0,0 +1,285 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <cmath>
+
+#include "Core/Exceptions.hpp"
+#include "Core/Logging.hpp"
+#include "TabulatedDynamics.hpp"
+
+namespace ComPWA {
+namespace Physics {
+namespace Dynamics {
+
+using ComPWA::FunctionTree::FunctionTree;
+using ComPWA::FunctionTree::Parameter;
+using ComPWA::FunctionTree::ParameterList;
+using ComPWA::FunctionTree::ParType;
+using ComPWA::FunctionTree::Value;
+
+namespace {
+
+/// Number of events that are interpolated together.
+const std::size_t EventBlockSize = 64;
+
+/// Number of segments of the mSq interval
+const std::size_t NumberOfSegments = 16;
+
+/// Number of grid intervals of a segment before and after the refinement
+const std::size_t InitialIntervals = 4;
+const std::size_t MaxIntervals = 4096;
+
+/// Weights of the cubic interpolation through the grid points 0, 1, 2, 3 at
+/// position \p t (in units of the grid spacing).
+inline void cubicWeights(double t, double &w0, double &w1, double &w2,
+                         double &w3) {
+  double t1 = t - 1.0;
+  double t2 = t - 2.0;
+  double t3 = t - 3.0;
+  w0 = -t1 * t2 * t3 * (1.0 / 6.0);
+  w1 = 0.5 * t * t2 * t3;
+  w2 = -0.5 * t * t1 * t3;
+  w3 = t * t1 * t2 * (1.0 / 6.0);
+}
+
+/// Cubic interpolation of the equidistant \p Grid with \p n intervals at
+/// position \p t (in units of the grid spacing).
+std::complex<double>
+interpolateGrid(const std::vector<std::complex<double>> &Grid, std::size_t n,
+                double t) {
+  double First = std::max(0.0, std::min(std::floor(t) - 1.0, n - 3.0));
+  std::size_t j = First;
+  double w0, w1, w2, w3;
+  cubicWeights(t - First, w0, w1, w2, w3);
+  return w0 * Grid[j] + w1 * Grid[j + 1] + w2 * Grid[j + 2] +
+         w3 * Grid[j + 3];
+}
+
+/// Values of all parameters of \p paras that are not data columns.
+std::vector<double> parameterValues(const ParameterList &paras) {
+  std::vector<double> Values;
+  for (const auto &x : paras.doubleParameters())
+    Values.push_back(x->value());
+  for (const auto &x : paras.doubleValues())
+    Values.push_back(x->value());
+  for (const auto &x : paras.intValues())
+    Values.push_back(x->value());
+  for (const auto &x : paras.complexValues()) {
+    Values.push_back(x->value().real());
+    Values.push_back(x->value().imag());
+  }
+  return Values;
+}
+
+} // namespace
+
+TabulatedDynamicsStrategy::TabulatedDynamicsStrategy(
+    std::shared_ptr<ComPWA::FunctionTree::Strategy> Dynamics_,
+    std::pair<double, double> InvMassBounds, double RelativeError_)
+    : ComPWA::FunctionTree::Strategy(ParType::MCOMPLEX), Dynamics(Dynamics_),
+      MassSqMin(InvMassBounds.first), MassSqMax(InvMassBounds.second),
+      RelativeError(RelativeError_),
+      SegmentWidth((MassSqMax - MassSqMin) / NumberOfSegments),
+      HasReachedGridLimit(false) {
+  if (!Dynamics || Dynamics->OutType() != ParType::MCOMPLEX)
+    throw BadParameter("TabulatedDynamicsStrategy::TabulatedDynamicsStrategy()"
+                       " | Only strategies with a complex data column as "
+                       "output can be tabulated!");
+  if (!(MassSqMin < MassSqMax))
+    throw BadParameter("TabulatedDynamicsStrategy::TabulatedDynamicsStrategy()"
+                       " | Invalid invariant mass interval [" +
+                       std::to_string(MassSqMin) + ", " +
+                       std::to_string(MassSqMax) + "]!");
+  if (!(RelativeError > 0.0))
+    throw BadParameter("TabulatedDynamicsStrategy::TabulatedDynamicsStrategy()"
+                       " | Relative error has to be positive!");
+}
+
+std::vector<std::complex<double>> TabulatedDynamicsStrategy::evaluateDynamics(
+    const ParameterList &paras, std::vector<double> MassSq) const {
+  std::size_t n = MassSq.size();
+  ParameterList GridList(paras);
+  GridList.mDoubleValues()[0] = std::make_shared<Value<std::vector<double>>>(
+      paras.mDoubleValue(0)->name(), std::move(MassSq));
+  std::shared_ptr<Parameter> Out = ComPWA::FunctionTree::MComplex("", n);
+  Dynamics->execute(GridList, Out);
+  return std::static_pointer_cast<Value<std::vector<std::complex<double>>>>(
+             Out)
+      ->values();
+}
+
+void TabulatedDynamicsStrategy::tabulate(const ParameterList &paras) {
+  std::vector<std::vector<std::complex<double>>> Grids(NumberOfSegments);
+  std::vector<std::size_t> SegmentIntervals(NumberOfSegments,
+                                            InitialIntervals);
+  std::vector<bool> IsConverged(NumberOfSegments, false);
+
+  std::vector<double> MassSq;
+  for (std::size_t s = 0; s < NumberOfSegments; ++s) {
+    double Step = SegmentWidth / InitialIntervals;
+    for (std::size_t k = 0; k <= InitialIntervals; ++k)
+      MassSq.push_back(MassSqMin + s * SegmentWidth + k * Step);
+  }
+  auto GridValues = evaluateDynamics(paras, MassSq);
+  double Scale(0.0);
+  for (std::size_t s = 0; s < NumberOfSegments; ++s) {
+    auto First = GridValues.begin() + s * (InitialIntervals + 1);
+    Grids[s].assign(First, First + InitialIntervals + 1);
+  }
+  for (const auto &x : GridValues)
+    Scale = std::max(Scale, std::abs(x));
+
+  // bisect the grids of all segments whose midpoints are not reproduced by
+  // the interpolation, the wrapped strategy is called once per level
+  while (std::find(IsConverged.begin(), IsConverged.end(), false) !=
+         IsConverged.end()) {
+    MassSq.clear();
+    for (std::size_t s = 0; s < NumberOfSegments; ++s) {
+      if (IsConverged[s])
+        continue;
+      double Step = SegmentWidth / SegmentIntervals[s];
+      for (std::size_t k = 0; k < SegmentIntervals[s]; ++k)
+        MassSq.push_back(MassSqMin + s * SegmentWidth + (k + 0.5) * Step);
+    }
+    auto Midpoints = evaluateDynamics(paras, MassSq);
+    for (const auto &x : Midpoints)
+      Scale = std::max(Scale, std::abs(x));
+
+    auto Midpoint = Midpoints.begin();
+    for (std::size_t s = 0; s < NumberOfSegments; ++s) {
+      if (IsConverged[s])
+        continue;
+      std::size_t n = SegmentIntervals[s];
+      double Error(0.0);
+      std::vector<std::complex<double>> Refined(2 * n + 1);
+      for (std::size_t k = 0; k < n; ++k, ++Midpoint) {
+        auto Interpolated = interpolateGrid(Grids[s], n, k + 0.5);
+        Error = std::max(Error, std::abs(*Midpoint - Interpolated));
+        Refined[2 * k] = Grids[s][k];
+        Refined[2 * k + 1] = *Midpoint;
+      }
+      Refined[2 * n] = Grids[s][n];
+      Grids[s] = std::move(Refined);
+      SegmentIntervals[s] = 2 * n;
+      if (Error <= RelativeError * Scale) {
+        IsConverged[s] = true;
+      } else if (2 * n >= MaxIntervals) {
+        IsConverged[s] = true;
+        if (!HasReachedGridLimit)
+          LOG(WARNING) << "TabulatedDynamicsStrategy::tabulate() | Relative "
+                          "error of "
+                       << RelativeError << " is not reached with "
+                       << MaxIntervals << " grid intervals per segment!";
+        HasReachedGridLimit = true;
+      }
+    }
+  }
+
+  InverseSteps.resize(NumberOfSegments);
+  Intervals.resize(NumberOfSegments);
+  Offsets.resize(NumberOfSegments);
+  Values.clear();
+  for (std::size_t s = 0; s < NumberOfSegments; ++s) {
+    InverseSteps[s] = SegmentIntervals[s] / SegmentWidth;
+    Intervals[s] = SegmentIntervals[s];
+    Offsets[s] = Values.size();
+    Values.insert(Values.end(), Grids[s].begin(), Grids[s].end());
+  }
+}
+
+void TabulatedDynamicsStrategy::interpolate(
+    std::size_t n, const double *MassSq, std::complex<double> *Result) const {
+  double InverseSegmentWidth = 1.0 / SegmentWidth;
+  double LastSegment = NumberOfSegments - 1;
+  for (std::size_t Begin = 0; Begin < n; Begin += EventBlockSize) {
+    std::size_t Size = std::min(EventBlockSize, n - Begin);
+    const double *X = MassSq + Begin;
+
+    std::size_t Index[EventBlockSize];
+    double W0[EventBlockSize], W1[EventBlockSize], W2[EventBlockSize],
+        W3[EventBlockSize];
+    for (std::size_t i = 0; i < Size; ++i) {
+      double Position = X[i] - MassSqMin;
+      // the order of min and max maps NaN to the first segment, these
+      // events are calculated directly in execute()
+      double Segment = std::max(
+          0.0,
+          std::min(std::floor(Position * InverseSegmentWidth), LastSegment));
+      std::size_t s = Segment;
+      double t = (Position - Segment * SegmentWidth) * InverseSteps[s];
+      double First =
+          std::max(0.0, std::min(std::floor(t) - 1.0, Intervals[s] - 3.0));
+      Index[i] = Offsets[s] + std::size_t(First);
+      cubicWeights(t - First, W0[i], W1[i], W2[i], W3[i]);
+    }
+
+    std::complex<double> *Out = Result + Begin;
+    for (std::size_t i = 0; i < Size; ++i) {
+      const std::complex<double> *f = Values.data() + Index[i];
+      Out[i] = W0[i] * f[0] + W1[i] * f[1] + W2[i] * f[2] + W3[i] * f[3];
+    }
+  }
+}
+
+void TabulatedDynamicsStrategy::execute(ParameterList &paras,
+                                        std::shared_ptr<Parameter> &out) {
+  if (out && checkType != out->type())
+    throw BadParameter(
+        "TabulatedDynamicsStrategy::execute() | Parameter type mismatch!");
+  if (paras.mDoubleValues().size() != 1 || !paras.mComplexValues().empty() ||
+      !paras.mIntValues().empty())
+    throw BadParameter("TabulatedDynamicsStrategy::execute() | Only dynamical "
+                       "functions of a single data column can be tabulated!");
+
+  auto MassSq = paras.mDoubleValue(0);
+  size_t n = MassSq->values().size();
+  if (!out)
+    out = ComPWA::FunctionTree::MComplex("", n);
+  auto par =
+      std::static_pointer_cast<Value<std::vector<std::complex<double>>>>(out);
+  auto &results = par->values(); // reference
+  if (results.size() != n)
+    results.resize(n);
+
+  try {
+    auto Parameters = parameterValues(paras);
+    if (Values.empty() || Parameters != TabulatedParameters) {
+      tabulate(paras);
+      TabulatedParameters = Parameters;
+    }
+    interpolate(n, MassSq->values().data(), results.data());
+
+    // events outside of the table are calculated directly
+    std::vector<std::size_t> Outside;
+    for (std::size_t i = 0; i < n; ++i) {
+      double x = MassSq->values()[i];
+      if (!(x >= MassSqMin && x <= MassSqMax))
+        Outside.push_back(i);
+    }
+    if (!Outside.empty()) {
+      std::vector<double> OutsideMassSq;
+      for (auto i : Outside)
+        OutsideMassSq.push_back(MassSq->values()[i]);
+      auto OutsideValues = evaluateDynamics(paras, std::move(OutsideMassSq));
+      for (std::size_t i = 0; i < Outside.size(); ++i)
+        results[Outside[i]] = OutsideValues[i];
+    }
+  } catch (std::exception &ex) {
+    LOG(ERROR) << "TabulatedDynamicsStrategy::execute() | " << ex.what();
+    throw std::runtime_error("TabulatedDynamicsStrategy::execute() | "
+                             "Evaluation of dynamical function failed!");
+  }
+}
+
+void TabulatedDynamics::tabulate(FunctionTree &Tree,
+                                 std::pair<double, double> InvMassBounds,
+                                 double RelativeError) {
+  Tree.Head->setStrategy(std::make_shared<TabulatedDynamicsStrategy>(
+      Tree.Head->strategy(), InvMassBounds, RelativeError));
+}
+
+} // namespace Dynamics
+} // namespace Physics
+} // namespace ComPWA
@@ -0,0 +1,102 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef COMPWA_PHYSICS_DYNAMICS_TABULATEDDYNAMICS_HPP_
+#define COMPWA_PHYSICS_DYNAMICS_TABULATEDDYNAMICS_HPP_
+
+#include <complex>
+#include <memory>
+#include <utility>
+#include <vector>
+
+#include "Core/FunctionTree/FunctionTree.hpp"
+#include "Core/FunctionTree/Functions.hpp"
+
+namespace ComPWA {
+namespace Physics {
+namespace Dynamics {
+
+///
+/// \class TabulatedDynamicsStrategy
+/// Wraps the strategy of a dynamical function that depends on a single data
+/// column mSq and is smooth in mSq (e.g. VoigtianStrategy). Whenever the
+/// parameters of the function change, the wrapped strategy is evaluated on a
+/// grid over the invariant mass interval [mSqMin, mSqMax] and the events are
+/// interpolated from this table. The cost of an evaluation is then O(grid)
+/// calls of the dynamical function and O(N) interpolations instead of O(N)
+/// calls.
+///
+/// The interval is split into segments of equal size. Each segment has its
+/// own equidistant grid, which is refined by bisection until cubic
+/// interpolation reproduces the function at the midpoints of the grid to
+/// RelativeError times the maximum of |f| on the grid. Events outside of the
+/// interval are calculated with the wrapped strategy.
+///
+/// The leaves of the node are the ones of the wrapped strategy. Only
+/// strategies with a single data column and without other per event inputs
+/// (e.g. the trees without FactorTreeCache) can be tabulated.
+///
+class TabulatedDynamicsStrategy : public ComPWA::FunctionTree::Strategy {
+public:
+  TabulatedDynamicsStrategy(
+      std::shared_ptr<ComPWA::FunctionTree::Strategy> Dynamics_,
+      std::pair<double, double> InvMassBounds, double RelativeError_ = 1e-6);
+
+  virtual const std::string to_str() const {
+    return "TabulatedDynamicsStrategy";
+  }
+
+  virtual void execute(ComPWA::FunctionTree::ParameterList &paras,
+                       std::shared_ptr<ComPWA::FunctionTree::Parameter> &out);
+
+  /// Number of grid points of the current table.
+  std::size_t numberOfGridPoints() const { return Values.size(); }
+
+private:
+  /// Evaluate the wrapped strategy at \p MassSq with the parameters of
+  /// \p paras.
+  std::vector<std::complex<double>>
+  evaluateDynamics(const ComPWA::FunctionTree::ParameterList &paras,
+                   std::vector<double> MassSq) const;
+
+  /// Build the table for the parameters of \p paras.
+  void tabulate(const ComPWA::FunctionTree::ParameterList &paras);
+
+  /// Cubic interpolation of the table at \p n points \p MassSq.
+  void interpolate(std::size_t n, const double *MassSq,
+                   std::complex<double> *Result) const;
+
+  std::shared_ptr<ComPWA::FunctionTree::Strategy> Dynamics;
+  double MassSqMin;
+  double MassSqMax;
+  double RelativeError;
+  double SegmentWidth;
+
+  /// Parameter values the table was calculated for
+  std::vector<double> TabulatedParameters;
+  /// Inverse grid spacing, number of intervals and position of the first
+  /// grid point in Values for each segment
+  std::vector<double> InverseSteps;
+  std::vector<double> Intervals;
+  std::vector<std::size_t> Offsets;
+  std::vector<std::complex<double>> Values;
+  bool HasReachedGridLimit;
+};
+
+namespace TabulatedDynamics {
+
+/// Replace the strategy of the head node of \p Tree (a dynamical function
+/// created by one of the createFunctionTree() functions) by a
+/// TabulatedDynamicsStrategy over the mSq interval \p InvMassBounds.
+void tabulate(ComPWA::FunctionTree::FunctionTree &Tree,
+              std::pair<double, double> InvMassBounds,
+              double RelativeError = 1e-6);
+
+} // namespace TabulatedDynamics
+
+} // namespace Dynamics
+} // namespace Physics
+} // namespace ComPWA
+
+#endif
@@ -0,0 +1,153 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#include <algorithm>
+#include <cmath>
+
+#include "Faddeeva.hh"
+#include "FastFaddeeva.hpp"
+
+namespace ComPWA {
+namespace Physics {
+namespace Dynamics {
+
+namespace {
+
+/// Number of points that are calculated together.
+const std::size_t BlockSize = 64;
+
+/// The continued fraction is used for |Re(z)| + Im(z) >= 8. There the
+/// exponentially small terms of w(z) that the continued fraction misses are
+/// below exp(-64).
+const double ContinuedFractionRange = 8.0;
+
+const double InverseSqrtPi = 0.564189583547756286948079451561;
+
+/// Number of terms of the Weideman approximation and of the continued
+/// fraction for the accuracy targets, see the table of FaddeevaFunction.
+struct Approximation {
+  double RelativeError;
+  unsigned int WeidemanTerms;
+  unsigned int ContinuedFractionTerms;
+};
+
+const Approximation Approximations[] = {
+    {1e-6, 16, 4}, {1e-9, 24, 8}, {1e-12, 32, 12}, {5e-14, 40, 12}};
+
+/// Coefficients of the polynomial of the Weideman approximation with \p N
+/// terms (the function cef() of the paper). The discrete Fourier transform
+/// of the real and even samples is a cosine sum, which is evaluated in long
+/// double.
+std::vector<double> weidemanCoefficients(unsigned int N, long double L) {
+  const long double Pi = std::acos(-1.0L);
+  unsigned int M = 2 * N;
+  std::vector<long double> f(M);
+  for (unsigned int k = 0; k < M; ++k) {
+    long double t = L * std::tan(k * Pi / (2 * M));
+    f[k] = std::exp(-t * t) * (L * L + t * t);
+  }
+  std::vector<double> Coefficients(N);
+  for (unsigned int m = 1; m <= N; ++m) {
+    long double Sum = f[0];
+    for (unsigned int k = 1; k < M; ++k)
+      Sum += 2 * f[k] * std::cos(Pi * k * m / M);
+    Coefficients[m - 1] = Sum / (2 * M);
+  }
+  return Coefficients;
+}
+
+} // namespace
+
+FaddeevaFunction::FaddeevaFunction(double RelativeError_)
+    : RelativeError(RelativeError_), L(0.0), ContinuedFractionTerms(0) {
+  for (const auto &Approx : Approximations) {
+    if (RelativeError < Approx.RelativeError)
+      continue;
+    long double LongL = std::sqrt(Approx.WeidemanTerms / std::sqrt(2.0L));
+    L = LongL;
+    Coefficients = weidemanCoefficients(Approx.WeidemanTerms, LongL);
+    ContinuedFractionTerms = Approx.ContinuedFractionTerms;
+    break;
+  }
+}
+
+std::complex<double> FaddeevaFunction::
+operator()(std::complex<double> z) const {
+  double x = z.real();
+  std::complex<double> Result;
+  evaluate(1, &x, z.imag(), &Result);
+  return Result;
+}
+
+void FaddeevaFunction::evaluate(std::size_t n, const double *x, double y,
+                                std::complex<double> *Result) const {
+  if (Coefficients.empty() || y < 0.0) {
+    for (std::size_t i = 0; i < n; ++i)
+      Result[i] = Faddeeva::w(std::complex<double>(x[i], y), RelativeError);
+    return;
+  }
+
+  std::size_t N = Coefficients.size();
+  double *ResultParts = reinterpret_cast<double *>(Result);
+  for (std::size_t Begin = 0; Begin < n; Begin += BlockSize) {
+    std::size_t Size = std::min(BlockSize, n - Begin);
+    const double *X = x + Begin;
+
+    // Weideman: w(z) = 2 p(Z) / (L - iz)^2 + 1 / sqrt(pi) / (L - iz) with
+    // Z = (L + iz) / (L - iz)
+    double Zr[BlockSize], Zi[BlockSize], Pr[BlockSize], Pi[BlockSize];
+    double Dr = L + y;
+    for (std::size_t i = 0; i < Size; ++i) {
+      double DSq = Dr * Dr + X[i] * X[i];
+      Zr[i] = (L * L - y * y - X[i] * X[i]) / DSq;
+      Zi[i] = 2.0 * L * X[i] / DSq;
+      Pr[i] = Coefficients[N - 1];
+      Pi[i] = 0.0;
+    }
+    for (std::size_t m = N - 1; m-- > 0;) {
+      double a = Coefficients[m];
+      for (std::size_t i = 0; i < Size; ++i) {
+        double Re = Pr[i] * Zr[i] - Pi[i] * Zi[i] + a;
+        Pi[i] = Pr[i] * Zi[i] + Pi[i] * Zr[i];
+        Pr[i] = Re;
+      }
+    }
+
+    // continued fraction: w(z) = i / sqrt(pi) / (z - 1/2 / (z - 1 / (z -
+    // 3/2 / ...))), evaluated from the inside
+    double Cr[BlockSize], Ci[BlockSize];
+    for (std::size_t i = 0; i < Size; ++i) {
+      Cr[i] = X[i];
+      Ci[i] = y;
+    }
+    for (unsigned int k = ContinuedFractionTerms; k > 0; --k) {
+      double h = 0.5 * k;
+      for (std::size_t i = 0; i < Size; ++i) {
+        double Scale = h / (Cr[i] * Cr[i] + Ci[i] * Ci[i]);
+        Cr[i] = X[i] - Scale * Cr[i];
+        Ci[i] = y + Scale * Ci[i];
+      }
+    }
+
+    double *Out = ResultParts + 2 * Begin;
+    for (std::size_t i = 0; i < Size; ++i) {
+      double InvDSq = 1.0 / (Dr * Dr + X[i] * X[i]);
+      double InvDr = Dr * InvDSq;
+      double InvDi = X[i] * InvDSq;
+      double Qr = 2.0 * (Pr[i] * InvDr - Pi[i] * InvDi) + InverseSqrtPi;
+      double Qi = 2.0 * (Pr[i] * InvDi + Pi[i] * InvDr);
+      double WeidemanRe = InvDr * Qr - InvDi * Qi;
+      double WeidemanIm = InvDr * Qi + InvDi * Qr;
+
+      double Scale = InverseSqrtPi / (Cr[i] * Cr[i] + Ci[i] * Ci[i]);
+      bool IsOutside = std::fabs(X[i]) + y >= ContinuedFractionRange;
+      Out[2 * i] = IsOutside ? Ci[i] * Scale : WeidemanRe;
+      Out[2 * i + 1] = IsOutside ? Cr[i] * Scale : WeidemanIm;
+    }
+  }
+}
+
+} // namespace Dynamics
+} // namespace Physics
+} // namespace ComPWA
@@ -0,0 +1,75 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#ifndef COMPWA_PHYSICS_DYNAMICS_UTILS_FASTFADDEEVA_HPP_
+#define COMPWA_PHYSICS_DYNAMICS_UTILS_FASTFADDEEVA_HPP_
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+namespace ComPWA {
+namespace Physics {
+namespace Dynamics {
+
+///
+/// \class FaddeevaFunction
+/// Fast evaluation of the Faddeeva function w(z) = exp(-z^2) erfc(-iz) in the
+/// upper half plane Im(z) >= 0 with a selectable accuracy.
+///
+/// For |Re(z)| + Im(z) < 8 the rational approximation of J.A.C. Weideman
+/// (SIAM J. Numer. Anal. 31 (1994) 1497) with N terms is used, outside the
+/// Laplace continued fraction of w(z) with K terms. N and K are chosen for
+/// the accuracy target. The maximal relative errors of w(z) measured against
+/// Faddeeva::w() are
+///
+/// | accuracy target | N  | K  | measured error |
+/// |-----------------|----|----|----------------|
+/// | >= 1e-6         | 16 |  4 | 4.3e-7         |
+/// | >= 1e-9         | 24 |  8 | 4.3e-10        |
+/// | >= 1e-12        | 32 | 12 | 3.1e-13        |
+/// | >= 5e-14        | 40 | 12 | 1.9e-14        |
+///
+/// Smaller targets and points in the lower half plane are passed on to
+/// Faddeeva::w(). Like for Faddeeva::w(), the error is relative to |w(z)|.
+/// Close to the real axis Re(w) is much smaller than |w| for |Re(z)| > 3, so
+/// the relative error of Re(w) alone is larger there.
+///
+/// evaluate() processes blocks of points with plain loops over arrays,
+/// which are vectorised by the compiler.
+///
+class FaddeevaFunction {
+public:
+  /// The relative error of w(z) is at most \p RelativeError_.
+  explicit FaddeevaFunction(double RelativeError_ = 1e-13);
+
+  std::complex<double> operator()(std::complex<double> z) const;
+
+  /// Calculate w(x[i] + i * y) for \p n points with the common imaginary
+  /// part \p y and store them in \p Result.
+  void evaluate(std::size_t n, const double *x, double y,
+                std::complex<double> *Result) const;
+
+  double relativeError() const { return RelativeError; }
+
+  /// Number of terms of the rational approximation. Zero if Faddeeva::w()
+  /// is used.
+  std::size_t numberOfTerms() const { return Coefficients.size(); }
+
+private:
+  double RelativeError;
+  /// Parameter L of the Weideman approximation
+  double L;
+  /// Coefficients of the polynomial of the Weideman approximation, starting
+  /// with the constant term
+  std::vector<double> Coefficients;
+  /// Depth of the continued fraction
+  unsigned int ContinuedFractionTerms;
+};
+
+} // namespace Dynamics
+} // namespace Physics
+} // namespace ComPWA
+
+#endif
@@ -2,6 +2,8 @@
 // This file is part of the ComPWA framework, check
 // https://github.com/ComPWA/ComPWA/license.txt for details.
 
+#include <algorithm>
+
 #include "Voigtian.hpp"
 
 namespace ComPWA {
@@ -14,6 +16,13 @@ using ComPWA::FunctionTree::Parameter;
 using ComPWA::FunctionTree::ParameterList;
 using ComPWA::FunctionTree::Value;
 
+namespace {
+
+/// Number of events whose Faddeeva function is calculated together.
+const std::size_t EventBlockSize = 64;
+
+} // namespace
+
 std::shared_ptr<ComPWA::FunctionTree::FunctionTree>
 Voigtian::createFunctionTree(
     InputInfo Params, const ComPWA::FunctionTree::ParameterList &DataSample,
@@ -25,7 +34,7 @@ Voigtian::createFunctionTree(
 
   auto tr = std::make_shared<ComPWA::FunctionTree::FunctionTree>(
       NodeName, ComPWA::FunctionTree::MComplex("", sampleSize),
-      std::make_shared<VoigtianStrategy>());
+      std::make_shared<VoigtianStrategy>("", Params.Accuracy));
 
   tr->createLeaf("Mass", Params.Mass, NodeName);
   tr->createLeaf("Width", Params.Width, NodeName);
@@ -117,16 +126,22 @@ void VoigtianStrategy::execute(ParameterList &paras,
   double Gamma0 = paras.doubleParameter(1)->value();
   double sigma = paras.doubleValue(0)->value();
 
-  // calc function for each point
-  for (unsigned int ele = 0; ele < n; ele++) {
-    try {
-      results.at(ele) = Voigtian::dynamicalFunction(
-          paras.mDoubleValue(0)->values().at(ele), m0, Gamma0, sigma);
-    } catch (std::exception &ex) {
-      LOG(ERROR) << "VoigtianStrategy::execute() | " << ex.what();
-      throw(std::runtime_error("VoigtianStrategy::execute() | "
-                               "Evaluation of dynamic function failed!"));
-    }
+  // calc function for each block of events, w(z) is calculated for the
+  // whole block
+  const double *mSq = paras.mDoubleValue(0)->values().data();
+  std::complex<double> *Result = results.data();
+  double c = 1.0 / (sqrt(2.0) * sigma);
+  double a = c * 0.5 * Gamma0;
+  for (size_t Begin = 0; Begin < n; Begin += EventBlockSize) {
+    size_t Size = std::min(EventBlockSize, n - Begin);
+    double u[EventBlockSize];
+    for (size_t i = 0; i < Size; ++i)
+      u[i] = c * (std::sqrt(mSq[Begin + i]) - m0);
+    std::complex<double> w[EventBlockSize];
+    W.evaluate(Size, u, a, w);
+    for (size_t i = 0; i < Size; ++i)
+      Result[Begin + i] = Voigtian::dynamicalFunction(mSq[Begin + i], m0,
+                                                      Gamma0, sigma, w[i]);
   }
 }
 
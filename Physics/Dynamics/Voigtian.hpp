@@ -17,6 +17,7 @@
 #include "FormFactor.hpp"
 #include "RelativisticBreitWigner.hpp"
 #include "Utils/Faddeeva.hh"
+#include "Utils/FastFaddeeva.hpp"
 
 namespace ComPWA {
 namespace Physics {
@@ -42,31 +43,26 @@ struct InputInfo : RelativisticBreitWigner::InputInfo {
   /// resolution: the width of gaussian function which is used to represent the
   /// resolution of mass spectrum
   double Sigma;
+  /// relative accuracy of the Faddeeva function w(z), see FaddeevaFunction
+  double Accuracy = 1e-13;
 };
 
-/// Dynamical voigt function.
+/// Dynamical voigt function with the Faddeeva function \p w(z) calculated by
+/// the caller. \p w is the value of w at z = (sqrt(mSq) - mR + i wR / 2) /
+/// (sqrt(2) sigma).
 /// \param mSq Invariant mass squared
 /// \param mR Mass of the resonant state
 /// \param wR Width of the resonant state
 /// \param sigma Width of the gaussian, i.e., the resolution of the mass
-/// spectrum at mR \return Amplitude value
+/// spectrum at mR
+/// \param w Faddeeva function at z
+/// \return Amplitude value
 inline std::complex<double> dynamicalFunction(double mSq, double mR, double wR,
-                                              double sigma) {
-
-  double sqrtS = sqrt(mSq);
-
-  // the non-relativistic BreitWigner which is convoluted in Voigtian
-  // has the exactly following expression:
-  // BW(x, m, width) = 1/pi * width/2 * 1/((x - m)^2 + (width/2)^2)
-  // i.e., the Lorentz formula with Gamma = width/2 and x' = x - m
-  /// https://root.cern.ch/doc/master/RooVoigtianian_8cxx_source.html
-  double argu = sqrtS - mR;
+                                              double sigma,
+                                              std::complex<double> w) {
+  double argu = sqrt(mSq) - mR;
   double c = 1.0 / (sqrt(2.0) * sigma);
-  double a = c * 0.5 * wR;
-  double u = c * argu;
-  std::complex<double> z(u, a);
-  std::complex<double> v = Faddeeva::w(z, 1e-13);
-  double val = c * 1.0 / sqrt(M_PI) * v.real();
+  double val = c * 1.0 / sqrt(M_PI) * w.real();
   double sqrtVal = sqrt(val);
 
   /// keep the phi angle of the complex BW
@@ -89,14 +85,28 @@ inline std::complex<double> dynamicalFunction(double mSq, double mR, double wR,
   result *= g_production;
   result *= g_final;
 
-  assert((!std::isnan(result.real()) || !std::isinf(result.real())) &&
-         "Voigtian::dynamicalFunction() | Result is NaN or Inf!");
-  assert((!std::isnan(result.imag()) || !std::isinf(result.imag())) &&
-         "Voigtian::dynamicalFunction() | Result is NaN or Inf!");
-
   return result;
 }
 
+/// Dynamical voigt function.
+/// \param mSq Invariant mass squared
+/// \param mR Mass of the resonant state
+/// \param wR Width of the resonant state
+/// \param sigma Width of the gaussian, i.e., the resolution of the mass
+/// spectrum at mR \return Amplitude value
+inline std::complex<double> dynamicalFunction(double mSq, double mR, double wR,
+                                              double sigma) {
+  // the non-relativistic BreitWigner which is convoluted in Voigtian
+  // has the exactly following expression:
+  // BW(x, m, width) = 1/pi * width/2 * 1/((x - m)^2 + (width/2)^2)
+  // i.e., the Lorentz formula with Gamma = width/2 and x' = x - m
+  /// https://root.cern.ch/doc/master/RooVoigtianian_8cxx_source.html
+  double argu = sqrt(mSq) - mR;
+  double c = 1.0 / (sqrt(2.0) * sigma);
+  std::complex<double> z(c * argu, c * 0.5 * wR);
+  return dynamicalFunction(mSq, mR, wR, sigma, Faddeeva::w(z, 1e-13));
+}
+
 std::shared_ptr<ComPWA::FunctionTree::FunctionTree>
 createFunctionTree(InputInfo Params,
                    const ComPWA::FunctionTree::ParameterList &DataSample,
@@ -104,11 +114,16 @@ createFunctionTree(InputInfo Params,
 
 } // namespace Voigtian
 
+///
+/// \class VoigtianStrategy
+/// Evaluates the Voigtian in blocks of events. The Faddeeva function is
+/// calculated with FaddeevaFunction for the accuracy \p Accuracy.
+///
 class VoigtianStrategy : public ComPWA::FunctionTree::Strategy {
 public:
-  VoigtianStrategy(std::string sname = "")
+  VoigtianStrategy(std::string sname = "", double Accuracy = 1e-13)
       : ComPWA::FunctionTree::Strategy(ComPWA::FunctionTree::ParType::MCOMPLEX),
-        name(sname) {}
+        name(sname), W(Accuracy) {}
 
   virtual const std::string to_str() const {
     return ("Voigtian Function of " + name);
@@ -119,6 +134,7 @@ public:
 
 protected:
   std::string name;
+  FaddeevaFunction W;
 };
 
 } // namespace Dynamics
@@ -11,6 +11,7 @@
 #include "ThirdParty/qft++/include/qft++/Vector4.h"
 
 #include <algorithm>
+#include <cassert>
 #include <cmath>
 #include <numeric>
 
@@ -194,6 +195,33 @@ throw BeyondPhsp("HelicityKinematics::convert() |"
                        std::vector<double>{mB, mC, qAB, qBC, qCA}};
 }
 
+void DalitzKinematics::convert(const Event *EventsBegin,
+                               const Event *EventsEnd,
+                               const std::vector<double *> &Columns,
+                               char *PhspMask) const {
+  assert(Columns.size() == 5);
+  for (std::size_t i = 0; EventsBegin + i != EventsEnd; ++i) {
+    const auto &Particles = EventsBegin[i].ParticleList;
+    const FourMomentum &pA = Particles[0].fourMomentum();
+    const FourMomentum &pB = Particles[1].fourMomentum();
+    const FourMomentum &pC = Particles[2].fourMomentum();
+    double mSqA = pA.invMassSq();
+    double mSqB = pB.invMassSq();
+    double mSqC = pC.invMassSq();
+    double qAB = FourMomentum::invariantMass(pA, pB);
+    double qBC = FourMomentum::invariantMass(pB, pC);
+    double qCA = FourMomentum::invariantMass(pC, pA);
+
+    double Variables[] = {std::sqrt(mSqB), std::sqrt(mSqC), qAB, qBC, qCA};
+    for (std::size_t var = 0; var < 5; ++var) {
+      if (Columns[var])
+        Columns[var][i] = Variables[var];
+    }
+    if (PhspMask)
+      PhspMask[i] = (qAB + qBC + qCA - mSqA - mSqB - mSqC) < M2;
+  }
+}
+
 double DalitzKinematics::helicityAngle(double M, double m, double m2,
                                        double mSpec, double invMassSqA,
                                        double invMassSqB) const {
@@ -56,6 +56,14 @@ public:
   /// const std::pair<double, double>) is called. In this way only
   /// the variables are calculated that are used by the model.
   DataPoint convert(const Event &event) const;
+  using Kinematics::convert;
+
+  /// Convert the events [\p EventsBegin, \p EventsEnd) into \p Columns.
+  /// The columns are filled with the same variables as convert(const Event&)
+  /// returns and \p PhspMask with the criterion of isWithinPhsp().
+  void convert(const Event *EventsBegin, const Event *EventsEnd,
+               const std::vector<double *> &Columns,
+               char *PhspMask) const final;
 
   /// Check if \p point is within phase space boundaries.
   bool isWithinPhsp(const DataPoint &point) const;
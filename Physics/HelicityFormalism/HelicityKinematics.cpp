@@ -5,13 +5,17 @@
 #include <algorithm>
 #include <cmath>
 #include <numeric>
+#include <sstream>
 #include <stdexcept>
 #include <tuple>
 
 #include "Core/Event.hpp"
+#include "Core/EventCollection.hpp"
+#include "Core/Exceptions.hpp"
 #include "Core/Logging.hpp"
 #include "Core/Particle.hpp"
 #include "Core/Properties.hpp"
+#include "Core/VectorMath.hpp"
 #include "Physics/HelicityFormalism/HelicityKinematics.hpp"
 
 #include "qft++/Vector4.h"
@@ -20,6 +24,148 @@ namespace ComPWA {
 namespace Physics {
 namespace HelicityFormalism {
 
+namespace {
+
+bool isWithinBounds(double mSq, double theta, double phi,
+                    const std::pair<double, double> &MassSqBounds) {
+  if (mSq < MassSqBounds.first || mSq > MassSqBounds.second)
+    return false;
+  if (theta < 0 || theta > M_PI)
+    return false;
+  if (phi < -M_PI || phi > M_PI)
+    return false;
+  return true;
+}
+
+/// Number of events whose helicity variables are calculated together. The
+/// loops over the events of a block operate on plain arrays and are
+/// vectorised by the compiler.
+const std::size_t EventBlockSize = 64;
+
+/// Four-momenta of a block of events in structure of arrays layout.
+struct FourMomentumBlock {
+  double Px[EventBlockSize];
+  double Py[EventBlockSize];
+  double Pz[EventBlockSize];
+  double E[EventBlockSize];
+};
+
+/// Boost into the rest frame of a decaying state for a block of events.
+struct BoostBlock {
+  double Bx[EventBlockSize];
+  double By[EventBlockSize];
+  double Bz[EventBlockSize];
+  double Gamma[EventBlockSize];
+  double GammaFactor[EventBlockSize];
+  double MassSq[EventBlockSize];
+};
+
+/// Calculate the boost into the rest frame of the decaying state with the
+/// daughters \p FinalA and \p FinalB. The invariant mass is calculated in
+/// the same order of operations as in the per-event conversion, because the
+/// mass of the full final state lies exactly on its phase space boundary.
+void calculateBoost(std::size_t Size, const FourMomentumBlock &FinalA,
+                    const FourMomentumBlock &FinalB, BoostBlock &Boost) {
+  for (std::size_t i = 0; i < Size; ++i) {
+    double Sx = FinalA.Px[i] + FinalB.Px[i];
+    double Sy = FinalA.Py[i] + FinalB.Py[i];
+    double Sz = FinalA.Pz[i] + FinalB.Pz[i];
+    double SE = FinalA.E[i] + FinalB.E[i];
+    Boost.MassSq[i] = -(Sx * Sx + Sy * Sy + Sz * Sz - SE * SE);
+    double bx = -Sx / SE;
+    double by = -Sy / SE;
+    double bz = -Sz / SE;
+    double Gamma = 1.0 / std::sqrt(1.0 - bx * bx - by * by - bz * bz);
+    Boost.Bx[i] = bx;
+    Boost.By[i] = by;
+    Boost.Bz[i] = bz;
+    Boost.Gamma[i] = Gamma;
+    Boost.GammaFactor[i] = Gamma * Gamma / (Gamma + 1.0);
+  }
+}
+
+/// Boost the three-momentum (\p px, \p py, \p pz) with energy \p E of event
+/// \p i, like QFT::Tensor::Boost().
+inline void boost(const BoostBlock &Boost, std::size_t i, double E,
+                  double &px, double &py, double &pz) {
+  double bx(Boost.Bx[i]), by(Boost.By[i]), bz(Boost.Bz[i]);
+  double Shift = Boost.Gamma[i] * E +
+                 Boost.GammaFactor[i] * (bx * px + by * py + bz * pz);
+  px += bx * Shift;
+  py += by * Shift;
+  pz += bz * Shift;
+}
+
+/// Vectorised version of HelicityKinematics::calculateHelicityVariables()
+/// for the helicity angles of a block of events.
+/// The rotations of the daughter momentum are expressed via the components
+/// of the boosted recoil and parent recoil momenta, so the first loop
+/// contains no trigonometric functions. The angles are taken in a second
+/// loop with the branch-free VectorMath::acos() and VectorMath::atan2(). \p Recoil is null if the SubSystem has no recoil. If it has
+/// no parent recoil, \p ParentRecoil has to contain the artificial vector
+/// (0, 0, 1, 0) along the z-axis.
+void calculateHelicityAngles(std::size_t Size, const BoostBlock &Boost,
+                             const FourMomentumBlock &FinalA,
+                             const FourMomentumBlock *Recoil,
+                             const FourMomentumBlock &ParentRecoil,
+                             double *Theta, double *Phi) {
+  // the cosine of theta is stored in Theta, the arguments of atan2() for phi
+  // in PhiY and Phi
+  double PhiY[EventBlockSize];
+  if (!Recoil) {
+    for (std::size_t i = 0; i < Size; ++i) {
+      double dx(FinalA.Px[i]), dy(FinalA.Py[i]), dz(FinalA.Pz[i]);
+      boost(Boost, i, FinalA.E[i], dx, dy, dz);
+      Theta[i] = dz / std::sqrt(dx * dx + dy * dy + dz * dz);
+      PhiY[i] = dy;
+      Phi[i] = dx;
+    }
+  } else {
+    for (std::size_t i = 0; i < Size; ++i) {
+      double dx(FinalA.Px[i]), dy(FinalA.Py[i]), dz(FinalA.Pz[i]);
+      boost(Boost, i, FinalA.E[i], dx, dy, dz);
+      double rx(Recoil->Px[i]), ry(Recoil->Py[i]), rz(Recoil->Pz[i]);
+      boost(Boost, i, Recoil->E[i], rx, ry, rz);
+      double px(ParentRecoil.Px[i]), py(ParentRecoil.Py[i]),
+          pz(ParentRecoil.Pz[i]);
+      boost(Boost, i, ParentRecoil.E[i], px, py, pz);
+
+      // rotation by -phi around z and by pi - theta of the recoil around y,
+      // which turns the recoil into the negative z direction
+      double rho = std::sqrt(rx * rx + ry * ry);
+      double r = std::sqrt(rho * rho + rz * rz);
+      double CosPhi = rho > 0.0 ? rx / rho : 1.0;
+      double SinPhi = rho > 0.0 ? ry / rho : 0.0;
+      double CosTheta = r > 0.0 ? rz / r : 0.0;
+      double SinTheta = r > 0.0 ? rho / r : 1.0;
+
+      double x1 = CosPhi * dx + SinPhi * dy;
+      double DaughterX = -CosTheta * x1 + SinTheta * dz;
+      double DaughterY = -SinPhi * dx + CosPhi * dy;
+      Theta[i] = (-SinTheta * x1 - CosTheta * dz) /
+                 std::sqrt(dx * dx + dy * dy + dz * dz);
+
+      x1 = CosPhi * px + SinPhi * py;
+      double ParentX = -CosTheta * x1 + SinTheta * pz;
+      double ParentY = -SinPhi * px + CosPhi * py;
+
+      // the rotation by pi - phi of the parent recoil around z only shifts
+      // the azimuthal angle, so it is applied to the arguments of atan2()
+      bool ParentAlongZ = ParentX == 0.0 && ParentY == 0.0;
+      PhiY[i] = ParentAlongZ ? -DaughterY
+                             : ParentY * DaughterX - ParentX * DaughterY;
+      Phi[i] = ParentAlongZ ? -DaughterX
+                            : -(ParentX * DaughterX + ParentY * DaughterY);
+    }
+  }
+  for (std::size_t i = 0; i < Size; ++i) {
+    Theta[i] = VectorMath::acos(Theta[i]);
+    Phi[i] = VectorMath::atan2(PhiY[i], Phi[i]);
+  }
+}
+
+} // namespace
+
 HelicityKinematics::HelicityKinematics(ComPWA::ParticleList partL,
                                        std::vector<pid> initialState,
                                        std::vector<pid> finalState,
@@ -53,15 +199,9 @@ double HelicityKinematics::phspVolume() const { return PhspVolume; }
 bool HelicityKinematics::isWithinPhaseSpace(const DataPoint &point) const {
   unsigned int pos = 0;
   for (auto bounds : InvMassBounds) {
-    if (point.KinematicVariableList[pos] < bounds.first ||
-        point.KinematicVariableList[pos] > bounds.second) {
-      return false;
-    }
-    if (point.KinematicVariableList[pos + 1] < 0 ||
-        point.KinematicVariableList[pos + 1] > M_PI)
-      return false;
-    if (point.KinematicVariableList[pos + 2] < -M_PI ||
-        point.KinematicVariableList[pos + 2] > M_PI)
+    if (!isWithinBounds(point.KinematicVariableList[pos],
+                        point.KinematicVariableList[pos + 1],
+                        point.KinematicVariableList[pos + 2], bounds))
       return false;
 
     pos += 3;
@@ -89,6 +229,35 @@ void HelicityKinematics::convert(const Event &event, DataPoint &point,
   convert(event, point, sys, massLimits);
 }
 
+std::string HelicityKinematics::getConfigurationKey() const {
+  auto writeList = [](std::ostream &Stream, const std::string &Label,
+                      const std::vector<unsigned int> &List) {
+    Stream << Label << "(";
+    for (auto x : List)
+      Stream << x << " ";
+    Stream << ")";
+  };
+
+  // the version has to be increased whenever the definition of the variables
+  // changes
+  std::stringstream Key;
+  Key.precision(17);
+  Key << "HelicityKinematics/1\n" << KinematicsInfo << "\nmasses:";
+  for (auto Mass : KinematicsInfo.getFinalStateMasses())
+    Key << " " << Mass;
+  auto P4 = KinematicsInfo.getInitialStateFourMomentum();
+  Key << "\ninitial state: " << P4.px() << " " << P4.py() << " " << P4.pz()
+      << " " << P4.e() << "\n";
+  for (const auto &sys : Subsystems) {
+    for (const auto &Final : sys.getFinalStates())
+      writeList(Key, "final", Final);
+    writeList(Key, " recoil", sys.getRecoilState());
+    writeList(Key, " parent recoil", sys.getParentRecoilState());
+    Key << "\n";
+  }
+  return Key.str();
+}
+
 unsigned int HelicityKinematics::getDataID(const SubSystem &subSys) const {
   auto const result = std::find(Subsystems.begin(), Subsystems.end(), subSys);
   return result - Subsystems.begin();
@@ -228,6 +397,7 @@ unsigned int HelicityKinematics::addSubSystem(const SubSystem &subSys) {
   if (result == Subsystems.end()) {
     Subsystems.push_back(subSys);
     InvMassBounds.push_back(calculateInvMassBounds(subSys));
+    addToPlan(subSys);
     std::stringstream ss;
     ss << subSys;
     VariableNames.push_back("mSq" + ss.str());
@@ -280,17 +450,236 @@ double HelicityKinematics::helicityAngle(double M, double m, double m2,
 void HelicityKinematics::convert(
     const Event &event, DataPoint &point, const SubSystem &sys,
     const std::pair<double, double> &limits) const {
-  FourMomentum FinalA, FinalB;
-  for (auto s : sys.getFinalStates().at(0)) {
-    unsigned int index = KinematicsInfo.convertFinalStateIDToPositionIndex(s);
-    FinalA += event.ParticleList[index].fourMomentum();
+  auto sumFourMomenta = [&](const std::vector<unsigned int> &FinalStates) {
+    FourMomentum Sum;
+    for (auto s : FinalStates) {
+      unsigned int index = KinematicsInfo.convertFinalStateIDToPositionIndex(s);
+      Sum += event.ParticleList[index].fourMomentum();
+    }
+    return Sum;
+  };
+
+  auto Variables = calculateHelicityVariables(
+      sumFourMomenta(sys.getFinalStates().at(0)),
+      sumFourMomenta(sys.getFinalStates().at(1)),
+      sumFourMomenta(sys.getRecoilState()),
+      sumFourMomenta(sys.getParentRecoilState()), sys.getRecoilState().size(),
+      sys.getParentRecoilState().size());
+
+  point.Weight = event.Weight;
+  point.KinematicVariableList.push_back(std::get<0>(Variables));
+  point.KinematicVariableList.push_back(std::get<1>(Variables));
+  point.KinematicVariableList.push_back(std::get<2>(Variables));
+}
+
+std::vector<std::vector<double>>
+HelicityKinematics::convert(const EventCollection &Events) const {
+  if (!Subsystems.size()) {
+    LOG(ERROR) << "HelicityKinematics::convert() | No variables were "
+                  "requested before. Therefore this function is doing nothing!";
   }
+  if (Events.numberOfParticles() != KinematicsInfo.getFinalStateMasses().size())
+    throw ComPWA::BadParameter(
+        "HelicityKinematics::convert() | EventCollection contains " +
+        std::to_string(Events.numberOfParticles()) +
+        " final state particles, but kinematics expects " +
+        std::to_string(KinematicsInfo.getFinalStateMasses().size()) + "!");
+
+  std::vector<std::vector<double>> Data(3 * Subsystems.size(),
+                                        std::vector<double>(Events.size()));
+  std::vector<double *> Columns;
+  for (auto &Column : Data)
+    Columns.push_back(Column.data());
+  convertWithPlan(
+      Events.size(),
+      [&Events](unsigned int pos, std::size_t i) {
+        return fourMomentum(Events, pos, i);
+      },
+      Columns, nullptr);
+  return Data;
+}
+
+void HelicityKinematics::convert(const Event *EventsBegin,
+                                 const Event *EventsEnd,
+                                 const std::vector<double *> &Columns,
+                                 char *PhspMask) const {
+  if (Columns.size() != 3 * Subsystems.size())
+    throw ComPWA::BadParameter(
+        "HelicityKinematics::convert() | " + std::to_string(Columns.size()) +
+        " columns given, but kinematics has " +
+        std::to_string(3 * Subsystems.size()) + " variables!");
+  convertWithPlan(
+      EventsEnd - EventsBegin,
+      [EventsBegin](unsigned int pos, std::size_t i) -> const FourMomentum & {
+        return EventsBegin[i].ParticleList[pos].fourMomentum();
+      },
+      Columns, PhspMask);
+}
 
-  for (auto s : sys.getFinalStates().at(1)) {
-    unsigned int index = KinematicsInfo.convertFinalStateIDToPositionIndex(s);
-    FinalB += event.ParticleList[index].fourMomentum();
+template <typename MomentumAccessor>
+void HelicityKinematics::convertWithPlan(
+    std::size_t NumberOfEvents, const MomentumAccessor &fourMomentumOf,
+    const std::vector<double *> &Columns, char *PhspMask) const {
+  // Only the part of the plan that is needed for the requested columns is
+  // evaluated. The phase space check needs the invariant masses of all
+  // SubSystems, but none of the angles.
+  std::vector<char> NeededSums(MomentumSums.size(), 0);
+  std::vector<char> NeededBoosts(DecayingStates.size(), PhspMask != nullptr);
+  for (std::size_t sysID = 0; sysID < Plans.size(); ++sysID) {
+    const SubSystemPlan &Plan(Plans[sysID]);
+    if (Columns[3 * sysID])
+      NeededBoosts[Plan.DecayingState] = 1;
+    if (!Columns[3 * sysID + 1] && !Columns[3 * sysID + 2])
+      continue;
+    NeededBoosts[Plan.DecayingState] = 1;
+    NeededSums[Plan.FinalA] = 1;
+    if (Plan.Recoil >= 0)
+      NeededSums[Plan.Recoil] = 1;
+    if (Plan.ParentRecoil >= 0)
+      NeededSums[Plan.ParentRecoil] = 1;
+  }
+  for (std::size_t BoostID = 0; BoostID < DecayingStates.size(); ++BoostID) {
+    if (!NeededBoosts[BoostID])
+      continue;
+    NeededSums[DecayingStates[BoostID].first] = 1;
+    NeededSums[DecayingStates[BoostID].second] = 1;
   }
+  // each sum only depends on sums before it
+  for (std::size_t SumID = MomentumSums.size(); SumID-- > 0;) {
+    if (NeededSums[SumID] && MomentumSums[SumID].Prefix >= 0)
+      NeededSums[MomentumSums[SumID].Prefix] = 1;
+  }
+
+  std::vector<FourMomentumBlock> Sums(MomentumSums.size());
+  std::vector<BoostBlock> Boosts(DecayingStates.size());
+  FourMomentumBlock ZAxis;
+  std::fill(ZAxis.Px, ZAxis.Px + EventBlockSize, 0.0);
+  std::fill(ZAxis.Py, ZAxis.Py + EventBlockSize, 0.0);
+  std::fill(ZAxis.Pz, ZAxis.Pz + EventBlockSize, 1.0);
+  std::fill(ZAxis.E, ZAxis.E + EventBlockSize, 0.0);
+  // angles of which only one is requested are written to scratch buffers
+  double ThetaBuffer[EventBlockSize];
+  double PhiBuffer[EventBlockSize];
+
+  for (std::size_t Begin = 0; Begin < NumberOfEvents;
+       Begin += EventBlockSize) {
+    std::size_t Size = std::min(EventBlockSize, NumberOfEvents - Begin);
+    for (std::size_t SumID = 0; SumID < MomentumSums.size(); ++SumID) {
+      if (!NeededSums[SumID])
+        continue;
+      FourMomentumBlock &Sum(Sums[SumID]);
+      const MomentumSum &Recipe(MomentumSums[SumID]);
+      for (std::size_t i = 0; i < Size; ++i) {
+        const FourMomentum &P4 = fourMomentumOf(Recipe.Position, Begin + i);
+        Sum.Px[i] = P4.px();
+        Sum.Py[i] = P4.py();
+        Sum.Pz[i] = P4.pz();
+        Sum.E[i] = P4.e();
+      }
+      if (Recipe.Prefix < 0)
+        continue;
+      const FourMomentumBlock &Prefix(Sums[Recipe.Prefix]);
+      for (std::size_t i = 0; i < Size; ++i) {
+        Sum.Px[i] += Prefix.Px[i];
+        Sum.Py[i] += Prefix.Py[i];
+        Sum.Pz[i] += Prefix.Pz[i];
+        Sum.E[i] += Prefix.E[i];
+      }
+    }
+    for (std::size_t BoostID = 0; BoostID < DecayingStates.size(); ++BoostID) {
+      if (NeededBoosts[BoostID])
+        calculateBoost(Size, Sums[DecayingStates[BoostID].first],
+                       Sums[DecayingStates[BoostID].second], Boosts[BoostID]);
+    }
 
+    for (std::size_t sysID = 0; sysID < Plans.size(); ++sysID) {
+      const SubSystemPlan &Plan(Plans[sysID]);
+      const BoostBlock &Boost(Boosts[Plan.DecayingState]);
+      if (Columns[3 * sysID])
+        std::copy(Boost.MassSq, Boost.MassSq + Size,
+                  Columns[3 * sysID] + Begin);
+      double *Theta = Columns[3 * sysID + 1];
+      double *Phi = Columns[3 * sysID + 2];
+      if (!Theta && !Phi)
+        continue;
+      calculateHelicityAngles(
+          Size, Boost, Sums[Plan.FinalA],
+          Plan.Recoil < 0 ? nullptr : &Sums[Plan.Recoil],
+          Plan.ParentRecoil < 0 ? ZAxis : Sums[Plan.ParentRecoil],
+          Theta ? Theta + Begin : ThetaBuffer, Phi ? Phi + Begin : PhiBuffer);
+    }
+
+    if (!PhspMask)
+      continue;
+    // angles that are not requested are not checked; acos() and atan2()
+    // never leave the allowed ranges anyway
+    std::fill(PhspMask + Begin, PhspMask + Begin + Size, 1);
+    for (std::size_t sysID = 0; sysID < Plans.size(); ++sysID) {
+      const double *MassSq = Boosts[Plans[sysID].DecayingState].MassSq;
+      const double *Theta = Columns[3 * sysID + 1];
+      const double *Phi = Columns[3 * sysID + 2];
+      for (std::size_t i = 0; i < Size; ++i) {
+        if (!isWithinBounds(MassSq[i], Theta ? Theta[Begin + i] : 0.0,
+                            Phi ? Phi[Begin + i] : 0.0, InvMassBounds[sysID]))
+          PhspMask[Begin + i] = 0;
+      }
+    }
+  }
+}
+
+unsigned int HelicityKinematics::addMomentumSum(const IndexList &Positions) {
+  // the order of the positions is kept, so that the sums are identical to
+  // the ones of the per-event conversion
+  auto Found = MomentumSumIDs.find(Positions);
+  if (Found != MomentumSumIDs.end())
+    return Found->second;
+
+  MomentumSum Sum;
+  Sum.Position = Positions.back();
+  Sum.Prefix = -1;
+  if (Positions.size() > 1)
+    Sum.Prefix =
+        addMomentumSum(IndexList(Positions.begin(), Positions.end() - 1));
+  MomentumSums.push_back(Sum);
+  MomentumSumIDs[Positions] = MomentumSums.size() - 1;
+  return MomentumSums.size() - 1;
+}
+
+void HelicityKinematics::addToPlan(const SubSystem &sys) {
+  SubSystemPlan Plan;
+  Plan.FinalA = addMomentumSum(toPositionIndices(sys.getFinalStates().at(0)));
+  unsigned int FinalB =
+      addMomentumSum(toPositionIndices(sys.getFinalStates().at(1)));
+  // the addition of the two daughter momenta is commutative
+  auto State = std::make_pair(std::min(Plan.FinalA, FinalB),
+                              std::max(Plan.FinalA, FinalB));
+  auto Found = std::find(DecayingStates.begin(), DecayingStates.end(), State);
+  Plan.DecayingState = Found - DecayingStates.begin();
+  if (Found == DecayingStates.end())
+    DecayingStates.push_back(State);
+  Plan.Recoil = -1;
+  if (sys.getRecoilState().size())
+    Plan.Recoil = addMomentumSum(toPositionIndices(sys.getRecoilState()));
+  Plan.ParentRecoil = -1;
+  if (sys.getParentRecoilState().size())
+    Plan.ParentRecoil =
+        addMomentumSum(toPositionIndices(sys.getParentRecoilState()));
+  Plans.push_back(Plan);
+}
+
+IndexList HelicityKinematics::toPositionIndices(
+    const std::vector<unsigned int> &FinalStates) const {
+  IndexList Positions;
+  for (auto s : FinalStates)
+    Positions.push_back(KinematicsInfo.convertFinalStateIDToPositionIndex(s));
+  return Positions;
+}
+
+std::tuple<double, double, double>
+HelicityKinematics::calculateHelicityVariables(
+    const FourMomentum &FinalA, const FourMomentum &FinalB,
+    const FourMomentum &RecoilP4, const FourMomentum &ParentRecoilP4,
+    bool HasRecoil, bool HasParentRecoil) {
   // Four momentum of the decaying resonance
   FourMomentum State = FinalA + FinalB;
   double mSq = State.invMassSq();
@@ -298,20 +687,12 @@ void HelicityKinematics::convert(
   QFT::Vector4<double> DecayingState(State);
   QFT::Vector4<double> Daughter(FinalA);
 
-  // calculate the recoil and parent recoil
-  auto const &RecoilState = sys.getRecoilState();
-
   // the first step is boosting everything into the rest system of the
   // decaying state
   Daughter.Boost(DecayingState);
 
-  if (RecoilState.size() > 0) {
-    FourMomentum TempRecoil;
-    for (auto s : RecoilState) {
-      unsigned int index = KinematicsInfo.convertFinalStateIDToPositionIndex(s);
-      TempRecoil += event.ParticleList[index].fourMomentum();
-    }
-    QFT::Vector4<double> Recoil(TempRecoil);
+  if (HasRecoil) {
+    QFT::Vector4<double> Recoil(RecoilP4);
 
     Recoil.Boost(DecayingState);
 
@@ -319,18 +700,10 @@ void HelicityKinematics::convert(
     Daughter.RotateZ(-Recoil.Phi());
     Daughter.RotateY(M_PI - Recoil.Theta());
 
-    auto const &ParentRecoilState = sys.getParentRecoilState();
     // in case there is no parent recoil, it is artificially along z
     QFT::Vector4<double> ParentRecoil(0.0, 0.0, 0.0, 1.0);
-    if (ParentRecoilState.size() > 0) {
-      FourMomentum TempParentRecoil;
-      for (auto s : ParentRecoilState) {
-        unsigned int index =
-            KinematicsInfo.convertFinalStateIDToPositionIndex(s);
-        TempParentRecoil += event.ParticleList[index].fourMomentum();
-      }
-      ParentRecoil = TempParentRecoil;
-    }
+    if (HasParentRecoil)
+      ParentRecoil = ParentRecoilP4;
 
     ParentRecoil.Boost(DecayingState);
     ParentRecoil.RotateZ(-Recoil.Phi());
@@ -344,10 +717,7 @@ void HelicityKinematics::convert(
   double cosTheta = Daughter.CosTheta();
   double phi = Daughter.Phi();
 
-  point.Weight = event.Weight;
-  point.KinematicVariableList.push_back(mSq);
-  point.KinematicVariableList.push_back(std::acos(cosTheta));
-  point.KinematicVariableList.push_back(phi);
+  return std::make_tuple(mSq, std::acos(cosTheta), phi);
 }
 
 const std::pair<double, double> &
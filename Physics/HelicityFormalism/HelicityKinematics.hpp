@@ -5,6 +5,8 @@
 #ifndef PHYSICS_HELICITYFORMALISM_HELICITYKINEMATICS_HPP_
 #define PHYSICS_HELICITYFORMALISM_HELICITYKINEMATICS_HPP_
 
+#include <map>
+#include <tuple>
 #include <vector>
 
 #include "Core/Kinematics.hpp"
@@ -116,6 +118,27 @@ public:
   void convert(const Event &event, DataPoint &point,
                const SubSystem &sys) const;
 
+  /// Calculate the variables of all SubSystems for all \p Events. The
+  /// four-momenta are summed directly from the columns of the EventCollection.
+  /// The variables are calculated with the evaluation plan of the batch
+  /// conversion.
+  std::vector<std::vector<double>>
+  convert(const EventCollection &Events) const final;
+
+  /// Calculate the variables of all SubSystems for the events
+  /// [\p EventsBegin, \p EventsEnd) and write them to \p Columns. The
+  /// SubSystems are evaluated with a precompiled plan (see addSubSystem()),
+  /// so that shared momentum sums and boosts are calculated once per event.
+  /// No memory is allocated per event. The events are processed in blocks
+  /// in structure of arrays layout, so that the boosts and rotations are
+  /// vectorised. The results agree with convert(const Event&) up to
+  /// rounding. Only the parts of the plan needed for the non-null columns
+  /// are evaluated, so SubSystems that the model does not use cost (almost)
+  /// nothing.
+  void convert(const Event *EventsBegin, const Event *EventsEnd,
+               const std::vector<double *> &Columns,
+               char *PhspMask) const final;
+
   /// Check if \p point is within phase space boundaries.
   bool isWithinPhaseSpace(const DataPoint &point) const final;
 
@@ -161,6 +184,10 @@ public:
 
   double phspVolume() const;
 
+  /// The key contains the reaction, the masses of the final state particles,
+  /// the initial state four-momentum and the list of SubSystems.
+  std::string getConfigurationKey() const final;
+
   const ParticleStateTransitionKinematicsInfo &
   getParticleStateTransitionKinematicsInfo() const {
     return KinematicsInfo;
@@ -179,8 +206,68 @@ private:
 
   std::vector<std::string> VariableNames;
 
+  /// \name Evaluation plan of the batch conversion
+  /// The SubSystems are compiled into a plan, in which the four-momentum sum
+  /// of each distinct list of final state particles and the boost into the
+  /// rest frame of each distinct decaying state are calculated only once per
+  /// event. The results are shared by all SubSystems that need them.
+  ///@{
+
+  /// A momentum sum is the sum of the momentum sum with ID Prefix (none if
+  /// Prefix is negative) and the four-momentum of the particle at Position.
+  struct MomentumSum {
+    int Prefix;
+    unsigned int Position;
+  };
+
+  /// Momentum sum IDs used by a SubSystem. Recoil and ParentRecoil are
+  /// negative if the SubSystem has no (parent) recoil.
+  struct SubSystemPlan {
+    unsigned int DecayingState;
+    unsigned int FinalA;
+    int Recoil;
+    int ParentRecoil;
+  };
+
+  /// Momentum sums, each entry only depends on entries before it.
+  std::vector<MomentumSum> MomentumSums;
+  std::map<IndexList, unsigned int> MomentumSumIDs;
+  /// Momentum sum IDs of the two daughters of each decaying state, for which
+  /// a boost is needed.
+  std::vector<std::pair<unsigned int, unsigned int>> DecayingStates;
+  /// Plan of each SubSystem, in the order of Subsystems.
+  std::vector<SubSystemPlan> Plans;
+
+  /// Get the ID of the momentum sum of the particles at \p Positions. The
+  /// sum and the sums it depends on are added to the plan if necessary.
+  unsigned int addMomentumSum(const IndexList &Positions);
+  void addToPlan(const SubSystem &sys);
+
+  /// Calculate the variables of all SubSystems for \p NumberOfEvents events
+  /// according to the plan. \p fourMomentumOf(Position, i) returns the
+  /// four-momentum of the particle at Position in event i. Momentum sums and
+  /// boosts that no requested column (and no phase space check) depends on
+  /// are skipped.
+  template <typename MomentumAccessor>
+  void convertWithPlan(std::size_t NumberOfEvents,
+                       const MomentumAccessor &fourMomentumOf,
+                       const std::vector<double *> &Columns,
+                       char *PhspMask) const;
+  ///@}
+
   std::pair<double, double> calculateInvMassBounds(const SubSystem &sys) const;
 
+  /// Positions of the final state particles of \p FinalStates in the event.
+  IndexList
+  toPositionIndices(const std::vector<unsigned int> &FinalStates) const;
+
+  /// Calculate the triple (\f$m^2, \Theta, \phi\f$) from the summed
+  /// four-momenta of the two decay products, the recoil and the parent recoil.
+  static std::tuple<double, double, double> calculateHelicityVariables(
+      const FourMomentum &FinalA, const FourMomentum &FinalB,
+      const FourMomentum &Recoil, const FourMomentum &ParentRecoil,
+      bool HasRecoil, bool HasParentRecoil);
+
   IndexListTuple sortSubsystem(const IndexListTuple &SubSys) const;
   std::vector<std::pair<IndexList, IndexList>>
   redistributeIndexLists(const IndexList &A, const IndexList &B) const;
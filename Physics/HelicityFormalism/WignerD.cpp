@@ -2,6 +2,13 @@
 // This file is part of the ComPWA framework, check
 // https://github.com/ComPWA/ComPWA/license.txt for details.
 
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <sstream>
+
+#include "Core/Exceptions.hpp"
+#include "Core/VectorMath.hpp"
 #include "WignerD.hpp"
 
 namespace ComPWA {
@@ -10,30 +17,177 @@ namespace HelicityFormalism {
 
 using namespace ComPWA::FunctionTree;
 
-std::shared_ptr<ComPWA::FunctionTree::FunctionTree>
-WignerD::createFunctionTree(double J, double MuPrime, double Mu,
-                            const ComPWA::FunctionTree::ParameterList &sample,
-                            int posTheta, int posPhi) {
+namespace {
+
+/// Number of events that are calculated together.
+const std::size_t BlockSize = 64;
 
+long double factorial(int n) {
+  long double Result = 1.0L;
+  for (int i = 2; i <= n; ++i)
+    Result *= i;
+  return Result;
+}
+
+int twice(double QuantumNumber) { return std::lround(2.0 * QuantumNumber); }
+
+std::shared_ptr<ComPWA::FunctionTree::FunctionTree>
+createWignerDTree(std::string NodeName, double J, double MuPrime, double Mu,
+                  const ComPWA::FunctionTree::ParameterList &sample,
+                  int posTheta, int posPhi) {
   // in case of spin zero do not explicitly include the WignerD
   if ((double)J == 0)
     return std::make_shared<ComPWA::FunctionTree::FunctionTree>(
-        "WignerD", ComPWA::FunctionTree::Value<int>("", 1));
+        NodeName, ComPWA::FunctionTree::Value<int>("", 1));
 
   auto tr = std::make_shared<ComPWA::FunctionTree::FunctionTree>(
-      "WignerD", MComplex("", 0), std::make_shared<WignerDStrategy>("WignerD"));
+      NodeName, MComplex("", 0), std::make_shared<WignerDStrategy>("WignerD"));
 
-  tr->createLeaf("spin", J, "WignerD");
-  tr->createLeaf("muprime", MuPrime, "WignerD");
-  tr->createLeaf("mu", Mu, "WignerD");
+  tr->createLeaf("spin", J, NodeName);
+  tr->createLeaf("muprime", MuPrime, NodeName);
+  tr->createLeaf("mu", Mu, NodeName);
   tr->createLeaf(sample.mDoubleValue(posTheta)->name(),
-                 sample.mDoubleValue(posTheta), "WignerD");
+                 sample.mDoubleValue(posTheta), NodeName);
   tr->createLeaf(sample.mDoubleValue(posPhi)->name(),
-                 sample.mDoubleValue(posPhi), "WignerD");
+                 sample.mDoubleValue(posPhi), NodeName);
 
   return tr;
 }
 
+} // namespace
+
+WignerDCoefficients::WignerDCoefficients(int TwiceJ_, int TwiceMuPrime_,
+                                         int TwiceMu_)
+    : TwiceJ(TwiceJ_), TwiceMuPrime(TwiceMuPrime_), TwiceMu(TwiceMu_),
+      CosPower(0), SinPower(0), Coefficients(1, 1.0) {
+  if (TwiceJ < 0 || std::abs(TwiceMuPrime) > TwiceJ ||
+      std::abs(TwiceMu) > TwiceJ || (TwiceJ + TwiceMuPrime) % 2 ||
+      (TwiceJ + TwiceMu) % 2)
+    throw ComPWA::BadParameter(
+        "WignerDCoefficients::WignerDCoefficients() | Invalid quantum "
+        "numbers 2J=" +
+        std::to_string(TwiceJ) + ", 2mu'=" + std::to_string(TwiceMuPrime) +
+        ", 2mu=" + std::to_string(TwiceMu) + "!");
+  if (TwiceJ == 0)
+    return;
+
+  // same sum as in QFT::Wigner_d(), the term k contains
+  // cos(beta/2)^(2k-m-n) sin(beta/2)^(2J+m+n-2k)
+  int MPlusN = (TwiceMuPrime + TwiceMu) / 2;
+  int JPlusM = (TwiceJ + TwiceMuPrime) / 2;
+  int JMinusM = (TwiceJ - TwiceMuPrime) / 2;
+  int JPlusN = (TwiceJ + TwiceMu) / 2;
+  int JMinusN = (TwiceJ - TwiceMu) / 2;
+  int KLow = std::max(0, MPlusN);
+  int KHigh = std::min(JPlusM, JPlusN);
+
+  long double Norm = std::sqrt((TwiceJ + 1) / (4.0L * std::acos(-1.0L)));
+  long double Constant =
+      ((JPlusM % 2) ? -Norm : Norm) *
+      std::sqrt(factorial(JPlusM) * factorial(JMinusM) * factorial(JPlusN) *
+                factorial(JMinusN));
+
+  CosPower = 2 * KLow - MPlusN;
+  SinPower = TwiceJ + MPlusN - 2 * KHigh;
+  Coefficients.resize(KHigh - KLow + 1);
+  for (int k = KLow; k <= KHigh; ++k) {
+    long double Term =
+        Constant / (factorial(k) * factorial(JPlusM - k) *
+                    factorial(JPlusN - k) * factorial(k - MPlusN));
+    Coefficients[k - KLow] = (k % 2) ? -Term : Term;
+  }
+}
+
+double WignerDCoefficients::operator()(double beta) const {
+  double alpha = 0.0;
+  std::complex<double> Result;
+  evaluate(1, &alpha, &beta, &Result);
+  return Result.real();
+}
+
+std::complex<double> WignerDCoefficients::operator()(double alpha,
+                                                     double beta) const {
+  std::complex<double> Result;
+  evaluate(1, &alpha, &beta, &Result);
+  return Result;
+}
+
+void WignerDCoefficients::evaluate(std::size_t n, const double *alpha,
+                                   const double *beta,
+                                   std::complex<double> *Result) const {
+  std::size_t N = Coefficients.size() - 1;
+  double MuPrime = 0.5 * TwiceMuPrime;
+  double *ResultParts = reinterpret_cast<double *>(Result);
+  for (std::size_t Begin = 0; Begin < n; Begin += BlockSize) {
+    std::size_t Size = std::min(BlockSize, n - Begin);
+    const double *Alpha = alpha + Begin;
+    const double *Beta = beta + Begin;
+
+    double CosSq[BlockSize], SinSq[BlockSize], Prefactor[BlockSize];
+    for (std::size_t i = 0; i < Size; ++i) {
+      double s, c;
+      VectorMath::sincos(0.5 * Beta[i], s, c);
+      CosSq[i] = c * c;
+      SinSq[i] = s * s;
+      Prefactor[i] =
+          VectorMath::pow(c, CosPower) * VectorMath::pow(s, SinPower);
+    }
+
+    // homogeneous Horner scheme in cos^2 and sin^2
+    double Sum[BlockSize], SinPowers[BlockSize];
+    for (std::size_t i = 0; i < Size; ++i) {
+      Sum[i] = Coefficients[N];
+      SinPowers[i] = 1.0;
+    }
+    for (std::size_t m = N; m-- > 0;) {
+      double C = Coefficients[m];
+      for (std::size_t i = 0; i < Size; ++i) {
+        SinPowers[i] *= SinSq[i];
+        Sum[i] = Sum[i] * CosSq[i] + C * SinPowers[i];
+      }
+    }
+
+    // phase exp(-i mu' alpha)
+    double *Out = ResultParts + 2 * Begin;
+    for (std::size_t i = 0; i < Size; ++i) {
+      double s, c;
+      VectorMath::sincos(MuPrime * Alpha[i], s, c);
+      double d = Prefactor[i] * Sum[i];
+      Out[2 * i] = d * c;
+      Out[2 * i + 1] = -d * s;
+    }
+  }
+}
+
+std::shared_ptr<ComPWA::FunctionTree::FunctionTree>
+WignerD::createFunctionTree(double J, double MuPrime, double Mu,
+                            const ComPWA::FunctionTree::ParameterList &sample,
+                            int posTheta, int posPhi) {
+  return createWignerDTree("WignerD", J, MuPrime, Mu, sample, posTheta,
+                           posPhi);
+}
+
+std::shared_ptr<ComPWA::FunctionTree::FunctionTree>
+WignerDTreeCache::wignerDTree(double J, double MuPrime, double Mu,
+                              const ParameterList &DataSample,
+                              unsigned int posTheta, unsigned int posPhi) {
+  auto Theta = DataSample.mDoubleValue(posTheta);
+  auto Phi = DataSample.mDoubleValue(posPhi);
+  Key WignerDKey(twice(J), twice(MuPrime), twice(Mu), Theta, Phi);
+  if (auto Cached = WignerDTrees.find(WignerDKey))
+    return Cached;
+
+  std::ostringstream Name;
+  Name << "(" << J << "," << MuPrime << "," << Mu << ")[" << Theta->name()
+       << "," << Phi->name() << "]";
+  auto Tree =
+      createWignerDTree(WignerDTrees.uniqueName("WignerD", Name.str()), J,
+                        MuPrime, Mu, DataSample, posTheta, posPhi);
+
+  WignerDTrees.insert(WignerDKey, Tree);
+  return Tree;
+}
+
 void WignerDStrategy::execute(
     ParameterList &paras,
     std::shared_ptr<ComPWA::FunctionTree::Parameter> &out) {
@@ -46,9 +200,9 @@ void WignerDStrategy::execute(
   }
 #endif
 
-  double J = paras.doubleValue(0)->value();
-  double muPrime = paras.doubleValue(1)->value();
-  double mu = paras.doubleValue(2)->value();
+  int TwiceJ = twice(paras.doubleValue(0)->value());
+  int TwiceMuPrime = twice(paras.doubleValue(1)->value());
+  int TwiceMu = twice(paras.doubleValue(2)->value());
 
   auto thetas = paras.mDoubleValue(0);
   auto phis = paras.mDoubleValue(1);
@@ -62,16 +216,18 @@ void WignerDStrategy::execute(
   if (results.size() != n) {
     results.resize(n);
   }
-  for (unsigned int ele = 0; ele < n; ele++) {
-    try {
-      results[ele] = WignerD::dynamicalFunction(
-          J, muPrime, mu, phis->values()[ele], thetas->values()[ele], 0.0);
-    } catch (std::exception &ex) {
-      LOG(ERROR) << "WignerDStrategy::execute() | " << ex.what();
-      throw std::runtime_error("WignerDStrategy::execute() | "
-                               "Evaluation of dynamical function failed!");
-    }
-  } // end element loop
+  try {
+    if (TwiceJ != Coefficients.twiceJ() ||
+        TwiceMuPrime != Coefficients.twiceMuPrime() ||
+        TwiceMu != Coefficients.twiceMu())
+      Coefficients = WignerDCoefficients(TwiceJ, TwiceMuPrime, TwiceMu);
+    Coefficients.evaluate(n, phis->values().data(), thetas->values().data(),
+                          results.data());
+  } catch (std::exception &ex) {
+    LOG(ERROR) << "WignerDStrategy::execute() | " << ex.what();
+    throw std::runtime_error("WignerDStrategy::execute() | "
+                             "Evaluation of dynamical function failed!");
+  }
 }
 
 } // namespace HelicityFormalism
@@ -5,7 +5,14 @@
 #ifndef COMPWA_PHYSICS_HELICITY_FORMALISM_WIGNERD_HPP_
 #define COMPWA_PHYSICS_HELICITY_FORMALISM_WIGNERD_HPP_
 
+#include <complex>
+#include <cstddef>
+#include <map>
+#include <tuple>
+#include <vector>
+
 #include "Core/FunctionTree/FunctionTree.hpp"
+#include "Core/FunctionTree/FunctionTreeCache.hpp"
 #include "Core/FunctionTree/Functions.hpp"
 
 #include "qft++/WignerD.h"
@@ -17,6 +24,54 @@ struct DataPoint;
 namespace Physics {
 namespace HelicityFormalism {
 
+///
+/// \class WignerDCoefficients
+/// Normalised WignerD function sqrt((2J+1)/(4pi)) d^J_{mu' mu}(beta)
+/// exp(-i mu' alpha) of fixed quantum numbers (see
+/// WignerD::dynamicalFunction()). The sum over factorials of QFT::Wigner_d()
+/// is calculated once in the constructor. It is a polynomial
+///
+///   d(beta) = c^a s^b sum_i C_i (c^2)^i (s^2)^(n-i),
+///   c = cos(beta/2), s = sin(beta/2),
+///
+/// whose coefficients C_i (including the normalisation) are stored. For spin
+/// zero the function is one, like WignerD::dynamicalFunction().
+///
+/// For beta < 0, QFT::Wigner_d() swaps mu' and mu and uses abs(beta). This is
+/// not necessary for the polynomial, which is valid for all beta: only s
+/// changes its sign, and b + 2(n-i) has the parity of mu' - mu for all
+/// terms. Hence d(-beta) = (-1)^(mu'-mu) d(beta) = d^J_{mu mu'}(beta).
+///
+class WignerDCoefficients {
+public:
+  /// The quantum numbers are given as twice their value, so that half
+  /// integer spins are exact.
+  WignerDCoefficients(int TwiceJ_, int TwiceMuPrime_, int TwiceMu_);
+
+  double operator()(double beta) const;
+
+  std::complex<double> operator()(double alpha, double beta) const;
+
+  /// Calculate the WignerD function for \p n pairs of angles \p alpha and
+  /// \p beta (gamma = 0) and store them in \p Result.
+  void evaluate(std::size_t n, const double *alpha, const double *beta,
+                std::complex<double> *Result) const;
+
+  int twiceJ() const { return TwiceJ; }
+  int twiceMuPrime() const { return TwiceMuPrime; }
+  int twiceMu() const { return TwiceMu; }
+
+private:
+  int TwiceJ;
+  int TwiceMuPrime;
+  int TwiceMu;
+  /// Power a of cos(beta/2) that all terms have in common
+  int CosPower;
+  /// Power b of sin(beta/2) that all terms have in common
+  int SinPower;
+  std::vector<double> Coefficients;
+};
+
 ///
 /// Angular distribution based on WignerD functions
 ///
@@ -28,11 +83,7 @@ inline double dynamicalFunction(double J, double muPrime, double mu,
   if ((double)J == 0)
     return 1.0;
 
-  assert(!std::isnan(beta));
-  assert(std::cos(beta) <= 1 && std::cos(beta) >= -1);
-
   double result = QFT::Wigner_d(J, muPrime, mu, beta);
-  assert(!std::isnan(result));
 
   double pi4 = M_PI * 4.0;
   double norm = std::sqrt((2.0 * J + 1) / pi4);
@@ -46,19 +97,12 @@ inline std::complex<double> dynamicalFunction(double J, double muPrime,
   if ((double)J == 0)
     return std::complex<double>(1.0, 0);
 
-  assert(!std::isnan(alpha));
-  assert(!std::isnan(beta));
-  assert(!std::isnan(gamma));
-
   std::complex<double> i(0, 1);
 
   double tmp = WignerD::dynamicalFunction(J, muPrime, mu, beta);
   std::complex<double> result =
       tmp * std::exp(-i * (muPrime * alpha + mu * gamma));
 
-  assert(!std::isnan(result.real()));
-  assert(!std::isnan(result.imag()));
-
   return result;
 }
 
@@ -68,11 +112,14 @@ createFunctionTree(double J, double MuPrime, double Mu,
                    int posTheta, int posPhi);
 } // namespace WignerD
 
+/// Strategy that calculates the WignerD function for each event. The
+/// WignerDCoefficients are built for the quantum numbers of the leaves spin,
+/// muprime and mu and are reused as long as these do not change.
 class WignerDStrategy : public ComPWA::FunctionTree::Strategy {
 public:
   WignerDStrategy(const std::string &resonanceName)
-      : Strategy(ComPWA::FunctionTree::ParType::MCOMPLEX), name(resonanceName) {
-  }
+      : Strategy(ComPWA::FunctionTree::ParType::MCOMPLEX), name(resonanceName),
+        Coefficients(0, 0, 0) {}
 
   virtual const std::string to_str() const { return ("WignerD of " + name); }
 
@@ -81,6 +128,32 @@ public:
 
 protected:
   std::string name;
+  WignerDCoefficients Coefficients;
+};
+
+///
+/// \class WignerDTreeCache
+/// The WignerD functions depend only on the angle columns of the data. The
+/// cache creates a FunctionTree for each combination of quantum numbers and
+/// angle columns once and returns the same tree for all further requests, so
+/// that the angular distribution is calculated once for all amplitudes that
+/// share it. Data and phase space sample use different columns.
+///
+class WignerDTreeCache {
+public:
+  /// WignerD::createFunctionTree() of the columns \p posTheta and \p posPhi
+  /// of \p DataSample.
+  std::shared_ptr<ComPWA::FunctionTree::FunctionTree>
+  wignerDTree(double J, double MuPrime, double Mu,
+              const ComPWA::FunctionTree::ParameterList &DataSample,
+              unsigned int posTheta, unsigned int posPhi);
+
+private:
+  using Key =
+      std::tuple<int, int, int,
+                 std::weak_ptr<const ComPWA::FunctionTree::Parameter>,
+                 std::weak_ptr<const ComPWA::FunctionTree::Parameter>>;
+  ComPWA::FunctionTree::FunctionTreeCache<Key> WignerDTrees;
 };
 
 } // namespace HelicityFormalism
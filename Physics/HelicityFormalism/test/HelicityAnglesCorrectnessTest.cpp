@@ -383,4 +383,53 @@ BOOST_AUTO_TEST_CASE(HelicityAnglesCorrectnessTest) {
   }
 }
 
+/*!
+ * The batch conversion calculates the helicity angles with a vectorised
+ * implementation. It is compared with the per-event conversion for all
+ * subsystems of the four body final state.
+ */
+BOOST_AUTO_TEST_CASE(VectorisedHelicityAnglesTest) {
+  ComPWA::Logging log("INFO", "output.log");
+
+  std::stringstream ModelStringStream;
+  ModelStringStream << ModelConfigXML;
+  auto partL = readParticles(ModelStringStream);
+
+  boost::property_tree::ptree tr;
+  ModelStringStream.clear();
+  ModelStringStream << ModelConfigXML;
+  boost::property_tree::xml_parser::read_xml(ModelStringStream, tr);
+
+  auto kin = ComPWA::Physics::createHelicityKinematics(
+      partL, tr.get_child("HelicityKinematics"));
+  kin.createAllSubsystems();
+
+  ComPWA::Data::Root::RootGenerator gen(
+      kin.getParticleStateTransitionKinematicsInfo());
+  ComPWA::Data::Root::RootUniformRealGenerator RandomGenerator(123);
+  // the size is not a multiple of the internal block size
+  auto sample(ComPWA::Data::generatePhsp(1000, gen, RandomGenerator));
+
+  std::size_t NumberOfVariables = kin.getKinematicVariableNames().size();
+  std::vector<std::vector<double>> Data(NumberOfVariables,
+                                        std::vector<double>(sample.size()));
+  std::vector<double *> Columns;
+  for (auto &Column : Data)
+    Columns.push_back(Column.data());
+  kin.convert(sample.data(), sample.data() + sample.size(), Columns, nullptr);
+
+  for (std::size_t i = 0; i < sample.size(); ++i) {
+    DataPoint point(kin.convert(sample[i]));
+    for (std::size_t var = 0; var < NumberOfVariables; var += 3) {
+      BOOST_CHECK_SMALL(Data[var][i] - point.KinematicVariableList[var],
+                        1e-10);
+      BOOST_CHECK_SMALL(Data[var + 1][i] - point.KinematicVariableList[var + 1],
+                        1e-10);
+      BOOST_CHECK_SMALL(calculatePhiDiff(Data[var + 2][i],
+                                         point.KinematicVariableList[var + 2]),
+                        1e-10);
+    }
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
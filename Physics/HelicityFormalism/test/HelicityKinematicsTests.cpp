@@ -5,9 +5,15 @@
 // Define Boost test module
 #define BOOST_TEST_MODULE HelicityFormalism
 
+#include "Core/Event.hpp"
+#include "Core/Exceptions.hpp"
 #include "Core/Logging.hpp"
+#include "Data/DataSet.hpp"
 #include "Physics/HelicityFormalism/HelicityKinematics.hpp"
 
+#include <cmath>
+#include <random>
+
 #include <boost/property_tree/ptree.hpp>
 #include <boost/property_tree/xml_parser.hpp>
 #include <boost/test/unit_test.hpp>
@@ -16,16 +22,25 @@ const std::string HelicityTestParticles = R"####(
 <ParticleList>
   <Particle Name='pi0'>
     <Pid>111</Pid>
+    <Parameter Type='Mass' Name='Mass_pi0'>
+      <Value>0.1349766</Value>
+    </Parameter>
 	<QuantumNumber Class='Spin' Type='Spin' Value='0'/>
 	<QuantumNumber Class='Int' Type='Parity' Value='-1'/>
   </Particle>
   <Particle Name='gamma'>
     <Pid>22</Pid>
+    <Parameter Type='Mass' Name='Mass_gamma'>
+      <Value>0.0</Value>
+    </Parameter>
 	<QuantumNumber Class='Spin' Type='Spin' Value='1'/>
 	<QuantumNumber Class='Int' Type='Parity' Value='-1'/>
   </Particle>
   <Particle Name='jpsi'>
     <Pid>443</Pid>
+    <Parameter Type='Mass' Name='Mass_jpsi'>
+      <Value>3.096900</Value>
+    </Parameter>
 	<QuantumNumber Class='Spin' Type='Spin' Value='1'/>
 	<QuantumNumber Class='Int' Type='Parity' Value='-1'/>
   </Particle>
@@ -78,4 +93,151 @@ BOOST_AUTO_TEST_CASE(CreateAllSubsystems) {
   BOOST_CHECK_EQUAL(kin3->subSystems().size(), 270);
 }
 
+BOOST_AUTO_TEST_CASE(BatchConvert) {
+  ComPWA::Logging log("debug", "");
+
+  std::stringstream modelStream;
+  modelStream << HelicityTestParticles;
+  auto partL = ComPWA::readParticles(modelStream);
+
+  ComPWA::Physics::HelicityFormalism::HelicityKinematics kin(
+      partL, {443}, {22, 111, 111});
+  kin.createAllSubsystems();
+
+  // the batch conversion does not require physical events, only time-like
+  // four-momenta. Part of the events is outside of the phase space.
+  std::mt19937 Generator(1234);
+  std::uniform_real_distribution<double> Momentum(-2.0, 2.0);
+  std::vector<ComPWA::Event> Events(100);
+  for (auto &Evt : Events) {
+    for (double Mass : {0.0, 0.135, 0.135}) {
+      double px(Momentum(Generator)), py(Momentum(Generator)),
+          pz(Momentum(Generator));
+      double E = std::sqrt(px * px + py * py + pz * pz + Mass * Mass);
+      Evt.ParticleList.push_back(ComPWA::Particle(px, py, pz, E));
+    }
+  }
+
+  std::size_t NumberOfVariables = kin.getKinematicVariableNames().size();
+  std::vector<std::vector<double>> Data(NumberOfVariables,
+                                        std::vector<double>(Events.size()));
+  std::vector<double *> Columns;
+  for (auto &Column : Data)
+    Columns.push_back(Column.data());
+  std::vector<char> PhspMask(Events.size());
+  kin.convert(Events.data(), Events.data() + Events.size(), Columns,
+              PhspMask.data());
+
+  std::size_t NumberWithinPhaseSpace(0);
+  for (std::size_t i = 0; i < Events.size(); ++i) {
+    ComPWA::DataPoint Point = kin.convert(Events[i]);
+    // the batch conversion is vectorised and differs in the last digits
+    for (std::size_t var = 0; var < NumberOfVariables; ++var)
+      BOOST_CHECK_SMALL(Data[var][i] - Point.KinematicVariableList[var],
+                        1e-10);
+    BOOST_CHECK_EQUAL(bool(PhspMask[i]), kin.isWithinPhaseSpace(Point));
+    NumberWithinPhaseSpace += PhspMask[i];
+  }
+  BOOST_CHECK(NumberWithinPhaseSpace > 0);
+  BOOST_CHECK(NumberWithinPhaseSpace < Events.size());
+
+  // request only some of the variables, the others are not calculated
+  std::vector<std::vector<double>> Selected(
+      NumberOfVariables, std::vector<double>(Events.size(), -100.0));
+  std::vector<double *> SelectedColumns(NumberOfVariables, nullptr);
+  for (std::size_t var : {0, 4, 8, 9, 15})
+    SelectedColumns[var] = Selected[var].data();
+  std::vector<char> SelectedPhspMask(Events.size());
+  kin.convert(Events.data(), Events.data() + Events.size(), SelectedColumns,
+              SelectedPhspMask.data());
+  for (std::size_t var = 0; var < NumberOfVariables; ++var) {
+    for (std::size_t i = 0; i < Events.size(); ++i) {
+      if (SelectedColumns[var])
+        BOOST_CHECK_EQUAL(Selected[var][i], Data[var][i]);
+      else
+        BOOST_CHECK_EQUAL(Selected[var][i], -100.0);
+    }
+  }
+  BOOST_CHECK(SelectedPhspMask == PhspMask);
+
+  // one column per kinematic variable is required
+  SelectedColumns.pop_back();
+  BOOST_CHECK_THROW(kin.convert(Events.data(), Events.data() + Events.size(),
+                                SelectedColumns, SelectedPhspMask.data()),
+                    ComPWA::BadParameter);
+}
+
+BOOST_AUTO_TEST_CASE(ConvertWithinPhaseSpace) {
+  ComPWA::Logging log("warning", "");
+
+  std::stringstream modelStream;
+  modelStream << HelicityTestParticles;
+  auto partL = ComPWA::readParticles(modelStream);
+
+  ComPWA::Physics::HelicityFormalism::HelicityKinematics kin(
+      partL, {443}, {22, 111, 111});
+  kin.createAllSubsystems();
+
+  // more events than one conversion block, part of them is outside of the
+  // phase space, and every event has its own weight
+  std::mt19937 Generator(4321);
+  std::uniform_real_distribution<double> Momentum(-2.0, 2.0);
+  std::vector<ComPWA::Event> Events(5000);
+  for (std::size_t i = 0; i < Events.size(); ++i) {
+    for (double Mass : {0.0, 0.135, 0.135}) {
+      double px(Momentum(Generator)), py(Momentum(Generator)),
+          pz(Momentum(Generator));
+      double E = std::sqrt(px * px + py * py + pz * pz + Mass * Mass);
+      Events[i].ParticleList.push_back(ComPWA::Particle(px, py, pz, E));
+    }
+    Events[i].Weight = 1.0 + i;
+  }
+
+  auto Reduced = ComPWA::Data::reduceToPhaseSpace(Events, kin);
+  BOOST_REQUIRE(Reduced.size() > 0);
+  BOOST_REQUIRE(Reduced.size() < Events.size());
+
+  auto Expected = ComPWA::Data::convertEventsToDataSet(Reduced, kin);
+  auto Fused =
+      ComPWA::Data::convertEventsToDataSetWithinPhaseSpace(Events, kin);
+  BOOST_CHECK(Fused.VariableNames == Expected.VariableNames);
+  BOOST_CHECK(Fused.Data == Expected.Data);
+  BOOST_CHECK(Fused.Weights == Expected.Weights);
+
+  std::vector<std::string> UsedVariableNames{
+      Expected.VariableNames[0], Expected.VariableNames[4],
+      Expected.VariableNames[8]};
+  auto ExpectedUsed =
+      ComPWA::Data::convertEventsToDataSet(Reduced, kin, UsedVariableNames);
+  auto FusedUsed = ComPWA::Data::convertEventsToDataSetWithinPhaseSpace(
+      Events, kin, UsedVariableNames);
+  BOOST_CHECK(FusedUsed.Data == ExpectedUsed.Data);
+  BOOST_CHECK(FusedUsed.Weights == ExpectedUsed.Weights);
+  BOOST_CHECK(FusedUsed.Data[1].empty());
+}
+
+BOOST_AUTO_TEST_CASE(ConfigurationKey) {
+  ComPWA::Logging log("debug", "");
+
+  std::stringstream modelStream;
+  modelStream << HelicityTestParticles;
+  auto partL = ComPWA::readParticles(modelStream);
+
+  using ComPWA::Physics::HelicityFormalism::HelicityKinematics;
+  HelicityKinematics kin(partL, {443}, {22, 111, 111});
+  HelicityKinematics kin2(partL, {443}, {22, 111, 111});
+  HelicityKinematics kin3(partL, {443}, {111, 22, 111});
+  BOOST_CHECK(!kin.getConfigurationKey().empty());
+  BOOST_CHECK_EQUAL(kin.getConfigurationKey(), kin2.getConfigurationKey());
+  BOOST_CHECK(kin.getConfigurationKey() != kin3.getConfigurationKey());
+
+  kin.addSubSystem({0}, {1}, {2}, {});
+  BOOST_CHECK(kin.getConfigurationKey() != kin2.getConfigurationKey());
+  kin2.addSubSystem({0}, {1}, {2}, {});
+  BOOST_CHECK_EQUAL(kin.getConfigurationKey(), kin2.getConfigurationKey());
+  kin.addSubSystem({0}, {2}, {1}, {});
+  kin2.addSubSystem({1}, {2}, {0}, {});
+  BOOST_CHECK(kin.getConfigurationKey() != kin2.getConfigurationKey());
+}
+
 BOOST_AUTO_TEST_SUITE_END()
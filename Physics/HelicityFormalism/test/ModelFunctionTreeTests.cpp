@@ -6,6 +6,8 @@
 #define BOOST_TEST_MODULE HelicityFormalism
 
 #include "Core/Logging.hpp"
+#include "Data/DataSet.hpp"
+#include "Data/Generate.hpp"
 #include "Data/Root/RootGenerator.hpp"
 #include "Physics/BuilderXML.hpp"
 #include "Physics/HelicityFormalism/HelicityKinematics.hpp"
@@ -13,6 +15,7 @@
 #include <boost/property_tree/xml_parser.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include <numeric>
 #include <vector>
 
 using namespace ComPWA;
@@ -145,4 +148,117 @@ BOOST_AUTO_TEST_CASE(KinematicsConstructionFromXML) {
                     std::pow(findParticle(partL, "jpsi").getMass().Value, 2));
 }
 
+// Coherent sum of two amplitudes with the same resonance in two SubSystems
+const std::string InterferenceTestModel = R"####(
+<Intensity Class="NormalizedIntensity" Name="jpsiToPi0GammaPi0_norm">
+  <IntegrationStrategy Class="MCIntegrationStrategy"/>
+  <Intensity Class="CoherentIntensity" Name="jpsiToPi0GammaPi0">
+    <Amplitude Class="CoefficientAmplitude" Name="omega_01">
+      <Parameter Class='Double' Type="Magnitude" Name="Magnitude_omega_01">
+        <Value>1.0</Value>
+      </Parameter>
+      <Parameter Class='Double' Type="Phase" Name="Phase_omega_01">
+        <Value>0.0</Value>
+      </Parameter>
+      <Amplitude Class="HelicityDecay" Name="omegaToPi0Gamma_01">
+        <DecayParticle Name="omega" Helicity="1"/>
+        <RecoilSystem FinalState="2" />
+        <DecayProducts>
+          <Particle Name="pi0" FinalState="0" Helicity="0"/>
+          <Particle Name="gamma" FinalState="1" Helicity="1"/>
+        </DecayProducts>
+      </Amplitude>
+    </Amplitude>
+    <Amplitude Class="CoefficientAmplitude" Name="omega_21">
+      <Parameter Class='Double' Type="Magnitude" Name="Magnitude_omega_21">
+        <Value>0.5</Value>
+      </Parameter>
+      <Parameter Class='Double' Type="Phase" Name="Phase_omega_21">
+        <Value>1.0</Value>
+      </Parameter>
+      <Amplitude Class="HelicityDecay" Name="omegaToPi0Gamma_21">
+        <DecayParticle Name="omega" Helicity="1"/>
+        <RecoilSystem FinalState="0" />
+        <DecayProducts>
+          <Particle Name="pi0" FinalState="2" Helicity="0"/>
+          <Particle Name="gamma" FinalState="1" Helicity="1"/>
+        </DecayProducts>
+      </Amplitude>
+    </Amplitude>
+  </Intensity>
+</Intensity>
+)####";
+
+BOOST_AUTO_TEST_CASE(InterferenceIntegralNormalization) {
+  ComPWA::Logging log("", "warning");
+
+  std::stringstream modelStream;
+  modelStream << HelicityTestParticles;
+  auto partL = readParticles(modelStream);
+  modelStream.clear();
+  boost::property_tree::ptree tr;
+  modelStream << HelicityTestKinematics;
+  boost::property_tree::xml_parser::read_xml(modelStream, tr);
+  auto kin = ComPWA::Physics::createHelicityKinematics(
+      partL, tr.get_child("HelicityKinematics"));
+
+  ComPWA::Data::Root::RootGenerator gen(
+      kin.getParticleStateTransitionKinematicsInfo());
+  ComPWA::Data::Root::RootUniformRealGenerator randomGen(123);
+  auto phspSample = ComPWA::Data::generatePhsp(2000, gen, randomGen);
+  auto sample = ComPWA::Data::generatePhsp(100, gen, randomGen);
+
+  modelStream.clear();
+  boost::property_tree::ptree modelTree;
+  modelStream << InterferenceTestModel;
+  boost::property_tree::xml_parser::read_xml(modelStream, modelTree);
+  ComPWA::Physics::IntensityBuilderXML builder(
+      partL, kin, modelTree.get_child("Intensity"), phspSample);
+  auto intensity = builder.createIntensity();
+  // the normalization is calculated from the interference matrix
+  BOOST_CHECK(intensity.print(-1).find("InterferenceIntegral(") !=
+              std::string::npos);
+
+  // reference: the unnormalized intensity divided by its mean over the phsp
+  // sample, which is the integral of the MCIntegrationStrategy without the
+  // interference matrix
+  ComPWA::Physics::IntensityBuilderXML unnormalizedBuilder(
+      partL, kin, modelTree.get_child("Intensity.Intensity"));
+  auto unnormalized = unnormalizedBuilder.createIntensity();
+  auto phspData = ComPWA::Data::convertEventsToDataSet(phspSample, kin);
+  auto data = ComPWA::Data::convertEventsToDataSet(sample, kin);
+
+  auto check = [&]() {
+    auto phspValues = unnormalized.evaluate(phspData.Data);
+    double integral = std::inner_product(phspValues.begin(), phspValues.end(),
+                                         phspData.Weights.begin(), 0.0) /
+                      std::accumulate(phspData.Weights.begin(),
+                                      phspData.Weights.end(), 0.0);
+    auto expected = unnormalized.evaluate(data.Data);
+    auto result = intensity.evaluate(data.Data);
+    BOOST_REQUIRE_EQUAL(result.size(), expected.size());
+    for (std::size_t i = 0; i < result.size(); ++i)
+      BOOST_CHECK_CLOSE(result[i], expected[i] / integral, 1e-9);
+  };
+  check();
+
+  // a change of the coefficients only changes the quadratic form, a change
+  // of the shapes recalculates the interference matrix
+  for (auto newValue : std::vector<std::pair<std::string, double>>{
+           {"Phase_omega_21", -2.0},
+           {"Magnitude_omega_01", 0.3},
+           {"Width_omega", 0.05}}) {
+    for (auto intens : {&intensity, &unnormalized}) {
+      auto parameters = std::get<1>(intens->bind(data.Data));
+      for (auto p : parameters.doubleParameters()) {
+        if (p->name() == newValue.first) {
+          p->fixParameter(false);
+          p->setValue(newValue.second);
+        }
+      }
+    }
+    check();
+  }
+}
+
 BOOST_AUTO_TEST_SUITE_END()
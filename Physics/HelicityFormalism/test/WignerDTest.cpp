@@ -0,0 +1,136 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#define BOOST_TEST_MODULE WignerDTest
+
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Core/FunctionTree/FunctionTree.hpp"
+#include "Physics/HelicityFormalism/WignerD.hpp"
+
+using namespace ComPWA::Physics::HelicityFormalism;
+
+BOOST_AUTO_TEST_SUITE(HelicityFormalism)
+
+/// Pairs of angles (phi, theta) including the boundaries of theta and
+/// negative values.
+std::vector<std::pair<double, double>> createAngles() {
+  std::vector<std::pair<double, double>> Angles;
+  for (double Theta = -M_PI; Theta <= M_PI + 1e-9; Theta += M_PI / 24)
+    Angles.push_back(std::make_pair(2.0 * Theta + 0.3, Theta));
+  Angles.push_back(std::make_pair(0.0, 0.0));
+  Angles.push_back(std::make_pair(-1.0, M_PI));
+  return Angles;
+}
+
+BOOST_AUTO_TEST_CASE(WignerDCoefficientsTest) {
+  auto Angles = createAngles();
+  std::size_t Mismatches(0);
+  for (int TwiceJ = 0; TwiceJ <= 8; ++TwiceJ) {
+    for (int TwiceMuPrime = -TwiceJ; TwiceMuPrime <= TwiceJ;
+         TwiceMuPrime += 2) {
+      for (int TwiceMu = -TwiceJ; TwiceMu <= TwiceJ; TwiceMu += 2) {
+        WignerDCoefficients Coefficients(TwiceJ, TwiceMuPrime, TwiceMu);
+        for (auto Angle : Angles) {
+          auto Expected = WignerD::dynamicalFunction(
+              0.5 * TwiceJ, 0.5 * TwiceMuPrime, 0.5 * TwiceMu, Angle.first,
+              Angle.second, 0.0);
+          auto Result = Coefficients(Angle.first, Angle.second);
+          if (std::abs(Result - Expected) > 1e-13)
+            ++Mismatches;
+          double ExpectedReal = WignerD::dynamicalFunction(
+              0.5 * TwiceJ, 0.5 * TwiceMuPrime, 0.5 * TwiceMu, Angle.second);
+          if (std::abs(Coefficients(Angle.second) - ExpectedReal) > 1e-13)
+            ++Mismatches;
+        }
+      }
+    }
+  }
+  BOOST_CHECK_EQUAL(Mismatches, 0);
+
+  BOOST_CHECK_THROW(WignerDCoefficients(2, 4, 0), ComPWA::BadParameter);
+  BOOST_CHECK_THROW(WignerDCoefficients(2, 1, 0), ComPWA::BadParameter);
+}
+
+BOOST_AUTO_TEST_CASE(WignerDCoefficientsNegativeBeta) {
+  // QFT::Wigner_d() swaps the helicities for beta < 0, the polynomial does
+  // not
+  std::size_t Mismatches(0);
+  for (int TwiceJ = 1; TwiceJ <= 8; ++TwiceJ) {
+    double Norm = std::sqrt((TwiceJ + 1) / (4.0 * M_PI));
+    for (int TwiceMuPrime = -TwiceJ; TwiceMuPrime <= TwiceJ;
+         TwiceMuPrime += 2) {
+      for (int TwiceMu = -TwiceJ; TwiceMu <= TwiceJ; TwiceMu += 2) {
+        WignerDCoefficients Coefficients(TwiceJ, TwiceMuPrime, TwiceMu);
+        for (double Beta = -M_PI; Beta < 0.0; Beta += M_PI / 19) {
+          double Expected =
+              Norm * ComPWA::QFT::Wigner_d(0.5 * TwiceJ, 0.5 * TwiceMuPrime,
+                                           0.5 * TwiceMu, Beta);
+          if (std::abs(Coefficients(Beta) - Expected) > 1e-13)
+            ++Mismatches;
+        }
+      }
+    }
+  }
+  BOOST_CHECK_EQUAL(Mismatches, 0);
+}
+
+BOOST_AUTO_TEST_CASE(SharedWignerDTrees) {
+  using namespace ComPWA::FunctionTree;
+  auto Angles = createAngles();
+  std::vector<double> Thetas, Phis;
+  for (auto Angle : Angles) {
+    Phis.push_back(Angle.first);
+    Thetas.push_back(Angle.second);
+  }
+  ParameterList DataSample;
+  DataSample.addValue(
+      std::make_shared<Value<std::vector<double>>>("theta", Thetas));
+  DataSample.addValue(
+      std::make_shared<Value<std::vector<double>>>("phi", Phis));
+  ParameterList PhspSample;
+  PhspSample.addValue(
+      std::make_shared<Value<std::vector<double>>>("theta", Thetas));
+  PhspSample.addValue(
+      std::make_shared<Value<std::vector<double>>>("phi", Phis));
+
+  WignerDTreeCache Cache;
+  auto Tree = Cache.wignerDTree(1.0, 1.0, -1.0, DataSample, 0, 1);
+  BOOST_CHECK_EQUAL(Cache.wignerDTree(1.0, 1.0, -1.0, DataSample, 0, 1), Tree);
+  // the phase space sample and other quantum numbers have their own trees
+  BOOST_CHECK_NE(Cache.wignerDTree(1.0, 1.0, -1.0, PhspSample, 0, 1), Tree);
+  BOOST_CHECK_NE(Cache.wignerDTree(1.0, 1.0, 0.0, DataSample, 0, 1), Tree);
+  BOOST_CHECK_NE(Cache.wignerDTree(2.0, 1.0, -1.0, DataSample, 0, 1), Tree);
+
+  // the same tree is inserted twice, Sum = (1 + 2) * WignerD
+  auto Sum = std::make_shared<FunctionTree>(
+      "Sum", MComplex("", 0), std::make_shared<AddAll>(ParType::MCOMPLEX));
+  Sum->insertTree(Tree, "Sum");
+  auto Product = std::make_shared<FunctionTree>(
+      "Product", MComplex("", 0),
+      std::make_shared<MultAll>(ParType::MCOMPLEX));
+  Product->insertTree(Tree, "Product");
+  Product->createLeaf("Factor", 2.0, "Product");
+  Sum->insertTree(Product, "Sum");
+
+  auto Values =
+      std::dynamic_pointer_cast<Value<std::vector<std::complex<double>>>>(
+          Sum->parameter())
+          ->values();
+  BOOST_REQUIRE_EQUAL(Values.size(), Angles.size());
+  std::size_t Mismatches(0);
+  for (std::size_t i = 0; i < Angles.size(); ++i) {
+    auto Expected = 3.0 * WignerD::dynamicalFunction(
+                              1.0, 1.0, -1.0, Phis[i], Thetas[i], 0.0);
+    if (std::abs(Values[i] - Expected) > 1e-13)
+      ++Mismatches;
+  }
+  BOOST_CHECK_EQUAL(Mismatches, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
@@ -0,0 +1,390 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+// Define Boost test module
+#define BOOST_TEST_MODULE Physics
+
+#include <map>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include <boost/property_tree/ptree.hpp>
+#include <boost/property_tree/xml_parser.hpp>
+#include <boost/test/unit_test.hpp>
+
+#include "Core/Logging.hpp"
+#include "Core/Properties.hpp"
+#include "Data/DataSet.hpp"
+#include "Data/Generate.hpp"
+#include "Data/Root/RootGenerator.hpp"
+#include "Physics/BuilderXML.hpp"
+#include "Physics/Compiled/HelicityExpression.hpp"
+#include "Physics/HelicityFormalism/HelicityKinematics.hpp"
+
+using namespace ComPWA;
+using namespace ComPWA::Physics::Compiled;
+using ComPWA::Physics::HelicityFormalism::HelicityKinematics;
+
+BOOST_AUTO_TEST_SUITE(CompiledIntensityTest);
+
+// Model of the DalitzFit example (Examples/DalitzFit/DalitzFitApp.cpp)
+const std::string DalitzFitModelXML = R"####(
+<Intensity Class="NormalizedIntensity" Name="jpsiGammaPiPi_norm">
+  <IntegrationStrategy Class="MCIntegrationStrategy"/>
+  <Intensity Class="CoherentIntensity" Name="jpsiGammaPiPi">
+    <Amplitude Class="CoefficientAmplitude" Name="f2(1270)">
+      <Parameter Class='Double' Type="Magnitude"  Name="Magnitude_f2">
+        <Value>1.0</Value>
+        <Min>-1.0</Min>
+        <Max>2.0</Max>
+        <Fix>false</Fix>
+      </Parameter>
+      <Parameter Class='Double' Type="Phase" Name="Phase_f2">
+        <Value>0.0</Value>
+        <Min>-100</Min>
+        <Max>100</Max>
+        <Fix>false</Fix>
+      </Parameter>
+      <Amplitude Class="NormalizedAmplitude" Name="f2(1270)_normed">
+        <IntegrationStrategy Class="MCIntegrationStrategy"/>
+        <Amplitude Class="HelicityDecay" Name="f2ToPiPi">
+          <DecayParticle Name="f2(1270)" Helicity="0"/>
+          <RecoilSystem FinalState="0" />
+          <DecayProducts>
+            <Particle Name="pi0" FinalState="1"  Helicity="0"/>
+            <Particle Name="pi0" FinalState="2"  Helicity="0"/>
+          </DecayProducts>
+        </Amplitude>
+      </Amplitude>
+    </Amplitude>
+    <Amplitude Class="CoefficientAmplitude" Name="myAmp">
+      <Parameter Class='Double' Type="Magnitude"  Name="Magnitude_my">
+        <Value>1.0</Value>
+        <Min>-1.0</Min>
+        <Max>2.0</Max>
+        <Fix>true</Fix>
+      </Parameter>
+      <Parameter Class='Double' Type="Phase" Name="Phase_my">
+        <Value>0.0</Value>
+        <Min>-100</Min>
+        <Max>100</Max>
+        <Fix>true</Fix>
+      </Parameter>
+      <Amplitude Class="NormalizedAmplitude" Name="myAmp_normed">
+        <IntegrationStrategy Class="MCIntegrationStrategy"/>
+        <Amplitude Class="HelicityDecay" Name="MyResToPiPi">
+          <DecayParticle Name="myRes" Helicity="0"/>
+          <RecoilSystem FinalState="0" />
+          <DecayProducts>
+            <Particle Name="pi0" FinalState="1"  Helicity="0"/>
+            <Particle Name="pi0" FinalState="2"  Helicity="0"/>
+          </DecayProducts>
+        </Amplitude>
+      </Amplitude>
+    </Amplitude>
+  </Intensity>
+</Intensity>
+)####";
+
+const std::string DalitzFitParticles = R"####(
+<ParticleList>
+  <Particle Name="J/psi">
+    <Pid>443</Pid>
+    <Parameter Type="Mass" Name="Mass_jpsi">
+      <Value>3.096900</Value>
+      <Fix>true</Fix>
+    </Parameter>
+    <QuantumNumber Class="Spin" Type="Spin" Value="1" />
+    <QuantumNumber Class="Int" Type="Charge" Value="0" />
+    <QuantumNumber Class="Int" Type="Parity" Value="-1" />
+    <QuantumNumber Class="Int" Type="Cparity" Value="-1" />
+  </Particle>
+  <Particle Name="pi0">
+    <Pid>111</Pid>
+    <Parameter Type="Mass" Name="Mass_neutralPion">
+      <Value>0.1349766</Value>
+      <Error>0.000006</Error>
+    </Parameter>
+    <QuantumNumber Class="Spin" Type="Spin" Value="0" />
+    <QuantumNumber Class="Int" Type="Charge" Value="0" />
+    <QuantumNumber Class="Int" Type="Parity" Value="-1" />
+    <QuantumNumber Class="Int" Type="Cparity" Value="1" />
+  </Particle>
+  <Particle Name="gamma">
+    <Pid>22</Pid>
+    <Parameter Type="Mass" Name="Mass_gamma">
+      <Value>0.0</Value>
+    </Parameter>
+    <QuantumNumber Class="Spin" Type="Spin" Value="1" />
+    <QuantumNumber Class="Int" Type="Charge" Value="0" />
+    <QuantumNumber Class="Int" Type="Parity" Value="-1" />
+    <QuantumNumber Class="Int" Type="Cparity" Value="-1" />
+  </Particle>
+  <Particle Name="f2(1270)">
+    <Pid>225</Pid>
+    <Parameter Class='Double' Type="Mass" Name="Mass_f2(1270)">
+      <Value>1.2755</Value>
+      <Error>8.0E-04</Error>
+      <Min>0.1</Min>
+      <Max>2.0</Max>
+      <Fix>false</Fix>
+    </Parameter>
+    <QuantumNumber Class="Spin" Type="Spin" Value="2"/>
+    <QuantumNumber Class="Int" Type="Charge" Value="0"/>
+    <QuantumNumber Class="Int" Type="Parity" Value="+1"/>
+    <QuantumNumber Class="Int" Type="Cparity" Value="+1"/>
+    <DecayInfo Type="relativisticBreitWigner">
+      <FormFactor Type="0" />
+      <Parameter Class='Double' Type="Width" Name="Width_f2(1270)">
+        <Value>0.1867</Value>
+      </Parameter>
+      <Parameter Class='Double' Type="MesonRadius" Name="Radius_rho">
+        <Value>2.5</Value>
+        <Fix>true</Fix>
+      </Parameter>
+    </DecayInfo>
+  </Particle>
+  <Particle Name="myRes">
+    <Pid>999999</Pid>
+    <Parameter Class='Double' Type="Mass" Name="Mass_myRes">
+      <Value>2.0</Value>
+      <Error>8.0E-04</Error>
+      <Min>1.1</Min>
+      <Max>4.0</Max>
+      <Fix>true</Fix>
+    </Parameter>
+    <QuantumNumber Class="Spin" Type="Spin" Value="1"/>
+    <QuantumNumber Class="Int" Type="Charge" Value="0"/>
+    <QuantumNumber Class="Int" Type="Parity" Value="+1"/>
+    <QuantumNumber Class="Int" Type="Cparity" Value="+1"/>
+    <DecayInfo Type="relativisticBreitWigner">
+      <FormFactor Type="0" />
+      <Parameter Class='Double' Type="Width" Name="Width_myRes">
+        <Value>1.0</Value>
+        <Min>0.1</Min>
+        <Max>1.5</Max>
+        <Fix>false</Fix>
+      </Parameter>
+      <Parameter Class='Double' Type="MesonRadius" Name="Radius_myRes">
+        <Value>2.5</Value>
+        <Fix>true</Fix>
+      </Parameter>
+    </DecayInfo>
+  </Particle>
+</ParticleList>
+)####";
+
+/// Set the parameters of \p Intens by name.
+void setParameters(ComPWA::Intensity &Intens,
+                   const std::map<std::string, double> &NewValues) {
+  std::vector<double> Values;
+  for (auto const &p : Intens.getParameters()) {
+    auto x = NewValues.find(p.Name);
+    Values.push_back(x == NewValues.end() ? p.Value : x->second);
+  }
+  Intens.updateParametersFrom(Values);
+}
+
+/// Set the parameters of \p Intens by name. FunctionTreeIntensity does not
+/// accept new values of fixed parameters, so we change them in the tree.
+void setParameters(ComPWA::FunctionTree::FunctionTreeIntensity &Intens,
+                   const std::vector<std::vector<double>> &Data,
+                   const std::map<std::string, double> &NewValues) {
+  auto Parameters = std::get<1>(Intens.bind(Data));
+  for (auto p : Parameters.doubleParameters()) {
+    auto x = NewValues.find(p->name());
+    if (x != NewValues.end())
+      p->setValue(x->second);
+  }
+}
+
+template <int TwiceJ, int TwiceMuPrime, int TwiceMu>
+void checkWignerD(const EvaluationContext &Context, std::size_t NumberOfEvents,
+                  HelicityColumns Columns) {
+  ComPWA::Physics::HelicityFormalism::WignerDCoefficients Expected(
+      TwiceJ, TwiceMuPrime, TwiceMu);
+  auto Node = wignerD<TwiceJ, TwiceMuPrime, TwiceMu>(Columns);
+  for (std::size_t i = 0; i < NumberOfEvents; ++i) {
+    auto Reference = Expected(Context.column(Columns.Phi, i),
+                              Context.column(Columns.Theta, i));
+    auto Result = Node(Context, i);
+    BOOST_CHECK_SMALL(std::abs(Result - Reference), 1e-13);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(HelicityNodes) {
+  // angles including negative theta and the boundaries of the range
+  std::vector<std::vector<double>> Data = {
+      {0.5, 1.0, 2.0, 3.5, 1.2, 0.8, 2.9},
+      {-3.0, -1.0, 0.0, 0.3, 1.5, 2.7, M_PI},
+      {0.1, -2.0, 1.0, 3.0, -0.5, 2.2, -M_PI}};
+  auto Columns = helicityColumns(0);
+  double NoParameters[1] = {0.0};
+  auto Context = createEvaluationContext(NoParameters, Data);
+  std::size_t n = Data[0].size();
+
+  // the compile time coefficients agree with the run time ones
+  checkWignerD<0, 0, 0>(Context, n, Columns);
+  checkWignerD<1, 1, -1>(Context, n, Columns);
+  checkWignerD<2, 0, 0>(Context, n, Columns);
+  checkWignerD<3, 1, -1>(Context, n, Columns);
+  checkWignerD<3, -3, 1>(Context, n, Columns);
+  checkWignerD<4, 2, 0>(Context, n, Columns);
+  checkWignerD<4, -4, 4>(Context, n, Columns);
+  checkWignerD<8, 2, -6>(Context, n, Columns);
+
+  // Flatte with precomputed channel constants against the scalar function
+  ParameterSet Pars;
+  auto Mass = Pars.add("Mass", 0.98);
+  auto Radius = Pars.add("Radius", 1.5);
+  FlatteChannel Signal{Pars.add("MassA", 0.1396), Pars.add("MassB", 0.1396),
+                       Pars.add("G", 0.3)};
+  FlatteChannel HiddenB{Pars.add("MassKp", 0.4937), Pars.add("MassKm", 0.4937),
+                        Pars.add("GB", 0.9)};
+  FlatteChannel HiddenC{Pars.add("MassEta", 0.5479),
+                        Pars.add("MassPi", 0.1350), Pars.add("GC", 0.4)};
+  std::vector<double> Values;
+  for (auto const &p : Pars.parameters())
+    Values.push_back(p.Value);
+  auto FlatteContext = createEvaluationContext(Values.data(), Data);
+
+  auto checkFlatte = [&](double CouplingC) {
+    Values[HiddenC.G.Index] = CouplingC;
+    auto TwoChannels = flatte<0>(Columns, Mass, Radius, Signal, HiddenB);
+    auto ThreeChannels = flatte<1, ComPWA::Physics::Dynamics::FormFactorType::
+                                       BlattWeisskopf>(
+        Columns, Mass, Radius, Signal, HiddenB, HiddenC);
+    TwoChannels.update(Values.data());
+    ThreeChannels.update(Values.data());
+    for (std::size_t i = 0; i < n; ++i) {
+      double mSq = Data[0][i];
+      auto Expected = ComPWA::Physics::Dynamics::Flatte::dynamicalFunction(
+          mSq, 0.98, 0.1396, 0.1396, 0.3, 0.4937, 0.4937, 0.9, 0.5479, 0.1350,
+          0.0, 0, 1.5, ComPWA::Physics::Dynamics::FormFactorType::noFormFactor);
+      auto Result = TwoChannels(FlatteContext, i);
+      BOOST_CHECK_SMALL(std::abs(Result - Expected),
+                        1e-12 * std::abs(Expected));
+      Expected = ComPWA::Physics::Dynamics::Flatte::dynamicalFunction(
+          mSq, 0.98, 0.1396, 0.1396, 0.3, 0.4937, 0.4937, 0.9, 0.5479, 0.1350,
+          CouplingC, 1, 1.5,
+          ComPWA::Physics::Dynamics::FormFactorType::BlattWeisskopf);
+      Result = ThreeChannels(FlatteContext, i);
+      BOOST_CHECK_SMALL(std::abs(Result - Expected),
+                        1e-12 * std::abs(Expected));
+    }
+  };
+  checkFlatte(0.4);
+  // a zero coupling of the third channel skips it
+  checkFlatte(0.0);
+}
+
+BOOST_AUTO_TEST_CASE(DalitzFitModel) {
+  ComPWA::Logging Log("warning");
+
+  std::stringstream ParticlesStream(DalitzFitParticles);
+  ParticleList PartL = readParticles(ParticlesStream);
+
+  HelicityKinematics Kin(PartL, {443}, {22, 111, 111});
+
+  ComPWA::Data::Root::RootGenerator Gen(
+      Kin.getParticleStateTransitionKinematicsInfo());
+  ComPWA::Data::Root::RootUniformRealGenerator RandomGenerator(173);
+  auto PhspSample(ComPWA::Data::generatePhsp(20000, Gen, RandomGenerator));
+
+  // XML model as reference
+  std::stringstream ModelStream(DalitzFitModelXML);
+  boost::property_tree::ptree ModelTree;
+  boost::property_tree::xml_parser::read_xml(ModelStream, ModelTree);
+  ComPWA::Physics::IntensityBuilderXML Builder(
+      PartL, Kin, ModelTree.get_child("Intensity"), PhspSample);
+  auto TreeIntensity = Builder.createIntensity();
+
+  // Same model as compiled expression. The SubSystem is shared by both
+  // resonances and has already been added by the builder.
+  auto Sys = helicityColumns(
+      Kin.addSubSystem(ComPWA::Physics::SubSystem({{1}, {2}}, {}, {})));
+  auto Phsp = std::make_shared<const ComPWA::Data::DataSet>(
+      ComPWA::Data::convertEventsToDataSet(PhspSample, Kin));
+
+  ParameterSet Pars;
+  auto MassPi0 = Pars.add("Mass_neutralPion", 0.1349766);
+  auto F2 = wignerD<4, 0, 0>(Sys) *
+            relativisticBreitWigner<2>(Sys, Pars.add("Mass_f2(1270)", 1.2755),
+                                       Pars.add("Width_f2(1270)", 0.1867),
+                                       Pars.add("Radius_rho", 2.5), MassPi0,
+                                       MassPi0);
+  auto MyRes = wignerD<2, 0, 0>(Sys) *
+               relativisticBreitWigner<1>(Sys, Pars.add("Mass_myRes", 2.0),
+                                          Pars.add("Width_myRes", 1.0),
+                                          Pars.add("Radius_myRes", 2.5),
+                                          MassPi0, MassPi0);
+  auto Amplitude = coefficient(Pars.add("Magnitude_f2", 1.0),
+                               Pars.add("Phase_f2", 0.0)) *
+                       normalized(F2, Phsp) +
+                   coefficient(Pars.add("Magnitude_my", 1.0),
+                               Pars.add("Phase_my", 0.0)) *
+                       normalized(MyRes, Phsp);
+  auto CompiledIntens =
+      makeIntensity(normalized(absSquare(Amplitude), Phsp), Pars);
+
+  // evaluate on a statistically independent sample
+  auto Sample = ComPWA::Data::convertEventsToDataSet(
+      ComPWA::Data::generatePhsp(1000, Gen, RandomGenerator), Kin);
+
+  auto Check = [&]() {
+    auto Expected = TreeIntensity.evaluate(Sample.Data);
+    auto Result = CompiledIntens.evaluate(Sample.Data);
+    BOOST_REQUIRE_EQUAL(Result.size(), Expected.size());
+    for (std::size_t i = 0; i < Result.size(); ++i)
+      BOOST_CHECK_CLOSE(Result[i], Expected[i], 1e-9);
+  };
+  Check();
+
+  // change the free parameters of the model
+  std::map<std::string, double> NewValues = {{"Magnitude_f2", 0.7},
+                                             {"Phase_f2", 1.3},
+                                             {"Mass_f2(1270)", 1.3},
+                                             {"Width_myRes", 0.6}};
+  setParameters(TreeIntensity, Sample.Data, NewValues);
+  setParameters(CompiledIntens, NewValues);
+  Check();
+
+  for (auto const &p : CompiledIntens.getParameters()) {
+    if (NewValues.count(p.Name))
+      BOOST_CHECK_EQUAL(p.Value, NewValues[p.Name]);
+  }
+
+  // evaluate directly on columns that are not owned by vectors, e.g. the
+  // columns of a memory mapped file
+  std::vector<const double *> Columns;
+  for (const auto &Column : Sample.Data)
+    Columns.push_back(Column.data());
+  BOOST_CHECK(CompiledIntens.evaluate(Columns, Sample.Weights.size()) ==
+              CompiledIntens.evaluate(Sample.Data));
+
+  // a DataSet with only the variables that the model reads has empty
+  // columns for all others, here for those of a second SubSystem
+  Kin.addSubSystem(ComPWA::Physics::SubSystem({{0}, {1}}, {}, {}));
+  auto Sparse = ComPWA::Data::convertEventsToDataSet(
+      ComPWA::Data::generatePhsp(1000, Gen, RandomGenerator), Kin,
+      TreeIntensity.getUsedDataVariableNames());
+  std::size_t NumberOfEmptyColumns(0);
+  std::vector<const double *> SparseColumns;
+  for (const auto &Column : Sparse.Data) {
+    NumberOfEmptyColumns += Column.empty();
+    SparseColumns.push_back(Column.empty() ? nullptr : Column.data());
+  }
+  BOOST_REQUIRE(NumberOfEmptyColumns > 0);
+  auto SparseResult = CompiledIntens.evaluate(Sparse.Data);
+  BOOST_REQUIRE_EQUAL(SparseResult.size(), Sparse.Weights.size());
+  BOOST_CHECK(CompiledIntens.evaluate(SparseColumns, Sparse.Weights.size()) ==
+              SparseResult);
+  auto Expected = TreeIntensity.evaluate(Sparse.Data);
+  for (std::size_t i = 0; i < SparseResult.size(); ++i)
+    BOOST_CHECK_CLOSE(SparseResult[i], Expected[i], 1e-9);
+}
+
+BOOST_AUTO_TEST_SUITE_END();
@@ -0,0 +1,585 @@
+// Copyright (c) 2019 The ComPWA Team.
+// This file is part of the ComPWA framework, check
+// https://github.com/ComPWA/ComPWA/license.txt for details.
+
+#define BOOST_TEST_MODULE DynamicsTest
+
+#include <cmath>
+#include <complex>
+#include <vector>
+
+#include <boost/test/unit_test.hpp>
+
+#include "Core/FunctionTree/FunctionTree.hpp"
+#include "Physics/Dynamics/Flatte.hpp"
+#include "Physics/Dynamics/KMatrix.hpp"
+#include "Physics/Dynamics/RelativisticBreitWigner.hpp"
+#include "Physics/Dynamics/TabulatedDynamics.hpp"
+#include "Physics/Dynamics/Utils/Faddeeva.hh"
+#include "Physics/Dynamics/Utils/FastFaddeeva.hpp"
+#include "Physics/Dynamics/Voigtian.hpp"
+
+using namespace ComPWA::Physics::Dynamics;
+
+BOOST_AUTO_TEST_SUITE(Dynamics)
+
+/// Invariant masses squared below, at and above the threshold of two pions.
+std::vector<double> createMassSqValues() {
+  std::vector<double> mSq;
+  for (double x = 0.01; x < 4.0; x += 0.0137)
+    mSq.push_back(x);
+  mSq.push_back((0.13957 + 0.13957) * (0.13957 + 0.13957));
+  return mSq;
+}
+
+BOOST_AUTO_TEST_CASE(BatchedPhspFactor) {
+  // sqrt(s) = 0, below and above threshold, at the threshold and the
+  // pseudo-threshold |ma - mb|
+  std::vector<double> SqrtS{0.0};
+  for (auto x : createMassSqValues())
+    SqrtS.push_back(std::sqrt(x));
+  SqrtS.push_back(0.547862 + 0.13957);
+  SqrtS.push_back(0.547862 - 0.13957);
+
+  std::size_t Mismatches(0);
+  std::vector<std::complex<double>> Phsp(SqrtS.size());
+  std::vector<std::complex<double>> Q(SqrtS.size());
+  for (auto Masses : {std::make_pair(0.13957, 0.13957),
+                      std::make_pair(0.547862, 0.13957),
+                      std::make_pair(0.493677, 0.497611)}) {
+    double ma = Masses.first;
+    double mb = Masses.second;
+    // skip sqrt(s) = 0, for which the result is not finite
+    phspFactor(SqrtS.size() - 1, SqrtS.data() + 1, ma, mb, Phsp.data() + 1);
+    qValue(SqrtS.size() - 1, SqrtS.data() + 1, ma, mb, Q.data() + 1);
+    for (std::size_t i = 1; i < SqrtS.size(); ++i) {
+      auto Reference = phspFactor(SqrtS[i], ma, mb);
+      Mismatches += std::abs(Phsp[i] - Reference) > 1e-14 * std::abs(Reference);
+      auto QReference = qValue(SqrtS[i], ma, mb);
+      Mismatches += std::abs(Q[i] - QReference) > 1e-14 * std::abs(QReference);
+    }
+    phspFactor(1, SqrtS.data(), ma, mb, Phsp.data());
+    BOOST_CHECK(!std::isfinite(Phsp[0].real()) ||
+                !std::isfinite(Phsp[0].imag()));
+  }
+  BOOST_CHECK_EQUAL(Mismatches, 0);
+}
+
+BOOST_AUTO_TEST_CASE(BatchedFormFactor) {
+  std::vector<double> SqrtS;
+  for (auto x : createMassSqValues())
+    SqrtS.push_back(std::sqrt(x));
+  double ma = 0.13957;
+  double mb = 0.547862;
+
+  std::size_t Mismatches(0);
+  std::vector<double> Values(SqrtS.size());
+  auto compare = [&](unsigned int L, double Radius, FormFactorType Type) {
+    FormFactor(SqrtS.size(), SqrtS.data(), ma, mb, L, Radius, Type,
+               Values.data());
+    for (std::size_t i = 0; i < SqrtS.size(); ++i) {
+      double Reference = FormFactor(SqrtS[i], ma, mb, L, Radius, Type);
+      Mismatches += std::abs(Values[i] - Reference) > 1e-13 * Reference;
+    }
+  };
+  for (unsigned int L = 0; L <= 4; ++L) {
+    compare(L, 1.5, FormFactorType::BlattWeisskopf);
+    compare(L, 0.0, FormFactorType::BlattWeisskopf);
+    compare(L, 1.5, FormFactorType::noFormFactor);
+  }
+  compare(0, 2.0, FormFactorType::CrystalBarrel);
+  BOOST_CHECK_EQUAL(Mismatches, 0);
+
+  // unsupported types give NaN instead of an exception
+  FormFactor(SqrtS.size(), SqrtS.data(), ma, mb, 1, 2.0,
+             FormFactorType::CrystalBarrel, Values.data());
+  BOOST_CHECK(std::isnan(Values.front()));
+}
+
+BOOST_AUTO_TEST_CASE(RelativisticBreitWignerParameterBlock) {
+  auto mSq = createMassSqValues();
+  // the parameters are read at runtime, since the compiler may otherwise
+  // fold the reference with constant parameters differently than the block
+  volatile double Parameters[] = {0.775, 0.13957, 0.149, 1.5,
+                                  0.98,  0.547,   0.07,  2.0};
+  double mR = Parameters[0], m = Parameters[1], Width = Parameters[2],
+         Radius = Parameters[3];
+  std::vector<FormFactorType> Types{FormFactorType::noFormFactor,
+                                    FormFactorType::BlattWeisskopf};
+  std::size_t Mismatches(0);
+  for (auto Type : Types) {
+    for (unsigned int L = 0; L <= 4; ++L) {
+      auto Block = RelativisticBreitWigner::createParameterBlock(
+          mR, m, m, Width, L, Radius, Type);
+      for (auto x : mSq) {
+        auto Reference = RelativisticBreitWigner::dynamicalFunction(
+            x, mR, m, m, Width, L, Radius, Type);
+        auto Value = RelativisticBreitWigner::dynamicalFunction(x, Block);
+        Mismatches += Value.real() != Reference.real() ||
+                      Value.imag() != Reference.imag();
+      }
+    }
+  }
+  // different daughter masses and the CrystalBarrel form factor
+  mR = Parameters[4];
+  double mb = Parameters[5];
+  Width = Parameters[6];
+  Radius = Parameters[7];
+  auto Block = RelativisticBreitWigner::createParameterBlock(
+      mR, m, mb, Width, 0, Radius, FormFactorType::CrystalBarrel);
+  for (auto x : mSq) {
+    auto Reference = RelativisticBreitWigner::dynamicalFunction(
+        x, mR, m, mb, Width, 0, Radius, FormFactorType::CrystalBarrel);
+    auto Value = RelativisticBreitWigner::dynamicalFunction(x, Block);
+    Mismatches +=
+        Value.real() != Reference.real() || Value.imag() != Reference.imag();
+  }
+  BOOST_CHECK_EQUAL(Mismatches, 0);
+}
+
+BOOST_AUTO_TEST_CASE(BatchedBreitWigner) {
+  auto mSq = createMassSqValues();
+  std::vector<std::complex<double>> Phsp;
+  std::vector<std::complex<double>> Values(mSq.size());
+  std::vector<double> ff(mSq.size());
+  std::size_t Mismatches(0);
+  std::size_t Zeros(0);
+  for (auto Type : {FormFactorType::BlattWeisskopf,
+                    FormFactorType::CrystalBarrel}) {
+    for (unsigned int L = 0; L <= 4; ++L) {
+      if (Type == FormFactorType::CrystalBarrel && L > 0)
+        continue;
+      // the event at the threshold of two pions gives zero (odd L)
+      double mb = L % 2 ? 0.13957 : 0.547862;
+      auto Block = RelativisticBreitWigner::createParameterBlock(
+          1.275, 0.13957, mb, 0.185, L, 1.5, Type);
+      Phsp.clear();
+      for (std::size_t i = 0; i < mSq.size(); ++i) {
+        double sqrtS = std::sqrt(mSq[i]);
+        Phsp.push_back(phspFactor(sqrtS, 0.13957, mb));
+        ff[i] = FormFactor(Phsp[i] * 8.0 * M_PI * sqrtS, L, 1.5, Type);
+      }
+      RelativisticBreitWigner::dynamicalFunction(
+          mSq.size(), mSq.data(), Phsp.data(), ff.data(), Block, Values.data());
+      for (std::size_t i = 0; i < mSq.size(); ++i) {
+        auto Reference = RelativisticBreitWigner::dynamicalFunction(
+            mSq[i], Phsp[i], ff[i], Block);
+        Zeros += Reference == std::complex<double>(0, 0);
+        Mismatches +=
+            std::abs(Values[i] - Reference) > 1e-12 * std::abs(Reference);
+      }
+    }
+  }
+  BOOST_CHECK_EQUAL(Zeros, 2);
+  BOOST_CHECK_EQUAL(Mismatches, 0);
+}
+
+BOOST_AUTO_TEST_CASE(BreitWignerStrategy) {
+  using namespace ComPWA::FunctionTree;
+  auto mSq = createMassSqValues();
+  ParameterList DataSample;
+  DataSample.addValue(
+      std::make_shared<Value<std::vector<double>>>("mSq", mSq));
+
+  RelativisticBreitWigner::InputInfo Params;
+  Params.L = 2;
+  Params.Mass = std::make_shared<FitParameter>("Mass", 1.275);
+  Params.Width = std::make_shared<FitParameter>("Width", 0.185);
+  Params.MesonRadius = std::make_shared<FitParameter>("MesonRadius", 1.5);
+  Params.FFType = FormFactorType::BlattWeisskopf;
+  Params.DaughterMasses =
+      std::make_pair(std::make_shared<FitParameter>("MassA", 0.13957),
+                     std::make_shared<FitParameter>("MassB", 0.13957));
+  auto Tree =
+      RelativisticBreitWigner::createFunctionTree(Params, DataSample, 0, "");
+  auto Values =
+      std::dynamic_pointer_cast<Value<std::vector<std::complex<double>>>>(
+          Tree->parameter())
+          ->values();
+  BOOST_REQUIRE_EQUAL(Values.size(), mSq.size());
+  std::size_t Mismatches(0);
+  for (std::size_t i = 0; i < mSq.size(); ++i) {
+    auto Reference = RelativisticBreitWigner::dynamicalFunction(
+        mSq[i], 1.275, 0.13957, 0.13957, 0.185, 2, 1.5,
+        FormFactorType::BlattWeisskopf);
+    Mismatches += std::abs(Values[i] - Reference) > 1e-12 * std::abs(Reference);
+  }
+  BOOST_CHECK_EQUAL(Mismatches, 0);
+}
+
+BOOST_AUTO_TEST_CASE(UnsupportedFormFactorType) {
+  using namespace ComPWA::FunctionTree;
+  ParameterList DataSample;
+  DataSample.addValue(std::make_shared<Value<std::vector<double>>>(
+      "mSq", createMassSqValues()));
+
+  RelativisticBreitWigner::InputInfo Params;
+  Params.L = 1;
+  Params.Mass = std::make_shared<FitParameter>("Mass", 0.98);
+  Params.Width = std::make_shared<FitParameter>("Width", 0.07);
+  Params.MesonRadius = std::make_shared<FitParameter>("MesonRadius", 1.5);
+  Params.FFType = FormFactorType::CrystalBarrel;
+  Params.DaughterMasses =
+      std::make_pair(std::make_shared<FitParameter>("MassA", 0.13957),
+                     std::make_shared<FitParameter>("MassB", 0.547));
+  // the tree is rejected at construction instead of during the evaluation
+  BOOST_CHECK_THROW(
+      RelativisticBreitWigner::createFunctionTree(Params, DataSample, 0, ""),
+      ComPWA::BadParameter);
+  Params.FFType = FormFactorType::BlattWeisskopf;
+  Params.L = 5;
+  BOOST_CHECK_THROW(
+      RelativisticBreitWigner::createFunctionTree(Params, DataSample, 0, ""),
+      ComPWA::BadParameter);
+  Params.L = 4;
+  BOOST_CHECK_NO_THROW(
+      RelativisticBreitWigner::createFunctionTree(Params, DataSample, 0, ""));
+}
+
+BOOST_AUTO_TEST_CASE(SharedFactorTrees) {
+  using namespace ComPWA::FunctionTree;
+  auto mSq = createMassSqValues();
+  ParameterList DataSample;
+  DataSample.addValue(
+      std::make_shared<Value<std::vector<double>>>("mSq", mSq));
+  ParameterList PhspSample;
+  PhspSample.addValue(
+      std::make_shared<Value<std::vector<double>>>("mSq", mSq));
+
+  // two resonances of the same subsystem and decay channel
+  RelativisticBreitWigner::InputInfo Rho;
+  Rho.L = 1;
+  Rho.Mass = std::make_shared<FitParameter>("MassRho", 0.775);
+  Rho.Width = std::make_shared<FitParameter>("WidthRho", 0.149);
+  Rho.MesonRadius = std::make_shared<FitParameter>("MesonRadius", 1.5);
+  Rho.FFType = FormFactorType::BlattWeisskopf;
+  Rho.DaughterMasses =
+      std::make_pair(std::make_shared<FitParameter>("MassA", 0.13957),
+                     std::make_shared<FitParameter>("MassB", 0.13957));
+  auto RhoPrime = Rho;
+  RhoPrime.Mass = std::make_shared<FitParameter>("MassRhoPrime", 1.465);
+  RhoPrime.Width = std::make_shared<FitParameter>("WidthRhoPrime", 0.4);
+
+  FactorTreeCache Cache;
+  auto RhoTree = RelativisticBreitWigner::createFunctionTree(Rho, DataSample,
+                                                             0, "", Cache);
+  auto RhoPrimeTree = RelativisticBreitWigner::createFunctionTree(
+      RhoPrime, DataSample, 0, "", Cache);
+
+  auto Barrier =
+      Cache.barrierFactorTree(Rho.DaughterMasses.first,
+                              Rho.DaughterMasses.second, Rho.MesonRadius,
+                              Rho.L, Rho.FFType, DataSample, 0);
+  BOOST_CHECK_EQUAL(RhoTree->Head->childNodes().back(), Barrier->Head);
+  BOOST_CHECK_EQUAL(RhoPrimeTree->Head->childNodes().back(), Barrier->Head);
+  BOOST_CHECK_EQUAL(
+      Barrier->Head->childNodes().back(),
+      Cache.phspFactorTree(Rho.DaughterMasses.first, Rho.DaughterMasses.second,
+                           DataSample, 0)
+          ->Head);
+  // the phase space sample and other quantum numbers have their own trees
+  BOOST_CHECK_NE(Cache.barrierFactorTree(
+                     Rho.DaughterMasses.first, Rho.DaughterMasses.second,
+                     Rho.MesonRadius, Rho.L, Rho.FFType, PhspSample, 0),
+                 Barrier);
+  BOOST_CHECK_NE(Cache.barrierFactorTree(
+                     Rho.DaughterMasses.first, Rho.DaughterMasses.second,
+                     Rho.MesonRadius, 2, Rho.FFType, DataSample, 0),
+                 Barrier);
+
+  std::size_t Mismatches(0);
+  for (const auto &Info : {Rho, RhoPrime}) {
+    auto Tree = RelativisticBreitWigner::createFunctionTree(Info, DataSample,
+                                                            0, "", Cache);
+    auto Values =
+        std::dynamic_pointer_cast<Value<std::vector<std::complex<double>>>>(
+            Tree->parameter())
+            ->values();
+    BOOST_REQUIRE_EQUAL(Values.size(), mSq.size());
+    for (std::size_t i = 0; i < mSq.size(); ++i) {
+      auto Reference = RelativisticBreitWigner::dynamicalFunction(
+          mSq[i], Info.Mass->value(), 0.13957, 0.13957, Info.Width->value(),
+          1, 1.5, FormFactorType::BlattWeisskopf);
+      Mismatches +=
+          std::abs(Values[i] - Reference) > 1e-12 * std::abs(Reference);
+    }
+  }
+  BOOST_CHECK_EQUAL(Mismatches, 0);
+
+  // a changed mass of a daughter is propagated to both resonances
+  Rho.DaughterMasses.second->fixParameter(false);
+  Rho.DaughterMasses.second->setValue(0.1349768);
+  auto Values =
+      std::dynamic_pointer_cast<Value<std::vector<std::complex<double>>>>(
+          RhoPrimeTree->parameter())
+          ->values();
+  for (std::size_t i = 0; i < mSq.size(); ++i) {
+    auto Reference = RelativisticBreitWigner::dynamicalFunction(
+        mSq[i], 1.465, 0.13957, 0.1349768, 0.4, 1, 1.5,
+        FormFactorType::BlattWeisskopf);
+    Mismatches += std::abs(Values[i] - Reference) > 1e-12 * std::abs(Reference);
+  }
+  BOOST_CHECK_EQUAL(Mismatches, 0);
+}
+
+BOOST_AUTO_TEST_CASE(FlatteStrategy) {
+  using namespace ComPWA::FunctionTree;
+  auto mSq = createMassSqValues();
+  ParameterList DataSample;
+  DataSample.addValue(
+      std::make_shared<Value<std::vector<double>>>("mSq", mSq));
+
+  // a0(980) decaying to eta pi, with K K and eta' pi as hidden channels
+  Flatte::InputInfo Params;
+  Params.L = 0;
+  Params.Mass = std::make_shared<FitParameter>("Mass", 0.99);
+  Params.MesonRadius = std::make_shared<FitParameter>("MesonRadius", 1.5);
+  Params.DaughterMasses =
+      std::make_pair(std::make_shared<FitParameter>("MassEta", 0.547862),
+                     std::make_shared<FitParameter>("MassPi", 0.13957));
+  Params.G = std::make_shared<FitParameter>("G", 0.324);
+  Params.HiddenCouplings.push_back(Coupling(0.4, 0.493677, 0.497611));
+
+  std::size_t Mismatches(0);
+  for (unsigned int NumberOfHidden = 1; NumberOfHidden <= 2;
+       ++NumberOfHidden) {
+    if (NumberOfHidden == 2)
+      Params.HiddenCouplings.push_back(Coupling(0.2, 0.95778, 0.13957));
+    for (auto Type : {FormFactorType::noFormFactor,
+                      FormFactorType::BlattWeisskopf,
+                      FormFactorType::CrystalBarrel}) {
+      Params.FFType = Type;
+      FactorTreeCache Cache;
+      auto Trees = {Flatte::createFunctionTree(Params, DataSample, 0, ""),
+                    Flatte::createFunctionTree(Params, DataSample, 0, "",
+                                               Cache)};
+      for (auto Tree : Trees) {
+        auto Values =
+            std::dynamic_pointer_cast<Value<std::vector<std::complex<double>>>>(
+                Tree->parameter())
+                ->values();
+        BOOST_REQUIRE_EQUAL(Values.size(), mSq.size());
+        for (std::size_t i = 0; i < mSq.size(); ++i) {
+          auto Hidden = Params.HiddenCouplings;
+          if (Hidden.size() == 1)
+            Hidden.push_back(Coupling(0.0, 0.0, 0.0));
+          auto Reference = Flatte::dynamicalFunction(
+              mSq[i], 0.99, 0.547862, 0.13957, 0.324, Hidden[0].MassA->value(),
+              Hidden[0].MassB->value(), Hidden[0].G->value(),
+              Hidden[1].MassA->value(), Hidden[1].MassB->value(),
+              Hidden[1].G->value(), 0, 1.5, Type);
+          Mismatches += std::abs(Values[i] - Reference) >
+                        1e-12 * std::abs(Reference);
+        }
+      }
+    }
+  }
+  BOOST_CHECK_EQUAL(Mismatches, 0);
+}
+
+BOOST_AUTO_TEST_CASE(FastFaddeeva) {
+  // logarithmic grid in the upper half plane, which contains both regions of
+  // FaddeevaFunction and their boundary
+  std::vector<double> x, y;
+  for (double LogX = -4.0; LogX <= 4.0; LogX += 0.0125) {
+    x.push_back(std::pow(10.0, LogX));
+    x.push_back(-std::pow(10.0, LogX));
+  }
+  x.push_back(0.0);
+  for (double LogY = -6.0; LogY <= 3.0; LogY += 0.1)
+    y.push_back(std::pow(10.0, LogY));
+  y.push_back(0.0);
+
+  for (double Accuracy : {1e-6, 1e-9, 1e-12, 1e-13, 1e-15}) {
+    FaddeevaFunction W(Accuracy);
+    double MaxError(0.0);
+    std::vector<std::complex<double>> Values(x.size());
+    for (auto Im : y) {
+      W.evaluate(x.size(), x.data(), Im, Values.data());
+      for (std::size_t i = 0; i < x.size(); ++i) {
+        auto Reference = Faddeeva::w(std::complex<double>(x[i], Im), 1e-15);
+        MaxError =
+            std::max(MaxError, std::abs(Values[i] - Reference) /
+                                   std::abs(Reference));
+      }
+    }
+    BOOST_CHECK_LE(MaxError, Accuracy);
+    BOOST_CHECK_EQUAL(W(std::complex<double>(0.3, 0.7)),
+                      [&]() {
+                        double Re(0.3);
+                        std::complex<double> Value;
+                        W.evaluate(1, &Re, 0.7, &Value);
+                        return Value;
+                      }());
+  }
+  BOOST_CHECK_EQUAL(FaddeevaFunction(1e-15).numberOfTerms(), 0);
+  BOOST_CHECK_EQUAL(FaddeevaFunction(1e-13).numberOfTerms(), 40);
+  // the lower half plane is passed on to Faddeeva::w()
+  BOOST_CHECK_EQUAL(FaddeevaFunction(1e-6)(std::complex<double>(1.0, -0.5)),
+                    Faddeeva::w(std::complex<double>(1.0, -0.5), 1e-6));
+}
+
+BOOST_AUTO_TEST_CASE(VoigtianStrategy) {
+  using namespace ComPWA::FunctionTree;
+  std::vector<double> mSq;
+  for (double x = 2.9; x < 3.3; x += 0.0001)
+    mSq.push_back(x * x);
+  ParameterList DataSample;
+  DataSample.addValue(
+      std::make_shared<Value<std::vector<double>>>("mSq", mSq));
+
+  // J/psi with a resolution of 3 MeV and a wider state
+  for (double Width : {0.0000929, 0.02}) {
+    Voigtian::InputInfo Params;
+    Params.L = 0;
+    Params.FFType = FormFactorType::noFormFactor;
+    Params.Mass = std::make_shared<FitParameter>("Mass", 3.0969);
+    Params.Width = std::make_shared<FitParameter>("Width", Width);
+    Params.Sigma = 0.003;
+    auto Tree = Voigtian::createFunctionTree(Params, DataSample, 0, "");
+    auto Values =
+        std::dynamic_pointer_cast<Value<std::vector<std::complex<double>>>>(
+            Tree->parameter())
+            ->values();
+    BOOST_REQUIRE_EQUAL(Values.size(), mSq.size());
+    // the peak value is used as scale, since the tails of the Voigtian are
+    // the differences of the much larger Im(w)
+    double Peak = std::abs(
+        Voigtian::dynamicalFunction(3.0969 * 3.0969, 3.0969, Width, 0.003));
+    double MaxError(0.0);
+    for (std::size_t i = 0; i < mSq.size(); ++i) {
+      auto Reference =
+          Voigtian::dynamicalFunction(mSq[i], 3.0969, Width, 0.003);
+      MaxError = std::max(MaxError, std::abs(Values[i] - Reference) / Peak);
+    }
+    BOOST_CHECK_LE(MaxError, 1e-12);
+  }
+}
+
+BOOST_AUTO_TEST_CASE(TabulatedDynamicsStrategy) {
+  using namespace ComPWA::FunctionTree;
+  std::vector<double> mSq;
+  for (double x = 2.9; x < 3.3; x += 0.0001)
+    mSq.push_back(x * x);
+  // events outside of the table
+  mSq.push_back(2.8 * 2.8);
+  mSq.push_back(3.4 * 3.4);
+  ParameterList DataSample;
+  DataSample.addValue(
+      std::make_shared<Value<std::vector<double>>>("mSq", mSq));
+
+  Voigtian::InputInfo Params;
+  Params.L = 0;
+  Params.FFType = FormFactorType::noFormFactor;
+  Params.Mass = std::make_shared<FitParameter>("Mass", 3.0969);
+  Params.Width = std::make_shared<FitParameter>("Width", 0.02);
+  Params.Sigma = 0.003;
+  auto Tree = Voigtian::createFunctionTree(Params, DataSample, 0, "");
+  TabulatedDynamics::tabulate(*Tree, std::make_pair(2.9 * 2.9, 3.3 * 3.3),
+                              1e-8);
+  auto Strategy =
+      std::dynamic_pointer_cast<ComPWA::Physics::Dynamics::
+                                    TabulatedDynamicsStrategy>(
+          Tree->Head->strategy());
+  BOOST_REQUIRE(Strategy);
+
+  // the table is recalculated if a parameter changes
+  Params.Mass->fixParameter(false);
+  for (double Mass : {3.0969, 3.2}) {
+    Params.Mass->setValue(Mass);
+    auto Values =
+        std::dynamic_pointer_cast<Value<std::vector<std::complex<double>>>>(
+            Tree->parameter())
+            ->values();
+    BOOST_REQUIRE_EQUAL(Values.size(), mSq.size());
+    BOOST_CHECK_LT(Strategy->numberOfGridPoints(), mSq.size() / 2);
+    double Peak =
+        std::abs(Voigtian::dynamicalFunction(Mass * Mass, Mass, 0.02, 0.003));
+    double MaxError(0.0);
+    for (std::size_t i = 0; i < mSq.size(); ++i) {
+      auto Reference = Voigtian::dynamicalFunction(mSq[i], Mass, 0.02, 0.003);
+      MaxError = std::max(MaxError, std::abs(Values[i] - Reference) / Peak);
+    }
+    BOOST_CHECK_LE(MaxError, 1e-8);
+  }
+}
+
+/// K-matrix with the channels pi pi, K K and eta eta, two poles and a
+/// background term.
+KMatrix::InputInfo createKMatrixInfo(unsigned int NumberOfChannels) {
+  using ComPWA::FunctionTree::FitParameter;
+  std::vector<double> Masses{0.13957, 0.493677, 0.547862, 0.27914,
+                             0.957780};
+  std::vector<std::vector<double>> Couplings{{0.5, 0.9, 0.3, -0.4, 0.2},
+                                             {0.8, -0.2, 0.6, 0.7, -0.5}};
+  KMatrix::InputInfo Params;
+  for (unsigned int a = 0; a < NumberOfChannels; ++a) {
+    auto Mass = std::make_shared<FitParameter>("Mass" + std::to_string(a),
+                                               Masses[a]);
+    Params.Channels.push_back(std::make_pair(Mass, Mass));
+  }
+  std::vector<double> PoleMasses{0.98, 1.5};
+  for (unsigned int p = 0; p < 2; ++p) {
+    KMatrix::Pole Pole;
+    std::string Name = "Pole" + std::to_string(p);
+    Pole.Mass = std::make_shared<FitParameter>(Name + "Mass", PoleMasses[p]);
+    for (unsigned int a = 0; a < NumberOfChannels; ++a)
+      Pole.Couplings.push_back(std::make_shared<FitParameter>(
+          Name + "Coupling" + std::to_string(a), Couplings[p][a]));
+    Pole.Magnitude = std::make_shared<FitParameter>(Name + "Magnitude", 1.0);
+    Pole.Phase = std::make_shared<FitParameter>(Name + "Phase", 0.7 * p);
+    Params.Poles.push_back(Pole);
+  }
+  Params.Background.push_back(KMatrix::BackgroundTerm{
+      0, NumberOfChannels - 1, std::make_shared<FitParameter>("f", 0.4)});
+  return Params;
+}
+
+BOOST_AUTO_TEST_CASE(KMatrixStrategy) {
+  using namespace ComPWA::FunctionTree;
+  auto mSq = createMassSqValues();
+  ParameterList DataSample;
+  DataSample.addValue(
+      std::make_shared<Value<std::vector<double>>>("mSq", mSq));
+
+  // a single pole in a single channel is a Breit-Wigner
+  auto Params = createKMatrixInfo(1);
+  Params.Poles.pop_back();
+  Params.Background.clear();
+  double mR = 0.98;
+  double g = 0.5;
+  std::size_t Mismatches(0);
+  std::complex<double> i(0, 1);
+  for (auto x : mSq) {
+    double RhoSq = 1.0 - 4.0 * 0.13957 * 0.13957 / x;
+    std::complex<double> Rho =
+        RhoSq > 0.0 ? std::sqrt(RhoSq) : i * std::sqrt(-RhoSq);
+    auto Reference = g / (mR * mR - x - i * g * g * Rho);
+    if (std::abs(KMatrix::dynamicalFunction(x, Params) - Reference) >
+        1e-12 * std::abs(Reference))
+      ++Mismatches;
+  }
+  BOOST_CHECK_EQUAL(Mismatches, 0);
+
+  for (unsigned int NumberOfChannels = 1;
+       NumberOfChannels <= KMatrix::MaxChannels; ++NumberOfChannels) {
+    for (unsigned int Channel = 0; Channel < NumberOfChannels; ++Channel) {
+      Params = createKMatrixInfo(NumberOfChannels);
+      Params.Channel = Channel;
+      auto Tree = KMatrix::createFunctionTree(Params, DataSample, 0, "");
+      auto Values =
+          std::dynamic_pointer_cast<Value<std::vector<std::complex<double>>>>(
+              Tree->parameter())
+              ->values();
+      BOOST_REQUIRE_EQUAL(Values.size(), mSq.size());
+      for (std::size_t i = 0; i < mSq.size(); ++i) {
+        auto Reference = KMatrix::dynamicalFunction(mSq[i], Params);
+        if (std::abs(Values[i] - Reference) > 1e-12 * std::abs(Reference))
+          ++Mismatches;
+      }
+    }
+  }
+  BOOST_CHECK_EQUAL(Mismatches, 0);
+}
+
+BOOST_AUTO_TEST_SUITE_END()
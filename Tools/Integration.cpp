@@ -5,10 +5,13 @@
 #include "Integration.hpp"
 
 #include "Core/Logging.hpp"
+#include "Data/ChunkedDataSet.hpp"
 #include "Data/DataSet.hpp"
+#include "Data/DataSetView.hpp"
 
 #include <algorithm>
 #include <cmath>
+#include <numeric>
 #include <vector>
 
 #include "ThirdParty/parallelstl/include/pstl/algorithm"
@@ -35,38 +38,143 @@ KahanSummation KahanSum(KahanSummation accumulation, double value) {
   return result;
 }
 
-std::pair<double, double> integrateWithError(
-    ComPWA::Function<std::vector<double>, std::vector<std::vector<double>>>
-        &intensity,
-    const ComPWA::Data::DataSet &phspsample, double phspVolume) {
+/// Running sums of the weighted intensities \f$x_i = w_i f_i\f$ over several
+/// chunks of a sample. The squared residuals are accumulated relative to the
+/// mean of each chunk and combined pairwise (Chan et al.), which is as stable
+/// as the two-pass calculation on the complete sample.
+struct IntegrationSums {
+  KahanSummation WeightSum{0., 0.};
+  KahanSummation IntensitySum{0., 0.};
+  double NumberOfEvents = 0.0;
+  double Mean = 0.0;
+  double ResidualsSqSum = 0.0;
+
+  void add(std::vector<double> &WeightedIntensities,
+           const std::vector<double> &Weights) {
+    if (WeightedIntensities.empty())
+      return;
+    WeightSum =
+        std::accumulate(Weights.begin(), Weights.end(), WeightSum, KahanSum);
+    KahanSummation ChunkSum =
+        std::accumulate(WeightedIntensities.begin(), WeightedIntensities.end(),
+                        KahanSummation{0., 0.}, KahanSum);
+    IntensitySum = KahanSum(IntensitySum, ChunkSum);
+
+    double ChunkSize = WeightedIntensities.size();
+    double ChunkMean = ChunkSum / ChunkSize;
+    // We reuse the intensities vector to store residuals of intensities
+    std::transform(pstl::execution::par_unseq, WeightedIntensities.begin(),
+                   WeightedIntensities.end(), WeightedIntensities.begin(),
+                   [&ChunkMean](double x) {
+                     return (x - ChunkMean) * (x - ChunkMean);
+                   });
+    double ChunkResidualsSqSum = std::accumulate(
+        WeightedIntensities.begin(), WeightedIntensities.end(),
+        KahanSummation{0., 0.}, KahanSum);
+
+    combine(ChunkSize, ChunkMean, ChunkResidualsSqSum);
+  }
+
+  /// Same as above, but each entry is counted \p Multiplicities times, e.g.
+  /// the entries of a Data::DataSetView with their replica weights.
+  void add(const std::vector<double> &WeightedIntensities,
+           const std::vector<double> &Weights,
+           const std::vector<double> &Multiplicities) {
+    KahanSummation ChunkWeightSum{0., 0.};
+    KahanSummation ChunkSum{0., 0.};
+    KahanSummation ChunkSize{0., 0.};
+    for (std::size_t i = 0; i < WeightedIntensities.size(); ++i) {
+      ChunkWeightSum = KahanSum(ChunkWeightSum, Multiplicities[i] * Weights[i]);
+      ChunkSum = KahanSum(ChunkSum, Multiplicities[i] * WeightedIntensities[i]);
+      ChunkSize = KahanSum(ChunkSize, Multiplicities[i]);
+    }
+    if (ChunkSize == 0.0)
+      return;
+    WeightSum = KahanSum(WeightSum, ChunkWeightSum);
+    IntensitySum = KahanSum(IntensitySum, ChunkSum);
+
+    double ChunkMean = ChunkSum / ChunkSize;
+    KahanSummation ChunkResidualsSqSum{0., 0.};
+    for (std::size_t i = 0; i < WeightedIntensities.size(); ++i) {
+      double Residual = WeightedIntensities[i] - ChunkMean;
+      ChunkResidualsSqSum = KahanSum(ChunkResidualsSqSum,
+                                     Multiplicities[i] * Residual * Residual);
+    }
+    combine(ChunkSize, ChunkMean, ChunkResidualsSqSum);
+  }
+
+private:
+  void combine(double ChunkSize, double ChunkMean,
+               double ChunkResidualsSqSum) {
+    double Delta = ChunkMean - Mean;
+    double Total = NumberOfEvents + ChunkSize;
+    ResidualsSqSum += ChunkResidualsSqSum +
+                      Delta * Delta * NumberOfEvents * ChunkSize / Total;
+    Mean += Delta * ChunkSize / Total;
+    NumberOfEvents = Total;
+  }
+};
 
-  auto WeightSum =
-      std::accumulate(phspsample.Weights.begin(), phspsample.Weights.end(),
-                      KahanSummation{0., 0.}, KahanSum);
+/// Integral and its error from the accumulated sums.
+std::pair<double, double> getIntegralWithError(const IntegrationSums &Sums,
+                                               double phspVolume) {
+  double AvgInt = Sums.IntensitySum / Sums.WeightSum;
+  double Integral = AvgInt * phspVolume;
+
+  // residuals with respect to AvgInt instead of the mean of the weighted
+  // intensities
+  double IntensityResidualsSum =
+      Sums.ResidualsSqSum +
+      Sums.NumberOfEvents * (Sums.Mean - AvgInt) * (Sums.Mean - AvgInt);
+  double AvgIntResSq = IntensityResidualsSum / (Sums.WeightSum - 1);
+  double IntegralErrorSq =
+      AvgIntResSq * phspVolume * phspVolume / Sums.WeightSum;
 
-  std::vector<double> Intensities = intensity.evaluate(phspsample.Data);
+  return std::make_pair(Integral, std::sqrt(IntegralErrorSq));
+}
+
+std::pair<double, double>
+integrateWithError(ComPWA::Intensity &intensity,
+                   const ComPWA::Data::ChunkedDataSet &phspsample,
+                   double phspVolume) {
+  IntegrationSums Sums;
+  phspsample.forEachChunk([&](const ComPWA::Data::DataSet &Chunk) {
+    std::vector<double> Intensities = intensity.evaluate(Chunk.Data);
+    std::transform(
+        pstl::execution::par_unseq, Intensities.begin(), Intensities.end(),
+        Chunk.Weights.begin(), Intensities.begin(),
+        [](double intensity, double weight) { return intensity * weight; });
+    Sums.add(Intensities, Chunk.Weights);
+  });
+  return getIntegralWithError(Sums, phspVolume);
+}
+
+std::pair<double, double>
+integrateWithError(ComPWA::Intensity &intensity,
+                   const ComPWA::Data::DataSetView &phspsample,
+                   double phspVolume) {
+  std::vector<double> Intensities =
+      ComPWA::Data::evaluate(intensity, phspsample);
+  std::vector<double> Weights = phspsample.getWeights();
   std::transform(
       pstl::execution::par_unseq, Intensities.begin(), Intensities.end(),
-      phspsample.Weights.begin(), Intensities.begin(),
+      Weights.begin(), Intensities.begin(),
       [](double intensity, double weight) { return intensity * weight; });
 
-  auto IntensitySum = std::accumulate(Intensities.begin(), Intensities.end(),
-                                  KahanSummation{0., 0.}, KahanSum);
-  double AvgInt = IntensitySum / WeightSum;
-  double Integral = AvgInt * phspVolume ;
-  
-  // We reuse the intensities vector to store residuals of intensities
-  std::transform(pstl::execution::par_unseq, Intensities.begin(),
-                 Intensities.end(), Intensities.begin(),
-                 [&AvgInt](double intensity) {
-                   return (intensity - AvgInt) * (intensity - AvgInt);
-                 });
-  auto IntensityResidualsSum = std::accumulate(
-      Intensities.begin(), Intensities.end(), KahanSummation{0., 0.}, KahanSum);
-  double AvgIntResSq = IntensityResidualsSum / (WeightSum - 1);
-  double IntegralErrorSq = AvgIntResSq * phspVolume * phspVolume / WeightSum;
-  
-  return std::make_pair(Integral, std::sqrt(IntegralErrorSq));
+  IntegrationSums Sums;
+  if (phspsample.getReplicaWeights().empty())
+    Sums.add(Intensities, Weights);
+  else
+    Sums.add(Intensities, Weights, phspsample.getReplicaWeights());
+  return getIntegralWithError(Sums, phspVolume);
+}
+
+std::pair<double, double>
+integrateWithError(ComPWA::Intensity &intensity,
+                   const ComPWA::Data::DataSet &phspsample,
+                   double phspVolume) {
+  return integrateWithError(
+      intensity, ComPWA::Data::SingleChunkDataSet(phspsample), phspVolume);
 }
 
 double integrate(ComPWA::Intensity &intensity,
@@ -74,6 +182,18 @@ double integrate(ComPWA::Intensity &intensity,
   return integrateWithError(intensity, phspsample, phspVolume).first;
 }
 
+double integrate(ComPWA::Intensity &intensity,
+                 const ComPWA::Data::ChunkedDataSet &phspsample,
+                 double phspVolume) {
+  return integrateWithError(intensity, phspsample, phspVolume).first;
+}
+
+double integrate(ComPWA::Intensity &intensity,
+                 const ComPWA::Data::DataSetView &phspsample,
+                 double phspVolume) {
+  return integrateWithError(intensity, phspsample, phspVolume).first;
+}
+
 double maximum(ComPWA::Intensity &intensity,
                const ComPWA::Data::DataSet &sample) {
   if (!sample.Weights.size()) {
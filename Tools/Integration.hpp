@@ -11,6 +11,8 @@ namespace ComPWA {
 
 namespace Data {
 struct DataSet;
+class ChunkedDataSet;
+class DataSetView;
 }
 
 namespace Tools {
@@ -42,6 +44,28 @@ double integrate(ComPWA::Intensity &intensity,
                  const ComPWA::Data::DataSet &phspsample,
                  double phspVolume = 1.0);
 
+/// Calculate integral and its error for a sample that is processed in
+/// chunks. The sums of the formulas above are accumulated over all chunks.
+std::pair<double, double>
+integrateWithError(ComPWA::Intensity &intensity,
+                   const ComPWA::Data::ChunkedDataSet &phspsample,
+                   double phspVolume = 1.0);
+
+double integrate(ComPWA::Intensity &intensity,
+                 const ComPWA::Data::ChunkedDataSet &phspsample,
+                 double phspVolume = 1.0);
+
+/// Calculate integral and its error for a resampled sample, e.g. a
+/// bootstrap replica. Each entry counts as many times as its replica weight.
+std::pair<double, double>
+integrateWithError(ComPWA::Intensity &intensity,
+                   const ComPWA::Data::DataSetView &phspsample,
+                   double phspVolume = 1.0);
+
+double integrate(ComPWA::Intensity &intensity,
+                 const ComPWA::Data::DataSetView &phspsample,
+                 double phspVolume = 1.0);
+
 double maximum(ComPWA::Intensity &intensity,
                const ComPWA::Data::DataSet &sample);
 
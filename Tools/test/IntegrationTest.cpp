@@ -5,8 +5,11 @@
 #define BOOST_TEST_MODULE IntegrationTest
 
 #include "Tools/Integration.hpp"
+#include "Core/Exceptions.hpp"
 #include "Core/Logging.hpp"
+#include "Data/Binary/StreamingDataSet.hpp"
 #include "Data/DataSet.hpp"
+#include "Data/DataSetView.hpp"
 #include "Data/Generate.hpp"
 #include "Data/Root/RootGenerator.hpp"
 #include "Physics/BuilderXML.hpp"
@@ -15,6 +18,8 @@
 #include <boost/property_tree/xml_parser.hpp>
 #include <boost/test/unit_test.hpp>
 
+#include <random>
+
 using namespace ComPWA;
 
 BOOST_AUTO_TEST_SUITE(ToolTests)
@@ -297,6 +302,83 @@ BOOST_AUTO_TEST_CASE(IntegrationGaussianTest) {
             << integral.second;
 
   BOOST_CHECK_SMALL(std::abs(integral.first - 1.0), 3 * integral.second);
+
+  // the same sample streamed from a file in several chunks
+  ComPWA::Data::Binary::writeDataSet(PhspSample, "IntegrationTest.bin");
+  {
+    ComPWA::Data::Binary::StreamingDataSet Stream({"IntegrationTest.bin"},
+                                                  30000);
+    BOOST_CHECK_EQUAL(Stream.numberOfChunks(), 7);
+    auto ChunkedIntegral = ComPWA::Tools::integrateWithError(
+        Gauss, Stream, domain_range.second - domain_range.first);
+    BOOST_CHECK_CLOSE(ChunkedIntegral.first, integral.first, 1e-9);
+    BOOST_CHECK_CLOSE(ChunkedIntegral.second, integral.second, 1e-6);
+  }
+  std::remove("IntegrationTest.bin");
+}
+
+BOOST_AUTO_TEST_CASE(IntegrationDataSetViewTest) {
+  ComPWA::Logging Log("trace", "");
+
+  double mean(3.0);
+  double sigma(0.1);
+  auto Gauss = Gaussian(mean, sigma);
+
+  std::pair<double, double> domain_range(mean - 10.0 * sigma,
+                                         mean + 10.0 * sigma);
+  double Volume = domain_range.second - domain_range.first;
+  ComPWA::Data::DataSet PhspSample;
+  PhspSample.Data.push_back({});
+  std::mt19937 mt_gen(123456);
+  std::uniform_real_distribution<double> distribution(domain_range.first,
+                                                      domain_range.second);
+  for (unsigned int i = 0; i < 20000; ++i) {
+    PhspSample.Data[0].push_back(distribution(mt_gen));
+    PhspSample.Weights.push_back(1.0 + 0.5 * (i % 3));
+  }
+
+  // a view of all events in their original order gives the same result
+  auto integral = ComPWA::Tools::integrateWithError(Gauss, PhspSample, Volume);
+  auto ViewIntegral = ComPWA::Tools::integrateWithError(
+      Gauss, ComPWA::Data::DataSetView(PhspSample), Volume);
+  BOOST_CHECK_EQUAL(ViewIntegral.first, integral.first);
+  BOOST_CHECK_EQUAL(ViewIntegral.second, integral.second);
+
+  // a replica is equivalent to a copy of the resampled events
+  auto Replica = ComPWA::Data::createPoissonBootstrapView(PhspSample, 42);
+  ComPWA::Data::DataSet ReplicaSample;
+  ReplicaSample.Data.push_back({});
+  auto Weights = Replica.getWeights();
+  for (std::size_t i = 0; i < Replica.size(); ++i) {
+    for (int j = 0; j < Replica.getReplicaWeights()[i]; ++j) {
+      ReplicaSample.Data[0].push_back(PhspSample.Data[0][i]);
+      ReplicaSample.Weights.push_back(Weights[i]);
+    }
+  }
+  BOOST_CHECK_EQUAL(Replica.getNumberOfEvents(), ReplicaSample.Weights.size());
+  auto ReplicaIntegral =
+      ComPWA::Tools::integrateWithError(Gauss, Replica, Volume);
+  auto CopyIntegral =
+      ComPWA::Tools::integrateWithError(Gauss, ReplicaSample, Volume);
+  BOOST_CHECK_CLOSE(ReplicaIntegral.first, CopyIntegral.first, 1e-9);
+  BOOST_CHECK_CLOSE(ReplicaIntegral.second, CopyIntegral.second, 1e-6);
+
+  // the same for an index array
+  ComPWA::Data::DataSetView Subsample(PhspSample, {5, 3, 3, 19999, 12});
+  ComPWA::Data::DataSet SubsampleCopy;
+  SubsampleCopy.Data.push_back({});
+  for (auto Index : Subsample.getIndices()) {
+    SubsampleCopy.Data[0].push_back(PhspSample.Data[0][Index]);
+    SubsampleCopy.Weights.push_back(PhspSample.Weights[Index]);
+  }
+  BOOST_CHECK_CLOSE(ComPWA::Tools::integrate(Gauss, Subsample, Volume),
+                    ComPWA::Tools::integrate(Gauss, SubsampleCopy, Volume),
+                    1e-9);
+
+  BOOST_CHECK_THROW(ComPWA::Data::DataSetView(PhspSample, {20000}),
+                    ComPWA::BadParameter);
+  BOOST_CHECK_THROW(ComPWA::Data::DataSetView(PhspSample, {1, 2}, {1.0}),
+                    ComPWA::BadParameter);
 }
 
 BOOST_AUTO_TEST_SUITE_END()